@@ -24,6 +24,7 @@
 #pragma link C++ class FairGeaneApplication+;
 #pragma link C++ class FairGenerator+;
 #pragma link C++ class FairLink+;
+#pragma link C++ class FairLinkTable+;
 //#pragma link C++ class FairLinkedData+;
 //#pragma link C++ class FairSingleLinkedData+;
 #pragma link C++ class FairMultiLinkedData+;
@@ -42,12 +43,14 @@
 #pragma link C++ class FairRun+;
 #pragma link C++ class FairRunAna;
 #pragma link C++ class FairRunAnaProof;
+#pragma link C++ class FairRunAnaMP;
 #pragma link C++ class FairRunIdGenerator;
 #pragma link C++ class FairRunSim;
 #pragma link C++ class FairTrackParam+;
 #pragma link C++ class FairTrajFilter;
 #pragma link C++ class FairVolume+;
 #pragma link C++ class FairVolumeList+;
+#pragma link C++ class FairGeoCache+;
 #pragma link C++ class FairField+;
 #pragma link C++ class FairGenericStack+;
 #pragma link C++ class FairTask+;
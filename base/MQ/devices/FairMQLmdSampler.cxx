@@ -16,6 +16,8 @@
 #include "FairMQLogger.h"
 #include "FairMQLmdSampler.h"
 #include <stdexcept>
+#include <cstring>
+#include <chrono>
 
 FairMQLmdSampler::FairMQLmdSampler() : 
     fCurrentFile(0),
@@ -29,7 +31,12 @@ FairMQLmdSampler::FairMQLmdSampler() :
     fxSubEvent(nullptr),
     fxInfoHeader(nullptr),
     stop(false),
-    fMsgCounter(0)
+    fMsgCounter(0),
+    fSubEvtCounter(0),
+    fBatchSize(0),
+    fBatchTimeout(0),
+    fSubEventChanMap(),
+    fBatches()
 {
 }
 
@@ -66,9 +73,27 @@ void FairMQLmdSampler::AddSubEvtKey(short type, short subType, short procid, sho
 }
 
 
+//______________________________________________________________________________
+void FairMQLmdSampler::SetBatching(int batchSize, int batchTimeout)
+{
+    fBatchSize = batchSize;
+    fBatchTimeout = batchTimeout;
+}
+
+
 //______________________________________________________________________________
 void FairMQLmdSampler::InitTask()
 {
+    // resolve the channel of each sub-event key once
+    fBatches.clear();
+    for (const auto& p : fSubEventChanMap)
+    {
+        if (!fChannels.count(p.second))
+        {
+            throw std::runtime_error(std::string("FairMQLmdSampler::InitTask: MQ-channel name '") + p.second + "' does not exist. Check the MQ-channel configuration");
+        }
+        fBatches.insert(std::make_pair(p.first, FairMQSubEventBatch(&fChannels.at(p.second).at(0))));
+    }
   
     if(fFileNames.size() == 0) 
     {
@@ -89,14 +114,51 @@ void FairMQLmdSampler::InitTask()
 
 void FairMQLmdSampler::Run()
 {
-    
+    auto start = std::chrono::steady_clock::now();
+
     while (CheckCurrentState(RUNNING) )//&& !stop)
     {    
         if(1 == ReadEvent())
             break;
+
+        if(fBatchTimeout > 0)
+            SendBatches(true);
     }
-    LOG(INFO)<<"Sent "<<fMsgCounter<<" messages.";
+    // send the incomplete batches
+    SendBatches(false);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    LOG(INFO)<<"Sent "<<fSubEvtCounter<<" sub-events of "<<fNEvent<<" events in "<<fMsgCounter<<" messages.";
+    if(seconds > 0)
+        LOG(INFO)<<"Rate: "<<fNEvent/seconds<<" events/s, "<<fSubEvtCounter/seconds<<" sub-events/s, "<<fMsgCounter/seconds<<" messages/s";
+
+}
 
+
+//______________________________________________________________________________
+void FairMQLmdSampler::SendBatch(FairMQSubEventBatch& batch)
+{
+    if(batch.GetNSubEvents() == 0)
+        return;
+
+    std::unique_ptr<FairMQMessage> msg(fTransportFactory->CreateMessage(batch.GetMessageSize()));
+    batch.Write(msg->GetData());
+    batch.GetChannel()->Send(msg);
+    batch.Clear();
+    fMsgCounter++;
+}
+
+
+//______________________________________________________________________________
+void FairMQLmdSampler::SendBatches(bool timeoutOnly)
+{
+    auto now = std::chrono::steady_clock::now();
+    for (auto& p : fBatches)
+    {
+        FairMQSubEventBatch& batch = p.second;
+        if(batch.GetNSubEvents() > 0 && (!timeoutOnly || now - batch.GetStartTime() >= std::chrono::milliseconds(fBatchTimeout)))
+            SendBatch(batch);
+    }
 }
 
 
@@ -201,8 +263,8 @@ int FairMQLmdSampler::ReadEvent()
         // Data to send : fxEventData
         SubEvtKey key(setype, sesubtype, seprocid, sesubcrate, secontrol);
 
-        
-        if(!fSubEventChanMap.count(key))
+        auto it = fBatches.find(key);
+        if(it == fBatches.end())
         {
             LOG(TRACE)<<"FairMQLmdSampler::ReadEvent: sub-event key not registered";
         }
@@ -211,20 +273,28 @@ int FairMQLmdSampler::ReadEvent()
             LOG(TRACE)<<"array size = "<<sebuflength;
             LOG(TRACE)<<"fxEventData = "<<*fxEventData;
 
-            std::string chanName=fSubEventChanMap.at(key);
-            LOG(TRACE)<<"chanName="<<chanName;
+            FairMQSubEventBatch& batch = it->second;
+            fSubEvtCounter++;
+
+            if(fBatchSize > 0)
+            {
+                // the sub-event data is only valid until the next event is read, the batch keeps a copy
+                batch.Add(fxEventData, sebuflength);
+                if(batch.GetNSubEvents() >= fBatchSize)
+                    SendBatch(batch);
+                continue;
+            }
 
             // send header
             //std::unique_ptr<FairMQMessage> header(fTransportFactory->CreateMessage(fxSubEvent, sizeof(fxSubEvent), free_buffer, nullptr));
             //fChannels.at(chanName).at(0).SendPart(header);
 
-            int* arraySize = new int(sebuflength);
-
-            std::unique_ptr<FairMQMessage> msgSize(fTransportFactory->CreateMessage(arraySize, sizeof(int)));
-            fChannels.at(chanName).at(0).SendPart(msgSize);
-            // send data
-            std::unique_ptr<FairMQMessage> msg(fTransportFactory->CreateMessage(fxEventData, sebuflength, free_buffer, nullptr));
-            fChannels.at(chanName).at(0).Send(msg);
+            std::unique_ptr<FairMQMessage> msgSize(fTransportFactory->CreateMessage(sizeof(int)));
+            std::memcpy(msgSize->GetData(), &sebuflength, sizeof(int));
+            batch.GetChannel()->SendPart(msgSize);
+            // send data (sebuflength is in 32 bit words)
+            std::unique_ptr<FairMQMessage> msg(fTransportFactory->CreateMessage(fxEventData, sebuflength * sizeof(int), free_buffer, nullptr));
+            batch.GetChannel()->Send(msg);
             fMsgCounter++;
             /*
             if(Unpack(fxEventData, sebuflength,
@@ -328,6 +398,9 @@ void FairMQLmdSampler::AddFile(const std::string& fileName)
 void FairMQLmdSampler::Close()
 {
     f_evt_get_close(fxInputChannel);
+    // the channel is allocated for each file in OpenNextFile
+    delete fxInputChannel;
+    fxInputChannel = nullptr;
     //Unpack((Int_t*)fxBuffer, sizeof(s_bufhe), -4, -4, -4, -4, -4);  
     fCurrentEvent=0;
 }
@@ -26,6 +26,7 @@ extern "C"
 
 #include "FairMQDevice.h"
 #include "FairMQMessage.h"
+#include "FairMQSubEventBatch.h"
 
 #include <string>
 #include <vector>
@@ -49,11 +50,18 @@ public:
     void AddDir(const std::string& dir);
     void AddFile(const std::string& fileName);
 
+    /// Sends the sub-events of each key in batches instead of one by one (see FairMQSubEventBatch)
+    /// @param batchSize Maximum number of sub-events per batch, 0 sends every sub-event as size and data part (default)
+    /// @param batchTimeout Maximum time in ms a sub-event waits in an incomplete batch, 0 for no limit
+    void SetBatching(int batchSize, int batchTimeout = 0);
+
 protected:
 
     void InitTask();
     void Run();
     int ReadEvent();
+    void SendBatch(FairMQSubEventBatch& batch);
+    void SendBatches(bool timeoutOnly);
     bool OpenNextFile(const std::string& fileName);
     
     void Close();
@@ -71,8 +79,12 @@ private:
     s_filhe* fxInfoHeader;
     bool stop;
     int fMsgCounter;
+    int fSubEvtCounter;
+    int fBatchSize;
+    int fBatchTimeout;
     typedef std::tuple<short,short,short,short,short> SubEvtKey;
     std::map<SubEvtKey,std::string > fSubEventChanMap;
+    std::map<SubEvtKey,FairMQSubEventBatch> fBatches; // sub-event key -> channel and pending sub-events, filled in InitTask
 };
 
 #endif  /* !FAIRMQLMDSAMPLER_H */
\ No newline at end of file
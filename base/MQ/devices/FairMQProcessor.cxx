@@ -15,17 +15,34 @@
 #include <boost/thread.hpp>
 #include <boost/bind.hpp>
 
+#include "RVersion.h"
+#include "TROOT.h"
+#include "TThread.h"
+
 #include "FairMQProcessor.h"
+#include "FairMQWorkerPool.h"
 #include "FairMQLogger.h"
 
+using namespace std;
+
 FairMQProcessor::FairMQProcessor()
-  : fProcessorTask(NULL)
+  : fNumWorkers(1)
+  , fOrderedOutput(0)
+  , fBatchedInput(0)
+  , fBatchedOutput(0)
+  , fProcessorTask(NULL)
+  , fTaskFactory()
+  , fWorkerTasks()
 {
 }
 
 FairMQProcessor::~FairMQProcessor()
 {
     delete fProcessorTask;
+    for (unsigned int i = 0; i < fWorkerTasks.size(); ++i)
+    {
+        delete fWorkerTasks.at(i);
+    }
 }
 
 void FairMQProcessor::SetTask(FairMQProcessorTask* task)
@@ -33,16 +50,63 @@ void FairMQProcessor::SetTask(FairMQProcessorTask* task)
     fProcessorTask = task;
 }
 
+void FairMQProcessor::SetTaskFactory(function<FairMQProcessorTask*()> factory)
+{
+    fTaskFactory = factory;
+}
+
 void FairMQProcessor::InitTask()
 {
+    if (!fProcessorTask && fTaskFactory)
+    {
+        fProcessorTask = fTaskFactory();
+    }
+
     fProcessorTask->InitTask();
 
     fProcessorTask->SetSendPart(boost::bind(&FairMQProcessor::SendPart, this));
     fProcessorTask->SetReceivePart(boost::bind(&FairMQProcessor::ReceivePart, this));
+
+    if (fNumWorkers > 1)
+    {
+        if (fBatchedInput && !fBatchedOutput)
+        {
+            LOG(WARN) << "The workers send one message per received batch, the output is batched.";
+            fBatchedOutput = 1;
+        }
+
+        if (!fTaskFactory)
+        {
+            LOG(ERROR) << "NumWorkers > 1 requires a task factory (SetTaskFactory()), running with a single worker.";
+            fNumWorkers = 1;
+            return;
+        }
+
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,6,0)
+        // the task clones create and fill ROOT objects concurrently
+        ROOT::EnableThreadSafety();
+#else
+        TThread::Initialize();
+#endif
+
+        // multipart messages are received/sent by the pool threads, the callbacks are not available to the workers
+        for (int i = fWorkerTasks.size(); i < fNumWorkers - 1; ++i)
+        {
+            FairMQProcessorTask* task = fTaskFactory();
+            task->InitTask();
+            fWorkerTasks.push_back(task);
+        }
+    }
 }
 
 void FairMQProcessor::Run()
 {
+    if (fNumWorkers > 1)
+    {
+        RunWorkerPool();
+        return;
+    }
+
     int receivedMsgs = 0;
     int sentMsgs = 0;
 
@@ -58,7 +122,26 @@ void FairMQProcessor::Run()
 
         if (dataInChannel.Receive(fProcessorTask->GetPayload()) > 0)
         {
-            fProcessorTask->Exec();
+            if (!fBatchedInput)
+            {
+                fProcessorTask->Exec();
+            }
+            else if (!fBatchedOutput)
+            {
+                // every event is sent on its own, the payload keeps the received batch
+                fProcessorTask->ExecBatch(fTransportFactory, [&](FairMQMessage* msg)
+                {
+                    dataOutChannel.Send(msg);
+                    ++sentMsgs;
+                });
+                fProcessorTask->GetPayload()->CloseMessage();
+                continue;
+            }
+            else if (fProcessorTask->ExecBatch(fTransportFactory) < 0)
+            {
+                fProcessorTask->GetPayload()->CloseMessage();
+                continue;
+            }
 
             dataOutChannel.Send(fProcessorTask->GetPayload());
             sentMsgs++;
@@ -70,6 +153,36 @@ void FairMQProcessor::Run()
     LOG(INFO) << "Received " << receivedMsgs << " and sent " << sentMsgs << " messages!";
 }
 
+void FairMQProcessor::RunWorkerPool()
+{
+    // store the channel references to avoid traversing the map on every loop iteration
+    const FairMQChannel& dataInChannel = fChannels.at("data-in").at(0);
+    const FairMQChannel& dataOutChannel = fChannels.at("data-out").at(0);
+
+    FairMQWorkerPool pool(fNumWorkers, fOrderedOutput != 0);
+
+    boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+
+    pool.Run(dataInChannel, dataOutChannel, fTransportFactory,
+             [this]() { return CheckCurrentState(RUNNING); },
+             [this](const int worker, unique_ptr<FairMQMessage>& msg)
+             {
+                 FairMQProcessorTask* task = (worker == 0) ? fProcessorTask : fWorkerTasks.at(worker - 1);
+                 task->SetPayload(msg.get());
+                 if (fBatchedInput)
+                 {
+                     return task->ExecBatch(fTransportFactory) >= 0;
+                 }
+                 task->Exec();
+                 return true;
+             });
+
+    double seconds = (boost::posix_time::microsec_clock::local_time() - start).total_microseconds() / 1.e6;
+
+    LOG(INFO) << "Received " << pool.GetNumReceived() << " and sent " << pool.GetNumSent() << " messages with "
+              << fNumWorkers << " workers (" << pool.GetNumSent() / seconds << " msg/s)!";
+}
+
 void FairMQProcessor::SendPart()
 {
       fChannels.at("data-out").at(0).Send(fProcessorTask->GetPayload(), "snd-more");
@@ -89,3 +202,88 @@ bool FairMQProcessor::ReceivePart()
         return false;
     }
 }
+
+void FairMQProcessor::SetProperty(const int key, const string& value)
+{
+    switch (key)
+    {
+        default:
+            FairMQDevice::SetProperty(key, value);
+            break;
+    }
+}
+
+string FairMQProcessor::GetProperty(const int key, const string& default_ /*= ""*/)
+{
+    switch (key)
+    {
+        default:
+            return FairMQDevice::GetProperty(key, default_);
+    }
+}
+
+void FairMQProcessor::SetProperty(const int key, const int value)
+{
+    switch (key)
+    {
+        case NumWorkers:
+            fNumWorkers = value;
+            break;
+        case OrderedOutput:
+            fOrderedOutput = value;
+            break;
+        case BatchedInput:
+            fBatchedInput = value;
+            break;
+        case BatchedOutput:
+            fBatchedOutput = value;
+            break;
+        default:
+            FairMQDevice::SetProperty(key, value);
+            break;
+    }
+}
+
+int FairMQProcessor::GetProperty(const int key, const int default_ /*= 0*/)
+{
+    switch (key)
+    {
+        case NumWorkers:
+            return fNumWorkers;
+        case OrderedOutput:
+            return fOrderedOutput;
+        case BatchedInput:
+            return fBatchedInput;
+        case BatchedOutput:
+            return fBatchedOutput;
+        default:
+            return FairMQDevice::GetProperty(key, default_);
+    }
+}
+
+string FairMQProcessor::GetPropertyDescription(const int key)
+{
+    switch (key)
+    {
+        case NumWorkers:
+            return "NumWorkers: Number of worker threads, each running its own task clone (1 processes on the receiving thread).";
+        case OrderedOutput:
+            return "OrderedOutput: Send the processed messages in the order they were received (1/0, only with NumWorkers > 1).";
+        case BatchedInput:
+            return "BatchedInput: The received messages are event batches of a sampler with EventsPerMessage > 1 (1/0).";
+        case BatchedOutput:
+            return "BatchedOutput: Send the processed events of a batch as one batch, instead of one message per event (1/0, only with BatchedInput).";
+        default:
+            return FairMQDevice::GetPropertyDescription(key);
+    }
+}
+
+void FairMQProcessor::ListProperties()
+{
+    LOG(INFO) << "Properties of FairMQProcessor:";
+    for (int p = FairMQConfigurable::Last; p < FairMQProcessor::Last; ++p)
+    {
+        LOG(INFO) << " " << GetPropertyDescription(p);
+    }
+    LOG(INFO) << "---------------------------";
+}
@@ -15,6 +15,10 @@
 #ifndef FAIRMQPROCESSOR_H_
 #define FAIRMQPROCESSOR_H_
 
+#include <string>
+#include <vector>
+#include <functional>
+
 #include "FairMQDevice.h"
 #include "FairMQProcessorTask.h"
 
@@ -22,19 +26,47 @@
 class FairMQProcessor : public FairMQDevice
 {
   public:
+    enum
+    {
+        NumWorkers = FairMQDevice::Last,
+        OrderedOutput,
+        BatchedInput,
+        BatchedOutput,
+        Last
+    };
+
     FairMQProcessor();
     virtual ~FairMQProcessor();
     void SetTask(FairMQProcessorTask* task);
+    /// Sets a factory for the processor task. Required for NumWorkers > 1, where every worker thread gets its own task clone.
+    void SetTaskFactory(std::function<FairMQProcessorTask*()> factory);
 
     void SendPart();
     bool ReceivePart();
 
+    virtual void SetProperty(const int key, const std::string& value);
+    virtual std::string GetProperty(const int key, const std::string& default_ = "");
+    virtual void SetProperty(const int key, const int value);
+    virtual int GetProperty(const int key, const int default_ = 0);
+
+    virtual std::string GetPropertyDescription(const int key);
+    virtual void ListProperties();
+
   protected:
+    int fNumWorkers;
+    int fOrderedOutput;
+    int fBatchedInput;
+    int fBatchedOutput;
+
     virtual void InitTask();
     virtual void Run();
 
   private:
     FairMQProcessorTask* fProcessorTask;
+    std::function<FairMQProcessorTask*()> fTaskFactory;
+    std::vector<FairMQProcessorTask*> fWorkerTasks; ///< task clones of the workers 1..N-1 (worker 0 uses fProcessorTask)
+
+    void RunWorkerPool();
 
     /// Copy Constructor
     FairMQProcessor(const FairMQProcessor&);
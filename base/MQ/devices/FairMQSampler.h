@@ -57,6 +57,7 @@ class FairMQSampler : public FairMQDevice
         ParFile,
         Branch,
         EventRate,
+        EventsPerMessage,
         Last
     };
 
@@ -95,6 +96,7 @@ class FairMQSampler : public FairMQDevice
     int fNumEvents;
     int fEventRate;
     int fEventCounter;
+    int fEventsPerMessage; // Number of events sent in one message (see FairMQEventBatch), 1 sends the events unbatched.
     bool fContinuous;
 
   private:
@@ -22,6 +22,7 @@ FairMQSampler<Loader>::FairMQSampler()
     , fNumEvents(0)
     , fEventRate(1)
     , fEventCounter(0)
+    , fEventsPerMessage(1)
     , fContinuous(false)
 {
 }
@@ -81,17 +82,36 @@ void FairMQSampler<Loader>::Run()
     boost::timer::auto_cpu_timer timer;
 
     LOG(INFO) << "Number of events to process: " << fNumEvents;
+    if (fEventsPerMessage > 1)
+    {
+        LOG(INFO) << "Sending " << fEventsPerMessage << " events per message";
+    }
 
     // store the channel references to avoid traversing the map on every loop iteration
     FairMQChannel& dataOutChannel = fChannels.at("data-out").at(0);
 
     do
     {
-        for (Long64_t eventNr = 0; eventNr < fNumEvents; ++eventNr)
+        for (Long64_t eventNr = 0; eventNr < fNumEvents; eventNr += fEventsPerMessage)
         {
             fSamplerTask->SetEventIndex(eventNr);
             fFairRunAna->RunMQ(eventNr);
 
+            if (fEventsPerMessage > 1)
+            {
+                // Only the first event of the batch goes through the event cycle of FairRunAna,
+                // for the others the task reads its branch and serializes it in the same pass.
+                fSamplerTask->AddOutputToBatch();
+                for (Long64_t batchNr = eventNr + 1; batchNr < eventNr + fEventsPerMessage && batchNr < fNumEvents; ++batchNr)
+                {
+                    fSamplerTask->SetEventIndex(batchNr);
+                    fSamplerTask->ReadBranchEntry(batchNr);
+                    fSamplerTask->Exec("");
+                    fSamplerTask->AddOutputToBatch();
+                }
+                fSamplerTask->CloseBatch();
+            }
+
             dataOutChannel.Send(fSamplerTask->GetOutput());
             ++sentMsgs;
 
@@ -191,6 +211,9 @@ void FairMQSampler<Loader>::SetProperty(const int key, const int value)
         case EventRate:
             fEventRate = value;
             break;
+        case EventsPerMessage:
+            fEventsPerMessage = (value > 1) ? value : 1;
+            break;
         default:
             FairMQDevice::SetProperty(key, value);
             break;
@@ -204,6 +227,8 @@ int FairMQSampler<Loader>::GetProperty(const int key, const int default_/*= 0*/)
     {
         case EventRate:
             return fEventRate;
+        case EventsPerMessage:
+            return fEventsPerMessage;
         default:
             return FairMQDevice::GetProperty(key, default_);
     }
@@ -222,6 +247,8 @@ std::string FairMQSampler<Loader>::GetPropertyDescription(const int key)
             return "Branch: Name of the Branch (e.g. FairTestDetectorDigi).";
         case EventRate:
             return "EventRate: Upper limit for the message rate.";
+        case EventsPerMessage:
+            return "EventsPerMessage: Number of events sent in one message, with a table of their offsets (see FairMQEventBatch).";
         default:
             return FairMQDevice::GetPropertyDescription(key);
     }
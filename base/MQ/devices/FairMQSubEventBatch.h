@@ -0,0 +1,131 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/*
+ * File:   FairMQSubEventBatch.h
+ *
+ * Created on March 7, 2016
+ */
+
+#ifndef FAIRMQSUBEVENTBATCH_H
+#define FAIRMQSUBEVENTBATCH_H
+
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#include "FairMQChannel.h"
+
+/**
+ * Collects consecutive MBS sub-events with the same header key and writes them
+ * into one message. All fields are 32 bit integers:
+ *
+ *   [n] [offset 0] ... [offset n] [data of sub-event 0] ... [data of sub-event n-1]
+ *
+ * The offsets are counted in 32 bit words from the start of the message, the
+ * size of sub-event i is offset i+1 - offset i.
+ */
+
+class FairMQSubEventBatch
+{
+public:
+
+    FairMQSubEventBatch(const FairMQChannel* channel = nullptr) :
+        fChannel(channel),
+        fData(),
+        fOffsets(),
+        fStartTime()
+    {
+    }
+
+    /// Appends a sub-event
+    /// @param data Sub-event data
+    /// @param size Size of the data in 32 bit words
+    void Add(const int* data, int size)
+    {
+        if (fOffsets.empty())
+        {
+            fStartTime = std::chrono::steady_clock::now();
+        }
+        fOffsets.push_back(fData.size());
+        fData.insert(fData.end(), data, data + size);
+    }
+
+    int GetNSubEvents() const
+    {
+        return fOffsets.size();
+    }
+
+    /// Get the size of the batch message in bytes
+    size_t GetMessageSize() const
+    {
+        return (2 + fOffsets.size() + fData.size()) * sizeof(int);
+    }
+
+    /// Get the time when the first sub-event of the batch was added
+    std::chrono::steady_clock::time_point GetStartTime() const
+    {
+        return fStartTime;
+    }
+
+    const FairMQChannel* GetChannel() const
+    {
+        return fChannel;
+    }
+
+    /// Writes the batch into a message buffer of GetMessageSize() bytes
+    void Write(void* buffer) const
+    {
+        int* out = static_cast<int*>(buffer);
+        int n = fOffsets.size();
+        int header = 2 + n;
+        out[0] = n;
+        for (int i = 0; i < n; ++i)
+        {
+            out[1 + i] = header + fOffsets[i];
+        }
+        out[1 + n] = header + fData.size();
+        if (!fData.empty())
+        {
+            std::memcpy(out + header, fData.data(), fData.size() * sizeof(int));
+        }
+    }
+
+    /// Removes the sub-events, keeping the allocated memory for the next batch
+    void Clear()
+    {
+        fData.clear();
+        fOffsets.clear();
+    }
+
+    /// Get the number of sub-events in a batch message
+    static int GetNSubEvents(const void* buffer)
+    {
+        return static_cast<const int*>(buffer)[0];
+    }
+
+    /// Get a sub-event of a batch message
+    /// @param buffer Message data
+    /// @param i Sub-event index in the range [0, GetNSubEvents(buffer))
+    /// @param size Returns the size of the sub-event in 32 bit words
+    /// @return Pointer to the sub-event data in the message
+    static const int* GetSubEvent(const void* buffer, int i, int& size)
+    {
+        const int* in = static_cast<const int*>(buffer);
+        size = in[2 + i] - in[1 + i];
+        return in + in[1 + i];
+    }
+
+private:
+
+    const FairMQChannel* fChannel;
+    std::vector<int> fData;
+    std::vector<int> fOffsets;
+    std::chrono::steady_clock::time_point fStartTime;
+};
+
+#endif  /* !FAIRMQSUBEVENTBATCH_H */
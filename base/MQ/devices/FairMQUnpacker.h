@@ -17,6 +17,7 @@
 
 #include "FairMQDevice.h"
 #include "FairMQMessage.h"
+#include "FairMQSubEventBatch.h"
 #include "RootSerializer.h"
 
 #include <stdexcept>
@@ -36,7 +37,8 @@ public:
     FairMQUnpacker() : serialization_type(),
         fSubEventChanMap(), 
         fUnpacker(nullptr), 
-        fInputChannelName()
+        fInputChannelName(),
+        fBatched(false)
     {
 
     }
@@ -79,6 +81,12 @@ public:
         }
     }
 
+    /// Expects the sub-events in batches, as sent by FairMQLmdSampler::SetBatching
+    void SetBatched(bool batched)
+    {
+        fBatched = batched;
+    }
+
 protected:
 
     void InitTask()
@@ -113,6 +121,35 @@ protected:
         const FairMQChannel& inputChannel = fChannels.at(fInputChannelName).at(0);
         const FairMQChannel& outputChannel = fChannels.at("data-out").at(0);
 
+        if (fBatched)
+        {
+            while (CheckCurrentState(RUNNING))
+            {
+                std::unique_ptr<FairMQMessage> batch(fTransportFactory->CreateMessage());
+
+                if(inputChannel.Receive(batch)>=0)
+                {
+                    int nSubEvts = FairMQSubEventBatch::GetNSubEvents(batch->GetData());
+                    LOG(TRACE)<<"batch of "<<nSubEvts<<" sub-events";
+
+                    for(int i = 0; i < nSubEvts; i++)
+                    {
+                        int dataSize;
+                        // the unpacker takes non-const data, it only reads it
+                        int* subEvt_ptr = const_cast<int*>(FairMQSubEventBatch::GetSubEvent(batch->GetData(), i, dataSize));
+
+                        fUnpacker->DoUnpack(subEvt_ptr,dataSize);
+
+                        std::unique_ptr<FairMQMessage> msg(fTransportFactory->CreateMessage());
+                        serialization_type::SetMessage(msg.get());
+                        outputChannel.Send(serialization_type::SerializeMsg(fUnpacker->GetOutputData()));
+                        fUnpacker->Reset();
+                    }
+                }
+            }
+            return;
+        }
+
         while (CheckCurrentState(RUNNING))
         {
 
@@ -146,6 +183,7 @@ protected:
 
     unpacker_type* fUnpacker;
     std::string fInputChannelName;
+    bool fBatched;
 
 };
 
@@ -0,0 +1,416 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/*
+ * File:   PrefetchTreeReader.h
+ *
+ * Sampler source policy which reads and serializes the events in background threads.
+ *
+ * Each serializer thread opens the tree on its own, reads blocks of consecutive entries
+ * of the branch through a TTreeCache and serializes them into ready messages with its own
+ * instance of the serialization policy. The sampler takes the messages with
+ * GetReadyMessage() in the order of the blocks, at most fQueueDepth blocks are read ahead.
+ * With several sockets on the output channel the entries are sharded by range: socket i
+ * gets the i-th part of the entries, in their order.
+ *
+ * The serialization policy is a template parameter because every thread needs an instance
+ * of its own, the serialization policy of the sampler is not used for the events.
+ */
+
+#ifndef PREFETCHTREEREADER_H
+#define PREFETCHTREEREADER_H
+
+// std
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <stdint.h>
+
+// boost
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+// ROOT
+#include "Rtypes.h"
+#include "RVersion.h"
+#include "TFile.h"
+#include "TROOT.h"
+#include "TThread.h"
+#include "TTree.h"
+
+// FairRoot
+#include "FairMQLogger.h"
+#include "FairMQMessage.h"
+
+template <typename DataType, typename SerializerType>
+class base_PrefetchTreeReader
+{
+  protected:
+    typedef DataType* DataType_ptr;
+
+  private:
+    /// consecutive entries of one output socket, serialized by one thread
+    struct Block
+    {
+        Block() : fSocket(0), fFirst(0), fLast(0), fMessages() {}
+
+        int fSocket;
+        int64_t fFirst;
+        int64_t fLast;
+        std::deque<FairMQMessage*> fMessages;
+    };
+
+  public:
+    base_PrefetchTreeReader()
+        : fFileName()
+        , fTreeName()
+        , fBranchName()
+        , fInputFile(nullptr)
+        , fTree(nullptr)
+        , fDataBranch(nullptr)
+        , fIndex(0)
+        , fIndexMax(0)
+        , fNumSerializers(4)
+        , fQueueDepth(64)
+        , fBlockSize(16)
+        , fCacheSize(30000000)
+        , fThreads()
+        , fMutex()
+        , fReadyCondition()
+        , fFreeCondition()
+        , fReady()
+        , fCurrent()
+        , fNumSockets(1)
+        , fNumBlocks(0)
+        , fNextBlock(0)
+        , fNextToSend(0)
+        , fNumAlive(0)
+        , fRunning(false)
+        , fStop(false)
+        , CreateMessage()
+        , GetSocketNumber()
+    {}
+
+    virtual ~base_PrefetchTreeReader()
+    {
+        StopThreads();
+        if (fInputFile)
+        {
+            fInputFile->Close();
+            delete fInputFile;
+        }
+    }
+
+    void SetFileProperties(const std::string &filename, const std::string &treename, const std::string &branchname)
+    {
+        fFileName = filename;
+        fTreeName = treename;
+        fBranchName = branchname;
+    }
+
+    /// number of serializer threads, blocks read ahead and entries per block
+    void SetParallelism(int numSerializers, int queueDepth = 64, int blockSize = 16)
+    {
+        fNumSerializers = numSerializers > 0 ? numSerializers : 1;
+        fQueueDepth = queueDepth > 0 ? queueDepth : 1;
+        fBlockSize = blockSize > 0 ? blockSize : 1;
+    }
+
+    /// size of the TTreeCache of each serializer thread
+    void SetCacheSize(int64_t bytes)
+    {
+        fCacheSize = bytes;
+    }
+
+    void InitSource()
+    {
+        // the threads read the file with trees of their own
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,6,0)
+        ROOT::EnableThreadSafety();
+#else
+        TThread::Initialize();
+#endif
+        fInputFile = TFile::Open(fFileName.c_str(), "READ");
+        if (fInputFile)
+        {
+            fTree = dynamic_cast<TTree*>(fInputFile->Get(fTreeName.c_str()));
+            if (fTree)
+            {
+                SetBranch(fTree, &fDataBranch);
+                fIndexMax = fTree->GetEntries();
+            }
+            else
+            {
+                LOG(ERROR) << "Could not find tree " << fTreeName;
+            }
+        }
+        else
+        {
+            LOG(ERROR) << "Could not open file " << fFileName << " in PrefetchTreeReader::InitSource()";
+        }
+    }
+
+    /// ///////////////////////////////////////////////////////////////////////////////////////
+    /// sets the first event of the next pass over the entries, a running pass is stopped
+    void SetIndex(int64_t Event)
+    {
+        StopThreads();
+        fIndex = Event;
+    }
+
+    /// ///////////////////////////////////////////////////////////////////////////////////////
+    /// synchronous read on the calling thread
+    DataType_ptr GetOutData()
+    {
+        return GetOutData(fIndex);
+    }
+
+    DataType_ptr GetOutData(int64_t Event)
+    {
+        fTree->GetEntry(Event);
+        return fDataBranch;
+    }
+
+    /// ///////////////////////////////////////////////////////////////////////////////////////
+    int64_t GetNumberOfEvent()
+    {
+        if (fTree)
+            return fIndexMax;
+        else
+            return 0;
+    }
+
+    /// ///////////////////////////////////////////////////////////////////////////////////////
+    /// the next serialized event and its output socket, nullptr after the last event.
+    /// The caller takes the ownership of the message.
+    FairMQMessage* GetReadyMessage(int& socketIdx)
+    {
+        if (!fRunning && !StartThreads())
+        {
+            return nullptr;
+        }
+
+        while (fCurrent.fMessages.empty())
+        {
+            boost::unique_lock<boost::mutex> lock(fMutex);
+            if (fNextToSend >= fNumBlocks)
+            {
+                return nullptr;
+            }
+            typename std::map<int64_t, Block>::iterator it;
+            while ((it = fReady.find(fNextToSend)) == fReady.end() && fNumAlive > 0)
+            {
+                fReadyCondition.wait(lock);
+            }
+            if (it == fReady.end())
+            {
+                LOG(ERROR) << "PrefetchTreeReader: no serializer thread left";
+                return nullptr;
+            }
+            fCurrent = it->second;
+            fReady.erase(it);
+            fNextToSend++;
+            fFreeCondition.notify_all();
+        }
+
+        socketIdx = fCurrent.fSocket;
+        FairMQMessage* msg = fCurrent.fMessages.front();
+        fCurrent.fMessages.pop_front();
+        return msg;
+    }
+
+    /// ///////////////////////////////////////////////////////////////////////////////////////
+    // provides a callback to the Sampler.
+    void BindGetSocketNumber(std::function<int()> callback)
+    {
+        GetSocketNumber = callback;
+    }
+
+    /// ///////////////////////////////////////////////////////////////////////////////////////
+    void BindCreateMessage(std::function<FairMQMessage*()> callback)
+    {
+        CreateMessage = callback;
+    }
+
+  private:
+    /// ///////////////////////////////////////////////////////////////////////////////////////
+    /// reads only the branch of the data
+    void SetBranch(TTree* tree, DataType_ptr* address)
+    {
+        tree->SetBranchStatus("*", 0);
+        tree->SetBranchStatus((fBranchName + "*").c_str(), 1);
+        tree->SetBranchAddress(fBranchName.c_str(), address);
+    }
+
+    /// entries of block j: the blocks of the sockets take turns
+    Block MakeBlock(int64_t j) const
+    {
+        int64_t n = fIndexMax - fIndex;
+        Block block;
+        block.fSocket = j % fNumSockets;
+        int64_t start = fIndex + n * block.fSocket / fNumSockets;
+        int64_t end = fIndex + n * (block.fSocket + 1) / fNumSockets;
+        block.fFirst = std::min(start + (j / fNumSockets) * fBlockSize, end);
+        block.fLast = std::min(block.fFirst + fBlockSize, end);
+        return block;
+    }
+
+    bool StartThreads()
+    {
+        if (!CreateMessage)
+        {
+            LOG(ERROR) << "PrefetchTreeReader: no message factory bound, BindCreateMessage() has to be called";
+            return false;
+        }
+        fNumSockets = GetSocketNumber ? GetSocketNumber() : 1;
+        if (fNumSockets < 1)
+        {
+            fNumSockets = 1;
+        }
+        int64_t n = fIndexMax > fIndex ? fIndexMax - fIndex : 0;
+        int64_t shard = (n + fNumSockets - 1) / fNumSockets;
+        fNumBlocks = fNumSockets * ((shard + fBlockSize - 1) / fBlockSize);
+        fNextBlock = 0;
+        fNextToSend = 0;
+        fNumAlive = fNumSerializers;
+        fStop = false;
+        fRunning = true;
+
+        LOG(INFO) << "PrefetchTreeReader: " << n << " events on " << fNumSockets << " sockets, serialized by "
+                  << fNumSerializers << " threads";
+        fThreads.reset(new boost::thread_group());
+        for (int i = 0; i < fNumSerializers; ++i)
+        {
+            fThreads->create_thread(boost::bind(&base_PrefetchTreeReader::Serialize, this));
+        }
+        return true;
+    }
+
+    void StopThreads()
+    {
+        if (!fRunning)
+        {
+            return;
+        }
+        {
+            boost::unique_lock<boost::mutex> lock(fMutex);
+            fStop = true;
+            fFreeCondition.notify_all();
+        }
+        fThreads->join_all();
+        fThreads.reset();
+
+        // events which were not sent
+        for (auto& p : fReady)
+        {
+            for (auto msg : p.second.fMessages)
+            {
+                delete msg;
+            }
+        }
+        fReady.clear();
+        for (auto msg : fCurrent.fMessages)
+        {
+            delete msg;
+        }
+        fCurrent.fMessages.clear();
+        fRunning = false;
+    }
+
+    /// ///////////////////////////////////////////////////////////////////////////////////////
+    /// serializer thread
+    void Serialize()
+    {
+        std::unique_ptr<TFile> file(TFile::Open(fFileName.c_str(), "READ"));
+        TTree* tree = file ? dynamic_cast<TTree*>(file->Get(fTreeName.c_str())) : nullptr;
+        if (!tree)
+        {
+            LOG(ERROR) << "PrefetchTreeReader: Could not read tree " << fTreeName << " from " << fFileName;
+            boost::unique_lock<boost::mutex> lock(fMutex);
+            fNumAlive--;
+            fReadyCondition.notify_all();
+            return;
+        }
+        DataType_ptr data = nullptr;
+        SetBranch(tree, &data);
+        tree->SetCacheSize(fCacheSize);
+        tree->AddBranchToCache(fBranchName.c_str(), kTRUE);
+        SerializerType serializer;
+
+        while (true)
+        {
+            int64_t j = 0;
+            {
+                boost::unique_lock<boost::mutex> lock(fMutex);
+                while (!fStop && fNextBlock < fNumBlocks && fNextBlock >= fNextToSend + fQueueDepth)
+                {
+                    fFreeCondition.wait(lock);
+                }
+                if (fStop || fNextBlock >= fNumBlocks)
+                {
+                    fNumAlive--;
+                    fReadyCondition.notify_all();
+                    break;
+                }
+                j = fNextBlock++;
+            }
+
+            Block block = MakeBlock(j);
+            for (int64_t entry = block.fFirst; entry < block.fLast; ++entry)
+            {
+                tree->GetEntry(entry);
+                FairMQMessage* msg = CreateMessage();
+                serializer.SetMessage(msg);
+                serializer.SerializeMsg(data);
+                block.fMessages.push_back(msg);
+            }
+
+            boost::unique_lock<boost::mutex> lock(fMutex);
+            fReady[j] = block;
+            fReadyCondition.notify_all();
+        }
+    }
+
+    std::string fFileName;
+    std::string fTreeName;
+    std::string fBranchName;
+    TFile* fInputFile;
+    TTree* fTree;
+    DataType_ptr fDataBranch;
+    int64_t fIndex;
+    int64_t fIndexMax;
+
+    int fNumSerializers;
+    int fQueueDepth; // blocks read ahead
+    int fBlockSize; // entries per block
+    int64_t fCacheSize;
+
+    std::unique_ptr<boost::thread_group> fThreads;
+    boost::mutex fMutex;
+    boost::condition_variable fReadyCondition; // a block was serialized
+    boost::condition_variable fFreeCondition; // a block was taken by the sampler
+    std::map<int64_t, Block> fReady; // serialized blocks by block number
+    Block fCurrent; // block being sent
+    int fNumSockets;
+    int64_t fNumBlocks;
+    int64_t fNextBlock; // next block to serialize
+    int64_t fNextToSend; // next block to send
+    int fNumAlive; // running serializer threads
+    bool fRunning;
+    bool fStop;
+
+    std::function<FairMQMessage*()> CreateMessage; // function pointer for the Sampler callback.
+    std::function<int()> GetSocketNumber; // function pointer for the Sampler callback.
+};
+
+template<typename T, typename U>
+using PrefetchTreeReader = base_PrefetchTreeReader<T, U>;
+
+#endif /* PREFETCHTREEREADER_H */
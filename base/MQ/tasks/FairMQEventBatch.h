@@ -0,0 +1,153 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/*
+ * File:   FairMQEventBatch.h
+ *
+ * Created on March 21, 2016
+ */
+
+#ifndef FAIRMQEVENTBATCH_H
+#define FAIRMQEVENTBATCH_H
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+/**
+ * Collects the serialized data of several events and writes them into one
+ * message. The header fields are 32 bit unsigned integers:
+ *
+ *   [n] [offset 0] [size 0] ... [offset n-1] [size n-1] [data of event 0] ... [data of event n-1]
+ *
+ * The offsets are counted in bytes from the start of the message. The data of
+ * every event starts at a multiple of 8 bytes, so the events can be read in
+ * place with the alignment of the message buffer.
+ */
+
+class FairMQEventBatch
+{
+public:
+
+    FairMQEventBatch() :
+        fData(),
+        fEvents()
+    {
+    }
+
+    /// Appends an event
+    /// @param data Serialized event
+    /// @param size Size of the data in bytes
+    void Add(const void* data, size_t size)
+    {
+        size_t offset = fData.size();
+        fEvents.push_back(Event(offset, size));
+        fData.resize(Align(offset + size));
+        if (size > 0)
+        {
+            std::memcpy(&fData[offset], data, size);
+        }
+    }
+
+    int GetNEvents() const
+    {
+        return fEvents.size();
+    }
+
+    /// Get the size of the batch message in bytes
+    size_t GetMessageSize() const
+    {
+        return HeaderSize(fEvents.size()) + fData.size();
+    }
+
+    /// Writes the batch into a message buffer of GetMessageSize() bytes
+    void Write(void* buffer) const
+    {
+        uint32_t* out = static_cast<uint32_t*>(buffer);
+        size_t n = fEvents.size();
+        size_t header = HeaderSize(n);
+        std::memset(buffer, 0, header);
+        out[0] = n;
+        for (size_t i = 0; i < n; ++i)
+        {
+            out[1 + 2 * i] = header + fEvents[i].first;
+            out[2 + 2 * i] = fEvents[i].second;
+        }
+        if (!fData.empty())
+        {
+            std::memcpy(static_cast<char*>(buffer) + header, &fData[0], fData.size());
+        }
+    }
+
+    /// Removes the events, keeping the allocated memory for the next batch
+    void Clear()
+    {
+        fData.clear();
+        fEvents.clear();
+    }
+
+    /// Checks the header and the event table of a batch message
+    static bool IsValid(const void* buffer, size_t size)
+    {
+        if (!buffer || size < sizeof(uint32_t))
+        {
+            return false;
+        }
+        const uint32_t* in = static_cast<const uint32_t*>(buffer);
+        size_t n = in[0];
+        if (HeaderSize(n) > size)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (in[1 + 2 * i] < HeaderSize(n) || in[1 + 2 * i] + static_cast<size_t>(in[2 + 2 * i]) > size)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Get the number of events in a batch message
+    static int GetNEvents(const void* buffer)
+    {
+        return static_cast<const uint32_t*>(buffer)[0];
+    }
+
+    /// Get an event of a batch message
+    /// @param buffer Message data
+    /// @param i Event index in the range [0, GetNEvents(buffer))
+    /// @param size Returns the size of the event in bytes
+    /// @return Pointer to the event data in the message
+    static void* GetEvent(void* buffer, int i, size_t& size)
+    {
+        const uint32_t* in = static_cast<const uint32_t*>(buffer);
+        size = in[2 + 2 * i];
+        return static_cast<char*>(buffer) + in[1 + 2 * i];
+    }
+
+private:
+
+    typedef std::pair<size_t, size_t> Event; // offset in fData and size
+
+    static size_t Align(size_t size)
+    {
+        return (size + 7) & ~static_cast<size_t>(7);
+    }
+
+    static size_t HeaderSize(size_t nEvents)
+    {
+        return Align((1 + 2 * nEvents) * sizeof(uint32_t));
+    }
+
+    std::vector<char> fData;
+    std::vector<Event> fEvents;
+};
+
+#endif  /* !FAIRMQEVENTBATCH_H */
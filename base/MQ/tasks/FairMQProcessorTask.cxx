@@ -12,13 +12,21 @@
  * @author: D. Klein, A. Rybalchenko
  */
 
+#include <cstring>
+
 #include "FairMQProcessorTask.h"
+#include "FairMQLogger.h"
 
+// the event messages of a batch do not own their data.
+static void free_batch_event(void* /*data*/, void* /*hint*/)
+{
+}
 
 FairMQProcessorTask::FairMQProcessorTask()
     : fPayload(NULL)
     , SendPart()
     , ReceivePart()
+    , fOutputBatch()
 {
 }
 
@@ -30,6 +38,61 @@ void FairMQProcessorTask::Exec(Option_t *opt)
 {
 }
 
+int FairMQProcessorTask::ExecBatch(FairMQTransportFactory* factory, boost::function<void(FairMQMessage*)> sendEvent)
+{
+    FairMQMessage* batch = fPayload;
+    char* batchData = static_cast<char*>(batch->GetData());
+    size_t batchSize = batch->GetSize();
+
+    if (!FairMQEventBatch::IsValid(batchData, batchSize))
+    {
+        LOG(ERROR) << "FairMQProcessorTask::ExecBatch(): received message is not an event batch";
+        return -1;
+    }
+
+    int numEvents = FairMQEventBatch::GetNEvents(batchData);
+    fOutputBatch.Clear();
+
+    for (int i = 0; i < numEvents; ++i)
+    {
+        size_t size = 0;
+        void* event = FairMQEventBatch::GetEvent(batchData, i, size);
+        fPayload = factory->CreateMessage(event, size, free_batch_event, NULL);
+
+        Exec();
+
+        if (sendEvent)
+        {
+            char* output = static_cast<char*>(fPayload->GetData());
+            if (output >= batchData && output < batchData + batchSize)
+            {
+                // Exec() left the event in place, the message must not refer to the batch after sending.
+                FairMQMessage* copy = factory->CreateMessage(fPayload->GetSize());
+                memcpy(copy->GetData(), output, fPayload->GetSize());
+                delete fPayload;
+                fPayload = copy;
+            }
+            sendEvent(fPayload);
+        }
+        else
+        {
+            fOutputBatch.Add(fPayload->GetData(), fPayload->GetSize());
+        }
+
+        delete fPayload;
+    }
+
+    fPayload = batch;
+
+    if (!sendEvent)
+    {
+        fPayload->Rebuild(fOutputBatch.GetMessageSize());
+        fOutputBatch.Write(fPayload->GetData());
+    }
+
+    return numEvents;
+}
+
 // initialize a callback to the Processor for sending multipart messages.
 void FairMQProcessorTask::SetSendPart(boost::function<void()> callback)
 {
@@ -23,6 +23,7 @@
 
 #include "FairMQMessage.h"
 #include "FairMQTransportFactory.h"
+#include "FairMQEventBatch.h"
 
 
 class FairMQProcessorTask : public FairTask
@@ -33,6 +34,18 @@ class FairMQProcessorTask : public FairTask
 
     virtual void Exec(Option_t* opt = "0");
 
+    /**
+     * Unpacks the event batch in the payload (see FairMQEventBatch) and calls Exec() for every event,
+     * with the payload set to a message that points to the event in the batch (no copy). Multipart
+     * callbacks are not available to Exec() here.
+     * @param factory Transport factory to create the event messages
+     * @param sendEvent Called with the output of every event. Without it the outputs are collected into
+     *                  a new batch in the payload.
+     * @return Number of events, -1 if the payload is not an event batch
+     */
+    int ExecBatch(FairMQTransportFactory* factory,
+                  boost::function<void(FairMQMessage*)> sendEvent = boost::function<void(FairMQMessage*)>());
+
     void SetSendPart(boost::function<void()>); // provides a callback to the Processor.
     void SetReceivePart(boost::function<bool()>); // provides a callback to the Processor.
 
@@ -43,6 +56,7 @@ class FairMQProcessorTask : public FairTask
     FairMQMessage* fPayload;
     boost::function<void()> SendPart; // function pointer for the Processor callback.
     boost::function<bool()> ReceivePart; // function pointer for the Processor callback.
+    FairMQEventBatch fOutputBatch; // outputs of ExecBatch() without callback
 
   private:
     /// Copy Constructor
@@ -14,6 +14,12 @@
 
 #include "FairMQSamplerTask.h"
 
+#include "TChain.h"
+#include "TTree.h"
+#include "TBranch.h"
+
+#include "FairMQLogger.h"
+
 using namespace std;
 
 FairMQSamplerTask::FairMQSamplerTask()
@@ -25,6 +31,8 @@ FairMQSamplerTask::FairMQSamplerTask()
     , fEventIndex(0)
     , SendPart()
     , fEvtHeader(NULL)
+    , fBatch()
+    , fBatchMessage(NULL)
 {
 }
 
@@ -37,12 +45,15 @@ FairMQSamplerTask::FairMQSamplerTask(const Text_t* name, int iVerbose)
     , fEventIndex(0)
     , SendPart()
     , fEvtHeader(NULL)
+    , fBatch()
+    , fBatchMessage(NULL)
 {
 }
 
 FairMQSamplerTask::~FairMQSamplerTask()
 {
     delete fInput;
+    delete fBatchMessage;
     // fOutput->CloseMessage();
 }
 
@@ -84,3 +95,49 @@ void FairMQSamplerTask::SetTransport(FairMQTransportFactory* factory)
 {
     fTransportFactory = factory;
 }
+
+void FairMQSamplerTask::ReadBranchEntry(Long64_t entry)
+{
+    TChain* chain = FairRootManager::Instance()->GetInChain();
+    // the chain sets the branch addresses when it switches to the tree of the entry
+    Long64_t treeEntry = chain->LoadTree(entry);
+    TBranch* branch = (treeEntry < 0) ? NULL : chain->GetTree()->GetBranch(fBranch.c_str());
+    if (!branch)
+    {
+        LOG(ERROR) << "FairMQSamplerTask: could not read entry " << entry << " of branch " << fBranch;
+        fInput->Clear();
+        return;
+    }
+    branch->GetEntry(treeEntry);
+}
+
+void FairMQSamplerTask::AddOutputToBatch()
+{
+    if (!fOutput)
+    {
+        return;
+    }
+    fBatch.Add(fOutput->GetData(), fOutput->GetSize());
+    delete fOutput;
+    fOutput = NULL;
+}
+
+void FairMQSamplerTask::CloseBatch()
+{
+    if (!fBatchMessage)
+    {
+        fBatchMessage = fTransportFactory->CreateMessage(fBatch.GetMessageSize());
+    }
+    else
+    {
+        fBatchMessage->Rebuild(fBatch.GetMessageSize());
+    }
+    fBatch.Write(fBatchMessage->GetData());
+    fBatch.Clear();
+    fOutput = fBatchMessage;
+}
+
+int FairMQSamplerTask::GetNBatchedEvents() const
+{
+    return fBatch.GetNEvents();
+}
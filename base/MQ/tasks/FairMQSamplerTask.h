@@ -22,6 +22,7 @@
 
 #include "FairMQMessage.h"
 #include "FairMQTransportFactory.h"
+#include "FairMQEventBatch.h"
 
 #include "TClonesArray.h"
 #include "FairTask.h"
@@ -43,6 +44,15 @@ class FairMQSamplerTask : public FairTask
     FairMQMessage *GetOutput();
     void SetTransport(FairMQTransportFactory *factory);
 
+    /// Reads the entry of the input branch alone, without the event cycle of FairRunAna::RunMQ().
+    /// Used for the events of a batch after the first one, which have to belong to the same run.
+    void ReadBranchEntry(Long64_t entry);
+    /// Appends the output of Exec() to the event batch and releases the output message.
+    void AddOutputToBatch();
+    /// Makes the output a single message with the events of the batch (see FairMQEventBatch) and empties the batch.
+    void CloseBatch();
+    int GetNBatchedEvents() const;
+
   protected:
     TClonesArray *fInput;
     std::string fBranch;
@@ -51,6 +61,8 @@ class FairMQSamplerTask : public FairTask
     Long64_t fEventIndex;
     boost::function<void()> SendPart; // function pointer for the Sampler callback.
     FairEventHeader *fEvtHeader;
+    FairMQEventBatch fBatch; // serialized events waiting for CloseBatch()
+    FairMQMessage *fBatchMessage; // reused for the batch messages
 
   private:
     /// Copy Constructor
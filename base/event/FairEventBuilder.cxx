@@ -57,7 +57,9 @@ FairEventBuilder::FairEventBuilder()
     fTimer                      (),
     fExecTime                   (0.),
     fIdentifier                 (0),
-    fMaxAllowedEventCreationTime(0.)
+    fMaxAllowedEventCreationTime(0.),
+    fParallel                   (kFALSE),
+    fHeaderPool                 ()
 {
 }
 // -------------------------------------------------------------------------
@@ -70,7 +72,9 @@ FairEventBuilder::FairEventBuilder(TString branchName, TString className, TStrin
     fTimer                      (),
     fExecTime                   (0.),
     fIdentifier                 (0),
-    fMaxAllowedEventCreationTime(0.)
+    fMaxAllowedEventCreationTime(0.),
+    fParallel                   (kFALSE),
+    fHeaderPool                 ()
 {
 }
 // -------------------------------------------------------------------------
@@ -80,6 +84,23 @@ FairEventBuilder::FairEventBuilder(TString branchName, TString className, TStrin
 // -----   Destructor   ----------------------------------------------------
 FairEventBuilder::~FairEventBuilder()
 {
+  for ( size_t i = 0 ; i < fHeaderPool.size() ; i++ ) {
+    delete fHeaderPool[i];
+  }
+}
+
+FairRecoEventHeader* FairEventBuilder::NewEventHeader()
+{
+  FairRecoEventHeader* header;
+  if ( fHeaderPool.empty() ) {
+    header = CreateEventHeader();
+  } else {
+    header = fHeaderPool.back();
+    fHeaderPool.pop_back();
+    header->Clear();
+  }
+  header->SetIdentifier(fIdentifier);
+  return header;
 }
 // -------------------------------------------------------------------------
 
@@ -27,6 +27,11 @@
  **    function and insert this identified data to the output TClonesArrays
  **    in the function StoreEventData(event)
  ** The implementations may be using any or both of the above functions.
+ **
+ ** Builders which only work on their own data in FindEvents() can be marked
+ ** with SetParallel(), so that the FairEventBuilderManager may run them at
+ ** the same time as other builders. The event headers can be taken from
+ ** NewEventHeader() and given back with RecycleEventHeader() to reuse them.
  **/
 
 
@@ -89,6 +94,21 @@ class FairEventBuilder : public FairWriteoutBuffer
       fMaxAllowedEventCreationTime = td;
     };
 
+    /** FindEvents() may run on another thread, at the same time as other builders */
+    void   SetParallel(Bool_t parallel) {
+      fParallel = parallel;
+    }
+    Bool_t IsParallel() {
+      return fParallel;
+    }
+
+    /** Event header with the identifier of the builder, a recycled one is reused after Clear() */
+    FairRecoEventHeader* NewEventHeader();
+    /** Keep an event header which is not needed anymore for NewEventHeader() */
+    void RecycleEventHeader(FairRecoEventHeader* header) {
+      fHeaderPool.push_back(header);
+    }
+
     void    SetBuilderName(const char* name) {
       fBuilderName=name;
     }
@@ -96,6 +116,13 @@ class FairEventBuilder : public FairWriteoutBuffer
       return fBuilderName;
     }
 
+  protected:
+
+    /** Creates the event headers for NewEventHeader(), to be overwritten for derived headers */
+    virtual FairRecoEventHeader* CreateEventHeader() {
+      return new FairRecoEventHeader();
+    }
+
   private:
 
     TString    fBuilderName;
@@ -106,7 +133,13 @@ class FairEventBuilder : public FairWriteoutBuffer
     Int_t      fIdentifier;
     Double_t   fMaxAllowedEventCreationTime;
 
-    ClassDef(FairEventBuilder,1);
+    Bool_t     fParallel;
+    std::vector<FairRecoEventHeader*> fHeaderPool; //! headers for reuse
+
+    FairEventBuilder(const FairEventBuilder&);
+    FairEventBuilder& operator=(const FairEventBuilder&);
+
+    ClassDef(FairEventBuilder,2);
 
 };
 
@@ -36,9 +36,14 @@
 #include "FairRuntimeDb.h"
 
 #include "TClonesArray.h"
+#include "TCondition.h"
 #include "TMath.h"
+#include "TMutex.h"
 #include "TRandom2.h"
+#include "TThread.h"
+#include "TVirtualMutex.h"
 
+#include <algorithm>
 #include <iomanip>
 
 using std::cout;
@@ -57,11 +62,29 @@ using std::sort;
 using std::iterator;
 using std::vector;
 
+namespace
+{
+bool EarlierEvent(const std::pair<double,FairRecoEventHeader*>& a, const std::pair<double,FairRecoEventHeader*>& b)
+{
+  return a.first < b.first;
+}
+}
+
 // -----   Default constructor   ------------------------------------------
 FairEventBuilderManager::FairEventBuilderManager()
   : FairTask("FairEventBuilderManager", 0),
     fEventBuilders  (),
-    fPossibleEvents()
+    fPossibleEvents(),
+    fNThreads       (1),
+    fThreads        (),
+    fMutex          (NULL),
+    fStartCondition (NULL),
+    fDoneCondition  (NULL),
+    fParallelBuilders(),
+    fNextBuilder    (0),
+    fNFinished      (0),
+    fStopThreads    (kFALSE),
+    fFoundEvents    ()
 {
 }
 // -------------------------------------------------------------------------
@@ -70,7 +93,17 @@ FairEventBuilderManager::FairEventBuilderManager()
 FairEventBuilderManager::FairEventBuilderManager(const char* name, Int_t iVerbose)
   : FairTask(name, iVerbose),
     fEventBuilders  (),
-    fPossibleEvents()
+    fPossibleEvents(),
+    fNThreads       (1),
+    fThreads        (),
+    fMutex          (NULL),
+    fStartCondition (NULL),
+    fDoneCondition  (NULL),
+    fParallelBuilders(),
+    fNextBuilder    (0),
+    fNFinished      (0),
+    fStopThreads    (kFALSE),
+    fFoundEvents    ()
 {
 }
 // -------------------------------------------------------------------------
@@ -80,6 +113,7 @@ FairEventBuilderManager::FairEventBuilderManager(const char* name, Int_t iVerbos
 // -----   Destructor   ----------------------------------------------------
 FairEventBuilderManager::~FairEventBuilderManager()
 {
+  StopThreads();
 }
 // -------------------------------------------------------------------------
 
@@ -109,27 +143,30 @@ void FairEventBuilderManager::Exec(Option_t* opt)
 // -----   Private method FillEventVectors   -------------------------------
 Double_t FairEventBuilderManager::FillEventVectors()
 {
-  // for ( std::vector<FairEventBuilder*>::iterator it = fEventBuilders.begin() ; it != fEventBuilders.end() ; ++it ) {
-  //   *it.FindEvents();
-  // }
   Double_t maxEventTimeAllowed = 10.e6;
+
+  FindEvents();
+
   for ( Int_t ieb = 0 ; ieb < fEventBuilders.size() ; ieb++ ) {
     if ( fVerbose ) { cout << "***** " << fEventBuilders[ieb]->GetName() << " *****" << endl; }
     if ( fVerbose ) { cout << "  there are " << fPossibleEvents[ieb].size() << " possible events" << endl; }
-    std::vector<std::pair<double,FairRecoEventHeader*> > tempBuilder = fEventBuilders[ieb]->FindEvents();
+    std::vector<std::pair<double,FairRecoEventHeader*> >& tempBuilder = fFoundEvents[ieb];
     if ( fVerbose ) {
       cout << "  event buffer " << fEventBuilders[ieb]->GetName() << " found " << tempBuilder.size() << " events" << endl;
     }
-    std::pair<double,FairRecoEventHeader*> tempPair;
-    for ( Int_t ipair = 0 ; ipair < tempBuilder.size() ; ipair++ ) {
-      fPossibleEvents[ieb].push_back(tempBuilder[ipair]);
-      if ( fVerbose )
-        cout << "    added event " << fPossibleEvents[ieb][fPossibleEvents[ieb].size()-1].second
-             << " at " << fPossibleEvents[ieb][fPossibleEvents[ieb].size()-1].second->GetEventTime() << " ns." << endl;
-    }
+    // both are sorted by time, merge the new events in
+    std::vector<std::pair<double,FairRecoEventHeader*> >& possibleEvents = fPossibleEvents[ieb];
+    size_t nOld = possibleEvents.size();
+    possibleEvents.insert(possibleEvents.end(), tempBuilder.begin(), tempBuilder.end());
+    std::inplace_merge(possibleEvents.begin(), possibleEvents.begin() + nOld, possibleEvents.end(), EarlierEvent);
     if ( fVerbose ) {
+      for ( Int_t ipair = 0 ; ipair < tempBuilder.size() ; ipair++ ) {
+        cout << "    added event " << tempBuilder[ipair].second
+             << " at " << tempBuilder[ipair].second->GetEventTime() << " ns." << endl;
+      }
       cout << "  and now " << fPossibleEvents[ieb].size() << " possible events" << endl;
     }
+    tempBuilder.clear();
 
     if ( fEventBuilders[ieb]->AllowedTime() < maxEventTimeAllowed ) {
       maxEventTimeAllowed = fEventBuilders[ieb]->AllowedTime();
@@ -139,6 +176,143 @@ Double_t FairEventBuilderManager::FillEventVectors()
 }
 // -------------------------------------------------------------------------
 
+// -----   Private method FindEvents   -------------------------------------
+void FairEventBuilderManager::FindEvents()
+{
+  fFoundEvents.resize(fEventBuilders.size());
+  if ( fNThreads > 1 && fThreads.empty() ) {
+    StartThreads();
+  }
+
+  if ( !fThreads.empty() ) {
+    TLockGuard lock(fMutex);
+    fParallelBuilders.clear();
+    for ( Int_t ieb = 0 ; ieb < fEventBuilders.size() ; ieb++ ) {
+      if ( fEventBuilders[ieb]->IsParallel() ) { fParallelBuilders.push_back(ieb); }
+    }
+    fNextBuilder = 0;
+    fNFinished = 0;
+    fStartCondition->Broadcast();
+  }
+
+  // the other builders run on this thread in the meantime
+  for ( Int_t ieb = 0 ; ieb < fEventBuilders.size() ; ieb++ ) {
+    if ( fThreads.empty() || !fEventBuilders[ieb]->IsParallel() ) {
+      FindEvents(ieb);
+    }
+  }
+
+  if ( !fThreads.empty() ) {
+    // help with the parallel builders which did not start yet
+    while ( RunNextBuilder() ) {}
+    TLockGuard lock(fMutex);
+    while ( fNFinished < fParallelBuilders.size() ) {
+      fDoneCondition->Wait();
+    }
+  }
+}
+// -------------------------------------------------------------------------
+
+// -----   Private method FindEvents   -------------------------------------
+void FairEventBuilderManager::FindEvents(Int_t ieb)
+{
+  fFoundEvents[ieb] = fEventBuilders[ieb]->FindEvents();
+  std::stable_sort(fFoundEvents[ieb].begin(), fFoundEvents[ieb].end(), EarlierEvent);
+}
+// -------------------------------------------------------------------------
+
+// -----   Private method RunNextBuilder   ---------------------------------
+Bool_t FairEventBuilderManager::RunNextBuilder()
+{
+  Int_t ieb;
+  {
+    TLockGuard lock(fMutex);
+    if ( fNextBuilder >= fParallelBuilders.size() ) {
+      return kFALSE;
+    }
+    ieb = fParallelBuilders[fNextBuilder++];
+  }
+
+  FindEvents(ieb);
+
+  TLockGuard lock(fMutex);
+  fNFinished++;
+  if ( fNFinished == fParallelBuilders.size() ) {
+    fDoneCondition->Signal();
+  }
+  return kTRUE;
+}
+// -------------------------------------------------------------------------
+
+// -----   Private method StartThreads   -----------------------------------
+void FairEventBuilderManager::StartThreads()
+{
+  TThread::Initialize();
+  fMutex = new TMutex();
+  fStartCondition = new TCondition(fMutex);
+  fDoneCondition = new TCondition(fMutex);
+  // the calling thread is one of the threads
+  for ( Int_t ithread = 1 ; ithread < fNThreads ; ithread++ ) {
+    TThread* thread = new TThread(Form("%s_%d", fName.Data(), ithread), &FairEventBuilderManager::ThreadLoop, this);
+    thread->Run();
+    fThreads.push_back(thread);
+  }
+  cout << "*** FairEventBuilderManager. Parallel event builders run on " << fNThreads << " threads." << endl;
+}
+// -------------------------------------------------------------------------
+
+// -----   Private method StopThreads   ------------------------------------
+void FairEventBuilderManager::StopThreads()
+{
+  if ( fThreads.empty() ) {
+    return;
+  }
+  {
+    TLockGuard lock(fMutex);
+    fStopThreads = kTRUE;
+    fStartCondition->Broadcast();
+  }
+  for ( size_t ithread = 0 ; ithread < fThreads.size() ; ithread++ ) {
+    fThreads[ithread]->Join();
+    delete fThreads[ithread];
+  }
+  fThreads.clear();
+  delete fStartCondition;
+  delete fDoneCondition;
+  delete fMutex;
+  fStartCondition = NULL;
+  fDoneCondition = NULL;
+  fMutex = NULL;
+  fStopThreads = kFALSE;
+}
+// -------------------------------------------------------------------------
+
+// -----   Private method ThreadLoop   -------------------------------------
+void* FairEventBuilderManager::ThreadLoop(void* arg)
+{
+  static_cast<FairEventBuilderManager*>(arg)->RunThread();
+  return 0;
+}
+// -------------------------------------------------------------------------
+
+// -----   Private method RunThread   --------------------------------------
+void FairEventBuilderManager::RunThread()
+{
+  for (;;) {
+    {
+      TLockGuard lock(fMutex);
+      while ( !fStopThreads && fNextBuilder >= fParallelBuilders.size() ) {
+        fStartCondition->Wait();
+      }
+      if ( fStopThreads ) {
+        return;
+      }
+    }
+    RunNextBuilder();
+  }
+}
+// -------------------------------------------------------------------------
+
 // -----   Public method CreateAndFillEvents   -----------------------------
 void FairEventBuilderManager::CreateAndFillEvent(FairRecoEventHeader* recoEvent)
 {
@@ -157,6 +331,18 @@ void FairEventBuilderManager::CreateAndFillEvent(FairRecoEventHeader* recoEvent)
 // -------------------------------------------------------------------------
 
 
+// -----   Protected method RemoveEvents   ---------------------------------
+void FairEventBuilderManager::RemoveEvents(Int_t ieb, size_t nEvents)
+{
+  std::vector<std::pair<double,FairRecoEventHeader*> >& events = fPossibleEvents[ieb];
+  nEvents = std::min(nEvents, events.size());
+  for ( size_t i = 0 ; i < nEvents ; i++ ) {
+    fEventBuilders[ieb]->RecycleEventHeader(events[i].second);
+  }
+  events.erase(events.begin(), events.begin() + nEvents);
+}
+// -------------------------------------------------------------------------
+
 // -----   Public method AddEventBuilder   ----------------------------------
 void FairEventBuilderManager::AddEventBuilder(FairEventBuilder* eventBuilder)
 {
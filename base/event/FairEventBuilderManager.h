@@ -27,6 +27,14 @@
  ** The heart of the experiment-specific implemenations is
  ** the AnalyzeAndExtractEvents() function, which should interpret
  ** the experimental data to reconstruct events.
+ **
+ ** With SetNumberOfThreads() the builders marked with SetParallel() run
+ ** FindEvents() on a pool of threads, while the other builders run on the
+ ** calling thread. Each builder fills only its own vector of new events,
+ ** which are merged into fPossibleEvents after all builders have finished.
+ ** The vectors in fPossibleEvents are kept sorted by the time of the events.
+ ** AnalyzeAndExtractEvents() removes the events it has taken with
+ ** RemoveEvents(), which gives their headers back to the builders for reuse.
  **/
 
 
@@ -43,6 +51,9 @@
 #include <vector>
 
 class TClonesArray;
+class TCondition;
+class TMutex;
+class TThread;
 
 class FairEventBuilderManager : public FairTask
 {
@@ -69,6 +80,12 @@ class FairEventBuilderManager : public FairTask
     /** Adding FairEventBuilder **/
     virtual void AddEventBuilder(FairEventBuilder* eventBuilder);
 
+
+    /** Number of threads for the builders which can run in parallel, 1 by default **/
+    void SetNumberOfThreads(Int_t nThreads) {
+      fNThreads = nThreads;
+    }
+
   protected:
 
     std::vector<FairEventBuilder*> fEventBuilders;
@@ -86,8 +103,36 @@ class FairEventBuilderManager : public FairTask
     /** Create output tree structure **/
     virtual void CreateAndFillEvent(FairRecoEventHeader* recoEvent);
 
+
+    /** Remove the first nEvents possible events of builder ieb and recycle their headers **/
+    void RemoveEvents(Int_t ieb, size_t nEvents);
+
   private:
 
+    /** Run FindEvents() of all builders into fFoundEvents **/
+    void FindEvents();
+    /** FindEvents() of one builder, with the events sorted by time **/
+    void FindEvents(Int_t ieb);
+    /** Run the next of fParallelBuilders, kFALSE if all have been started **/
+    Bool_t RunNextBuilder();
+
+    void StartThreads();
+    void StopThreads();
+    void RunThread();
+    static void* ThreadLoop(void* arg);
+
+    Int_t                  fNThreads;
+    std::vector<TThread*>  fThreads;          //!
+    TMutex*                fMutex;            //! guards the fields below
+    TCondition*            fStartCondition;   //! builders are waiting to run
+    TCondition*            fDoneCondition;    //! a builder has finished
+    std::vector<Int_t>     fParallelBuilders; //! builders run on the threads
+    size_t                 fNextBuilder;      //! next of fParallelBuilders to run
+    size_t                 fNFinished;        //! number of finished fParallelBuilders
+    Bool_t                 fStopThreads;      //!
+    /** events found by each builder in the current Exec **/
+    std::vector<std::vector<std::pair<double,FairRecoEventHeader*> > >  fFoundEvents; //!
+
     /** Get parameter containers **/
     virtual void SetParContainers();
 
@@ -104,7 +149,10 @@ class FairEventBuilderManager : public FairTask
     virtual void Finish();
 
 
-    ClassDef(FairEventBuilderManager,1);
+    FairEventBuilderManager(const FairEventBuilderManager&);
+    FairEventBuilderManager& operator=(const FairEventBuilderManager&);
+
+    ClassDef(FairEventBuilderManager,2);
 
 };
 
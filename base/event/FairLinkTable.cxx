@@ -0,0 +1,176 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#include "FairLinkTable.h"
+
+#include "FairMultiLinkedData.h"        // for FairMultiLinkedData
+#include "FairMultiLinkedData_Interface.h"  // for FairMultiLinkedData_Interface
+
+#include <iostream>                     // for operator<<, cout, endl
+
+ClassImp(FairLinkTable);
+
+FairLinkTable::FairLinkTable()
+  : TNamed(),
+    fNBlocks(),
+    fBlockFile(),
+    fBlockEntry(),
+    fBlockType(),
+    fBlockSize(),
+    fIndexDelta(),
+    fWeights(),
+    fRowBlock(),
+    fBlockLink(),
+    fIndexed(kFALSE),
+    fCompacted()
+{
+}
+
+FairLinkTable::FairLinkTable(const char* name, const char* title)
+  : TNamed(name, title),
+    fNBlocks(),
+    fBlockFile(),
+    fBlockEntry(),
+    fBlockType(),
+    fBlockSize(),
+    fIndexDelta(),
+    fWeights(),
+    fRowBlock(),
+    fBlockLink(),
+    fIndexed(kFALSE),
+    fCompacted()
+{
+}
+
+FairLinkTable::~FairLinkTable()
+{
+}
+
+void FairLinkTable::Clear(Option_t* /*option*/)
+{
+  fNBlocks.clear();
+  fBlockFile.clear();
+  fBlockEntry.clear();
+  fBlockType.clear();
+  fBlockSize.clear();
+  fIndexDelta.clear();
+  fWeights.clear();
+  fCompacted.clear();
+  fIndexed = kFALSE;
+}
+
+Int_t FairLinkTable::Add(const std::set<FairLink>& links)
+{
+  Int_t nBlocks = 0;
+  Int_t lastIndex = -1;
+  for (std::set<FairLink>::const_iterator it = links.begin(); it != links.end(); it++) {
+    if (nBlocks == 0 || it->GetFile() != fBlockFile.back() || it->GetEntry() != fBlockEntry.back()
+        || it->GetType() != fBlockType.back()) {
+      fBlockFile.push_back(it->GetFile());
+      fBlockEntry.push_back(it->GetEntry());
+      fBlockType.push_back(it->GetType());
+      fBlockSize.push_back(0);
+      nBlocks++;
+      lastIndex = -1;
+    }
+    fBlockSize.back()++;
+    fIndexDelta.push_back(it->GetIndex() - lastIndex);
+    fWeights.push_back(it->GetWeight());
+    lastIndex = it->GetIndex();
+  }
+  fNBlocks.push_back(nBlocks);
+  fIndexed = kFALSE;
+  return fNBlocks.size() - 1;
+}
+
+void FairLinkTable::BuildIndex() const
+{
+  fRowBlock.resize(fNBlocks.size());
+  Int_t block = 0;
+  for (size_t row = 0; row < fNBlocks.size(); row++) {
+    fRowBlock[row] = block;
+    block += fNBlocks[row];
+  }
+  fBlockLink.resize(fBlockSize.size());
+  Int_t link = 0;
+  for (size_t i = 0; i < fBlockSize.size(); i++) {
+    fBlockLink[i] = link;
+    link += fBlockSize[i];
+  }
+  fIndexed = kTRUE;
+}
+
+void FairLinkTable::FillLinks(Int_t block, Int_t nBlocks, Int_t link, std::set<FairLink>& links) const
+{
+  links.clear();
+  for (Int_t i = block; i < block + nBlocks; i++) {
+    Int_t index = -1;
+    for (Int_t j = 0; j < fBlockSize[i]; j++, link++) {
+      index += fIndexDelta[link];
+      // the links were sorted, they go to the end of the set
+      links.insert(links.end(), FairLink(fBlockFile[i], fBlockEntry[i], fBlockType[i], index, fWeights[link]));
+    }
+  }
+}
+
+void FairLinkTable::GetLinks(Int_t row, std::set<FairLink>& links) const
+{
+  if (row < 0 || row >= (Int_t)fNBlocks.size()) {
+    std::cout << "-E- FairLinkTable::GetLinks row " << row << " outside range " << fNBlocks.size() << std::endl;
+    links.clear();
+    return;
+  }
+  if (!fIndexed) { BuildIndex(); }
+  Int_t block = fRowBlock[row];
+  Int_t link = fNBlocks[row] > 0 ? fBlockLink[block] : 0;
+  FillLinks(block, fNBlocks[row], link, links);
+}
+
+FairMultiLinkedData* FairLinkTable::GetLinkData(TObject* object)
+{
+  FairMultiLinkedData* data = dynamic_cast<FairMultiLinkedData*>(object);
+  if (data) { return data; }
+  FairMultiLinkedData_Interface* interface = dynamic_cast<FairMultiLinkedData_Interface*>(object);
+  if (interface) { return interface->GetPointerToLinks(); }
+  return 0;
+}
+
+void FairLinkTable::Compact(TObject* object)
+{
+  FairMultiLinkedData* data = GetLinkData(object);
+  if (data == 0) { return; }
+  // links read from a table of the input are written to this one
+  data->LoadLinks();
+  if (data->fLinks.empty()) { return; }
+  data->fLinkTableIndex = Add(data->fLinks);
+  data->fLinks.clear();
+  fCompacted.push_back(data);
+}
+
+void FairLinkTable::Restore()
+{
+  // the rows were added in the order of the objects
+  Int_t block = 0;
+  Int_t link = 0;
+  for (size_t i = 0; i < fCompacted.size(); i++) {
+    FairMultiLinkedData* data = fCompacted[i];
+    Int_t row = data->fLinkTableIndex;
+    FillLinks(block, fNBlocks[row], link, data->fLinks);
+    for (Int_t j = 0; j < fNBlocks[row]; j++) {
+      link += fBlockSize[block++];
+    }
+    data->fLinkTableIndex = -1;
+  }
+  fCompacted.clear();
+}
+
+void FairLinkTable::Expand(FairMultiLinkedData& data) const
+{
+  if (data.fLinkTableIndex < 0) { return; }
+  GetLinks(data.fLinkTableIndex, data.fLinks);
+  data.fLinkTableIndex = -1;
+}
@@ -0,0 +1,93 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#ifndef FAIRLINKTABLE_H_
+#define FAIRLINKTABLE_H_
+
+#include "TNamed.h"                     // for TNamed
+
+#include "FairLink.h"                   // for FairLink
+
+#include "Rtypes.h"                     // for Int_t, Float_t, etc
+
+#include <set>                          // for set
+#include <vector>                       // for vector
+
+class FairMultiLinkedData;
+
+/**
+ * The links of all FairMultiLinkedData objects of one event in columns.
+ *
+ * Each object with links gets a row of the table. The links of a row are
+ * stored in blocks of consecutive links with the same file, entry and type,
+ * a block keeps these once and the indices of its links as differences to
+ * the previous index. With the table on a split branch every column is a
+ * branch of its own, the small and repetitive numbers compress much better
+ * than the links stored with each object.
+ *
+ * Compact() moves the links of an object into the table and leaves the row
+ * number in the object (see FairMultiLinkedData::GetLinkTableIndex()), the
+ * object gets its links back from the table of its event the first time
+ * they are used. FairRootManager::SetCompactLinks() writes the table as
+ * branch "LinkTable." of the output tree.
+ */
+class FairLinkTable : public TNamed
+{
+  public:
+    FairLinkTable();
+    FairLinkTable(const char* name, const char* title = "Links of the event");
+    virtual ~FairLinkTable();
+
+    /** Appends the links as a new row, returns the row number */
+    Int_t Add(const std::set<FairLink>& links);
+    /** The links of the row */
+    void GetLinks(Int_t row, std::set<FairLink>& links) const;
+
+    /** Moves the links of the object (a FairMultiLinkedData or FairMultiLinkedData_Interface)
+     ** into the table, objects without links are left as they are */
+    void Compact(TObject* object);
+    /** Gives the objects compacted since the last Clear() their links back */
+    void Restore();
+    /** Gives the object its links back, if they are in the table */
+    void Expand(FairMultiLinkedData& data) const;
+    /** To be called after new rows were read into the table */
+    void ResetIndex() { fIndexed = kFALSE; }
+
+    /** Removes all rows */
+    virtual void Clear(Option_t* option = "");
+
+    Int_t GetNRows() const { return fNBlocks.size(); }
+    Int_t GetNBlocks() const { return fBlockType.size(); }
+    Int_t GetNLinks() const { return fIndexDelta.size(); }
+
+    /** The link data of the object, NULL if it has none */
+    static FairMultiLinkedData* GetLinkData(TObject* object);
+
+  private:
+    void BuildIndex() const;
+    void FillLinks(Int_t block, Int_t nBlocks, Int_t link, std::set<FairLink>& links) const;
+
+    std::vector<Int_t> fNBlocks;        ///< number of blocks of each row
+    std::vector<Int_t> fBlockFile;      ///< file of the links of each block
+    std::vector<Int_t> fBlockEntry;     ///< entry of the links of each block
+    std::vector<Int_t> fBlockType;      ///< type of the links of each block
+    std::vector<Int_t> fBlockSize;      ///< number of links of each block
+    std::vector<Int_t> fIndexDelta;     ///< index of each link minus the index of the link before in the block (-1 for the first)
+    std::vector<Float_t> fWeights;      ///< weight of each link
+
+    mutable std::vector<Int_t> fRowBlock;   //! first block of each row
+    mutable std::vector<Int_t> fBlockLink;  //! first link of each block
+    mutable Bool_t fIndexed;                //! fRowBlock and fBlockLink belong to the rows
+    std::vector<FairMultiLinkedData*> fCompacted; //! objects compacted since the last Clear()
+
+    FairLinkTable(const FairLinkTable&);
+    FairLinkTable& operator=(const FairLinkTable&);
+
+    ClassDef(FairLinkTable, 1);
+};
+
+#endif /* FAIRLINKTABLE_H_ */
@@ -17,6 +17,7 @@
 
 #include "FairRootManager.h"            // for FairRootManager
 #include "FairLinkManager.h"            // for FairLinkManager
+#include "FairLinkTable.h"              // for FairLinkTable
 
 #include "TClonesArray.h"               // for TClonesArray
 
@@ -31,7 +32,8 @@ FairMultiLinkedData::FairMultiLinkedData()
    fPersistanceCheck(kTRUE),
    fInsertHistory(kTRUE),
    fVerbose(0),
-   fDefaultType(0)
+   fDefaultType(0),
+   fLinkTableIndex(-1)
 
 {
 }
@@ -42,7 +44,8 @@ FairMultiLinkedData::FairMultiLinkedData(std::set<FairLink> links, Bool_t persis
    fPersistanceCheck(persistanceCheck),
    fInsertHistory(kTRUE),
    fVerbose(0),
-   fDefaultType(0)
+   fDefaultType(0),
+   fLinkTableIndex(-1)
 {
 }
 
@@ -52,7 +55,8 @@ FairMultiLinkedData::FairMultiLinkedData(TString dataType, std::vector<Int_t> li
    fPersistanceCheck(persistanceCheck),
    fInsertHistory(kTRUE),
    fVerbose(0),
-   fDefaultType(0)
+   fDefaultType(0),
+   fLinkTableIndex(-1)
 
 {
   SimpleAddLinks(fileId, evtId, FairRootManager::Instance()->GetBranchId(dataType), links, bypass, mult);
@@ -65,14 +69,60 @@ FairMultiLinkedData::FairMultiLinkedData(Int_t dataType, std::vector<Int_t> link
    fPersistanceCheck(persistanceCheck),
    fInsertHistory(kTRUE),
    fVerbose(0),
-   fDefaultType(0)
+   fDefaultType(0),
+   fLinkTableIndex(-1)
 
 {
   SimpleAddLinks(fileId, evtId, dataType, links, bypass, mult);
 }
 
+FairMultiLinkedData::FairMultiLinkedData(const FairMultiLinkedData& toCopy)
+  :TObject(toCopy),
+   fLinks(),
+   fEntryNr(toCopy.fEntryNr),
+   fPersistanceCheck(toCopy.fPersistanceCheck),
+   fInsertHistory(toCopy.fInsertHistory),
+   fVerbose(toCopy.fVerbose),
+   fDefaultType(toCopy.fDefaultType),
+   fLinkTableIndex(-1)
+{
+  // the copy may outlive the link table of the event
+  toCopy.LoadLinks();
+  fLinks = toCopy.fLinks;
+}
+
+FairMultiLinkedData& FairMultiLinkedData::operator=(const FairMultiLinkedData& rhs)
+{
+  if (this != &rhs) {
+    TObject::operator=(rhs);
+    rhs.LoadLinks();
+    fLinks = rhs.fLinks;
+    fEntryNr = rhs.fEntryNr;
+    fPersistanceCheck = rhs.fPersistanceCheck;
+    fInsertHistory = rhs.fInsertHistory;
+    fVerbose = rhs.fVerbose;
+    fDefaultType = rhs.fDefaultType;
+    fLinkTableIndex = -1;
+  }
+  return *this;
+}
+
+void FairMultiLinkedData::ExpandLinks() const
+{
+  FairRootManager* ioman = FairRootManager::Instance();
+  FairLinkTable* table = ioman != 0 ? ioman->GetInLinkTable() : 0;
+  FairMultiLinkedData* data = const_cast<FairMultiLinkedData*>(this);
+  if (table != 0) {
+    table->Expand(*data);
+  } else {
+    std::cout << "-E- FairMultiLinkedData: the links are in a link table, but the input has no branch LinkTable." << std::endl;
+    data->fLinkTableIndex = -1;
+  }
+}
+
 FairLink FairMultiLinkedData::GetLink(Int_t pos) const
 {
+  LoadLinks();
   if (pos < (Int_t)fLinks.size()) {
     std::set<FairLink>::iterator it = fLinks.begin();
     for (int i = 0; i < pos; i++) { it++; }
@@ -85,14 +135,14 @@ FairLink FairMultiLinkedData::GetLink(Int_t pos) const
 
 void FairMultiLinkedData::SetLinks(FairMultiLinkedData links, Float_t mult)
 {
-  fLinks.clear();
+  ResetLinks();
   AddLinks(links, mult);
 }
 
 
 void FairMultiLinkedData::SetLink(FairLink link, Bool_t bypass, Float_t mult)
 {
-  fLinks.clear();
+  ResetLinks();
   Float_t weight = link.GetWeight() * mult;
   link.SetWeight(weight);
   AddLink(link, bypass);
@@ -180,6 +230,7 @@ void FairMultiLinkedData::InsertLink(FairLink link)
 	return;
   }
 
+  LoadLinks();
   std::set<FairLink>::iterator it = fLinks.find(link);
   if (it != fLinks.end()) {
     FairLink myTempLink = *it;
@@ -241,6 +292,7 @@ Bool_t FairMultiLinkedData::IsLinkInList(Int_t type, Int_t index)
 
 Int_t FairMultiLinkedData::LinkPosInList(Int_t type, Int_t index)
 {
+  LoadLinks();
   std::set<FairLink>::iterator it = std::find(fLinks.begin(), fLinks.end(), FairLink(type, index));
   if (it != fLinks.end()) {
     return std::distance(fLinks.begin(), it);
@@ -260,6 +312,7 @@ void FairMultiLinkedData::DeleteLink(Int_t type, Int_t index)
 FairMultiLinkedData FairMultiLinkedData::GetLinksWithType(Int_t type) const
 {
   FairMultiLinkedData result;
+  LoadLinks();
   for (std::set<FairLink>::iterator it = fLinks.begin(); it != fLinks.end(); it++) {
     if (it->GetType() == type) {
       FairLink myLink = *it;
@@ -300,6 +353,7 @@ TObject* FairMultiLinkedData::GetData(FairLink& myLink)
 
 void FairMultiLinkedData::SetAllWeights(Double_t weight)
 {
+  LoadLinks();
   std::set<FairLink> tempLinks;
   for (std::set<FairLink>::iterator it = fLinks.begin(); it != fLinks.end(); it++) {
     FairLink tempLink = *it;
@@ -311,6 +365,7 @@ void FairMultiLinkedData::SetAllWeights(Double_t weight)
 
 void FairMultiLinkedData::AddAllWeights(Double_t weight)
 {
+  LoadLinks();
   std::set<FairLink> tempLinks;
   for (std::set<FairLink>::iterator it = fLinks.begin(); it != fLinks.end(); it++) {
     FairLink tempLink = *it;
@@ -322,6 +377,7 @@ void FairMultiLinkedData::AddAllWeights(Double_t weight)
 
 void FairMultiLinkedData::MultiplyAllWeights(Double_t weight)
 {
+  LoadLinks();
   std::set<FairLink> tempLinks;
   for (std::set<FairLink>::iterator it = fLinks.begin(); it != fLinks.end(); it++) {
     FairLink tempLink = *it;
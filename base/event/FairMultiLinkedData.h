@@ -27,6 +27,8 @@
 #include <set>                          // for set
 #include <vector>                       // for vector
 
+class FairLinkTable;
+
 class FairMultiLinkedData : public  TObject
 {
   public:
@@ -35,11 +37,15 @@ class FairMultiLinkedData : public  TObject
     FairMultiLinkedData(TString dataType, std::vector<Int_t> links, Int_t fileId = -1, Int_t evtId = -1,Bool_t persistanceCheck = kTRUE, Bool_t bypass = kFALSE, Float_t mult = 1.0);///< Constructor
     FairMultiLinkedData(Int_t dataType, std::vector<Int_t> links, Int_t fileId = -1, Int_t evtId = -1, Bool_t persistanceCheck = kTRUE, Bool_t bypass = kFALSE, Float_t mult = 1.0);///< Constructor
 
+    FairMultiLinkedData(const FairMultiLinkedData& toCopy);///< Copy constructor, the copy has its links even if they are in a link table
+    FairMultiLinkedData& operator=(const FairMultiLinkedData& rhs);
+
     virtual ~FairMultiLinkedData() {};
 
-    virtual std::set<FairLink>    GetLinks() const {    return fLinks;}           ///< returns stored links as FairLinks
+    virtual std::set<FairLink>    GetLinks() const { LoadLinks(); return fLinks;}           ///< returns stored links as FairLinks
     virtual FairLink		GetEntryNr() const { return fEntryNr;}				///< gives back the entryNr
-    virtual Int_t           GetNLinks() const { return fLinks.size(); }       ///< returns the number of stored links
+    virtual Int_t           GetNLinks() const { LoadLinks(); return fLinks.size(); }       ///< returns the number of stored links
+    Int_t                   GetLinkTableIndex() const { return fLinkTableIndex; } ///< row of the links in the FairLinkTable of the event, -1 if the links are stored with the object
     virtual FairLink        GetLink(Int_t pos) const;                 ///< returns the FairLink at the given position
     virtual FairMultiLinkedData   GetLinksWithType(Int_t type) const;             ///< Gives you a list of links which contain the given type
     virtual std::vector<FairLink> GetSortedMCTracks();				///< Gives you a list of all FairLinks pointing to a "MCTrack" sorted by their weight
@@ -77,7 +83,7 @@ class FairMultiLinkedData : public  TObject
     virtual void DeleteLink(Int_t type, Int_t index);                               ///< Deletes a link ouf of fLinks
 
     virtual void Reset() {ResetLinks();}
-    virtual void ResetLinks() {fLinks.clear();}                                    ///< Clears fLinks
+    virtual void ResetLinks() {fLinks.clear(); fLinkTableIndex = -1;}               ///< Clears fLinks
 
 
     std::ostream& Print(std::ostream& out = std::cout) const
@@ -109,9 +115,16 @@ class FairMultiLinkedData : public  TObject
       }
     }
     Int_t fDefaultType;
+    /** Row of the links in the FairLinkTable of the event, -1 if they are in fLinks */
+    Int_t fLinkTableIndex;
+
+    /** Fills fLinks from the link table of the input if they are stored there */
+    void LoadLinks() const { if (fLinkTableIndex >= 0) { ExpandLinks(); } }
+    void ExpandLinks() const;
 
+    friend class FairLinkTable;
 
-    ClassDef(FairMultiLinkedData, 4);
+    ClassDef(FairMultiLinkedData, 5);
 };
 
 /**\fn virtual void FairMultiLinkedData::SetLinks(Int_t type, std::vector<Int_t> links)
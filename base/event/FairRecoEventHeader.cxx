@@ -26,4 +26,15 @@ FairRecoEventHeader::FairRecoEventHeader()
 FairRecoEventHeader::~FairRecoEventHeader() { }
 // -------------------------------------------------------------------------
 
+// -----   Public method Clear   -------------------------------------------
+void FairRecoEventHeader::Clear(Option_t* option)
+{
+  TNamed::Clear(option);
+  fRunId = 0;
+  fIdentifier = 0;
+  fEventTime = -1.;
+  fEventTimeError = -1.;
+}
+// -------------------------------------------------------------------------
+
 ClassImp(FairRecoEventHeader)
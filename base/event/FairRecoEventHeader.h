@@ -92,6 +92,10 @@ class FairRecoEventHeader : public TNamed
       return false;
     }
 
+    /** Resets all members to the values of the default constructor,
+     ** derived headers reset their own members as well */
+    virtual void Clear(Option_t* option = "");
+
     /**
      * Destructor
      */
@@ -15,20 +15,20 @@
 
 // -----   Default constructor   -------------------------------------------
 FairGenerator::FairGenerator()
-  : TNamed() {}
+  : TNamed(), fRandom(0) {}
 // -------------------------------------------------------------------------
 
 
 
 // -----   Constructor with name and title   -------------------------------
 FairGenerator::FairGenerator(const char* name, const char* title)
-  : TNamed(name, title) {}
+  : TNamed(name, title), fRandom(0) {}
 // -------------------------------------------------------------------------
 
 
 // -----   Copy constructor ------------------------------------------------
 FairGenerator::FairGenerator(const FairGenerator& rhs)
-  : TNamed(rhs) {}
+  : TNamed(rhs), fRandom(0) {}
 // -------------------------------------------------------------------------
 
 
@@ -44,6 +44,7 @@ FairGenerator& FairGenerator::operator= (const FairGenerator& rhs)
 
   // base class assignment
   TNamed::operator=(rhs);
+  fRandom = 0;
 
   return *this;
 }
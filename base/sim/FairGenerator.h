@@ -28,6 +28,7 @@ which has to use the method FairPrimaryGenerator::AddTrack.
 #include "TNamed.h"                     // for TNamed
 
 #include "Rtypes.h"                     // for Bool_t, etc
+#include "TRandom.h"                    // for TRandom, gRandom
 
 class FairPrimaryGenerator;
 
@@ -64,12 +65,27 @@ class FairGenerator : public TNamed
     /** Clone this object (used in MT mode only) */
     virtual FairGenerator* CloneGenerator() const;
 
+    /** Random generator for the draws of the generator: the per event
+        generator of FairPrimaryGenerator::SetEventSeed if one is set,
+        gRandom otherwise **/
+    TRandom* GetRandom() const { return fRandom ? fRandom : gRandom; }
+    void SetRandom(TRandom* random) { fRandom = random; }
+
+    /** kTRUE if the generator draws from gRandom or another global random
+        generator instead of GetRandom(). Such generators cannot run on the
+        producer thread of FairPrimaryGenerator::SetProducerThread, which
+        would share gRandom with the transport. Generators which draw only
+        from GetRandom(), or not at all, return kFALSE. **/
+    virtual Bool_t UsesGlobalRandom() const { return kTRUE; }
+
   protected:
     /** Copy constructor */
     FairGenerator(const FairGenerator&);
     /** Assignment operator */
     FairGenerator& operator= (const FairGenerator&);
 
+    TRandom* fRandom;  //! per event random generator, NULL for gRandom
+
     ClassDef(FairGenerator,1);
 };
 
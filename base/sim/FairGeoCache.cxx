@@ -0,0 +1,373 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#include "FairGeoCache.h"
+
+#include "FairGeoParSet.h"              // for FairGeoParSet
+#include "FairLogger.h"                 // for FairLogger, MESSAGE_ORIGIN
+#include "FairModule.h"                 // for FairModule
+#include "FairParGenericSet.h"          // for FairParGenericSet
+#include "FairParSet.h"                 // for FairParSet
+#include "FairParamList.h"              // for FairParamList
+#include "FairRun.h"                    // for FairRun
+#include "FairRuntimeDb.h"              // for FairRuntimeDb
+#include "FairVolume.h"                 // for FairVolume
+#include "FairVolumeList.h"             // for FairVolumeList
+
+#include "TBufferFile.h"                // for TBufferFile
+#include "TDirectory.h"                 // for TDirectory, gDirectory
+#include "TExMap.h"                     // for TExMap
+#include "TFile.h"                      // for TFile, gFile
+#include "TGeoManager.h"                // for TGeoManager, gGeoManager
+#include "TList.h"                      // for TList
+#include "TMD5.h"                       // for TMD5
+#include "TObjArray.h"                  // for TObjArray
+#include "TObjString.h"                 // for TObjString
+#include "TROOT.h"                      // for TROOT, gROOT
+#include "TRefArray.h"                  // for TRefArray
+#include "TSystem.h"                    // for TSystem, gSystem
+
+namespace
+{
+// key of the hash, checked before the geometry is read
+const char* kHashKey = "FairGeoCacheHash";
+
+/** open a cache file without changing the current file and directory */
+TFile* OpenCacheFile(const char* fileName, Option_t* option)
+{
+  TFile* currentFile = gFile;
+  TDirectory* currentDir = gDirectory;
+  TFile* f = TFile::Open(fileName, option);
+  gFile = currentFile;
+  gDirectory = currentDir;
+  if (f && f->IsZombie()) {
+    delete f;
+    f = 0;
+  }
+  return f;
+}
+
+/** hash stored in the cache file, empty if there is none */
+TString StoredHash(TFile* f)
+{
+  TObjString* stored = dynamic_cast<TObjString*>(f->Get(kHashKey));
+  TString hash = stored ? stored->GetString() : TString("");
+  delete stored;
+  return hash;
+}
+
+/** write the cache to a temporary file which replaces the old one when done,
+ ** so that jobs started in parallel never read a partly written cache */
+template<class Writer>
+Bool_t WriteCacheFile(const char* fileName, const char* hash, Writer& writer)
+{
+  TString tmpName = Form("%s.%d.tmp", fileName, gSystem->GetPid());
+  TFile* currentFile = gFile;
+  TDirectory* currentDir = gDirectory;
+
+  Bool_t ok = writer(tmpName);
+  if (ok) {
+    TFile* f = OpenCacheFile(tmpName, "UPDATE");
+    if (f) {
+      f->cd();
+      TObjString storedHash(hash);
+      ok = storedHash.Write(kHashKey) > 0;
+      f->Close();
+      delete f;
+    } else {
+      ok = kFALSE;
+    }
+  }
+  gFile = currentFile;
+  gDirectory = currentDir;
+
+  if (ok) {
+    ok = (gSystem->Rename(tmpName, fileName) == 0);
+  }
+  if (!ok) {
+    LOG(WARNING) << "Could not write the geometry cache " << fileName << FairLogger::endl;
+    gSystem->Unlink(tmpName);
+  }
+  return ok;
+}
+
+struct ObjectWriter {
+  TObject* fObject;
+  explicit ObjectWriter(TObject* obj) : fObject(obj) {}
+  Bool_t operator()(const char* name) {
+    TFile* f = OpenCacheFile(name, "RECREATE");
+    if (!f) { return kFALSE; }
+    f->cd();
+    Bool_t ok = fObject->Write("FairGeoCache") > 0;
+    f->Close();
+    delete f;
+    return ok;
+  }
+};
+
+struct GeometryWriter {
+  Bool_t operator()(const char* name) {
+    // the default option of Export streams the voxels as well
+    return gGeoManager->Export(name, "FAIRGeom") > 0;
+  }
+};
+
+/** copy the parameters of a container into another one of the same class,
+ ** the generic containers through their parameter list, the others with
+ ** their streamer */
+Bool_t CopyContainer(FairParSet* from, FairParSet* to)
+{
+  if (from->IsA() != to->IsA()) { return kFALSE; }
+  FairParGenericSet* generic = dynamic_cast<FairParGenericSet*>(from);
+  if (generic) {
+    FairParamList list;
+    generic->putParams(&list);
+    return static_cast<FairParGenericSet*>(to)->getParams(&list);
+  }
+  TBufferFile buffer(TBuffer::kWrite);
+  from->Streamer(buffer);
+  buffer.SetReadMode();
+  buffer.SetBufferOffset(0);
+  buffer.ResetMap();
+  to->Streamer(buffer);
+  return kTRUE;
+}
+}
+
+//_____________________________________________________________________________
+FairGeoCache::FairGeoCache()
+  : TNamed("FairGeoCache", "Cached geometry and volume tables"),
+    fHash(""),
+    fGeometry(0),
+    fVolumes(0),
+    fSensitive(),
+    fGeoNodes(0),
+    fParSets(0),
+    fModVolumes(),
+    fNbOfVolumes(0),
+    fChangedBefore(0)
+{
+}
+
+//_____________________________________________________________________________
+FairGeoCache::~FairGeoCache()
+{
+  // the contents belong to the session after Fill or Restore
+  delete fVolumes;
+  delete fGeoNodes;
+  delete fParSets;
+  delete fChangedBefore;
+}
+
+//_____________________________________________________________________________
+TString FairGeoCache::FileHash(const char* fileName)
+{
+  if (!fileName || gSystem->AccessPathName(fileName)) { return ""; }
+  TMD5* md5 = TMD5::FileChecksum(fileName);
+  if (!md5) { return ""; }
+  TString hash = md5->AsString();
+  delete md5;
+  return hash;
+}
+
+//_____________________________________________________________________________
+TString FairGeoCache::SetupHash(TObjArray* modules, const char* mediaFile)
+{
+  TString setup;
+  setup += Form("FairGeoCache %d ROOT %d\n", FairGeoCache::Class_Version(), gROOT->GetVersionCode());
+  setup += Form("media %s %s\n", mediaFile, FileHash(mediaFile).Data());
+
+  TIter next(modules);
+  FairModule* mod;
+  while ((mod = dynamic_cast<FairModule*>(next()))) {
+    TString geoFile = mod->GetGeometryFileName();
+    setup += Form("%s %s %d %d %s ", mod->ClassName(), mod->GetName(), mod->GetModId(),
+                  mod->IsActive(), mod->fMotherVolumeName.Data());
+    setup += Form("%s %s\n", geoFile.Data(), FileHash(geoFile).Data());
+  }
+
+  TMD5 md5;
+  md5.Update(reinterpret_cast<const UChar_t*>(setup.Data()), setup.Length());
+  md5.Final();
+  return md5.AsString();
+}
+
+//_____________________________________________________________________________
+FairGeoCache* FairGeoCache::ReadCache(const char* fileName, const char* hash)
+{
+  if (gSystem->AccessPathName(fileName)) {
+    LOG(INFO) << "No geometry cache " << fileName << " yet" << FairLogger::endl;
+    return 0;
+  }
+  TFile* f = OpenCacheFile(fileName, "READ");
+  if (!f) { return 0; }
+
+  FairGeoCache* cache = 0;
+  if (StoredHash(f) == hash) {
+    // like TGeoManager::Import, the geometry of the session is kept
+    TGeoManager* current = gGeoManager;
+    gGeoManager = 0;
+    cache = dynamic_cast<FairGeoCache*>(f->Get("FairGeoCache"));
+    gGeoManager = current;
+    if (cache && (cache->fHash != hash || !cache->fGeometry)) {
+      delete cache;
+      cache = 0;
+    }
+  } else {
+    LOG(INFO) << "Geometry cache " << fileName << " was written for another setup" << FairLogger::endl;
+  }
+  f->Close();
+  delete f;
+  return cache;
+}
+
+//_____________________________________________________________________________
+Bool_t FairGeoCache::WriteCache(const char* fileName, const char* hash)
+{
+  fHash = hash;
+  ObjectWriter writer(this);
+  Bool_t ok = WriteCacheFile(fileName, hash, writer);
+  if (ok) {
+    LOG(INFO) << "Geometry written to cache " << fileName << FairLogger::endl;
+  }
+  return ok;
+}
+
+//_____________________________________________________________________________
+TGeoManager* FairGeoCache::ReadGeometry(const char* fileName, const char* hash)
+{
+  if (gSystem->AccessPathName(fileName)) { return 0; }
+  TFile* f = OpenCacheFile(fileName, "READ");
+  if (!f) { return 0; }
+
+  TGeoManager* geo = 0;
+  if (StoredHash(f) == hash) {
+    geo = dynamic_cast<TGeoManager*>(f->Get("FAIRGeom"));
+  }
+  f->Close();
+  delete f;
+  return geo;
+}
+
+//_____________________________________________________________________________
+Bool_t FairGeoCache::WriteGeometry(const char* fileName, const char* hash)
+{
+  if (!gGeoManager) { return kFALSE; }
+  GeometryWriter writer;
+  return WriteCacheFile(fileName, hash, writer);
+}
+
+//_____________________________________________________________________________
+void FairGeoCache::MarkParameters(FairRuntimeDb* rtdb)
+{
+  delete fChangedBefore;
+  fChangedBefore = new TObjArray();
+  TIter next(rtdb->getListOfContainers());
+  FairParSet* cont;
+  while ((cont = dynamic_cast<FairParSet*>(next()))) {
+    if (cont->hasChanged()) { fChangedBefore->Add(cont); }
+  }
+}
+
+//_____________________________________________________________________________
+void FairGeoCache::Fill(FairRuntimeDb* rtdb, const Int_t* modVolumes, Int_t nModVolumes)
+{
+  fGeometry = gGeoManager;
+  fNbOfVolumes = FairModule::fNbOfVolumes;
+
+  FairVolumeList* vList = FairModule::vList;
+  Int_t nVolumes = vList ? vList->getEntries() : 0;
+  fVolumes = new TObjArray(nVolumes);
+  TExMap position(nVolumes + 1);
+  for (Int_t i = 0; i < nVolumes; i++) {
+    FairVolume* vol = vList->At(i);
+    fVolumes->Add(vol);
+    ULong64_t key = reinterpret_cast<ULong64_t>(vol);
+    position.Add(key, key, i+1);
+  }
+
+  TRefArray* svList = FairModule::svList;
+  Int_t nSensitive = svList ? svList->GetEntriesFast() : 0;
+  fSensitive.Set(nSensitive);
+  Int_t n = 0;
+  for (Int_t i = 0; i < nSensitive; i++) {
+    ULong64_t key = reinterpret_cast<ULong64_t>(svList->At(i));
+    Long64_t pos = position.GetValue(key, key);
+    if (pos > 0) { fSensitive[n++] = pos - 1; }
+  }
+  fSensitive.Set(n);
+
+  fGeoNodes = new TObjArray();
+  fParSets = new TObjArray();
+  TIter next(rtdb->getListOfContainers());
+  FairParSet* cont;
+  while ((cont = dynamic_cast<FairParSet*>(next()))) {
+    FairGeoParSet* geoPar = dynamic_cast<FairGeoParSet*>(cont);
+    if (geoPar) {
+      if (geoPar->GetGeoNodes()) { fGeoNodes->AddAll(geoPar->GetGeoNodes()); }
+    } else if (cont->hasChanged() && (!fChangedBefore || fChangedBefore->IndexOf(cont) < 0)) {
+      fParSets->Add(cont);
+    }
+  }
+
+  fModVolumes.Set(nModVolumes, modVolumes);
+}
+
+//_____________________________________________________________________________
+void FairGeoCache::Restore(TObjArray* modules, FairRuntimeDb* rtdb)
+{
+  gGeoManager = fGeometry;
+  FairModule::fNbOfVolumes = fNbOfVolumes;
+
+  for (Int_t i = 0; i < fVolumes->GetEntriesFast(); i++) {
+    FairModule::vList->addVolume(static_cast<FairVolume*>(fVolumes->At(i)));
+  }
+  for (Int_t i = 0; i < fSensitive.GetSize(); i++) {
+    FairVolume* vol = static_cast<FairVolume*>(fVolumes->At(fSensitive[i]));
+    TIter next(modules);
+    FairModule* mod;
+    while ((mod = dynamic_cast<FairModule*>(next()))) {
+      if (mod->GetModId() == vol->getModId()) {
+        vol->SetModule(mod);
+        break;
+      }
+    }
+    FairModule::svList->Add(vol);
+  }
+
+  FairGeoParSet* geoPar = dynamic_cast<FairGeoParSet*>(rtdb->getContainer("FairGeoParSet"));
+  if (geoPar) {
+    geoPar->SetGeometry(gGeoManager);
+    if (geoPar->GetGeoNodes()) { geoPar->GetGeoNodes()->AddAll(fGeoNodes); }
+  }
+
+  // A detector can hold the containers it created already, so the cached
+  // parameters are copied into them; containers which do not exist yet are
+  // added as they were read.
+  Int_t runId = FairRun::Instance()->GetRunId();
+  TIter next(fParSets);
+  FairParSet* cont;
+  while ((cont = dynamic_cast<FairParSet*>(next()))) {
+    FairParSet* old = rtdb->findContainer(cont->GetName());
+    if (old) {
+      if (!CopyContainer(cont, old)) {
+        LOG(ERROR) << "The cached parameters of " << cont->GetName()
+                   << " could not be restored" << FairLogger::endl;
+      }
+      delete cont;
+      cont = old;
+    } else {
+      rtdb->addContainer(cont);
+    }
+    cont->setChanged();
+    cont->setInputVersion(runId, 1);
+  }
+  // the containers belong to the runtime database now
+  fParSets->Clear();
+}
+
+ClassImp(FairGeoCache)
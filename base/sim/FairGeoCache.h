@@ -0,0 +1,88 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#ifndef FAIRGEOCACHE_H
+#define FAIRGEOCACHE_H
+
+#include "TNamed.h"                     // for TNamed
+
+#include "Rtypes.h"                     // for Int_t, etc
+#include "TArrayI.h"                    // for TArrayI
+#include "TString.h"                    // for TString
+
+class FairRuntimeDb;
+class TGeoManager;
+class TObjArray;
+
+/**
+ * Geometry of a simulation setup stored for the following jobs.
+ *
+ * The cache file holds the closed TGeoManager together with the tables
+ * which are filled while the modules construct their geometry: the volume
+ * list with the sensitive volumes, the FairGeoParSet nodes, the parameter
+ * containers changed during the construction and the volume to module map
+ * of the application. It is only used if the hash of the setup, i.e. of
+ * the media file and of the modules with their geometry files, is the same
+ * as the one it was written for. Geometries which are constructed in code
+ * are only identified by the module class and name, the cache file has to
+ * be removed after changing such a module. With a cache hit the
+ * ConstructGeometry() of the modules is not called: side effects of it
+ * other than the tables above, e.g. members set by a detector or
+ * containers which are not changed, are missing in such a session. The
+ * cached parameters are copied into containers which exist already.
+ *
+ * For the analysis only the geometry is cached, with the voxels, and
+ * identified by the content of the geometry file.
+ */
+class FairGeoCache : public TNamed
+{
+  public:
+    FairGeoCache();
+    virtual ~FairGeoCache();
+
+    /** MD5 of the file content, empty if the file can not be read */
+    static TString FileHash(const char* fileName);
+    /** hash of the media file and of all modules with their geometry files */
+    static TString SetupHash(TObjArray* modules, const char* mediaFile);
+
+    /** read the cache for the given hash, NULL if there is no valid one */
+    static FairGeoCache* ReadCache(const char* fileName, const char* hash);
+    /** write gGeoManager and the filled tables */
+    Bool_t WriteCache(const char* fileName, const char* hash);
+
+    /** geometry only caches for FairRunAna */
+    static TGeoManager* ReadGeometry(const char* fileName, const char* hash);
+    static Bool_t WriteGeometry(const char* fileName, const char* hash);
+
+    /** remember the parameter containers which are changed before the construction */
+    void MarkParameters(FairRuntimeDb* rtdb);
+    /** take over the volumes, containers and geometry after the construction */
+    void Fill(FairRuntimeDb* rtdb, const Int_t* modVolumes, Int_t nModVolumes);
+    /** make the cached geometry and tables the ones of this session */
+    void Restore(TObjArray* modules, FairRuntimeDb* rtdb);
+
+    /** pairs of volume index in gGeoManager and module id */
+    const TArrayI& GetModuleVolumes() const { return fModVolumes; }
+
+  private:
+    FairGeoCache(const FairGeoCache&);
+    FairGeoCache& operator=(const FairGeoCache&);
+
+    TString      fHash;         // hash of the setup
+    TGeoManager* fGeometry;     // closed geometry
+    TObjArray*   fVolumes;      // FairModule::vList
+    TArrayI      fSensitive;    // positions of FairModule::svList in fVolumes
+    TObjArray*   fGeoNodes;     // nodes of FairGeoParSet
+    TObjArray*   fParSets;      // containers filled during the construction
+    TArrayI      fModVolumes;   // pairs of volume index and module id
+    Int_t        fNbOfVolumes;  // FairModule::fNbOfVolumes
+    TObjArray*   fChangedBefore; //! containers changed before the construction
+
+    ClassDef(FairGeoCache,1)
+};
+
+#endif //FAIRGEOCACHE_H
@@ -14,6 +14,7 @@
 #include "FairDetector.h"               // for FairDetector
 #include "FairField.h"                  // for FairField
 #include "FairGenericStack.h"           // for FairGenericStack
+#include "FairGeoCache.h"               // for FairGeoCache
 #include "FairGeoInterface.h"           // for FairGeoInterface
 #include "FairGeoLoader.h"              // for FairGeoLoader
 #include "FairGeoMedia.h"               // for FairGeoMedia
@@ -40,6 +41,7 @@
 #include "Riosfwd.h"                    // for ostream
 #include "TDatabasePDG.h"               // for TDatabasePDG
 #include "TDirectory.h"                 // for TDirectory, gDirectory
+#include "TFile.h"                      // for TFile
 #include "TGeoManager.h"                // for gGeoManager, TGeoManager
 #include "TGeoMedium.h"                 // for TGeoMedium
 #include "TGeoNode.h"                   // for TGeoNode
@@ -49,24 +51,42 @@
 #include "TInterpreter.h"               // for TInterpreter, gInterpreter
 #include "TIterator.h"                  // for TIterator
 #include "TList.h"                      // for TList, TListIter
+#include "TMutex.h"                     // for TMutex
 #include "TObjArray.h"                  // for TObjArray
 #include "TObject.h"                    // for TObject
 #include "TParticlePDG.h"               // for TParticlePDG
 #include "TROOT.h"                      // for TROOT, gROOT
 #include "TRefArray.h"                  // for TRefArray
 #include "TSystem.h"                    // for TSystem, gSystem
+#include "TThread.h"                    // for TThread
 #include "TTree.h"                      // for TTree
 #include "TVirtualMC.h"                 // for TVirtualMC, gMC
 #include "TVirtualMCStack.h"            // for TVirtualMCStack
+#include "TVirtualMutex.h"              // for TLockGuard
 #include "THashList.h"
 class TParticle;
 
 #include <float.h>                      // for DBL_MAX
 #include <stdlib.h>                     // for NULL, getenv, exit
+#include <algorithm>                    // for sort
 #include <iostream>                     // for operator<<, basic_ostream, etc
 #include <utility>                      // for pair
+#include <vector>                       // for vector
 
 using std::pair;
+
+namespace {
+// Output files of the worker threads in MT mode. Opening and closing the
+// worker outputs is serialised, it changes the global lists of ROOT.
+std::vector<TString> gWorkerOutputFiles;
+
+TMutex& WorkerOutputMutex()
+{
+  static TMutex mutex;
+  return mutex;
+}
+}
+
 //_____________________________________________________________________________
 FairMCApplication::FairMCApplication(const char* name, const char* title,
                                      TObjArray* ModList, const char* MatName)
@@ -106,7 +126,11 @@ FairMCApplication::FairMCApplication(const char* name, const char* title,
    fEventHeader(NULL),
    fMCEventHeader(NULL),
    fRunInfo(),
-   fGeometryIsInitialized(kFALSE)
+   fGeometryIsInitialized(kFALSE),
+   fWorkerId(-1),
+   fEngineName(""),
+   fOutputFileName(""),
+   fGeometryFromCache(kFALSE)
 {
 // Standard Simulation constructor
 // Check if the Fair root manager exist!
@@ -187,7 +211,11 @@ FairMCApplication::FairMCApplication(const FairMCApplication& rhs)
    fEventHeader(NULL),
    fMCEventHeader(NULL),
    fRunInfo(),
-   fGeometryIsInitialized(kFALSE)
+   fGeometryIsInitialized(kFALSE),
+   fWorkerId(-1),
+   fEngineName(rhs.fEngineName),
+   fOutputFileName(rhs.fOutputFileName),
+   fGeometryFromCache(kFALSE)
 {
 // Copy constructor
 // Do not create Root manager
@@ -269,7 +297,11 @@ FairMCApplication::FairMCApplication()
    fEventHeader(NULL),
    fMCEventHeader(NULL),
    fRunInfo(),
-   fGeometryIsInitialized(kFALSE)
+   fGeometryIsInitialized(kFALSE),
+   fWorkerId(-1),
+   fEngineName(""),
+   fOutputFileName(""),
+   fGeometryFromCache(kFALSE)
 {
 // Default constructor
 }
@@ -332,6 +364,10 @@ FairMCApplication& FairMCApplication::operator=(const FairMCApplication& rhs)
     fEventHeader = NULL;
     fMCEventHeader = NULL;
     fGeometryIsInitialized = kFALSE;
+    fWorkerId = -1;
+    fEngineName = rhs.fEngineName;
+    fOutputFileName = rhs.fOutputFileName;
+    fGeometryFromCache = kFALSE;
 
     // Do not create Root manager
     
@@ -401,6 +437,21 @@ void FairMCApplication::InitMC(const char* setup, const char* cuts)
   }
   gMC->SetMagField(fxField);
 
+  // needed by the worker threads in MT mode, which are set up
+  // without access to the master run
+  fEngineName = FairRunSim::Instance()->GetName();
+  if (fRootManager && fRootManager->GetOutFile()) {
+    fOutputFileName = fRootManager->GetOutFile()->GetName();
+  }
+  if (fEngineName == "TGeant4") {
+    // Geant4 can transport on worker threads, which fill their own output
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,6,0)
+    ROOT::EnableThreadSafety();
+#else
+    TThread::Initialize();
+#endif
+  }
+
   gMC->Init();
   gMC->BuildPhysics();
   TString MCName=gMC->GetName();
@@ -430,6 +481,8 @@ void FairMCApplication::RunMC(Int_t nofEvents)
 
   // MC run.
   gMC->ProcessRun(nofEvents);
+  // collect the events simulated by the worker threads (MT mode)
+  MergeWorkerOutput();
   // finish run
   FinishRun();
   // Save histograms with memory and runtime information in the output file
@@ -457,10 +510,12 @@ void FairMCApplication::FinishRun()
   FairPrimaryGenerator* gen = FairRunSim::Instance()->GetPrimaryGenerator();
   //FairMCEventHeader* header = gen->GetEvent();
   Int_t nprimary = gen->GetTotPrimary();
+  gen->CloseCache();
   TObjArray* meshlist  = NULL;
 
   if (fRadGridMan ) {
 
+    fRadGridMan->FillMeshHistograms();
     meshlist = fRadGridMan->GetMeshList();
 
     TH2D* tid = NULL;
@@ -571,14 +626,31 @@ TVirtualMCApplication* FairMCApplication::CloneForWorker() const
   LOG(INFO) << "FairMCApplication::CloneForWorker " 
 	    << this << FairLogger::endl;
 
-  // Create new FairRunSim object on worker
+  TLockGuard lock(&WorkerOutputMutex());
+
+  // Each worker writes to <output>_w<id>.root, the files are merged
+  // into the output of the master at the end of the run.
+  Int_t workerId = gWorkerOutputFiles.size();
+  TString workerFile = "";
+  if (!fOutputFileName.IsNull()) {
+    workerFile = fOutputFileName;
+    if (workerFile.EndsWith(".root")) { workerFile.Resize(workerFile.Length()-5); }
+    workerFile += TString::Format("_w%d.root", workerId);
+  }
+  gWorkerOutputFiles.push_back(workerFile);
+
+  // Create new FairRunSim object on worker, it owns the FairRootManager of the worker
   FairRunSim* workerRun = new FairRunSim(kFALSE);
-  workerRun->SetName(FairRunSim::Instance()->GetName()); // Transport engine
-  workerRun->SetOutputFile("file1.root"); // TO DO: must be different on each  worker
+  workerRun->SetName(fEngineName); // Transport engine
+  if (!workerFile.IsNull()) {
+    FairRootManager::Instance()->SetOutFolderName(TString::Format("cbmroot_w%d", workerId));
+    workerRun->SetOutputFile(workerFile);
+  }
 
   // Create new  FairMCApplication object on worker
   FairMCApplication* workerApplication = new FairMCApplication(*this);
   workerApplication->SetGenerator(fEvGen->ClonePrimaryGenerator());
+  workerApplication->InitWorker(*this, workerId);
 
   LOG(INFO) << "FairMCApplication::CloneForWorker finished " 
 	    << this << FairLogger::endl;
@@ -591,18 +663,10 @@ void FairMCApplication::InitForWorker() const
   LOG(INFO) << "FairMCApplication::InitForWorker " 
 	    << this << FairLogger::endl;
 
-  // Create Root manager
-  // TO DO
-  //fRootManager
-  //  = new TMCRootManagerMT(GetName(), TVirtualMCRootManager::kWrite);
-  //fRootManager->SetDebug(true);
-
   // Set data to MC
   gMC->SetStack(fStack);
   gMC->SetMagField(fxField);
 
-  // if (fRootManager) RegisterStack();
-
   LOG(INFO) << "Monte Carlo Engine Worker Initialisation  with: "
 	    << gMC->GetName() << FairLogger::endl;
 }
@@ -610,7 +674,172 @@ void FairMCApplication::InitForWorker() const
 //_____________________________________________________________________________
 void FairMCApplication::FinishWorkerRun() const
 {
-  LOG(INFO) << "A01MCApplication::FinishWorkerRun: " << FairLogger::endl;
+  LOG(INFO) << "FairMCApplication::FinishWorkerRun: " << fWorkerId
+	    << FairLogger::endl;
+
+  for( std::list<FairDetector *>::const_iterator  listIter = listActiveDetectors.begin();
+        listIter != listActiveDetectors.end();
+        listIter++)
+  {
+        (*listIter)->FinishRun();
+  }
+
+  if (fRadGridMan) {
+    // the mesh histograms are shared by all workers
+    TLockGuard lock(&WorkerOutputMutex());
+    fRadGridMan->FillMeshHistograms();
+  }
+
+  if (fRootManager) {
+    TLockGuard lock(&WorkerOutputMutex());
+    fRootManager->Write();
+    fRootManager->CloseOutFile();
+    // the tree is deleted together with the file
+    fRootManager->SetOutTree(NULL);
+  }
+}
+
+//_____________________________________________________________________________
+void FairMCApplication::InitWorker(const FairMCApplication& master, Int_t workerId)
+{
+  fWorkerId = workerId;
+
+  // The volumes of the master dispatch the hits to the detectors of the
+  // master, the worker needs copies pointing to its own detector clones.
+  std::map<Int_t, FairModule*> modules;
+  fModIter->Reset();
+  FairModule* Mod=NULL;
+  while((Mod = dynamic_cast<FairModule*>(fModIter->Next()))) {
+    modules[Mod->GetModId()] = Mod;
+  }
+  std::multimap<Int_t, FairVolume*>::const_iterator volIter;
+  for (volIter = master.fVolMap.begin(); volIter != master.fVolMap.end(); volIter++) {
+    FairVolume* fv = volIter->second;
+    FairVolume* fNewV=new FairVolume( fv->GetName(), fv->getMCid());
+    fNewV->setModId(fv->getModId());
+    fNewV->SetModule(modules[fv->getModId()]);
+    fNewV->setCopyNo(fv->getCopyNo());
+    fNewV->setMCid(fv->getMCid());
+    fVolMap.insert(pair<Int_t, FairVolume* >(volIter->first, fNewV));
+  }
+  fModVolMap = master.fModVolMap;
+  fGeometryIsInitialized = kTRUE;
+
+  // the worker scores the meshes of the master into its own sums
+  if (master.fRadGridMan) {
+    fRadGridMan = new FairRadGridManager();
+    fRadGridMan->AddMeshList(master.fRadGridMan->GetMeshList());
+  }
+
+  // Register stack, detector collections and event header in the
+  // FairRootManager of this thread, as done by InitGeometry on the master
+  fRootManager = FairRootManager::Instance();
+  if (!fRootManager || !fRootManager->GetOutFile()) {
+    LOG(WARNING) << "No output for worker " << workerId << FairLogger::endl;
+    fRootManager = NULL;
+    return;
+  }
+
+  if(fEvGen!=0 && fStack!=0) {
+    fStack->Register();
+  }
+  for( std::list<FairDetector *>::iterator  listIter = listActiveDetectors.begin();
+        listIter != listActiveDetectors.end();
+        listIter++)
+  {
+    (*listIter)->Register();
+  }
+
+  fMCEventHeader = FairRunSim::Instance()->GetMCEventHeader();
+  if (master.fMCEventHeader) {
+    fMCEventHeader->SetRunID(master.fMCEventHeader->GetRunID());
+  }
+  fMCEventHeader->Register();
+  if(fEvGen) {
+    fEvGen->SetEvent(fMCEventHeader);
+  }
+
+  fRootManager->GetOutFile()->cd();
+  TString folderName = fRootManager->GetOutFolderName();
+  TTree* outTree =new TTree("cbmsim", "/" + folderName, 99);
+  fRootManager->TruncateBranchNames(outTree, folderName);
+  fRootManager->SetOutTree(outTree);
+}
+
+//_____________________________________________________________________________
+void FairMCApplication::MergeWorkerOutput()
+{
+  TLockGuard lock(&WorkerOutputMutex());
+  if (gWorkerOutputFiles.empty()) {
+    return;
+  }
+
+  TTree* outTree = fRootManager ? fRootManager->GetOutTree() : NULL;
+  if (!outTree) {
+    LOG(WARNING) << "No output tree, the output of the "
+		 << gWorkerOutputFiles.size() << " workers is not merged" << FairLogger::endl;
+    gWorkerOutputFiles.clear();
+    return;
+  }
+
+  LOG(INFO) << "Merging the output of " << gWorkerOutputFiles.size()
+	    << " workers" << FairLogger::endl;
+
+  TDirectory* savedir = gDirectory;
+
+  // The worker trees are read into the objects of the output tree. The
+  // events are ordered by the event number of the transport engine, which
+  // is unique over all workers. The MC track indices are local to an event
+  // and need no update.
+  std::vector<TFile*> files;
+  std::vector<TTree*> trees;
+  std::vector<pair<UInt_t, pair<UInt_t, Long64_t> > > events;
+  for (UInt_t iWorker = 0; iWorker < gWorkerOutputFiles.size(); iWorker++) {
+    if (gWorkerOutputFiles[iWorker].IsNull()) { continue; }
+    TFile* file = TFile::Open(gWorkerOutputFiles[iWorker]);
+    TTree* tree = file ? dynamic_cast<TTree*>(file->Get("cbmsim")) : NULL;
+    if (!tree) {
+      LOG(ERROR) << "No output tree in " << gWorkerOutputFiles[iWorker]
+		 << FairLogger::endl;
+      delete file;
+      continue;
+    }
+    outTree->CopyAddresses(tree);
+    TBranch* header = fMCEventHeader ? tree->GetBranch("MCEventHeader.") : NULL;
+    for (Long64_t entry = 0; entry < tree->GetEntries(); entry++) {
+      UInt_t eventId = entry;
+      if (header) {
+        header->GetEntry(entry);
+        eventId = fMCEventHeader->GetEventID();
+      }
+      events.push_back(pair<UInt_t, pair<UInt_t, Long64_t> >(eventId, pair<UInt_t, Long64_t>(trees.size(), entry)));
+    }
+    files.push_back(file);
+    trees.push_back(tree);
+  }
+
+  std::sort(events.begin(), events.end());
+  for (UInt_t i = 0; i < events.size(); i++) {
+    trees[events[i].second.first]->GetEntry(events[i].second.second);
+    outTree->Fill();
+  }
+
+  for (UInt_t i = 0; i < files.size(); i++) {
+    outTree->CopyAddresses(trees[i], kTRUE);
+    files[i]->Close();
+    delete files[i];
+  }
+  for (UInt_t iWorker = 0; iWorker < gWorkerOutputFiles.size(); iWorker++) {
+    if (!gWorkerOutputFiles[iWorker].IsNull()) {
+      gSystem->Unlink(gWorkerOutputFiles[iWorker]);
+    }
+  }
+  gWorkerOutputFiles.clear();
+
+  gDirectory=savedir;
+
+  LOG(INFO) << "Merged " << events.size() << " events from "
+	    << trees.size() << " workers" << FairLogger::endl;
 }
 
 //_____________________________________________________________________________
@@ -755,6 +984,11 @@ void FairMCApplication::FinishEvent()
 {
 // User actions after finishing of an event
 // ---
+  // The event number of the transport engine is unique over
+  // all workers in MT mode, the one of the generator is not.
+  if (fWorkerId >= 0 && fMCEventHeader) {
+    fMCEventHeader->SetEventID(gMC->CurrentEvent() + 1);
+  }
   // --> Fill the stack output array
   fStack->FillTrackArray();
   // --> Update track indizes in MCTracks and MCPoints
@@ -868,18 +1102,45 @@ void FairMCApplication::ConstructOpGeometry()
 void FairMCApplication::ConstructGeometry()
 {
 
-  fModIter->Reset();
-  FairModule* Mod=NULL;
-  Int_t NoOfVolumes=0;
-  Int_t NoOfVolumesBefore=0;
-  Int_t ModId=0;
-  while((Mod = dynamic_cast<FairModule*>(fModIter->Next()))) {
-    NoOfVolumesBefore=gGeoManager->GetListOfVolumes()->GetEntriesFast();
-    Mod->ConstructGeometry();
-    ModId=Mod->GetModId();
-    NoOfVolumes=gGeoManager->GetListOfVolumes()->GetEntriesFast();
-    for (Int_t n=NoOfVolumesBefore; n <= NoOfVolumes; n++) {
-      fModVolMap.insert(pair<Int_t, Int_t >(n,ModId));
+  // With a geometry cache the construction is skipped if the cache was
+  // written for the same setup, otherwise the cache is written at the end.
+  FairRunSim* run = FairRunSim::Instance();
+  TString cacheFile = run->GetGeometryCache();
+  TString cacheHash = "";
+  FairGeoCache* cache = NULL;
+  FairGeoCache* newCache = NULL;
+  if (!cacheFile.IsNull()) {
+    cacheHash = FairGeoCache::SetupHash(fModules, run->GetMaterialFile());
+    cache = FairGeoCache::ReadCache(cacheFile, cacheHash);
+  }
+
+  if (cache) {
+    cache->Restore(fModules, run->GetRuntimeDb());
+    const TArrayI& modVolumes = cache->GetModuleVolumes();
+    for (Int_t n = 0; n+1 < modVolumes.GetSize(); n += 2) {
+      fModVolMap.insert(pair<Int_t, Int_t >(modVolumes[n], modVolumes[n+1]));
+    }
+    delete cache;
+    fGeometryFromCache = kTRUE;
+    LOG(INFO) << "Geometry restored from cache " << cacheFile << FairLogger::endl;
+  } else {
+    if (!cacheFile.IsNull()) {
+      newCache = new FairGeoCache();
+      newCache->MarkParameters(run->GetRuntimeDb());
+    }
+    fModIter->Reset();
+    FairModule* Mod=NULL;
+    Int_t NoOfVolumes=0;
+    Int_t NoOfVolumesBefore=0;
+    Int_t ModId=0;
+    while((Mod = dynamic_cast<FairModule*>(fModIter->Next()))) {
+      NoOfVolumesBefore=gGeoManager->GetListOfVolumes()->GetEntriesFast();
+      Mod->ConstructGeometry();
+      ModId=Mod->GetModId();
+      NoOfVolumes=gGeoManager->GetListOfVolumes()->GetEntriesFast();
+      for (Int_t n=NoOfVolumesBefore; n <= NoOfVolumes; n++) {
+        fModVolMap.insert(pair<Int_t, Int_t >(n,ModId));
+      }
     }
   }
   fSenVolumes=FairModule::svList;
@@ -888,7 +1149,9 @@ void FairMCApplication::ConstructGeometry()
   }
   if (gGeoManager) {
     //  LOG(DEBUG) << "FairMCApplication::ConstructGeometry() : Now closing the geometry"<< FairLogger::endl;
-    gGeoManager->CloseGeometry();   // close geometry
+    if (!gGeoManager->IsClosed()) {
+      gGeoManager->CloseGeometry();   // close geometry
+    }
     gMC->SetRootGeometry();         // notify VMC about Root geometry
     Int_t Counter=0;
     TDatabasePDG* pdgDatabase = TDatabasePDG::Instance();
@@ -906,6 +1169,16 @@ void FairMCApplication::ConstructGeometry()
       }
     }
   }
+  if (newCache) {
+    std::vector<Int_t> modVolumes;
+    for (fModVolIter = fModVolMap.begin(); fModVolIter != fModVolMap.end(); ++fModVolIter) {
+      modVolumes.push_back(fModVolIter->first);
+      modVolumes.push_back(fModVolIter->second);
+    }
+    newCache->Fill(run->GetRuntimeDb(), modVolumes.empty() ? NULL : &modVolumes[0], static_cast<Int_t>(modVolumes.size()));
+    newCache->WriteCache(cacheFile, cacheHash);
+    delete newCache;
+  }
 }
 //_____________________________________________________________________________
 
@@ -114,6 +114,8 @@ class FairMCApplication : public TVirtualMCApplication
     virtual void          InitGeometry();                                   // MC Application
     /** Initialize MC engine */
     void                  InitMC(const char* setup,  const char* cuts);
+    /** kTRUE if the geometry was taken from the geometry cache */
+    Bool_t                IsGeometryFromCache() const { return fGeometryFromCache; }
     /** Initialize Tasks if any*/
     void                  InitTasks();
     /**Define actions at the end of each track */
@@ -271,7 +273,7 @@ class FairMCApplication : public TVirtualMCApplication
     std::list <FairDetector *> listDetectors;  //!
 
     
-    ClassDef(FairMCApplication,4)  //Interface to MonteCarlo application
+    ClassDef(FairMCApplication,6)  //Interface to MonteCarlo application
 
   private:
     /** Protected copy constructor */
@@ -279,8 +281,20 @@ class FairMCApplication : public TVirtualMCApplication
     /** Protected assignment operator */
     FairMCApplication& operator=(const FairMCApplication&);
 
+    /** Set up a worker application (MT mode only): output, branches and dispatcher */
+    void InitWorker(const FairMCApplication& master, Int_t workerId);
+    /** Merge the outputs of the workers into the output tree (MT mode only) */
+    void MergeWorkerOutput();
+
     FairRunInfo fRunInfo;//!
     Bool_t      fGeometryIsInitialized;
+    /** Index of a worker application (MT mode), -1 for the master */
+    Int_t       fWorkerId; //!
+    /** Transport engine and output file of the master run, used to set up the workers */
+    TString     fEngineName; //!
+    TString     fOutputFileName; //!
+    /** Geometry and volume tables were restored from the geometry cache */
+    Bool_t      fGeometryFromCache; //!
 };
 
 // inline functions
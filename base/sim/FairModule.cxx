@@ -25,6 +25,7 @@
 
 #include "TBuffer.h"                    // for TBuffer, operator<<, etc
 #include "TCollection.h"                // for TIter
+#include "TExMap.h"                     // for TExMap
 #include "TFile.h"                      // for TFile
 #include "TGeoManager.h"                // for TGeoManager, gGeoManager
 #include "TGeoMaterial.h"               // for TGeoMaterial
@@ -56,6 +57,50 @@ Int_t FairModule::fNbOfVolumes=0;
 FairVolumeList*  FairModule::vList=0;
 TRefArray*    FairModule::svList=0;
 
+namespace
+{
+// While a node tree is expanded the positions (+1) of the matrices in the
+// list of gGeoManager are kept in a hash map, so that removing the matrix
+// of every expanded node does not need a linear search through the list.
+TExMap* gMatrixIndex = 0;
+Int_t   gMatrixIndexed = 0;   // slots of the list which are in the index
+Int_t   gExpandDepth = 0;
+
+void IndexNewMatrices(TObjArray* matrices)
+{
+  for (Int_t i = gMatrixIndexed; i <= matrices->GetLast(); i++) {
+    TObject* m = matrices->UncheckedAt(i);
+    if (!m) { continue; }
+    ULong64_t key = reinterpret_cast<ULong64_t>(m);
+    if (!gMatrixIndex->GetValue(key, key)) { gMatrixIndex->Add(key, key, i+1); }
+  }
+  gMatrixIndexed = matrices->GetLast() + 1;
+}
+
+/** same as matrices->Remove(matrix) if the matrix is in the list */
+void RemoveMatrix(TObjArray* matrices, TGeoMatrix* matrix)
+{
+  if (!gMatrixIndex) {
+    if (matrices->FindObject(matrix)) { matrices->Remove(matrix); }
+    return;
+  }
+  IndexNewMatrices(matrices);
+  ULong64_t key = reinterpret_cast<ULong64_t>(matrix);
+  Long64_t pos = gMatrixIndex->GetValue(key, key);
+  if (pos <= 0) { return; }
+  gMatrixIndex->Remove(key, key);
+  if (matrices->At(pos-1) == matrix) {
+    matrices->RemoveAt(pos-1);
+  } else if (matrices->FindObject(matrix)) {
+    // the list was changed behind the index
+    matrices->Remove(matrix);
+  }
+  // removing the last entry shrinks the list, new matrices are
+  // appended to the free slots and have to be indexed again
+  if (gMatrixIndexed > matrices->GetLast() + 1) { gMatrixIndexed = matrices->GetLast() + 1; }
+}
+}
+
 
 
 //__________________________________________________________________________
@@ -257,8 +302,9 @@ void FairModule::ProcessNodes(TList* aList)
     MotherNode=node->getMotherNode();
     volume = new FairVolume( node->getTruncName(), fNbOfVolumes++);
     volume->setRealName(node->GetName());
-    vList->addVolume(volume);
+    // the node has to be known before adding, the list is indexed by it
     volume->setGeoNode(node);
+    vList->addVolume(volume);
     volume->setCopyNo(  node->getCopyNo());
 
     if(MotherNode!=0) {
@@ -300,17 +346,7 @@ void  FairModule::AddSensitiveVolume(TGeoVolume* v)
 //__________________________________________________________________________
 FairVolume* FairModule::getFairVolume(FairGeoNode* fN)
 {
-  FairVolume* fv;
-  FairVolume*  fvol=0;
-  for(Int_t i=0; i<vList->getEntries(); i++) {
-    fv=vList->At(i);
-    if((fv->getGeoNode())==fN) {
-      fvol=fv;
-      return fvol;
-      break;
-    }
-  }
-  return fvol;
+  return vList->findVolume(fN);
 }
 //__________________________________________________________________________
 void FairModule::ConstructRootGeometry()
@@ -531,8 +567,17 @@ void FairModule::ExpandNode(TGeoNode* fN)
   //FairGeoInterface* geoFace = geoLoad->getGeoInterface();
   //FairGeoMedia* Media =  geoFace->getMedia();
   //FairGeoBuilder* geobuild=geoLoad->getGeoBuilder();
+  TObjArray* matrices = gGeoManager->GetListOfMatrices();
+  // the index of the matrices is built once for the whole tree
+  Bool_t topNode = (gExpandDepth == 0);
+  if (topNode) {
+    gMatrixIndex = new TExMap(matrices->GetEntriesFast() + 1);
+    gMatrixIndexed = 0;
+  }
+  gExpandDepth++;
+
   TGeoMatrix* Matrix =fN->GetMatrix();
-  if(gGeoManager->GetListOfMatrices()->FindObject(Matrix)) { gGeoManager->GetListOfMatrices()->Remove(Matrix); }
+  RemoveMatrix(matrices, Matrix);
   TGeoVolume* v1=fN->GetVolume();
   TObjArray* NodeList=v1->GetNodes();
   for (Int_t Nod=0; Nod<NodeList->GetEntriesFast(); Nod++) {
@@ -552,6 +597,12 @@ void FairModule::ExpandNode(TGeoNode* fN)
       AddSensitiveVolume(v);
     }
   }
+
+  gExpandDepth--;
+  if (topNode) {
+    delete gMatrixIndex;
+    gMatrixIndex = 0;
+  }
 }
 
 //__________________________________________________________________________
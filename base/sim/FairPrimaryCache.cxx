@@ -0,0 +1,427 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#include "FairPrimaryCache.h"
+
+#include "FairGenericStack.h"           // for FairGenericStack
+#include "FairLogger.h"                 // for FairLogger, MESSAGE_ORIGIN
+#include "FairMCEventHeader.h"          // for FairMCEventHeader
+#include "FairPrimaryGenerator.h"       // for FairPrimaryGenerator
+
+#include "TCondition.h"                 // for TCondition
+#include "TDatabasePDG.h"               // for TDatabasePDG
+#include "TMCProcess.h"                 // for TMCProcess::kPPrimary
+#include "TMutex.h"                     // for TMutex
+#include "TObjArray.h"                  // for TObjArray
+#include "TRandom.h"                    // for TRandom, gRandom
+#include "TRandom3.h"                   // for TRandom3
+#include "TSystem.h"                    // for TSystem, gSystem
+#include "TThread.h"                    // for TThread
+#include "TVirtualMutex.h"              // for TLockGuard
+
+#include <string.h>                     // for memcmp, memcpy
+
+namespace
+{
+const char kMagic[8] = { 'F', 'A', 'I', 'R', 'P', 'R', 'I', 'M' };
+const Int_t kVersion = 1;
+const size_t kFileBuffer = 1 << 22;
+
+struct FileHeader {
+  char fMagic[8];
+  Int_t fVersion;
+  Int_t fTrackSize;                     // sizeof(FairPrimaryTrack) of the writer
+};
+
+struct EventRecord {
+  Double_t fValues[8];                  // x, y, z, t, b, rotX, rotY, rotZ
+  Int_t fEventId;
+  Int_t fIsSet;
+  Int_t fNTracks;
+  Int_t fReserved;
+};
+
+/** stack of the producer, keeps the tracks of the current event */
+class PrimaryRecorder : public FairGenericStack
+{
+  public:
+    PrimaryRecorder() : FairGenericStack(), fTracks(0) {}
+
+    void Start(std::vector<FairPrimaryTrack>* tracks) {
+      fTracks = tracks;
+      fTracks->clear();
+    }
+
+    virtual void PushTrack(Int_t toBeDone, Int_t parentID, Int_t pdgCode,
+                           Double_t px, Double_t py, Double_t pz,
+                           Double_t e, Double_t vx, Double_t vy,
+                           Double_t vz, Double_t time, Double_t polx,
+                           Double_t poly, Double_t polz, TMCProcess proc,
+                           Int_t& ntr, Double_t weight, Int_t is) {
+      PushTrack(toBeDone, parentID, pdgCode, px, py, pz, e, vx, vy, vz, time,
+                polx, poly, polz, proc, ntr, weight, is, -1);
+    }
+
+    virtual void PushTrack(Int_t toBeDone, Int_t, Int_t pdgCode,
+                           Double_t px, Double_t py, Double_t pz,
+                           Double_t e, Double_t vx, Double_t vy,
+                           Double_t vz, Double_t time, Double_t,
+                           Double_t, Double_t, TMCProcess,
+                           Int_t& ntr, Double_t weight, Int_t is,
+                           Int_t secondParentId) {
+      FairPrimaryTrack track = { px, py, pz, e, vx, vy, vz, time, weight,
+                                 pdgCode, toBeDone, is, secondParentId
+                               };
+      ntr = static_cast<Int_t>(fTracks->size());
+      fTracks->push_back(track);
+    }
+
+  private:
+    std::vector<FairPrimaryTrack>* fTracks;
+
+    PrimaryRecorder(const PrimaryRecorder&);
+    PrimaryRecorder& operator=(const PrimaryRecorder&);
+};
+
+Bool_t ReadHeader(FILE* f)
+{
+  FileHeader header;
+  return fread(&header, sizeof(header), 1, f) == 1
+         && memcmp(header.fMagic, kMagic, sizeof(kMagic)) == 0
+         && header.fVersion == kVersion
+         && header.fTrackSize == static_cast<Int_t>(sizeof(FairPrimaryTrack));
+}
+}
+
+//_____________________________________________________________________________
+FairPrimaryCache::FairPrimaryCache(FairPrimaryGenerator* producer)
+  : fProducer(producer),
+    fRecorder(producer ? new PrimaryRecorder() : 0),
+    fRandom(0),
+    fSeed(0),
+    fNProduced(0),
+    fInput(0),
+    fOutput(0),
+    fOutputName(""),
+    fOutputTmp(""),
+    fOutputOk(kFALSE),
+    fThread(0),
+    fMutex(0),
+    fNotEmpty(0),
+    fNotFull(0),
+    fQueueSize(0),
+    fQueue(),
+    fFree(),
+    fDone(kFALSE),
+    fStop(kFALSE)
+{
+}
+
+//_____________________________________________________________________________
+FairPrimaryCache::~FairPrimaryCache()
+{
+  StopProducer();
+
+  if (fInput) { fclose(fInput); }
+  if (fOutput) {
+    fOutputOk = (fclose(fOutput) == 0) && fOutputOk;
+    if (fOutputOk && gSystem->Rename(fOutputTmp, fOutputName) == 0) {
+      LOG(INFO) << "Primary events written to cache " << fOutputName << FairLogger::endl;
+    } else {
+      LOG(WARNING) << "Could not write the primary cache " << fOutputName << FairLogger::endl;
+      gSystem->Unlink(fOutputTmp);
+    }
+  }
+
+  for (size_t i = 0; i < fQueue.size(); i++) { delete fQueue[i]; }
+  for (size_t i = 0; i < fFree.size(); i++) { delete fFree[i]; }
+  delete fNotEmpty;
+  delete fNotFull;
+  delete fMutex;
+  delete fRandom;
+  delete fRecorder;
+  if (fProducer) {
+    // the generators are deleted by the primary generator of the run
+    fProducer->GetListOfGenerators()->Clear();
+    delete fProducer->GetEvent();
+    delete fProducer;
+  }
+}
+
+//_____________________________________________________________________________
+Bool_t FairPrimaryCache::IsCacheFile(const char* fileName)
+{
+  if (gSystem->AccessPathName(fileName)) { return kFALSE; }
+  FILE* f = fopen(fileName, "rb");
+  if (!f) { return kFALSE; }
+  Bool_t ok = ReadHeader(f);
+  fclose(f);
+  return ok;
+}
+
+//_____________________________________________________________________________
+Bool_t FairPrimaryCache::OpenInput(const char* fileName)
+{
+  fInput = fopen(fileName, "rb");
+  if (fInput && ReadHeader(fInput)) {
+    setvbuf(fInput, NULL, _IOFBF, kFileBuffer);
+    return kTRUE;
+  }
+  LOG(ERROR) << "Could not read the primary cache " << fileName << FairLogger::endl;
+  if (fInput) {
+    fclose(fInput);
+    fInput = 0;
+  }
+  return kFALSE;
+}
+
+//_____________________________________________________________________________
+Bool_t FairPrimaryCache::OpenOutput(const char* fileName)
+{
+  // written to a temporary file which replaces the old one at the end,
+  // a job reading the cache never sees a partly written file
+  fOutputName = fileName;
+  fOutputTmp = Form("%s.%d.tmp", fileName, gSystem->GetPid());
+  fOutput = fopen(fOutputTmp, "wb");
+  if (!fOutput) {
+    LOG(WARNING) << "Could not write the primary cache " << fileName << FairLogger::endl;
+    return kFALSE;
+  }
+  setvbuf(fOutput, NULL, _IOFBF, kFileBuffer);
+  FileHeader header;
+  memcpy(header.fMagic, kMagic, sizeof(kMagic));
+  header.fVersion = kVersion;
+  header.fTrackSize = sizeof(FairPrimaryTrack);
+  fOutputOk = fwrite(&header, sizeof(header), 1, fOutput) == 1;
+  return fOutputOk;
+}
+
+//_____________________________________________________________________________
+void FairPrimaryCache::SetEventSeed(UInt_t seed)
+{
+  fSeed = seed;
+  if (!fRandom) { fRandom = new TRandom3(); }
+}
+
+//_____________________________________________________________________________
+UInt_t FairPrimaryCache::EventSeed(UInt_t seed, Long64_t event)
+{
+  // splitmix64 of seed and event number, TRandom3 takes 0 as "seed from time"
+  ULong64_t x = (static_cast<ULong64_t>(seed) << 32) + static_cast<ULong64_t>(event);
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  x ^= x >> 31;
+  UInt_t eventSeed = static_cast<UInt_t>(x ^ (x >> 32));
+  return eventSeed ? eventSeed : 1;
+}
+
+//_____________________________________________________________________________
+void FairPrimaryCache::StartProducer(Int_t queueSize)
+{
+  if (fThread || !fProducer) { return; }
+  fQueueSize = queueSize > 0 ? queueSize : 1;
+
+  // lazy initialisations which must not run on two threads at once
+  TThread::Initialize();
+  TDatabasePDG::Instance()->GetParticle(211);
+
+  fMutex = new TMutex();
+  fNotEmpty = new TCondition(fMutex);
+  fNotFull = new TCondition(fMutex);
+  fThread = new TThread("FairPrimaryProducer", &FairPrimaryCache::ProducerLoop, this);
+  fThread->Run();
+  LOG(INFO) << "Primaries are generated on a producer thread, up to "
+            << fQueueSize << " events ahead" << FairLogger::endl;
+}
+
+//_____________________________________________________________________________
+void FairPrimaryCache::StopProducer()
+{
+  if (!fThread) { return; }
+  {
+    TLockGuard lock(fMutex);
+    fStop = kTRUE;
+    fNotFull->Broadcast();
+  }
+  fThread->Join();
+  delete fThread;
+  fThread = 0;
+}
+
+//_____________________________________________________________________________
+void* FairPrimaryCache::ProducerLoop(void* arg)
+{
+  static_cast<FairPrimaryCache*>(arg)->RunProducer();
+  return 0;
+}
+
+//_____________________________________________________________________________
+void FairPrimaryCache::RunProducer()
+{
+  for (;;) {
+    FairPrimaryEvent* event = 0;
+    {
+      TLockGuard lock(fMutex);
+      while (!fStop && fQueue.size() >= fQueueSize) { fNotFull->Wait(); }
+      if (fStop) { break; }
+      if (!fFree.empty()) {
+        event = fFree.back();
+        fFree.pop_back();
+      }
+    }
+    if (!event) { event = new FairPrimaryEvent(); }
+
+    Bool_t ok = Produce(*event);
+
+    TLockGuard lock(fMutex);
+    if (ok) {
+      fQueue.push_back(event);
+    } else {
+      delete event;
+      fDone = kTRUE;
+    }
+    fNotEmpty->Signal();
+    if (!ok) { break; }
+  }
+}
+
+//_____________________________________________________________________________
+Bool_t FairPrimaryCache::Produce(FairPrimaryEvent& event)
+{
+  // gRandom belongs to the transport and must not be touched by the
+  // producer thread, the generators draw from GetRandom()
+  TRandom* random = fThread ? 0 : gRandom;
+  if (fRandom) {
+    fRandom->SetSeed(EventSeed(fSeed, fNProduced));
+    fProducer->SetRandom(fRandom);
+    if (!fThread) { gRandom = fRandom; }
+  }
+  static_cast<PrimaryRecorder*>(fRecorder)->Start(&event.fTracks);
+  Bool_t ok = fProducer->MakeEvent(fRecorder);
+  if (fRandom) {
+    fProducer->SetRandom(0);
+    if (!fThread) { gRandom = random; }
+  }
+  if (!ok) { return kFALSE; }
+
+  FairMCEventHeader* header = fProducer->GetEvent();
+  event.fX = header->GetX();
+  event.fY = header->GetY();
+  event.fZ = header->GetZ();
+  event.fT = header->GetT();
+  event.fB = header->GetB();
+  event.fRotX = header->GetRotX();
+  event.fRotY = header->GetRotY();
+  event.fRotZ = header->GetRotZ();
+  event.fEventId = header->GetEventID();
+  event.fIsSet = header->IsSet();
+  fNProduced++;
+  return kTRUE;
+}
+
+//_____________________________________________________________________________
+Bool_t FairPrimaryCache::Read(FairPrimaryEvent& event)
+{
+  EventRecord record;
+  if (fread(&record, sizeof(record), 1, fInput) != 1) { return kFALSE; }
+  event.fX = record.fValues[0];
+  event.fY = record.fValues[1];
+  event.fZ = record.fValues[2];
+  event.fT = record.fValues[3];
+  event.fB = record.fValues[4];
+  event.fRotX = record.fValues[5];
+  event.fRotY = record.fValues[6];
+  event.fRotZ = record.fValues[7];
+  event.fEventId = record.fEventId;
+  event.fIsSet = record.fIsSet;
+  event.fTracks.resize(record.fNTracks);
+  if (record.fNTracks > 0
+      && fread(&event.fTracks[0], sizeof(FairPrimaryTrack), record.fNTracks, fInput)
+      != static_cast<size_t>(record.fNTracks)) {
+    LOG(ERROR) << "Primary cache ends within event " << record.fEventId << FairLogger::endl;
+    return kFALSE;
+  }
+  return kTRUE;
+}
+
+//_____________________________________________________________________________
+void FairPrimaryCache::Write(const FairPrimaryEvent& event)
+{
+  EventRecord record;
+  record.fValues[0] = event.fX;
+  record.fValues[1] = event.fY;
+  record.fValues[2] = event.fZ;
+  record.fValues[3] = event.fT;
+  record.fValues[4] = event.fB;
+  record.fValues[5] = event.fRotX;
+  record.fValues[6] = event.fRotY;
+  record.fValues[7] = event.fRotZ;
+  record.fEventId = event.fEventId;
+  record.fIsSet = event.fIsSet;
+  record.fNTracks = static_cast<Int_t>(event.fTracks.size());
+  record.fReserved = 0;
+  Bool_t ok = fwrite(&record, sizeof(record), 1, fOutput) == 1;
+  if (record.fNTracks > 0) {
+    ok = ok && fwrite(&event.fTracks[0], sizeof(FairPrimaryTrack), record.fNTracks, fOutput)
+         == static_cast<size_t>(record.fNTracks);
+  }
+  fOutputOk = fOutputOk && ok;
+}
+
+//_____________________________________________________________________________
+Bool_t FairPrimaryCache::NextEvent(FairGenericStack* stack, FairMCEventHeader* header, Int_t& nTracks)
+{
+  FairPrimaryEvent* event = 0;
+  if (fThread) {
+    TLockGuard lock(fMutex);
+    while (fQueue.empty() && !fDone) { fNotEmpty->Wait(); }
+    if (!fQueue.empty()) {
+      event = fQueue.front();
+      fQueue.pop_front();
+      fNotFull->Signal();
+    }
+  } else {
+    if (fFree.empty()) {
+      event = new FairPrimaryEvent();
+    } else {
+      event = fFree.back();
+      fFree.pop_back();
+    }
+    Bool_t ok = fInput ? Read(*event) : (fProducer && Produce(*event));
+    if (!ok) {
+      fFree.push_back(event);
+      event = 0;
+    }
+  }
+  if (!event) { return kFALSE; }
+
+  if (fOutput) { Write(*event); }
+
+  header->Reset();
+  header->SetEventID(event->fEventId);
+  header->SetVertex(event->fX, event->fY, event->fZ);
+  header->SetTime(event->fT);
+  header->SetB(event->fB);
+  header->MarkSet(event->fIsSet);
+  header->SetRotX(event->fRotX);
+  header->SetRotY(event->fRotY);
+  header->SetRotZ(event->fRotZ);
+
+  for (size_t i = 0; i < event->fTracks.size(); i++) {
+    const FairPrimaryTrack& t = event->fTracks[i];
+    Int_t ntr = 0;
+    stack->PushTrack(t.fToBeDone, -1, t.fPdg, t.fPx, t.fPy, t.fPz, t.fE,
+                     t.fVx, t.fVy, t.fVz, t.fTime, 0., 0., 0., kPPrimary, ntr,
+                     t.fWeight, t.fStatus, t.fSecondParent);
+  }
+  nTracks = static_cast<Int_t>(event->fTracks.size());
+
+  TLockGuard lock(fMutex);
+  fFree.push_back(event);
+  return kTRUE;
+}
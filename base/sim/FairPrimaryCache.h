@@ -0,0 +1,128 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#ifndef FAIRPRIMARYCACHE_H
+#define FAIRPRIMARYCACHE_H
+
+#include "Rtypes.h"                     // for Int_t, Double_t, etc
+#include "TString.h"                    // for TString
+
+#include <stdio.h>                      // for FILE
+#include <deque>                        // for deque
+#include <vector>                       // for vector
+
+class FairGenericStack;
+class FairMCEventHeader;
+class FairPrimaryGenerator;
+class TCondition;
+class TMutex;
+class TRandom;
+class TThread;
+
+/** Primary track as it is pushed to the stack by FairPrimaryGenerator::AddTrack.
+ ** The polarisation is always 0, the process kPPrimary and the parent -1. */
+struct FairPrimaryTrack {
+  Double_t fPx, fPy, fPz, fE;           // momentum and energy [GeV]
+  Double_t fVx, fVy, fVz;               // start vertex [cm]
+  Double_t fTime;                       // time of flight
+  Double_t fWeight;                     // track weight
+  Int_t fPdg;                           // PDG code
+  Int_t fToBeDone;                      // tracking flag
+  Int_t fStatus;                        // generation status
+  Int_t fSecondParent;                  // second mother, -1 if none
+};
+
+/** Primaries of one event with the generated part of the event header */
+struct FairPrimaryEvent {
+  Double_t fX, fY, fZ, fT, fB;          // vertex, time and impact parameter
+  Double_t fRotX, fRotY, fRotZ;         // event rotation
+  Int_t fEventId;                       // event number
+  Bool_t fIsSet;                        // header flag set by the generators
+  std::vector<FairPrimaryTrack> fTracks;
+};
+
+/**
+ * Primary events of FairPrimaryGenerator generated ahead of the transport.
+ *
+ * The events are produced by a copy of the primary generator, which records
+ * the tracks instead of pushing them to the stack, either on a producer
+ * thread which keeps up to queueSize events ready or on the calling thread.
+ * With an event seed the generators draw event n from a generator seeded
+ * with EventSeed(seed, n) (FairGenerator::GetRandom()), so that the
+ * primaries do not depend on the random numbers used by the transport.
+ * gRandom is replaced by it only on the calling thread; the producer thread
+ * never touches gRandom, which the transport and the tasks use at the same
+ * time, so it runs only generators which do not draw from gRandom.
+ *
+ * The events can be written to a binary cache file. A later job reading the
+ * file replays the same primaries without calling the generators; the file
+ * is only valid for the machine type which wrote it.
+ */
+class FairPrimaryCache
+{
+  public:
+    /** The producer generates the events and is deleted by the cache, its
+     ** generators belong to the primary generator it was copied from. It
+     ** is NULL if the events are only read from a cache file. */
+    explicit FairPrimaryCache(FairPrimaryGenerator* producer);
+    /** Stops the producer thread and renames a completely written file */
+    ~FairPrimaryCache();
+
+    /** True if the file is a primary cache written on this machine type */
+    static Bool_t IsCacheFile(const char* fileName);
+    /** Replay the events of a cache file */
+    Bool_t OpenInput(const char* fileName);
+    /** Write all events to a cache file */
+    Bool_t OpenOutput(const char* fileName);
+
+    /** Seed each event with EventSeed(seed, event number) */
+    void SetEventSeed(UInt_t seed);
+    /** Generate the events on a producer thread, at most queueSize ahead */
+    void StartProducer(Int_t queueSize);
+
+    /** Push the primaries of the next event to the stack and set the header.
+     ** Returns kFALSE at the end of the cache file or if a generator fails. */
+    Bool_t NextEvent(FairGenericStack* stack, FairMCEventHeader* header, Int_t& nTracks);
+
+    /** Seed of an event, never 0 */
+    static UInt_t EventSeed(UInt_t seed, Long64_t event);
+
+  private:
+    Bool_t Produce(FairPrimaryEvent& event);
+    Bool_t Read(FairPrimaryEvent& event);
+    void Write(const FairPrimaryEvent& event);
+    void RunProducer();
+    void StopProducer();
+    static void* ProducerLoop(void* arg);
+
+    FairPrimaryGenerator* fProducer;    // copy of the primary generator
+    FairGenericStack* fRecorder;        // stack of the producer
+    TRandom* fRandom;                   // per event random generator
+    UInt_t fSeed;                       // event seed
+    Long64_t fNProduced;                // number of generated events
+
+    FILE* fInput;                       // cache file which is replayed
+    FILE* fOutput;                      // cache file which is written
+    TString fOutputName;                // name of the written file
+    TString fOutputTmp;                 // name while it is written
+    Bool_t fOutputOk;                   // no write error so far
+
+    TThread* fThread;                   // producer thread
+    TMutex* fMutex;                     // guards the queues
+    TCondition* fNotEmpty;              // an event was produced
+    TCondition* fNotFull;               // an event was taken
+    size_t fQueueSize;                  // maximum number of ready events
+    std::deque<FairPrimaryEvent*> fQueue; // ready events
+    std::vector<FairPrimaryEvent*> fFree; // events for reuse
+    Bool_t fDone;                       // the producer has stopped
+    Bool_t fStop;                       // the producer has to stop
+
+    FairPrimaryCache(const FairPrimaryCache&);
+    FairPrimaryCache& operator=(const FairPrimaryCache&);
+};
+
+#endif
@@ -12,6 +12,7 @@
 #include "FairGenericStack.h"  // for FairGenericStack
 #include "FairLogger.h"        // for FairLogger, MESSAGE_ORIGIN
 #include "FairMCEventHeader.h" // for FairMCEventHeader
+#include "FairPrimaryCache.h"  // for FairPrimaryCache
 
 #include "TDatabasePDG.h" // for TDatabasePDG
 #include "TF1.h"          // for TF1
@@ -44,7 +45,8 @@ FairPrimaryGenerator::FairPrimaryGenerator()
       fSmearGausVertexXY(kFALSE), fBeamAngle(kFALSE), fEventPlane(kFALSE),
       fStack(NULL), fGenList(new TObjArray()),
       fListIter(fGenList->MakeIterator()), fEvent(NULL), fdoTracking(kTRUE),
-      fMCIndexOffset(0), fEventNr(0) {
+      fMCIndexOffset(0), fEventNr(0), fCacheFile(""), fQueueSize(0),
+      fEventSeed(0), fSeedEvents(kFALSE), fCache(NULL), fRandom(NULL) {
   fTargetZ[0] = 0.;
 }
 // -------------------------------------------------------------------------
@@ -61,7 +63,8 @@ FairPrimaryGenerator::FairPrimaryGenerator(const char *name, const char *title)
       fSmearGausVertexXY(kFALSE), fBeamAngle(kFALSE), fEventPlane(kFALSE),
       fStack(NULL), fGenList(new TObjArray()),
       fListIter(fGenList->MakeIterator()), fEvent(NULL), fdoTracking(kTRUE),
-      fMCIndexOffset(0), fEventNr(0) {
+      fMCIndexOffset(0), fEventNr(0), fCacheFile(""), fQueueSize(0),
+      fEventSeed(0), fSeedEvents(kFALSE), fCache(NULL), fRandom(NULL) {
   fTargetZ[0] = 0.;
 }
 
@@ -74,15 +77,19 @@ FairPrimaryGenerator::FairPrimaryGenerator(const FairPrimaryGenerator &rhs)
       fBeamAngleSigmaX(rhs.fBeamAngleSigmaX), fBeamAngleSigmaY(rhs.fBeamAngleSigmaY),
       fBeamDirection(rhs.fBeamDirection),
       fPhiMin(rhs.fPhiMin), fPhiMax(rhs.fPhiMax), fPhi(rhs.fPhi),
-      fTargetZ(new Double_t[1]), fNrTargets(rhs.fNrTargets),
+      fTargetZ(new Double_t[rhs.fNrTargets]), fNrTargets(rhs.fNrTargets),
       fTargetDz(rhs.fTargetDz), fVertex(rhs.fVertex), fNTracks(rhs.fNTracks),
       fSmearVertexZ(rhs.fSmearVertexZ), fSmearGausVertexZ(rhs.fSmearGausVertexZ),
       fSmearVertexXY(rhs.fSmearVertexXY), fSmearGausVertexXY(rhs.fSmearGausVertexXY),
       fBeamAngle(rhs.fBeamAngle), fEventPlane(rhs.fEventPlane),
       fStack(NULL), fGenList(new TObjArray()),
       fListIter(fGenList->MakeIterator()), fEvent(NULL), fdoTracking(rhs.fdoTracking),
-      fMCIndexOffset(rhs.fMCIndexOffset), fEventNr(rhs.fEventNr) {
-  fTargetZ[0] = rhs.fTargetZ[0];
+      fMCIndexOffset(rhs.fMCIndexOffset), fEventNr(rhs.fEventNr),
+      fCacheFile(""), fQueueSize(0), fEventSeed(0), fSeedEvents(kFALSE),
+      fCache(NULL), fRandom(NULL) {
+  for (Int_t i = 0; i < fNrTargets; i++) {
+    fTargetZ[i] = rhs.fTargetZ[i];
+  }
 }
 
 // -------------------------------------------------------------------------
@@ -94,13 +101,46 @@ Bool_t FairPrimaryGenerator::Init() {
       gen->Init();
     }
   }
+  CheckProducerThread();
   return kTRUE;
 }
 
+// -----   Protected method CheckProducerThread ----------------------------
+void FairPrimaryGenerator::CheckProducerThread() {
+  if (fQueueSize <= 0) {
+    return;
+  }
+  // the producer thread cannot get a gRandom of its own, generators which
+  // draw from it would share it with the transport
+  for (Int_t i = 0; i < fGenList->GetEntriesFast(); i++) {
+    FairGenerator *gen = static_cast<FairGenerator *>(fGenList->At(i));
+    if (gen && gen->UsesGlobalRandom()) {
+      LOG(ERROR) << "Generator " << gen->GetName()
+                 << " draws from gRandom, the primaries are generated "
+                    "without producer thread" << FairLogger::endl;
+      fQueueSize = 0;
+      return;
+    }
+  }
+}
+
+// -----   Public method SetRandom   ---------------------------------------
+void FairPrimaryGenerator::SetRandom(TRandom *random) {
+  fRandom = random;
+  for (Int_t i = 0; i < fGenList->GetEntriesFast(); i++) {
+    FairGenerator *gen = dynamic_cast<FairGenerator *>(fGenList->At(i));
+    if (gen) {
+      gen->SetRandom(random);
+    }
+  }
+}
+
 // -----   Destructor   ----------------------------------------------------
 FairPrimaryGenerator::~FairPrimaryGenerator() {
   //  cout<<"Enter Destructor of FairPrimaryGenerator"<<endl;
   // the stack is deleted by FairMCApplication
+  // the producer of the cache shares the generators
+  delete fCache;
   if (1 == fNrTargets) {
     delete fTargetZ;
   } else {
@@ -138,7 +178,7 @@ FairPrimaryGenerator& FairPrimaryGenerator::operator=(const FairPrimaryGenerator
     fPhiMin = rhs.fPhiMin;
     fPhiMax = rhs.fPhiMax;
     fPhi = rhs.fPhi;
-    fTargetZ = new Double_t[1];
+    fTargetZ = new Double_t[rhs.fNrTargets];
     fNrTargets = rhs.fNrTargets;
     fTargetDz = rhs.fTargetDz;
     fVertex = rhs.fVertex;
@@ -156,7 +196,15 @@ FairPrimaryGenerator& FairPrimaryGenerator::operator=(const FairPrimaryGenerator
     fdoTracking = rhs.fdoTracking;
     fMCIndexOffset = rhs.fMCIndexOffset;
     fEventNr = rhs.fEventNr;
-    fTargetZ[0] = rhs.fTargetZ[0];
+    for (Int_t i = 0; i < fNrTargets; i++) {
+      fTargetZ[i] = rhs.fTargetZ[i];
+    }
+    fCacheFile = "";
+    fQueueSize = 0;
+    fEventSeed = 0;
+    fSeedEvents = kFALSE;
+    fCache = NULL;
+    fRandom = NULL;
   }
   
   return *this;
@@ -169,69 +217,129 @@ Bool_t FairPrimaryGenerator::GenerateEvent(FairGenericStack *pStack) {
   if (!fEvent) {
     LOG(FATAL) << "No MCEventHeader branch!" << FairLogger::endl;
     return kFALSE;
-  } else {
+  }
 
-    // Initialise
+  if (fCacheFile.IsNull() && 0 == fQueueSize && !fSeedEvents) {
+    if (!MakeEvent(pStack)) {
+      return kFALSE;
+    }
+  } else {
+    if (!fCache) {
+      InitCache();
+    }
     fStack = pStack;
-    fNTracks = 0;
-    fEvent->Reset();
-
-    // Create event vertex
-    MakeVertex();
-    fEvent->SetVertex(fVertex);
-
-    // Create beam angle
-    // Here we only randomly generate two angles (anglex, angley)
-    // for the event and later on (in AddTrack())
-    // all our particles will be rotated accordingly.
-    if (fBeamAngle) {
-      MakeBeamAngle();
+    if (!fCache->NextEvent(pStack, fEvent, fNTracks)) {
+      return kFALSE;
     }
+  }
 
-    // Create event plane
-    // Randomly generate an angle by which each track added (in AddTrack())
-    // to the event is rotated around the z-axis
-    if (fEventPlane) {
-      MakeEventPlane();
-    }
+  fTotPrim += fNTracks;
+  // Screen output
+  LOG(DEBUG) << "(Event " << fEvent->GetEventID() << ") " << fNTracks
+             << " primary tracks from vertex (" << fEvent->GetX() << ", "
+             << fEvent->GetY() << ", " << fEvent->GetZ() << ") with beam angle ("
+             << fEvent->GetRotX() << ", " << fEvent->GetRotY() << ") " << FairLogger::endl;
 
-    // Call the ReadEvent methods from all registered generators
-    fListIter->Reset();
-    TObject *obj = 0;
-    FairGenerator *gen = 0;
-    while ((obj = fListIter->Next())) {
-      gen = dynamic_cast<FairGenerator *>(obj);
-      if (!gen) {
-        return kFALSE;
-      }
-      const char *genName = gen->GetName();
-      fMCIndexOffset = fNTracks; // number tracks before generator is called
-      Bool_t test = gen->ReadEvent(this);
-      if (!test) {
-        LOG(ERROR) << "ReadEvent failed for generator " << genName
-                   << FairLogger::endl;
-        return kFALSE;
-      }
+  fEvent->SetNPrim(fNTracks);
+
+  return kTRUE;
+}
+// -------------------------------------------------------------------------
+
+// -----   Protected method MakeEvent   ------------------------------------
+Bool_t FairPrimaryGenerator::MakeEvent(FairGenericStack *pStack) {
+  // Initialise
+  fStack = pStack;
+  fNTracks = 0;
+  fEvent->Reset();
+
+  // Create event vertex
+  MakeVertex();
+  fEvent->SetVertex(fVertex);
+
+  // Create beam angle
+  // Here we only randomly generate two angles (anglex, angley)
+  // for the event and later on (in AddTrack())
+  // all our particles will be rotated accordingly.
+  if (fBeamAngle) {
+    MakeBeamAngle();
+  }
+
+  // Create event plane
+  // Randomly generate an angle by which each track added (in AddTrack())
+  // to the event is rotated around the z-axis
+  if (fEventPlane) {
+    MakeEventPlane();
+  }
+
+  // Call the ReadEvent methods from all registered generators
+  fListIter->Reset();
+  TObject *obj = 0;
+  FairGenerator *gen = 0;
+  while ((obj = fListIter->Next())) {
+    gen = dynamic_cast<FairGenerator *>(obj);
+    if (!gen) {
+      return kFALSE;
+    }
+    const char *genName = gen->GetName();
+    fMCIndexOffset = fNTracks; // number tracks before generator is called
+    Bool_t test = gen->ReadEvent(this);
+    if (!test) {
+      LOG(ERROR) << "ReadEvent failed for generator " << genName
+                 << FairLogger::endl;
+      return kFALSE;
     }
+  }
 
-  
-    fTotPrim += fNTracks;
-    // Screen output
+  // Set the event number if not set already by one of the dedicated generators
+  if (-1 == fEvent->GetEventID()) {
+    fEventNr++;
+    fEvent->SetEventID(fEventNr);
+  }
 
-    // Set the event number if not set already by one of the dedicated generators
-    if (-1 == fEvent->GetEventID()) {
-      fEventNr++;
-      fEvent->SetEventID(fEventNr);
+  return kTRUE;
+}
+// -------------------------------------------------------------------------
+
+// -----   Protected method InitCache   ------------------------------------
+void FairPrimaryGenerator::InitCache() {
+  if (!fCacheFile.IsNull() && FairPrimaryCache::IsCacheFile(fCacheFile)) {
+    fCache = new FairPrimaryCache(NULL);
+    if (fCache->OpenInput(fCacheFile)) {
+      LOG(INFO) << "Primaries are replayed from cache " << fCacheFile
+                << FairLogger::endl;
     }
-    LOG(DEBUG) << "(Event " << fEvent->GetEventID() << ") " << fNTracks
-               << " primary tracks from vertex (" << fVertex.X() << ", "
-               << fVertex.Y() << ", " << fVertex.Z() << ") with beam angle ("
-               << fBeamAngleX << ", " << fBeamAngleY << ") " << FairLogger::endl;
+    return;
+  }
 
-    fEvent->SetNPrim(fNTracks);
+  // the producer works on its own copy of the settings and of the event
+  // header, the generators are shared
+  CheckProducerThread();
+  FairPrimaryGenerator *producer = new FairPrimaryGenerator(*this);
+  for (Int_t i = 0; i < fGenList->GetEntriesFast(); i++) {
+    producer->AddGenerator(static_cast<FairGenerator *>(fGenList->At(i)));
+  }
+  producer->SetEvent(static_cast<FairMCEventHeader *>(fEvent->Clone()));
 
-    return kTRUE;
+  fCache = new FairPrimaryCache(producer);
+  if (!fCacheFile.IsNull()) {
+    fCache->OpenOutput(fCacheFile);
   }
+  if (fSeedEvents) {
+    fCache->SetEventSeed(fEventSeed);
+  } else if (fQueueSize > 0) {
+    fCache->SetEventSeed(gRandom->Integer(kMaxUInt));
+  }
+  if (fQueueSize > 0) {
+    fCache->StartProducer(fQueueSize);
+  }
+}
+// -------------------------------------------------------------------------
+
+// -----   Public method CloseCache   --------------------------------------
+void FairPrimaryGenerator::CloseCache() {
+  delete fCache;
+  fCache = NULL;
 }
 // -------------------------------------------------------------------------
 
@@ -267,7 +375,7 @@ void FairPrimaryGenerator::AddTrack(Int_t pdgid, Double_t px_raw,
 
   // ---> Convert K0 and AntiK0 into K0s and K0L
   if (pdgid == 311 || pdgid == -311) {
-    Double_t test = gRandom->Uniform(0., 1.);
+    Double_t test = GetRandom()->Uniform(0., 1.);
     if (test >= 0.5) {
       pdgid = 310;
     } // K0S
@@ -410,32 +518,32 @@ void FairPrimaryGenerator::MakeVertex() {
   if (1 == fNrTargets) {
     vz = fTargetZ[0];
   } else {
-    Int_t Target = (Int_t)gRandom->Uniform(fNrTargets);
+    Int_t Target = (Int_t)GetRandom()->Uniform(fNrTargets);
     vz = fTargetZ[Target];
   }
 
   if (fSmearVertexZ)
-    vz = gRandom->Uniform(vz - fTargetDz / 2., vz + fTargetDz / 2.);
+    vz = GetRandom()->Uniform(vz - fTargetDz / 2., vz + fTargetDz / 2.);
 
   if (fSmearGausVertexZ) {
-    vz = gRandom->Gaus(vz, fTargetDz);
+    vz = GetRandom()->Gaus(vz, fTargetDz);
   }
 
   if (fSmearGausVertexXY) {
     if (fBeamSigmaX != 0.) {
-      vx = gRandom->Gaus(fBeamX0, fBeamSigmaX);
+      vx = GetRandom()->Gaus(fBeamX0, fBeamSigmaX);
     }
     if (fBeamSigmaY != 0.) {
-      vy = gRandom->Gaus(fBeamY0, fBeamSigmaY);
+      vy = GetRandom()->Gaus(fBeamY0, fBeamSigmaY);
     }
   }
 
   if (fSmearVertexXY) {
     if (fBeamSigmaX != 0.) {
-      vx = gRandom->Uniform(vx - fBeamSigmaX / 2., vx + fBeamSigmaX / 2.);
+      vx = GetRandom()->Uniform(vx - fBeamSigmaX / 2., vx + fBeamSigmaX / 2.);
     }
     if (fBeamSigmaY != 0.) {
-      vy = gRandom->Uniform(vy - fBeamSigmaY / 2., vy + fBeamSigmaY / 2.);
+      vy = GetRandom()->Uniform(vy - fBeamSigmaY / 2., vy + fBeamSigmaY / 2.);
     }
   }
 
@@ -445,8 +553,8 @@ void FairPrimaryGenerator::MakeVertex() {
 
 // -----   Private method MakeBeamAngle   -------------------------------
 void FairPrimaryGenerator::MakeBeamAngle() {
-  fBeamAngleX = gRandom->Gaus(fBeamAngleX0, fBeamAngleSigmaX);
-  fBeamAngleY = gRandom->Gaus(fBeamAngleY0, fBeamAngleSigmaY);
+  fBeamAngleX = GetRandom()->Gaus(fBeamAngleX0, fBeamAngleSigmaX);
+  fBeamAngleY = GetRandom()->Gaus(fBeamAngleY0, fBeamAngleSigmaY);
   fBeamDirection.SetXYZ(TMath::Tan(fBeamAngleX), TMath::Tan(fBeamAngleY), 1.);
   fEvent->SetRotX(fBeamAngleX);
   fEvent->SetRotY(fBeamAngleY);
@@ -455,7 +563,7 @@ void FairPrimaryGenerator::MakeBeamAngle() {
 
 // -----   Private method MakeEventPlane   -------------------------------
 void FairPrimaryGenerator::MakeEventPlane() {
-  fPhi = gRandom->Uniform(fPhiMin, fPhiMax);
+  fPhi = GetRandom()->Uniform(fPhiMin, fPhiMax);
   fEvent->SetRotZ(fPhi);
 }
 // -------------------------------------------------------------------------
@@ -30,12 +30,14 @@ the tracking from the macro (M. Al-Turany)
 #include "Riosfwd.h"   // for ostream
 #include "Rtypes.h"    // for Double_t, Bool_t, Int_t, etc
 #include "TObjArray.h" // for TObjArray
+#include "TString.h"   // for TString
 #include "TVector3.h"  // for TVector3
 
 #include <iostream> // for operator<<, basic_ostream, etc
 
 class FairGenericStack;
 class FairMCEventHeader;
+class FairPrimaryCache;
 class TF1;
 class TIterator;
 
@@ -152,12 +154,58 @@ public:
 
   Int_t GetTotPrimary() { return fTotPrim; }
 
+  /** Replay the primaries from a primary cache file if there is one,
+      otherwise write the generated primaries to it (see FairPrimaryCache).
+      The cache file is only completed by CloseCache. **/
+  void SetPrimaryCache(const char *fileName) { fCacheFile = fileName; }
+
+  /** Generate the primaries on a producer thread, up to queueSize events
+      ahead of the transport. The events are seeded as with SetEventSeed,
+      with a seed from gRandom if none is set. The producer never uses
+      gRandom, which belongs to the transport: all generators have to draw
+      from FairGenerator::GetRandom() (see FairGenerator::UsesGlobalRandom),
+      otherwise Init falls back to generating on the transport thread.
+      Only for sequential runs, not in MT mode. **/
+  void SetProducerThread(Int_t queueSize = 16) { fQueueSize = queueSize; }
+
+  /** Seed each event with a generator seeded from seed and the event
+      number, so that the primaries do not depend on the transport. The
+      generators get it by GetRandom(); without producer thread it also
+      replaces gRandom while the event is generated. **/
+  void SetEventSeed(UInt_t seed) {
+    fEventSeed = seed;
+    fSeedEvents = kTRUE;
+  }
+
+  /** Stop the producer thread and complete the primary cache file,
+      called by FairMCApplication at the end of the run **/
+  void CloseCache();
+
+  /** Random generator for the vertex, beam angle and event plane: the per
+      event generator if one is set, gRandom otherwise **/
+  TRandom *GetRandom() const { return fRandom ? fRandom : gRandom; }
+  /** Set the per event random generator of this and of all generators,
+      NULL for gRandom **/
+  void SetRandom(TRandom *random);
+
 protected:
   /**  Copy constructor */
   FairPrimaryGenerator(const FairPrimaryGenerator&);
   /**  Assignment operator */
   FairPrimaryGenerator &operator=(const FairPrimaryGenerator&);
 
+  friend class FairPrimaryCache;
+
+  /** Generates the vertex and calls the ReadEvent methods of the
+      generators, GenerateEvent without the cache **/
+  Bool_t MakeEvent(FairGenericStack *pStack);
+
+  /** Create the cache at the first event **/
+  void InitCache();
+
+  /** Switch off the producer thread if a generator draws from gRandom **/
+  void CheckProducerThread();
+
   /**  Nominal beam position at target in x [cm] */
   Double_t fBeamX0;
   /** Nominal beam position at target in y [cm]*/
@@ -235,6 +283,19 @@ protected:
    **/
   Int_t fEventNr;
 
+  /** Primary cache file */
+  TString fCacheFile; //!
+  /** Number of events generated ahead, 0 without producer thread */
+  Int_t fQueueSize; //!
+  /** Seed of the per event random generator */
+  UInt_t fEventSeed; //!
+  /** Flag for per event seeding */
+  Bool_t fSeedEvents; //!
+  /** Producer and cache of the primaries, NULL if not used */
+  FairPrimaryCache *fCache; //!
+  /** Per event random generator, NULL for gRandom */
+  TRandom *fRandom; //!
+
   /** Private method MakeVertex. If vertex smearing in xy is switched on,
       the event vertex is smeared Gaussianlike in x and y direction
       according to the mean beam positions and widths set by the
@@ -264,7 +325,7 @@ protected:
   **/
   void MakeEventPlane();
 
-  ClassDef(FairPrimaryGenerator, 5);
+  ClassDef(FairPrimaryGenerator, 6);
 };
 
 #endif
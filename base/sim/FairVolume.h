@@ -76,12 +76,12 @@ class FairVolume : public TNamed
     Int_t fCopyNo;         /**Volume Copy No*/
     Int_t fMotherId; /**Mother Volume Id*/
     Int_t fMotherCopyNo;   /**Mother Volume Copy No*/
-    FairDetector* fDetector; /** The Detector which will proccess the hits for this volume*/
-    FairModule*   fModule;    /**The Module in which the volume is */
+    FairDetector* fDetector; //! /** The Detector which will proccess the hits for this volume*/
+    FairModule*   fModule;   //! /**The Module in which the volume is */
     FairGeoNode*  fNode;     /**Node corresponding to this volume*/
     
 
-    ClassDef(FairVolume,2) // Volume Definition
+    ClassDef(FairVolume,3) // Volume Definition
 
 };
 
@@ -15,17 +15,24 @@
 #include "FairVolume.h"                 // for FairVolume
 #include "FairLogger.h"                 // for logging
 
+#include "TExMap.h"                     // for TExMap
+#include "THashTable.h"                 // for THashTable
+
 //_____________________________________________________________________________
 
 FairVolumeList::FairVolumeList()
   :TObject(),
-   fData(new TObjArray())
+   fData(new TObjArray()),
+   fNameIndex(new THashTable(TCollection::kInitHashTableCapacity, 2)),
+   fNodeIndex(new TExMap())
 {
 }
 
 //_____________________________________________________________________________
 FairVolumeList::~FairVolumeList()
 {
+  delete fNameIndex;
+  delete fNodeIndex;
   if (fData) {
     fData->Delete();
     delete fData;
@@ -62,18 +69,18 @@ Int_t FairVolumeList::getVolumeId(TString* name)
 //_____________________________________________________________________________
 FairVolume* FairVolumeList::findObject(TString name)
 {
-  FairVolume* obj = NULL;
+  return static_cast<FairVolume*>(fNameIndex->FindObject(name.Data()));
+}
 
-  for (int i = 0; i < fData->GetEntriesFast(); i++) {
-    obj = static_cast<FairVolume*>(fData->At(i));
-    if (obj) {
-      if (obj->GetName() == name) { 
-	return static_cast<FairVolume*>(obj); 
-      }
-    }
-  }
+//_____________________________________________________________________________
+FairVolume* FairVolumeList::findVolume(FairGeoNode* node)
+{
+  if (!node) { return NULL; }
+
+  ULong64_t key = reinterpret_cast<ULong64_t>(node);
+  Long64_t pos = fNodeIndex->GetValue(key, key);
 
-  return NULL;
+  return pos > 0 ? static_cast<FairVolume*>(fData->At(pos-1)) : NULL;
 }
 
 //_____________________________________________________________________________
@@ -89,6 +96,14 @@ void FairVolumeList::addVolume(FairVolume* elem)
 	       << FairLogger::endl; 
   } else {
     fData->Add(elem);
+    fNameIndex->Add(elem);
+    FairGeoNode* node = elem->getGeoNode();
+    if (node) {
+      ULong64_t key = reinterpret_cast<ULong64_t>(node);
+      if (!fNodeIndex->GetValue(key, key)) {
+        fNodeIndex->Add(key, key, fData->GetLast()+1);
+      }
+    }
   }
 }
 
@@ -15,6 +15,9 @@
 #include "TString.h"                    // for TString
 
 class FairVolume;
+class FairGeoNode;
+class THashTable;
+class TExMap;
 
 /**
 * This Object is only used for internal book keeping!
@@ -27,6 +30,8 @@ class FairVolumeList : public TObject
 {
   private:
     TObjArray* fData;
+    THashTable* fNameIndex; //! volumes hashed by name
+    TExMap* fNodeIndex;     //! geo node pointer -> position in fData + 1
     FairVolumeList(const FairVolumeList&);
     FairVolumeList& operator=(const FairVolumeList&);
 
@@ -38,12 +43,14 @@ class FairVolumeList : public TObject
     Int_t getVolumeId( TString* name );
 
     FairVolume* findObject( TString name );
+    /** volume which had the given geo node when it was added, NULL if none */
+    FairVolume* findVolume( FairGeoNode* node );
     void addVolume( FairVolume* elem);
 
     Int_t getEntries () { return fData->GetEntries();}
     FairVolume* At(Int_t pos ) { return ( (FairVolume*) fData->At(pos)); }
 
-    ClassDef(FairVolumeList,1) // Volume List
+    ClassDef(FairVolumeList,2) // Volume List
 };
 
 #endif //FAIR_VOLUMELIST_H
@@ -0,0 +1,281 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#include "FairAsyncWriter.h"
+
+#include "FairLogger.h"                 // for FairLogger, MESSAGE_ORIGIN
+#include "FairOutputTuner.h"            // for FairOutputTuner
+
+#include "RVersion.h"                   // for ROOT_VERSION_CODE
+#include "TBranch.h"                    // for TBranch
+#include "TBufferFile.h"                // for TBufferFile
+#include "TClass.h"                     // for TClass
+#include "TClonesArray.h"               // for TClonesArray
+#include "TCondition.h"                 // for TCondition
+#include "TMutex.h"                     // for TMutex
+#include "TObjArray.h"                  // for TObjArray
+#include "TROOT.h"                      // for ROOT::EnableThreadSafety
+#include "TStopwatch.h"                 // for TStopwatch
+#include "TThread.h"                    // for TThread
+#include "TTree.h"                      // for TTree
+#include "TVirtualMutex.h"              // for TLockGuard
+
+#include <algorithm>                    // for swap
+
+namespace
+{
+/** Access to the storage of a TClonesArray */
+class ClonesStorage : public TClonesArray
+{
+  public:
+    static void Swap(TClonesArray* a, TClonesArray* b) {
+      ClonesStorage* x = static_cast<ClonesStorage*>(a);
+      ClonesStorage* y = static_cast<ClonesStorage*>(b);
+      std::swap(x->fCont, y->fCont);
+      std::swap(x->fKeep, y->fKeep);
+      std::swap(x->fSize, y->fSize);
+      std::swap(x->fLast, y->fLast);
+      std::swap(x->fLowerBound, y->fLowerBound);
+      std::swap(x->fSorted, y->fSorted);
+    }
+};
+}
+
+//_____________________________________________________________________________
+FairAsyncWriter* FairAsyncWriter::Create(TTree* tree, Int_t queueDepth, FairOutputTuner* tuner)
+{
+  std::vector<Slot> slots;
+  TObjArray* branches = tree->GetListOfBranches();
+  for (Int_t i = 0; i < branches->GetEntriesFast(); i++) {
+    TBranch* branch = static_cast<TBranch*>(branches->UncheckedAt(i));
+    // the branches of a tree made from a folder point to the object pointers in the folder
+    void* address = branch->GetAddress();
+    TObject* object = address ? *static_cast<TObject**>(address) : 0;
+    if (!object || !object->IsA()->GetNew()) {
+      LOG(WARNING) << "FairAsyncWriter: branch " << branch->GetName()
+                   << " has no object which can be moved, the tree is filled on the event loop"
+                   << FairLogger::endl;
+      return 0;
+    }
+    Slot slot;
+    slot.fBranch = branch;
+    slot.fAddress = address;
+    slot.fObject = object;
+    slot.fClones = object->InheritsFrom(TClonesArray::Class()) ? static_cast<TClonesArray*>(object) : 0;
+    slots.push_back(slot);
+  }
+  return new FairAsyncWriter(tree, slots, queueDepth, tuner);
+}
+
+//_____________________________________________________________________________
+FairAsyncWriter::FairAsyncWriter(TTree* tree, const std::vector<Slot>& slots, Int_t queueDepth, FairOutputTuner* tuner)
+  : fTree(tree),
+    fTuner(tuner),
+    fSlots(slots),
+    fWriteObjects(slots.size(), 0),
+    fThread(0),
+    fMutex(0),
+    fNotEmpty(0),
+    fNotFull(0),
+    fQueueDepth(queueDepth > 0 ? queueDepth : 1),
+    fQueue(),
+    fFree(),
+    fNBusy(0),
+    fStop(kFALSE),
+    fWaitTime(0.),
+    fFillTime(0.)
+{
+  for (size_t i = 0; i < fSlots.size(); i++) {
+    const Slot& slot = fSlots[i];
+    if (slot.fClones) {
+      fWriteObjects[i] = new TClonesArray(slot.fClones->GetClass());
+    } else {
+      fWriteObjects[i] = static_cast<TObject*>(slot.fObject->IsA()->New());
+    }
+    slot.fBranch->SetAddress(&fWriteObjects[i]);
+  }
+
+  // the tree is filled while the event loop creates and streams objects
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,6,0)
+  ROOT::EnableThreadSafety();
+#else
+  TThread::Initialize();
+#endif
+
+  fMutex = new TMutex();
+  fNotEmpty = new TCondition(fMutex);
+  fNotFull = new TCondition(fMutex);
+  fThread = new TThread("FairAsyncWriter", &FairAsyncWriter::WriterLoop, this);
+  fThread->Run();
+  LOG(INFO) << "The output tree " << fTree->GetName() << " is filled on a writer thread, up to "
+            << fQueueDepth << " events behind" << FairLogger::endl;
+}
+
+//_____________________________________________________________________________
+FairAsyncWriter::~FairAsyncWriter()
+{
+  Stop();
+
+  for (size_t i = 0; i < fFree.size(); i++) {
+    Event* event = fFree[i];
+    for (size_t j = 0; j < fSlots.size(); j++) {
+      if (event->fClones[j]) { event->fClones[j]->Delete(); }
+      delete event->fClones[j];
+      delete event->fBuffers[j];
+    }
+    delete event;
+  }
+  for (size_t i = 0; i < fWriteObjects.size(); i++) {
+    if (fSlots[i].fClones) { static_cast<TClonesArray*>(fWriteObjects[i])->Delete(); }
+    delete fWriteObjects[i];
+  }
+  delete fNotEmpty;
+  delete fNotFull;
+  delete fMutex;
+}
+
+//_____________________________________________________________________________
+FairAsyncWriter::Event* FairAsyncWriter::NewEvent() const
+{
+  Event* event = new Event();
+  event->fClones.resize(fSlots.size(), 0);
+  event->fBuffers.resize(fSlots.size(), 0);
+  for (size_t i = 0; i < fSlots.size(); i++) {
+    if (fSlots[i].fClones) {
+      event->fClones[i] = new TClonesArray(fSlots[i].fClones->GetClass());
+    } else {
+      event->fBuffers[i] = new TBufferFile(TBuffer::kWrite);
+    }
+  }
+  return event;
+}
+
+//_____________________________________________________________________________
+void FairAsyncWriter::Snapshot()
+{
+  Event* event = 0;
+  {
+    TLockGuard lock(fMutex);
+    if (fQueue.size() >= fQueueDepth) {
+      TStopwatch timer;
+      while (fQueue.size() >= fQueueDepth) { fNotFull->Wait(); }
+      fWaitTime += timer.RealTime();
+    }
+    if (!fFree.empty()) {
+      event = fFree.back();
+      fFree.pop_back();
+    }
+  }
+  if (!event) { event = NewEvent(); }
+
+  for (size_t i = 0; i < fSlots.size(); i++) {
+    const Slot& slot = fSlots[i];
+    if (slot.fClones) {
+      // the registered array gets the emptied storage of an event written before
+      SwapStorage(slot.fClones, event->fClones[i]);
+    } else {
+      TBufferFile* buffer = event->fBuffers[i];
+      buffer->SetWriteMode();
+      buffer->Reset();
+      slot.fObject->Streamer(*buffer);
+    }
+  }
+
+  TLockGuard lock(fMutex);
+  fQueue.push_back(event);
+  fNotEmpty->Signal();
+}
+
+//_____________________________________________________________________________
+void FairAsyncWriter::Flush()
+{
+  if (!fThread) { return; }
+  TLockGuard lock(fMutex);
+  while (!fQueue.empty() || fNBusy > 0) { fNotFull->Wait(); }
+}
+
+//_____________________________________________________________________________
+void FairAsyncWriter::Stop()
+{
+  if (!fThread) { return; }
+  {
+    // the writer empties the queue before it stops
+    TLockGuard lock(fMutex);
+    fStop = kTRUE;
+    fNotEmpty->Broadcast();
+  }
+  fThread->Join();
+  delete fThread;
+  fThread = 0;
+
+  for (size_t i = 0; i < fSlots.size(); i++) {
+    fSlots[i].fBranch->SetAddress(fSlots[i].fAddress);
+  }
+  LOG(INFO) << "FairAsyncWriter: " << fTree->GetName() << " filled in " << fFillTime
+            << " s on the writer thread, the event loop waited " << fWaitTime << " s"
+            << FairLogger::endl;
+}
+
+//_____________________________________________________________________________
+void* FairAsyncWriter::WriterLoop(void* arg)
+{
+  static_cast<FairAsyncWriter*>(arg)->RunWriter();
+  return 0;
+}
+
+//_____________________________________________________________________________
+void FairAsyncWriter::RunWriter()
+{
+  for (;;) {
+    Event* event = 0;
+    {
+      TLockGuard lock(fMutex);
+      while (fQueue.empty() && !fStop) { fNotEmpty->Wait(); }
+      if (fQueue.empty()) { break; }
+      event = fQueue.front();
+      fQueue.pop_front();
+      fNBusy++;
+    }
+
+    Write(event);
+
+    TLockGuard lock(fMutex);
+    fFree.push_back(event);
+    fNBusy--;
+    fNotFull->Broadcast();
+  }
+}
+
+//_____________________________________________________________________________
+void FairAsyncWriter::Write(Event* event)
+{
+  TStopwatch timer;
+  for (size_t i = 0; i < fSlots.size(); i++) {
+    if (fSlots[i].fClones) {
+      SwapStorage(static_cast<TClonesArray*>(fWriteObjects[i]), event->fClones[i]);
+    } else {
+      TBufferFile* buffer = event->fBuffers[i];
+      buffer->SetReadMode();
+      buffer->Reset();
+      fWriteObjects[i]->Streamer(*buffer);
+    }
+  }
+  fTree->Fill();
+  if (fTuner) { fTuner->Observe(fTree); }
+  // the storage goes back to a registered array with the next Snapshot(),
+  // its objects may own memory and are destructed
+  for (size_t i = 0; i < fSlots.size(); i++) {
+    if (fSlots[i].fClones) { event->fClones[i]->Delete(); }
+  }
+  fFillTime += timer.RealTime();
+}
+
+//_____________________________________________________________________________
+void FairAsyncWriter::SwapStorage(TClonesArray* a, TClonesArray* b)
+{
+  ClonesStorage::Swap(a, b);
+}
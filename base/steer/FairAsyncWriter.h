@@ -0,0 +1,108 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#ifndef FAIRASYNCWRITER_H
+#define FAIRASYNCWRITER_H
+
+#include "Rtypes.h"                     // for Int_t, Double_t, etc
+
+#include <deque>                        // for deque
+#include <vector>                       // for vector
+
+class FairOutputTuner;
+class TBranch;
+class TBufferFile;
+class TClonesArray;
+class TCondition;
+class TMutex;
+class TObject;
+class TThread;
+class TTree;
+
+/**
+ * Fills an output tree on a writer thread.
+ *
+ * Snapshot() takes the event data out of the objects registered for the
+ * output and hands it to the writer thread, which fills the tree and
+ * compresses the baskets while the event loop continues. The data of a
+ * TClonesArray is moved by swapping its storage with the one of a spare
+ * array. The registered array gets the storage of an event written before,
+ * which the writer thread emptied after the fill, so it is empty after
+ * Snapshot() and keeps its allocated slots. Other objects (e.g. the
+ * event header) are streamed into a buffer and read back on the writer
+ * thread. At most queueDepth events wait for the writer, Snapshot()
+ * blocks while the queue is full.
+ *
+ * The branch addresses of the tree point to the writer's own objects until
+ * Stop() restores them. Only objects on top level branches can be moved,
+ * Create() returns NULL if the tree has other branches.
+ */
+class FairAsyncWriter
+{
+  public:
+    /** The writer for the tree, or NULL if the tree can not be filled asynchronously.
+     ** The tuner, if any, observes the tree after each fill on the writer thread. */
+    static FairAsyncWriter* Create(TTree* tree, Int_t queueDepth, FairOutputTuner* tuner = 0);
+    /** Stops the writer thread */
+    ~FairAsyncWriter();
+
+    /** Hand over the data of the current event to the writer thread */
+    void Snapshot();
+    /** Wait until all events handed over are in the tree */
+    void Flush();
+    /** Flush, stop the thread and restore the branch addresses */
+    void Stop();
+
+    /** Time the event loop waited for a free slot in the queue [s] */
+    Double_t GetWaitTime() const { return fWaitTime; }
+    /** Time the writer thread spent filling the tree [s] */
+    Double_t GetFillTime() const { return fFillTime; }
+
+  private:
+    /** An object on a top level branch */
+    struct Slot {
+      TBranch* fBranch;                 // branch of the object
+      void* fAddress;                   // original address of the branch
+      TObject* fObject;                 // object filled by the tasks
+      TClonesArray* fClones;            // fObject if it is a TClonesArray
+    };
+    /** The data of one event */
+    struct Event {
+      std::vector<TClonesArray*> fClones; // moved storage, per slot
+      std::vector<TBufferFile*> fBuffers; // streamed objects, per slot
+    };
+
+    FairAsyncWriter(TTree* tree, const std::vector<Slot>& slots, Int_t queueDepth, FairOutputTuner* tuner);
+    Event* NewEvent() const;
+    void Write(Event* event);
+    void RunWriter();
+    static void* WriterLoop(void* arg);
+    static void SwapStorage(TClonesArray* a, TClonesArray* b);
+
+    TTree* fTree;                       // output tree
+    FairOutputTuner* fTuner;            // tunes the tree after its first events
+    std::vector<Slot> fSlots;           // objects on the branches
+    std::vector<TObject*> fWriteObjects; // objects read by the branches, per slot
+
+    TThread* fThread;                   // writer thread
+    TMutex* fMutex;                     // guards the queues
+    TCondition* fNotEmpty;              // an event was handed over
+    TCondition* fNotFull;               // an event was written
+    size_t fQueueDepth;                 // maximum number of waiting events
+    std::deque<Event*> fQueue;          // events to write
+    std::vector<Event*> fFree;          // written events for reuse
+    Int_t fNBusy;                       // events taken by the writer
+    Bool_t fStop;                       // the writer has to stop
+
+    Double_t fWaitTime;                 // event loop waiting for the writer
+    Double_t fFillTime;                 // writer thread filling the tree
+
+    FairAsyncWriter(const FairAsyncWriter&);
+    FairAsyncWriter& operator=(const FairAsyncWriter&);
+};
+
+#endif
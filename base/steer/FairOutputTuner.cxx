@@ -0,0 +1,130 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#include "FairOutputTuner.h"
+
+#include "FairLogger.h"                 // for FairLogger, MESSAGE_ORIGIN
+
+#include "RVersion.h"                   // for ROOT_VERSION_CODE
+#include "TBranch.h"                    // for TBranch
+#include "TBranchElement.h"             // for TBranchElement
+#include "TObjArray.h"                  // for TObjArray
+#include "TTree.h"                      // for TTree
+
+#include <algorithm>                    // for max, min
+#include <vector>                       // for vector
+
+namespace
+{
+// ROOT compression settings, 100 * algorithm + level
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,10,0)
+const Int_t kFastCompression = 404;     // LZ4
+#else
+const Int_t kFastCompression = 101;     // zlib
+#endif
+const Int_t kArchiveCompression = 207;  // LZMA
+
+/** all branches of the list and their sub-branches */
+void CollectBranches(TObjArray* list, std::vector<TBranch*>& branches)
+{
+  for (Int_t i = 0; i < list->GetEntriesFast(); i++) {
+    TBranch* branch = static_cast<TBranch*>(list->UncheckedAt(i));
+    branches.push_back(branch);
+    CollectBranches(branch->GetListOfBranches(), branches);
+  }
+}
+}
+
+//_____________________________________________________________________________
+FairOutputTuner::FairOutputTuner(Int_t nEvents)
+  : fNEvents(nEvents > 0 ? nEvents : 1),
+    fClusterSize(30000000),
+    fBasketMemory(100000000),
+    fMinBasket(1024),
+    fMaxBasket(8000000),
+    fProfiles(),
+    fTuned(kFALSE)
+{
+}
+
+//_____________________________________________________________________________
+Bool_t FairOutputTuner::Observe(TTree* tree)
+{
+  if (fTuned || tree->GetEntries() < fNEvents) { return kFALSE; }
+  Tune(tree);
+  return kTRUE;
+}
+
+//_____________________________________________________________________________
+void FairOutputTuner::Tune(TTree* tree)
+{
+  fTuned = kTRUE;
+  Long64_t entries = tree->GetEntries();
+  if (entries <= 0) { return; }
+
+  // the sizes are only counted for baskets which have been written
+  tree->FlushBaskets();
+
+  std::vector<TBranch*> branches;
+  CollectBranches(tree->GetListOfBranches(), branches);
+  std::vector<Double_t> bytesPerEvent(branches.size());
+  Double_t total = 0.;
+  for (size_t i = 0; i < branches.size(); i++) {
+    bytesPerEvent[i] = static_cast<Double_t>(branches[i]->GetTotBytes()) / entries;
+    total += bytesPerEvent[i];
+  }
+  if (total <= 0.) { return; }
+
+  Long64_t clusterBytes = std::min(fClusterSize, fBasketMemory);
+  Long64_t cluster = std::max(static_cast<Long64_t>(clusterBytes / total), static_cast<Long64_t>(1));
+  tree->SetAutoFlush(cluster);
+
+  for (size_t i = 0; i < branches.size(); i++) {
+    // the data of one cluster and the entry offsets
+    Double_t size = 1.05 * bytesPerEvent[i] * cluster + 4. * cluster;
+    Int_t basketSize = static_cast<Int_t>(std::max(std::min(size, static_cast<Double_t>(fMaxBasket)), static_cast<Double_t>(fMinBasket)));
+    branches[i]->SetBasketSize(basketSize);
+    LOG(DEBUG) << "FairOutputTuner: branch " << branches[i]->GetName() << " " << bytesPerEvent[i]
+               << " bytes/event, basket size " << branches[i]->GetBasketSize() << FairLogger::endl;
+  }
+
+  TObjArray* topBranches = tree->GetListOfBranches();
+  for (Int_t i = 0; i < topBranches->GetEntriesFast(); i++) {
+    TBranch* branch = static_cast<TBranch*>(topBranches->UncheckedAt(i));
+    EProfile profile = GetProfile(branch);
+    branch->SetCompressionSettings(GetCompressionSettings(profile));
+    LOG(DEBUG) << "FairOutputTuner: branch " << branch->GetName() << " compression "
+               << (profile == kArchive ? "archive" : "fast") << FairLogger::endl;
+  }
+
+  LOG(INFO) << "FairOutputTuner: " << tree->GetName() << " has " << total << " bytes/event in "
+            << branches.size() << " branches, clusters of " << cluster << " events" << FairLogger::endl;
+}
+
+//_____________________________________________________________________________
+FairOutputTuner::EProfile FairOutputTuner::GetProfile(TBranch* branch) const
+{
+  TString name = branch->GetName();
+  std::map<TString, EProfile>::const_iterator it = fProfiles.find(name);
+  if (it != fProfiles.end()) { return it->second; }
+
+  TString className = branch->GetClassName();
+  if (branch->InheritsFrom(TBranchElement::Class())) {
+    TBranchElement* element = static_cast<TBranchElement*>(branch);
+    if (element->GetClonesName() && element->GetClonesName()[0]) { className = element->GetClonesName(); }
+  }
+  if (name.Contains("MC") || name.Contains("Point") || className.Contains("MC") || className.Contains("Point")) {
+    return kArchive;
+  }
+  return kFast;
+}
+
+//_____________________________________________________________________________
+Int_t FairOutputTuner::GetCompressionSettings(EProfile profile)
+{
+  return profile == kArchive ? kArchiveCompression : kFastCompression;
+}
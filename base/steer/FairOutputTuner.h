@@ -0,0 +1,74 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#ifndef FAIROUTPUTTUNER_H
+#define FAIROUTPUTTUNER_H
+
+#include "Rtypes.h"                     // for Int_t, Long64_t, etc
+#include "TString.h"                    // for TString
+
+#include <map>                          // for map
+
+class TBranch;
+class TTree;
+
+/**
+ * Tunes the layout of an output tree from the data of its first events.
+ *
+ * After the given number of events the tree is flushed and the serialized
+ * size of each branch per event is taken to set
+ *  - the AutoFlush interval, so that a cluster holds about SetClusterSize()
+ *    uncompressed bytes,
+ *  - the basket size of each branch, so that one basket holds the branch's
+ *    data of one cluster (within the basket size limits and the total
+ *    basket memory),
+ *  - the compression of each top level branch: kFast (LZ4, or zlib level 1
+ *    before ROOT 6.10) for data which is read again soon, kArchive (LZMA)
+ *    for Monte Carlo data. Branches with "MC" or "Point" in the branch or
+ *    class name are kArchive, the others kFast, unless set with SetProfile().
+ * The baskets written before keep their settings.
+ */
+class FairOutputTuner
+{
+  public:
+    enum EProfile { kFast, kArchive };
+
+    /** Tune after nEvents entries */
+    explicit FairOutputTuner(Int_t nEvents = 100);
+
+    /** Compression profile of a top level branch, overriding the default */
+    void SetProfile(const char* branchName, EProfile profile) { fProfiles[branchName] = profile; }
+    /** Uncompressed bytes per cluster (default 30 MB) */
+    void SetClusterSize(Long64_t bytes) { fClusterSize = bytes; }
+    /** Memory of the baskets of all branches (default 100 MB) */
+    void SetBasketMemory(Long64_t bytes) { fBasketMemory = bytes; }
+    /** Limits of the basket size of a branch (default 1 kB to 8 MB) */
+    void SetBasketSizeLimits(Int_t min, Int_t max) { fMinBasket = min; fMaxBasket = max; }
+
+    /** To be called after each Fill() of the tree, tunes it once it has the number of events.
+     ** Returns kTRUE when the tree was tuned. */
+    Bool_t Observe(TTree* tree);
+    /** Tune the tree from the entries filled so far */
+    void Tune(TTree* tree);
+    Bool_t IsTuned() const { return fTuned; }
+
+    /** Compression profile of a top level branch */
+    EProfile GetProfile(TBranch* branch) const;
+    /** ROOT compression settings (100 * algorithm + level) of a profile */
+    static Int_t GetCompressionSettings(EProfile profile);
+
+  private:
+    Int_t fNEvents;                     // events to observe
+    Long64_t fClusterSize;              // uncompressed bytes per cluster
+    Long64_t fBasketMemory;             // memory of all baskets
+    Int_t fMinBasket;                   // smallest basket size
+    Int_t fMaxBasket;                   // largest basket size
+    std::map<TString, EProfile> fProfiles; // profiles set by the user
+    Bool_t fTuned;                      // the tree has been tuned
+};
+
+#endif
@@ -13,15 +13,45 @@
 
 
 #include <iostream>
+#include <limits>
 #include "FairRadGridManager.h"
 #include "FairRootManager.h"
+#include "TH2.h"
 #include "TLorentzVector.h"
+#include "TMath.h"
 #include "TParticle.h"
 #include "TVirtualMC.h"
 #include "FairMesh.h"
 
 using namespace std;
 
+namespace
+{
+// histograms of a mesh, in the order of fBins and fStats
+enum { kTID = 0, kFluence = 1, kSEU = 2, kNEstimators = 3 };
+// entries and the 7 sums of TH1::GetStats for a 2D histogram
+const Int_t kNStats = 8;
+// cells per axis of the mesh grid
+const Int_t kMaxCells = 32;
+
+/** bin as TAxis::FindBin for fixed bins */
+inline Int_t FindBin(Double_t x, Double_t xmin, Double_t xmax, Int_t n)
+{
+  if (x < xmin) { return 0; }
+  if (!(x < xmax)) { return n + 1; }
+  return 1 + Int_t(n * (x - xmin) / (xmax - xmin));
+}
+
+TH2D* MeshHisto(FairMesh* aMesh, Int_t estimator)
+{
+  switch (estimator) {
+    case kTID: return aMesh->GetMeshTid();
+    case kFluence: return aMesh->GetMeshFlu();
+    default: return aMesh->GetMeshSEU();
+  }
+}
+}
+
 ClassImp(FairRadGridManager)
 
 FairRadGridManager* FairRadGridManager::fgInstance = NULL;
@@ -51,7 +81,12 @@ FairRadGridManager::FairRadGridManager()
     fRadl(0),
     fAbsl(0),
     fEstimator(0),
-    fMeshList(NULL)
+    fMeshList(NULL),
+    fScores(),
+    fBins(),
+    fStats(),
+    fCellStart(),
+    fCellMeshes()
 {
   /** radiation length default ctor */
   if(NULL == fgInstance) {
@@ -77,55 +112,202 @@ void FairRadGridManager::Reset()
   //  fMesh->Reset();
 }
 
+void FairRadGridManager::BuildIndex()
+{
+  fScores.clear();
+  Long64_t nBins = 0;
+  for (Int_t i = 0; i < 3; i++) {
+    fGridMin[i] = numeric_limits<Double_t>::max();
+    fGridMax[i] = -numeric_limits<Double_t>::max();
+  }
+  for (Int_t i = 0; fMeshList && i < fMeshList->GetEntriesFast(); i++) {
+    FairMesh* aMesh = dynamic_cast<FairMesh*>(fMeshList->At(i));
+    if (!aMesh || !aMesh->GetMeshTid()) { continue; }
+    MeshScore m;
+    m.fMesh = aMesh;
+    m.fXmin = aMesh->GetXmin();
+    m.fXmax = aMesh->GetXmax();
+    m.fYmin = aMesh->GetYmin();
+    m.fYmax = aMesh->GetYmax();
+    m.fZmin = aMesh->GetZmin();
+    m.fZmax = aMesh->GetZmax();
+    m.fBinVolume = aMesh->GetBinVolume();
+    m.fDiag = aMesh->GetDiag();
+    m.fNx = aMesh->GetMeshTid()->GetNbinsX();
+    m.fNy = aMesh->GetMeshTid()->GetNbinsY();
+    m.fOffset = nBins;
+    nBins += kNEstimators * (m.fNx + 2) * (m.fNy + 2);
+    fScores.push_back(m);
+
+    fGridMin[0] = TMath::Min(fGridMin[0], m.fXmin);
+    fGridMax[0] = TMath::Max(fGridMax[0], m.fXmax);
+    fGridMin[1] = TMath::Min(fGridMin[1], m.fYmin);
+    fGridMax[1] = TMath::Max(fGridMax[1], m.fYmax);
+    fGridMin[2] = TMath::Min(fGridMin[2], m.fZmin);
+    fGridMax[2] = TMath::Max(fGridMax[2], m.fZmax);
+  }
+  fBins.assign(2 * nBins, 0.);
+  fStats.assign(fScores.size() * kNEstimators * kNStats, 0.);
+
+  // about as many cells per axis as meshes
+  Int_t nMeshes = fScores.size();
+  Int_t nCells = 1;
+  for (Int_t i = 0; i < 3; i++) {
+    Double_t width = fGridMax[i] - fGridMin[i];
+    fGridN[i] = (width > 0.) ? TMath::Min(kMaxCells, TMath::Max(1, nMeshes)) : 1;
+    fGridInv[i] = (width > 0.) ? fGridN[i] / width : 0.;
+    nCells *= fGridN[i];
+  }
+
+  // lists of the meshes overlapping each cell, in the order of the mesh list
+  fCellStart.assign(nCells + 1, 0);
+  fCellMeshes.clear();
+  for (Int_t pass = 0; pass < 2; pass++) {
+    if (pass == 1) {
+      for (Int_t c = 0; c < nCells; c++) { fCellStart[c+1] += fCellStart[c]; }
+      fCellMeshes.resize(fCellStart[nCells]);
+    }
+    vector<Int_t> next(fCellStart.begin(), fCellStart.end() - 1);
+    for (Int_t k = 0; k < nMeshes; k++) {
+      const MeshScore& m = fScores[k];
+      for (Int_t iz = Cell(m.fZmin, 2); iz <= Cell(m.fZmax, 2); iz++) {
+        for (Int_t iy = Cell(m.fYmin, 1); iy <= Cell(m.fYmax, 1); iy++) {
+          for (Int_t ix = Cell(m.fXmin, 0); ix <= Cell(m.fXmax, 0); ix++) {
+            Int_t c = (iz * fGridN[1] + iy) * fGridN[0] + ix;
+            if (pass == 0) {
+              fCellStart[c+1]++;
+            } else {
+              fCellMeshes[next[c]++] = k;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+Int_t FairRadGridManager::Cell(Double_t x, Int_t axis) const
+{
+  Int_t c = Int_t((x - fGridMin[axis]) * fGridInv[axis]);
+  return TMath::Max(0, TMath::Min(c, fGridN[axis] - 1));
+}
+
+void FairRadGridManager::Score(Int_t mesh, Int_t estimator, Double_t x, Double_t y, Double_t w)
+{
+  const MeshScore& m = fScores[mesh];
+  Int_t binx = FindBin(x, m.fXmin, m.fXmax, m.fNx);
+  Int_t biny = FindBin(y, m.fYmin, m.fYmax, m.fNy);
+  Long64_t bin = m.fOffset + (estimator * (m.fNy + 2) + biny) * (m.fNx + 2) + binx;
+  fBins[2*bin] += w;
+  fBins[2*bin+1] += w * w;
+
+  // TH2::Fill counts all entries, the statistics only without under- and overflows
+  Double_t* stats = &fStats[(mesh * kNEstimators + estimator) * kNStats];
+  stats[0] += 1.;
+  if (binx == 0 || binx > m.fNx || biny == 0 || biny > m.fNy) { return; }
+  stats[1] += w;
+  stats[2] += w * w;
+  stats[3] += w * x;
+  stats[4] += w * x * x;
+  stats[5] += w * y;
+  stats[6] += w * y * y;
+  stats[7] += w * x * y;
+}
+
 void FairRadGridManager::FillMeshList()
 {
+  if (fCellStart.empty()) { BuildIndex(); }
 
-  /**Add a point to the collection*/
-  TParticle* part = gMC->GetStack()->GetCurrentTrack();
-  fTrackID = gMC->GetStack()->GetCurrentTrackNumber();
   gMC->TrackPosition(fPosIn);
-  gMC->TrackMomentum(fMomIn);
+  Double_t x = fPosIn.X();
+  Double_t y = fPosIn.Y();
+  Double_t z = fPosIn.Z();
+  if (!(x >= fGridMin[0] && x <= fGridMax[0] && y >= fGridMin[1] && y <= fGridMax[1]
+        && z >= fGridMin[2] && z <= fGridMax[2])) {
+    return;
+  }
+  Int_t cell = (Cell(z, 2) * fGridN[1] + Cell(y, 1)) * fGridN[0] + Cell(x, 0);
+
+  /** the step is read once for all meshes it is in */
+  TParticle* part = NULL;
+  Double_t eDep = 0.;
+  Double_t step = 0.;
   fELoss = 0.;
-//  Int_t MatId=  gMC->CurrentMaterial(fA, fZmat, fDensity, fRadl, fAbsl);
 
-  /** Sum energy loss for all steps in the mesh*/
-  for (Int_t i=0; i<fMeshList->GetEntriesFast(); i++ ) {
-    FairMesh* aMesh = (FairMesh*) fMeshList->At(i);
-    Double_t fBinVolume = aMesh->GetBinVolume();
-    Double_t fDiag = aMesh->GetDiag();
+  for (Int_t k = fCellStart[cell]; k < fCellStart[cell+1]; k++) {
+    Int_t iMesh = fCellMeshes[k];
+    const MeshScore& m = fScores[iMesh];
 
     // Geometry bound test
-    if ( IsTrackInside(fPosIn,aMesh) ) {
-      fELoss = gMC->Edep();
-      //cout << "-I- track (" << fTrackID << ")  is inside " << endl;
-      //cout << " E deposited is " << fELoss << endl;
+    if (x < m.fXmin || x > m.fXmax || y < m.fYmin || y > m.fYmax
+        || z < m.fZmin || z > m.fZmax) {
+      continue;
+    }
+    if (!part) {
+      part = gMC->GetStack()->GetCurrentTrack();
+      fTrackID = gMC->GetStack()->GetCurrentTrackNumber();
+      gMC->TrackMomentum(fMomIn);
+      eDep = gMC->Edep();
       gMC->TrackPosition(fPosOut);
       gMC->TrackMomentum(fMomOut);
+      step = gMC->TrackStep();
+    }
 
-      // Now cumulate fEloss (Gev/cm3)
-      // and normalize it to the mesh volume
+    // Now cumulate fEloss (Gev/cm3)
+    // and normalize it to the mesh volume
 
-      // 1 estimator Edep
-      fELoss = fELoss/fBinVolume;
-      // 2 estimator TrackLengh
-      fLength = gMC->TrackStep();
-      // fill TID
+    // 1 estimator Edep
+    fELoss = eDep/m.fBinVolume;
+    // 2 estimator TrackLengh
+    fLength = step;
+    // fill TID
+    Score(iMesh, kTID, fPosOut.X(), fPosOut.Y(), fELoss);
+    // fill total Fluence
+    if ( fLength < 5*m.fDiag ) {
 
-      aMesh->fillTID(fPosOut.X(),fPosOut.Y(),fELoss);
-      // fill total Fluence
-      if ( fLength < 5*fDiag ) {
+      fLength = fLength/m.fBinVolume;
+      Score(iMesh, kFluence, fPosOut.X(), fPosOut.Y(), fLength);
 
-        fLength = fLength/fBinVolume;
-        aMesh->fillFluence(fPosOut.X(),fPosOut.Y(),fLength);
+      // fill SEU
+      if ( part->P() > 0.02 ) {
+        Score(iMesh, kSEU, fPosOut.X(), fPosOut.Y(), fLength);
+      }
+    }
+  }
+}
 
-        // fill SEU
-        if ( part->P() > 0.02 ) {
-          aMesh->fillSEU(fPosOut.X(),fPosOut.Y(),fLength);
-        }
+void FairRadGridManager::FillMeshHistograms()
+{
+  for (size_t iMesh = 0; iMesh < fScores.size(); iMesh++) {
+    const MeshScore& m = fScores[iMesh];
+    Int_t nBins = (m.fNx + 2) * (m.fNy + 2);
+    for (Int_t estimator = 0; estimator < kNEstimators; estimator++) {
+      TH2D* histo = MeshHisto(m.fMesh, estimator);
+      Double_t* sums = &fStats[(iMesh * kNEstimators + estimator) * kNStats];
+      if (!histo || sums[0] == 0.) { continue; }
+
+      // the statistics of the histogram have to be taken before the bins change
+      Double_t stats[7];
+      histo->GetStats(stats);
+      Double_t entries = histo->GetEntries();
+
+      Double_t* bins = &fBins[2 * (m.fOffset + estimator * nBins)];
+      Double_t* sumw2 = histo->GetSumw2N() ? histo->GetSumw2()->GetArray() : NULL;
+      for (Int_t bin = 0; bin < nBins; bin++) {
+        if (bins[2*bin] == 0. && bins[2*bin+1] == 0.) { continue; }
+        histo->AddBinContent(bin, bins[2*bin]);
+        if (sumw2) { sumw2[bin] += bins[2*bin+1]; }
+        bins[2*bin] = 0.;
+        bins[2*bin+1] = 0.;
       }
 
+      for (Int_t i = 0; i < 7; i++) {
+        stats[i] += sums[i+1];
+      }
+      histo->PutStats(stats);
+      histo->SetEntries(entries + sums[0]);
+      for (Int_t i = 0; i < kNStats; i++) { sums[i] = 0.; }
     }
-
   }
 }
 
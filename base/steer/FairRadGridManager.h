@@ -20,6 +20,7 @@
 #include "TObjArray.h"                  // for TObjArray
 
 #include <iostream>                     // for basic_ostream::operator<<, etc
+#include <vector>                       // for vector
 
 class FairMesh;
 class TClonesArray;
@@ -27,6 +28,13 @@ class TClonesArray;
 
 /**
  * @class FairRadGridManager
+ *
+ * Scores the energy deposit, the fluence and the SEU fluence of the steps
+ * in the registered meshes. The meshes are found with a uniform grid of
+ * cells over their bounding boxes, so a step only tests the meshes of its
+ * cell. The scores are summed per histogram bin in flat arrays and added
+ * to the mesh histograms by FillMeshHistograms at the end of the run. In
+ * MT mode each worker has its own manager with its own sums.
  */
 
 
@@ -48,7 +56,7 @@ class FairRadGridManager
     /**
      * Class definition.
      */
-    ClassDef(FairRadGridManager,1);
+    ClassDef(FairRadGridManager,2);
 
 
   private:
@@ -96,17 +104,52 @@ class FairRadGridManager
     TObjArray* fMeshList;
 
     static Double_t fLtmp;
+
+    /** bounds, bins and position in fBins of a mesh */
+    struct MeshScore {
+      FairMesh* fMesh;
+      Double_t fXmin, fXmax, fYmin, fYmax, fZmin, fZmax;
+      Double_t fBinVolume;
+      Double_t fDiag;
+      Int_t fNx, fNy;
+      Long64_t fOffset;
+    };
+    /** the meshes with histograms */
+    std::vector<MeshScore> fScores;    //!
+    /** sum of the weights and of the squared weights per histogram bin */
+    std::vector<Double_t> fBins;       //!
+    /** entries and statistics sums (as TH1::GetStats) per histogram */
+    std::vector<Double_t> fStats;      //!
+    /** grid of cells over all meshes */
+    Double_t fGridMin[3];              //!
+    Double_t fGridMax[3];              //!
+    Double_t fGridInv[3];              //!
+    Int_t fGridN[3];                   //!
+    /** meshes of cell i: fCellMeshes[fCellStart[i]] ... fCellMeshes[fCellStart[i+1]-1] */
+    std::vector<Int_t> fCellStart;     //!
+    std::vector<Int_t> fCellMeshes;    //!
+
+    /** set up the cells and the sums for the mesh list */
+    void BuildIndex();
+    /** cell index along one axis */
+    Int_t Cell(Double_t x, Int_t axis) const;
+    /** add a weight to the sums of one histogram of a mesh, like TH2::Fill */
+    void Score(Int_t mesh, Int_t estimator, Double_t x, Double_t y, Double_t w);
+
   public:
 
     TObjArray* GetMeshList() { return fMeshList; }
     void AddMeshList ( TObjArray* list ) {
       std::cout << " grid manag " << list->GetEntriesFast() << std::endl;
       fMeshList = list;
+      fCellStart.clear();
     }
     Bool_t  IsTrackInside(TLorentzVector& vec, FairMesh* aMesh);
     Bool_t  IsTrackEntering(TLorentzVector& vec1,TLorentzVector& vec2);
     /** fill the 2D mesh */
     void FillMeshList();
+    /** add the sums since the last call to the mesh histograms */
+    void FillMeshHistograms();
     /**initialize the manager*/
     void  Init();
     /**reset*/
@@ -19,12 +19,9 @@
 #include "TGeoManager.h"                // for TGeoManager, gGeoManager
 #include "TGeoVolume.h"                 // for TGeoVolume
 #include "TLorentzVector.h"             // for TLorentzVector
-#include "TMap.h"                       // for TMap
 #include "TObjArray.h"                  // for TObjArray
 #include "TObject.h"                    // for TObject
 #include "TVector3.h"                   // for TVector3
-#include "TVectorDfwd.h"                // for TVectorD
-#include "TVectorT.h"                   // for TVectorT
 #include "TVirtualMC.h"                 // for TVirtualMC, gMC
 #include "TVirtualMCStack.h"            // for TVirtualMCStack
 
@@ -66,7 +63,7 @@ FairRadMapManager::FairRadMapManager()
     fAbsl(0),
     fActVol(0),
     fActMass(0),
-    fMassMap(NULL)
+    fVolumes()
 {
   /** radiation length default ctor */
   if(NULL == fgInstance) {
@@ -83,7 +80,6 @@ FairRadMapManager::~FairRadMapManager()
   fgInstance = NULL;
   fPointCollection->Delete();
   delete fPointCollection;
-  delete fMassMap;
 }
 
 void FairRadMapManager::Init()
@@ -92,42 +88,31 @@ void FairRadMapManager::Init()
   FairRootManager::Instance()->Register("RadMap","RadMapPoint", fPointCollection, kTRUE);
   cout << "RadMapMan initialized" << endl;
 
-  // compute once the masses of the volumes in this simulation and store them in a TMap object
+  // compute once the masses of the volumes in this simulation and store
+  // them by the volume id, as given by gMC->CurrentVolID
 
-  Int_t volumeiterator=0,lastvolume=0;
-  Double_t vmass;
-  TObjArray* volumelist;
-  TGeoVolume* myvolume;
-  const char* volumename;
-  fMassMap = new TMap(lastvolume+1,0);
+  TObjArray* volumelist = gGeoManager->GetListOfUVolumes();
+  Int_t nVolumes = volumelist->GetEntriesFast();
+  VolumeProperties empty = { 0., 0., 0., 0., 0., 0., kFALSE };
+  fVolumes.assign(nVolumes, empty);
 
-  volumelist = gGeoManager->GetListOfVolumes();
+  cout << "RadMapMan: calculating the masses for " << nVolumes << " volumes in this simulation" << endl;
 
-  lastvolume = volumelist->GetLast();
+  for (Int_t volumeId = 0; volumeId < nVolumes; volumeId++) {
+    TGeoVolume* myvolume = dynamic_cast<TGeoVolume*>(volumelist->At(volumeId));
+    if (!myvolume) { continue; }
+    fVolumes[volumeId].fMass = myvolume->WeightA(); // calculate weight analytically
 
-  volumeiterator=0;
-
-  cout << "RadMapMan: calculating the masses for " << lastvolume << " volumes in this simulation" << endl;
-
-  while ( volumeiterator<=lastvolume ) {
-    volumename = volumelist->At(volumeiterator)->GetName();
-    myvolume = gGeoManager->GetVolume(volumename);
-    vmass = myvolume->WeightA(); // calculate weight analytically
-    TVectorD* vomass= new TVectorD(1,1,vmass,"END"); // 1-dim vector
-
-    fMassMap->Add(myvolume,vomass);
-
-    cout <<  myvolume->GetName() << " has " << vmass << " kg" << endl;
-
-    volumeiterator++;
+    cout <<  myvolume->GetName() << " has " << fVolumes[volumeId].fMass << " kg" << endl;
   }
 
 }
 
 void FairRadMapManager::Reset()
 {
-  /**We have to free the momeory, Clear() is faster but not enough! */
-  fPointCollection->Delete();
+  /** The points keep their memory for the next event, the TClonesArray
+      destructs an old point before a new one is constructed in its place */
+  fPointCollection->Clear();
   printf(" FairRadMapManager::Reset() ------------------------------------------------\n");
 }
 
@@ -148,18 +133,22 @@ void FairRadMapManager::AddPoint(Int_t& ModuleId)
     fLength = gMC->TrackLength();
     gMC->TrackPosition(fPosIn);
     gMC->TrackMomentum(fMomIn);
-    //    Int_t MatId=  gMC->CurrentMaterial(fA, fZmat, fDensity, fRadl, fAbsl);
-    gMC->CurrentMaterial(fA, fZmat, fDensity, fRadl, fAbsl);
-
-    //    if (!gGeoManager) { GetGeoManager(); }
-    //    TGeoVolume* actVolume = gGeoManager->GetCurrentVolume();
-    TGeoVolume* actVolume = gGeoManager->GetVolume(fVolumeID);
-
-    TVectorD* ActMass = (TVectorD*)fMassMap->GetValue(actVolume);
-
-    fActMass = ActMass->Min(); // read from TVectorD
 
-    //    cout << actVolume->GetName() << " has " << fActMass << " kg" << endl;
+    if (fVolumeID >= 0 && fVolumeID < static_cast<Int_t>(fVolumes.size())) {
+      VolumeProperties& volume = fVolumes[fVolumeID];
+      if (!volume.fHasMaterial) {
+        gMC->CurrentMaterial(volume.fA, volume.fZmat, volume.fDensity, volume.fRadl, volume.fAbsl);
+        volume.fHasMaterial = kTRUE;
+      }
+      fA = volume.fA;
+      fZmat = volume.fZmat;
+      fDensity = volume.fDensity;
+      fRadl = volume.fRadl;
+      fAbsl = volume.fAbsl;
+      fActMass = volume.fMass;
+    } else {
+      gMC->CurrentMaterial(fA, fZmat, fDensity, fRadl, fAbsl);
+    }
 
   }
   /** Sum energy loss for all steps in the active volume */
@@ -14,11 +14,16 @@
 #include "Rtypes.h"                     // for Double_t, Float_t, Int_t, etc
 #include "TLorentzVector.h"             // for TLorentzVector
 
+#include <vector>                       // for vector
+
 class TClonesArray;
-class TMap;
 
 /**
  * @class FairRadMapManager
+ *
+ * The masses of the volumes are computed once at Init and kept in a table
+ * indexed by the volume id, together with the material of the volume,
+ * which is taken from the MC engine at the first entry into the volume.
  */
 
 
@@ -41,7 +46,7 @@ class FairRadMapManager
     /**
      * Class definition.
      */
-    ClassDef(FairRadMapManager,1);
+    ClassDef(FairRadMapManager,2);
 
 
   private:
@@ -94,7 +99,14 @@ class FairRadMapManager
     Double_t       fActVol;
     Double_t       fActMass;
 
-    TMap* fMassMap;
+    /** mass and material of a volume */
+    struct VolumeProperties {
+      Double_t fMass;
+      Float_t fA, fZmat, fDensity, fRadl, fAbsl;
+      Bool_t fHasMaterial;
+    };
+    /** properties by volume id */
+    std::vector<VolumeProperties> fVolumes; //!
 
 
   public:
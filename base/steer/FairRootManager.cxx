@@ -15,13 +15,18 @@
 // Class that takes care of Root IO.
 #include "FairRootManager.h"
 
+#include "FairAsyncWriter.h"            // for FairAsyncWriter
 #include "FairEventHeader.h"            // for FairEventHeader
 #include "FairFileHeader.h"             // for FairFileHeader
 #include "FairGeoNode.h"                // for FairGeoNode
 #include "FairLink.h"                   // for FairLink
+#include "FairLinkTable.h"              // for FairLinkTable
 #include "FairLogger.h"                 // for FairLogger, MESSAGE_ORIGIN
 #include "FairMonitor.h"                // for FairMonitor
+#include "FairOutputTuner.h"            // for FairOutputTuner
 #include "FairMCEventHeader.h"          // for FairMCEventHeader
+#include "FairMultiLinkedData.h"        // for FairMultiLinkedData
+#include "FairMultiLinkedData_Interface.h"  // for FairMultiLinkedData_Interface
 #include "FairRun.h"                    // for FairRun
 #include "FairTSBufferFunctional.h"     // for FairTSBufferFunctional, etc
 #include "FairWriteoutBuffer.h"         // for FairWriteoutBuffer
@@ -46,6 +51,7 @@
 #include "TRandom.h"                    // for TRandom, gRandom
 #include "TTree.h"                      // for TTree
 #include "TRefArray.h"                  // for TRefArray
+#include "TStopwatch.h"                 // for TStopwatch
 
 #include <stdlib.h>                     // for exit
 #include <string.h>                     // for NULL, strcmp
@@ -111,7 +117,19 @@ FairRootManager::FairRootManager()
     fListOfBranchesFromInput(0),
     fListOfBranchesFromInputIter(0),
     fListOfNonTimebasedBranches(new TRefArray()),
-    fListOfNonTimebasedBranchesIter(0)
+    fListOfNonTimebasedBranchesIter(0),
+    fOutFolderName("cbmroot"),
+    fAsyncWriteDepth(0),
+    fAsyncWriter(0),
+    fFillTime(0.),
+    fOutputTuner(0),
+    fCompactLinks(kFALSE),
+    fOutLinkTable(0),
+    fLinkDataObjects(),
+    fLinkDataCollected(kFALSE),
+    fInLinkTable(0),
+    fInLinkTableChecked(kFALSE),
+    fInLinkTableEntry(-1)
   {
   if (fgInstance) {
     Fatal("FairRootManager", "Singleton instance already exists.");
@@ -126,6 +144,9 @@ FairRootManager::~FairRootManager()
 {
 //
   LOG(DEBUG) << "Enter Destructor of FairRootManager" << FairLogger::endl;
+  delete fAsyncWriter;
+  delete fOutputTuner;
+  delete fInLinkTable;
   if(fOutTree) {
     delete fOutTree;
   }
@@ -179,16 +200,31 @@ TFile* FairRootManager::OpenOutFile(TFile* f)
   FairRun* fRun = FairRun::Instance();
   /**Check if a simulation run!*/
   if(!fRun->IsAna()) {
-    fCbmroot= gROOT->GetRootFolder()->AddFolder("cbmroot", "Main Folder");
+    fCbmroot= gROOT->GetRootFolder()->AddFolder(fOutFolderName, "Main Folder");
     gROOT->GetListOfBrowsables()->Add(fCbmroot);
   } else {
     fCbmout= gROOT->GetRootFolder()->AddFolder("cbmout", "Main Output Folder");
     gROOT->GetListOfBrowsables()->Add(fCbmout);
   }
+  RegisterLinkTable();
   return fOutFile;
 }
 //_____________________________________________________________________________
 
+//_____________________________________________________________________________
+void FairRootManager::CloseOutFile()
+{
+  // the writer thread must not fill the tree any more
+  if (fAsyncWriter) {
+    delete fAsyncWriter;
+    fAsyncWriter = 0;
+  }
+  if (fOutFile) {
+    fOutFile->Close();
+  }
+}
+//_____________________________________________________________________________
+
 //_____________________________________________________________________________
 TFile* FairRootManager::OpenOutFile(const char* fname)
 {
@@ -454,13 +490,170 @@ Bool_t FairRootManager::AllDataProcessed()
 void FairRootManager::Fill()
 {
   if (fOutTree != 0) {
-    fOutTree->Fill();
+    TStopwatch timer;
+    if (fCompactLinks) { CompactLinks(); }
+    if (fAsyncWriteDepth > 0 && !fAsyncWriter) {
+      fAsyncWriter = FairAsyncWriter::Create(fOutTree, fAsyncWriteDepth, fOutputTuner);
+      if (!fAsyncWriter) { fAsyncWriteDepth = 0; }
+    }
+    if (fAsyncWriter) {
+      fAsyncWriter->Snapshot();
+      // the arrays went to the writer thread, the other objects stay with the
+      // tasks, which may still use their links
+      if (fOutLinkTable) {
+        for (size_t i = 0; i < fLinkDataObjects.size(); i++) {
+          if (fLinkDataObjects[i]->InheritsFrom(TClonesArray::Class())) { continue; }
+          FairMultiLinkedData* data = FairLinkTable::GetLinkData(fLinkDataObjects[i]);
+          if (data) { fOutLinkTable->Expand(*data); }
+        }
+      }
+    } else {
+      fOutTree->Fill();
+      if (fOutputTuner) { fOutputTuner->Observe(fOutTree); }
+      // the tasks may still use the links of the event
+      if (fOutLinkTable) { fOutLinkTable->Restore(); }
+    }
+    fFillTime += timer.RealTime();
   } else {
     LOG(INFO) << " No Output Tree" << FairLogger::endl;
   }
 }
 //_____________________________________________________________________________
 
+//_____________________________________________________________________________
+void FairRootManager::SetOutputTuning(Int_t nEvents)
+{
+  // the writer thread observes the tree with the tuner until it is stopped
+  if (fAsyncWriter) {
+    LOG(ERROR) << "FairRootManager: the output tuning can not be changed while the output is written asynchronously"
+               << FairLogger::endl;
+    return;
+  }
+  delete fOutputTuner;
+  fOutputTuner = nEvents > 0 ? new FairOutputTuner(nEvents) : 0;
+}
+//_____________________________________________________________________________
+
+//_____________________________________________________________________________
+void FairRootManager::SetCompactLinks(Bool_t val)
+{
+  fCompactLinks = val;
+  RegisterLinkTable();
+}
+//_____________________________________________________________________________
+
+//_____________________________________________________________________________
+void FairRootManager::RegisterLinkTable()
+{
+  // the table is registered as soon as there is an output folder, then the
+  // output tree made from the folder has its branch
+  if (!fCompactLinks || fOutLinkTable || (fCbmout == 0 && fCbmroot == 0)) {
+    return;
+  }
+  fOutLinkTable = new FairLinkTable("LinkTable.");
+  Register("LinkTable.", "Links", fOutLinkTable, kTRUE);
+}
+//_____________________________________________________________________________
+
+//_____________________________________________________________________________
+void FairRootManager::CompactLinks()
+{
+  if (!fOutLinkTable) { RegisterLinkTable(); }
+  if (!fOutLinkTable) { return; }
+  if (!fLinkDataCollected) {
+    if (!fOutTree->GetBranch("LinkTable.")) {
+      // the output tree was made before SetCompactLinks()
+      fOutTree->Branch("LinkTable.", "FairLinkTable", &fOutLinkTable, 32000, 99);
+    }
+    TObjArray* branches = fOutTree->GetListOfBranches();
+    for (Int_t i = 0; i < branches->GetEntriesFast(); i++) {
+      void* address = static_cast<TBranch*>(branches->UncheckedAt(i))->GetAddress();
+      TObject* object = address ? *static_cast<TObject**>(address) : 0;
+      if (object == 0 || object == fOutLinkTable) { continue; }
+      TClass* cl = object->IsA();
+      if (object->InheritsFrom(TClonesArray::Class())) {
+        cl = static_cast<TClonesArray*>(object)->GetClass();
+      }
+      if (cl->InheritsFrom(FairMultiLinkedData::Class()) || cl->InheritsFrom(FairMultiLinkedData_Interface::Class())) {
+        fLinkDataObjects.push_back(object);
+      }
+    }
+    fLinkDataCollected = kTRUE;
+    LOG(INFO) << "FairRootManager: the links of " << fLinkDataObjects.size()
+              << " output branches are written to LinkTable." << FairLogger::endl;
+  }
+
+  fOutLinkTable->Clear();
+  for (size_t i = 0; i < fLinkDataObjects.size(); i++) {
+    TObject* object = fLinkDataObjects[i];
+    if (object->InheritsFrom(TClonesArray::Class())) {
+      TClonesArray* array = static_cast<TClonesArray*>(object);
+      for (Int_t j = 0; j < array->GetEntriesFast(); j++) {
+        fOutLinkTable->Compact(array->UncheckedAt(j));
+      }
+    } else {
+      fOutLinkTable->Compact(object);
+    }
+  }
+}
+//_____________________________________________________________________________
+
+//_____________________________________________________________________________
+FairLinkTable* FairRootManager::GetInLinkTable()
+{
+  if (!fInLinkTableChecked) {
+    fInLinkTableChecked = kTRUE;
+    if (fSource && fSourceChain && fSourceChain->GetBranch("LinkTable.")) {
+      fInLinkTable = new FairLinkTable();
+      fSource->ActivateObject(reinterpret_cast<TObject**>(&fInLinkTable), "LinkTable.");
+      // the current entry was read before the branch was activated
+      Long64_t localEntry = fSourceChain->LoadTree(fEntryNr);
+      if (localEntry >= 0) { fSourceChain->GetBranch("LinkTable.")->GetEntry(localEntry); }
+      fInLinkTableEntry = fEntryNr;
+    }
+  }
+  if (fInLinkTable && fInLinkTableEntry != fEntryNr) {
+    fInLinkTable->ResetIndex();
+    fInLinkTableEntry = fEntryNr;
+  }
+  return fInLinkTable;
+}
+//_____________________________________________________________________________
+
+//_____________________________________________________________________________
+TBranch* FairRootManager::ReadLinkTableEntry(TTree* dataTree, Int_t entryNr)
+{
+  // only the link table of the input chain is read
+  if (entryNr < 0 || GetInLinkTable() == 0 || (dataTree != GetInTree() && dataTree != GetInChain())) {
+    return 0;
+  }
+  TBranch* linkBranch = dataTree->GetBranch("LinkTable.");
+  if (linkBranch) {
+    linkBranch->GetEntry(entryNr);
+    fInLinkTable->ResetIndex();
+  }
+  return linkBranch;
+}
+//_____________________________________________________________________________
+
+//_____________________________________________________________________________
+void FairRootManager::ExpandLinks(TObject* object)
+{
+  if (object == 0 || GetInLinkTable() == 0) {
+    return;
+  }
+  if (object->InheritsFrom(TClonesArray::Class())) {
+    TClonesArray* array = static_cast<TClonesArray*>(object);
+    for (Int_t i = 0; i < array->GetEntriesFast(); i++) {
+      ExpandLinks(array->UncheckedAt(i));
+    }
+    return;
+  }
+  FairMultiLinkedData* links = FairLinkTable::GetLinkData(object);
+  if (links) { fInLinkTable->Expand(*links); }
+}
+//_____________________________________________________________________________
+
 //_____________________________________________________________________________
 void FairRootManager::LastFill()
 {
@@ -476,6 +669,20 @@ Int_t FairRootManager::Write(const char* name, Int_t option, Int_t bufsize)
 {
   /** Writes the tree in the file.*/
 
+  // time spent in TTree::Fill, on the writer thread if there is one
+  Double_t writeTime = fFillTime;
+  if(fAsyncWriter) {
+    fAsyncWriter->Stop();
+    writeTime = fAsyncWriter->GetFillTime();
+    delete fAsyncWriter;
+    fAsyncWriter = 0;
+  }
+  if(fFillTime > 0.) {
+    LOG(INFO) << "FairRootManager: filling the output tree took " << fFillTime
+              << " s on the event loop" << FairLogger::endl;
+    fFillTime = 0.;
+  }
+
   if(fOutTree!=0) {
     /** Get the file handle to the current output file from the tree.
       * If ROOT splits the file (due to the size of the file) the file
@@ -485,6 +692,11 @@ Int_t FairRootManager::Write(const char* name, Int_t option, Int_t bufsize)
     fOutFile = fOutTree->GetCurrentFile();
     fOutFile->cd();
     fOutTree->Write();
+    if(writeTime > 0.) {
+      LOG(INFO) << "FairRootManager: output tree " << fOutTree->GetTotBytes() / 1.e6 << " MB, "
+                << fOutTree->GetZipBytes() / 1.e6 << " MB compressed, filled at "
+                << fOutTree->GetTotBytes() / 1.e6 / writeTime << " MB/s" << FairLogger::endl;
+    }
   } else {
     LOG(INFO) << "No Output Tree" << FairLogger::endl;
   }
@@ -709,9 +921,11 @@ TObject* FairRootManager::GetCloneOfLinkData(const FairLink link)
     return 0;
   }
 
+  TBranch* linkBranch = 0;
   if (entryNr > -1) {         //get the right entry (if entryNr < 0 then the current entry is taken
     if (entryNr < dataBranch->GetEntries()) {
       dataBranch->GetEntry(entryNr);
+      linkBranch = ReadLinkTableEntry(dataTree, entryNr);
     } else {
       return 0;
     }
@@ -733,9 +947,14 @@ TObject* FairRootManager::GetCloneOfLinkData(const FairLink link)
 //      std::cout << "Result: " << *((FairMultiLinkedData*)result) << std::endl;
     }
   }
+  ExpandLinks(result);
   if (entryNr > -1) {
     dataBranch->GetEntry(oldEntryNr);  //reset the dataBranch to the original entry
   }
+  if (linkBranch) {
+    linkBranch->GetEntry(oldEntryNr);
+    fInLinkTable->ResetIndex();
+  }
   return result;
 }
 //_____________________________________________________________________________
@@ -791,9 +1010,11 @@ TClonesArray* FairRootManager::GetCloneOfTClonesArray(const FairLink link)
     return 0;
   }
 
+  TBranch* linkBranch = 0;
   if (entryNr > -1) { //get the right entry (if entryNr < 0 then the current entry is taken
     if (entryNr < dataBranch->GetEntries()) {
       dataBranch->GetEntry(entryNr);
+      linkBranch = ReadLinkTableEntry(dataTree, entryNr);
     } else {
       return 0;
     }
@@ -808,9 +1029,14 @@ TClonesArray* FairRootManager::GetCloneOfTClonesArray(const FairLink link)
   } else {
     result = (TClonesArray*) GetObject(GetBranchName(type))->Clone();
   }
+  ExpandLinks(result);
   if (entryNr > -1) {
     dataBranch->GetEntry(oldEntryNr); //reset the dataBranch to the original entry
   }
+  if (linkBranch) {
+    linkBranch->GetEntry(oldEntryNr);
+    fInLinkTable->ResetIndex();
+  }
   return result;
 
 }
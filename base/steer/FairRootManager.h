@@ -21,11 +21,15 @@
 #include <list>                         // for list
 #include <map>                          // for map, multimap, etc
 #include <queue>                        // for queue
+#include <vector>                       // for vector
 #include "FairSource.h"
 class BinaryFunctor;
+class FairAsyncWriter;
+class FairOutputTuner;
 class FairFileHeader;
 class FairGeoNode;
 class FairLink;
+class FairLinkTable;
 class FairLogger;
 class FairTSBufferFunctional;
 class FairWriteoutBuffer;
@@ -69,7 +73,7 @@ class FairRootManager : public TObject
     Int_t               CheckBranch(const char* BrName);
 
     
-    void                CloseOutFile() { if(fOutFile) { fOutFile->Close(); }}
+    void                CloseOutFile();
     /**Create a new file and save the current TGeoManager object to it*/
     void                CreateGeometryFile(const char* geofile);
     void                Fill();
@@ -89,6 +93,11 @@ class FairRootManager : public TObject
     TTree*              GetOutTree() {return fOutTree;}
     /** Return a pointer to the output File of type TFile */
     TFile*              GetOutFile() {return  fOutFile;}
+    /** Name of the main folder of a simulation output ("cbmroot" by default).
+        Has to be set before the output file is opened. The worker threads of a
+        multi-threaded simulation use one folder each. */
+    void                SetOutFolderName(const char* name) { fOutFolderName = name; }
+    const char*         GetOutFolderName() const { return fOutFolderName.Data(); }
     /**  Get the Object (container) for the given branch name,
          this method can be used to access the data of
          a branch that was created from a different
@@ -162,9 +171,29 @@ class FairRootManager : public TObject
    
     /**Set the output tree pointer*/
     void                SetOutTree(TTree* fTree) { fOutTree=fTree;}
+    /**Set the output file pointer, the output tree has to be moved to the file before*/
+    void                SetOutFile(TFile* f) { fOutFile=f;}
 
     /**Enables a last Fill command after all events are processed to store any data which is still in Buffers*/
     void        SetLastFill(Bool_t val = kTRUE) { fFillLastData=val;}
+    /**Fill the output tree on a writer thread (see FairAsyncWriter), with up to queueDepth events
+     * waiting to be written; 0 fills it on the event loop (default). The TClonesArrays of the output
+     * are emptied by Fill() in this mode. Has to be set before the first Fill().*/
+    void        SetAsyncWriting(Int_t queueDepth = 2) { fAsyncWriteDepth = queueDepth; }
+    Int_t       GetAsyncWriting() const { return fAsyncWriteDepth; }
+    /**Tune the basket sizes, the AutoFlush interval and the compression of the output tree
+     * from its first nEvents entries (see FairOutputTuner); 0 keeps the defaults. With asynchronous
+     * writing it has to be set before the first Fill(), later calls are refused.*/
+    void        SetOutputTuning(Int_t nEvents = 100);
+    /**The tuner of the output tree, to set the compression of single branches*/
+    FairOutputTuner* GetOutputTuner() { return fOutputTuner; }
+    /**Write the links of the FairMultiLinkedData in the output to the branch "LinkTable." (see FairLinkTable)
+     * instead of with each object; the objects get their links back when they are read. Has to be set
+     * before the output tree is created, not for data read time-based from other entries.*/
+    void        SetCompactLinks(Bool_t val = kTRUE);
+    Bool_t      GetCompactLinks() const { return fCompactLinks; }
+    /**The link table of the current entry of the input, NULL if the input has none*/
+    FairLinkTable* GetInLinkTable();
     /**When creating TTree from TFolder the fullpath of the objects is used as branch names
      * this method truncate the full path from the branch names
     */
@@ -320,8 +349,38 @@ class FairRootManager : public TObject
     TRefArray* fListOfNonTimebasedBranches; //!
     /** Iterator for the list of branches used with no-time stamp in time-based session */
     TIterator* fListOfNonTimebasedBranchesIter; //!
-
-    ClassDef(FairRootManager,11) // Root IO manager
+    /** Name of the main folder of a simulation output */
+    TString fOutFolderName; //!
+    /** Maximum number of events waiting for the writer thread, 0 without writer thread */
+    Int_t fAsyncWriteDepth; //!
+    /** Writer thread filling the output tree */
+    FairAsyncWriter* fAsyncWriter; //!
+    /** Time spent in Fill() on the event loop [s] */
+    Double_t fFillTime; //!
+    /** Tunes the layout of the output tree */
+    FairOutputTuner* fOutputTuner; //!
+    /** The links of the output are written to a link table */
+    Bool_t fCompactLinks; //!
+    /** Link table of the output */
+    FairLinkTable* fOutLinkTable; //!
+    /** Output objects with links, collected at the first Fill() */
+    std::vector<TObject*> fLinkDataObjects; //!
+    Bool_t fLinkDataCollected; //!
+    /** Link table of the input, NULL if the input has none */
+    FairLinkTable* fInLinkTable; //!
+    Bool_t fInLinkTableChecked; //!
+    /** Entry of the input the index of fInLinkTable was reset for */
+    Int_t fInLinkTableEntry; //!
+
+    void RegisterLinkTable();
+    /** Moves the links of the output objects into the link table */
+    void CompactLinks();
+    /** Reads the link table of the input at the entry of data read from another entry, NULL if it is not read */
+    TBranch* ReadLinkTableEntry(TTree* dataTree, Int_t entryNr);
+    /** Gives the object, or the objects of a TClonesArray, their links from the link table of the input */
+    void ExpandLinks(TObject* object);
+
+    ClassDef(FairRootManager,14) // Root IO manager
 };
 
 
@@ -55,9 +55,9 @@ FairRun::FairRun(Bool_t isMaster)
   }
   fRunInstance=this;
 
-  if ( isMaster ) {
-    fRootManager = new FairRootManager();
-  }
+  // the FairRootManager is thread local, workers of a multi-threaded
+  // simulation write to their own output
+  fRootManager = new FairRootManager();
   new FairLinkManager();
 }
 //_____________________________________________________________________________
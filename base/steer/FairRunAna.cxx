@@ -18,6 +18,7 @@
 #include "FairField.h"                  // for FairField
 #include "FairFieldFactory.h"           // for FairFieldFactory
 #include "FairFileHeader.h"             // for FairFileHeader
+#include "FairGeoCache.h"               // for FairGeoCache
 #include "FairLogger.h"                 // for FairLogger, MESSAGE_ORIGIN
 #include "FairParIo.h"                  // for FairParIo
 #include "FairParSet.h"                 // for FairParSet
@@ -95,6 +96,7 @@ FairRunAna::FairRunAna()
    fFinishProcessingLMDFile(kFALSE)
   ,fFileSource(0)
   ,fMixedSource(0)
+  ,fGeoCacheFile("")
 {
 
   fgRinstance=this;
@@ -138,6 +140,37 @@ void  FairRunAna::SetGeomFile(const char* GeoFileName)
   }
 }
 
+//_____________________________________________________________________________
+TGeoManager* FairRunAna::ReadGeometry()
+{
+  TString hash = "";
+  if (!fGeoCacheFile.IsNull()) {
+    hash = FairGeoCache::FileHash(fInputGeoFile->GetName());
+    TGeoManager* cached = FairGeoCache::ReadGeometry(fGeoCacheFile, hash);
+    if (cached) {
+      LOG(INFO) << "Geometry taken from cache " << fGeoCacheFile << FairLogger::endl;
+      return cached;
+    }
+  }
+
+  TGeoManager* geo = 0;
+  TIter next(fInputGeoFile->GetListOfKeys());
+  TKey* key;
+  while ((key = dynamic_cast<TKey*>(next()))) {
+    if (strcmp(key->GetClassName(),"TGeoManager") != 0) {
+      continue;
+    }
+    geo = dynamic_cast<TGeoManager*>(key->ReadObj());
+    break;
+  }
+
+  if (geo && !hash.IsNull()) {
+    gGeoManager = geo;
+    FairGeoCache::WriteGeometry(fGeoCacheFile, hash);
+  }
+  return geo;
+}
+
 //_____________________________________________________________________________
 
 void FairRunAna::Init()
@@ -157,15 +190,8 @@ void FairRunAna::Init()
  //Load Geometry from user file
   if (fLoadGeo) {
     if (fInputGeoFile!=0) { //First check if the user has a separate Geo file!
-      TIter next(fInputGeoFile->GetListOfKeys());
-      TKey* key;
-      while ((key =dynamic_cast< TKey*>(next()))) {
-        if (strcmp(key->GetClassName(),"TGeoManager") != 0) {
-          continue;
-        }
-        gGeoManager = dynamic_cast<TGeoManager*>(key->ReadObj());
-        break;
-      }
+      TGeoManager* geo = ReadGeometry();
+      if (geo) { gGeoManager = geo; }
     }
   } else {
     /*** Get the container that normly has the geometry and all the basic stuff from simulation*/
@@ -194,15 +220,8 @@ void FairRunAna::Init()
     // NO input file but there is a geometry file
     if (fLoadGeo) {
       if (fInputGeoFile!=0) { //First check if the user has a separate Geo file!
-        TIter next(fInputGeoFile->GetListOfKeys());
-        TKey* key;
-        while ((key = dynamic_cast<TKey*>(next()))) {
-          if (strcmp(key->GetClassName(),"TGeoManager") != 0) {
-            continue;
-          }
-          gGeoManager = dynamic_cast<TGeoManager*>(key->ReadObj());
-          break;
-        }
+        TGeoManager* geo = ReadGeometry();
+        if (geo) { gGeoManager = geo; }
       }
     }
   }
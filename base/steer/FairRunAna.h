@@ -28,6 +28,7 @@ class FairEventHeader;
 class FairField;
 class TF1;
 class TFile;
+class TGeoManager;
 class TTree;
 
 class FairFileSource;
@@ -139,6 +140,12 @@ class FairRunAna : public FairRun
     TFile*      GetGeoFile() {
       return fInputGeoFile;
     }
+    /** Keep the geometry of the geometry file with its voxels in a cache
+     *  file, which is used as long as the content of the geometry file
+     *  does not change */
+    void        SetGeometryCache(const char* fileName) {
+      fGeoCacheFile = fileName;
+    }
     /** Initialization of parameter container is set to static, i.e: the run id is
      *  is not checked anymore after initialization
      */
@@ -173,6 +180,9 @@ class FairRunAna : public FairRun
       return *this;
     }
 
+    /** read the geometry from the geometry file or from the cache */
+    TGeoManager* ReadGeometry();
+
     FairRunInfo fRunInfo;//!
 
   protected:
@@ -204,8 +214,10 @@ class FairRunAna : public FairRun
     FairFileSource*                         fFileSource;  //! 
     /** Temporary member to preserve old functionality without setting source in macro */
     FairMixedSource*                        fMixedSource; //! 
+    /** Geometry cache file */
+    TString                                 fGeoCacheFile; //!
 
-    ClassDef(FairRunAna ,5)
+    ClassDef(FairRunAna ,6)
 
 };
 
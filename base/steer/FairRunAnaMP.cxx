@@ -0,0 +1,387 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#include "FairRunAnaMP.h"
+
+#include "FairLogger.h"                 // for FairLogger, MESSAGE_ORIGIN
+#include "FairRootManager.h"            // for FairRootManager
+
+#include "TAxis.h"                      // for TAxis
+#include "TClass.h"                     // for TClass
+#include "TCollection.h"                // for TIter
+#include "TDirectory.h"                 // for TDirectory
+#include "TFile.h"                      // for TFile
+#include "TH1.h"                        // for TH1
+#include "TKey.h"                       // for TKey
+#include "TList.h"                      // for TList
+#include "TROOT.h"                      // for TROOT, gROOT
+#include "TStopwatch.h"                 // for TStopwatch
+#include "TSystem.h"                    // for TSystem, gSystem
+#include "TTree.h"                      // for TTree
+
+#include <fcntl.h>                      // for open, O_RDONLY
+#include <stdio.h>                      // for fflush
+#include <sys/types.h>                  // for pid_t
+#include <sys/wait.h>                   // for waitpid, WIFEXITED, etc
+#include <unistd.h>                     // for fork, dup2, close, _exit
+#include <iostream>                     // for cout
+#include <set>                          // for set
+
+namespace
+{
+/** Give the read-only files of the process file descriptors of its own.
+ ** After fork() the descriptors share the file offset with the parent and
+ ** the other workers, which would mix up the reads. */
+Bool_t ReopenInputFiles()
+{
+  TIter next(gROOT->GetListOfFiles());
+  while (TFile* file = dynamic_cast<TFile*>(next())) {
+    if (file->IsWritable()) {
+      continue;
+    }
+    if (file->GetFd() < 0) {
+      LOG(WARNING) << "FairRunAnaMP: " << file->GetName()
+                   << " is no local file, it is read with the connection of the parent" << FairLogger::endl;
+      continue;
+    }
+    int fd = open(file->GetName(), O_RDONLY);
+    if (fd < 0 || dup2(fd, file->GetFd()) < 0) {
+      LOG(ERROR) << "FairRunAnaMP: Could not reopen " << file->GetName() << FairLogger::endl;
+      return kFALSE;
+    }
+    close(fd);
+  }
+  return kTRUE;
+}
+
+/** Name of the file written by FairRunInfo::WriteInfo() for an output file */
+TString RunInfoFileName(const TString& fileName)
+{
+  TString dir = gSystem->DirName(fileName);
+  TString base = gSystem->BaseName(fileName);
+  base.ReplaceAll(".root", "");
+  return (fileName.Contains("/") ? dir + "/" : TString("")) + "FairRunInfo_" + base + ".root";
+}
+
+/** Histograms with one bin per event written by FairRunInfo::WriteInfo(). The
+ ** workers process different events, so these are never summed, not even if
+ ** the workers processed the same number of events. */
+Bool_t IsPerEvent(const TString& name)
+{
+  return name == "ResidentMemoryVsEvent" || name == "VirtualMemoryVsEvent" || name == "EventtimeVsEvent";
+}
+
+/** The bins of the second histogram appended to the first one, both with unit
+ ** bins starting at the same value. NULL if the binning does not fit. */
+TH1* Concatenate(TH1* merged, TH1* h)
+{
+  TAxis* a = merged->GetXaxis();
+  TAxis* b = h->GetXaxis();
+  if (merged->GetDimension() != 1 || h->GetDimension() != 1 || a->GetXmin() != b->GetXmin()
+      || a->GetBinWidth(1) != 1. || b->GetBinWidth(1) != 1.) {
+    return 0;
+  }
+  Int_t n1 = a->GetNbins();
+  Int_t n2 = b->GetNbins();
+  TH1* sum = static_cast<TH1*>(merged->Clone());
+  sum->SetDirectory(0);
+  sum->Reset();
+  sum->SetBins(n1 + n2, a->GetXmin(), a->GetXmin() + n1 + n2);
+  for (Int_t i = 1; i <= n1; i++) {
+    sum->SetBinContent(i, merged->GetBinContent(i));
+    sum->SetBinError(i, merged->GetBinError(i));
+  }
+  for (Int_t i = 1; i <= n2; i++) {
+    sum->SetBinContent(n1 + i, h->GetBinContent(i));
+    sum->SetBinError(n1 + i, h->GetBinError(i));
+  }
+  sum->SetEntries(merged->GetEntries() + h->GetEntries());
+  delete merged;
+  return sum;
+}
+
+/** The histogram of the next worker combined with the merged one of the
+ ** workers before: histograms per event (see IsPerEvent) are concatenated in
+ ** the order of the workers, all others are summed. NULL if they can not be
+ ** merged. */
+TH1* Combine(const TString& name, TH1* merged, TH1* h)
+{
+  if (IsPerEvent(name)) {
+    return Concatenate(merged, h);
+  }
+  TAxis* a = merged->GetXaxis();
+  TAxis* b = h->GetXaxis();
+  if (a->GetNbins() == b->GetNbins() && a->GetXmin() == b->GetXmin() && a->GetXmax() == b->GetXmax()
+      && merged->GetNbinsY() == h->GetNbinsY() && merged->GetNbinsZ() == h->GetNbinsZ()) {
+    merged->Add(h);
+    return merged;
+  }
+  return 0;
+}
+
+/** Merge the objects of a worker file into the target directory: histograms
+ ** are combined, other objects are taken from the first worker. */
+void MergeDirectory(TDirectory* target, TDirectory* source, Int_t worker, const char* skip)
+{
+  std::set<TString> done;
+  TIter next(source->GetListOfKeys());
+  while (TKey* key = dynamic_cast<TKey*>(next())) {
+    TString name = key->GetName();
+    // the keys are sorted with the highest cycle first
+    if ((skip && name == skip) || !done.insert(name).second) {
+      continue;
+    }
+    TClass* cl = TClass::GetClass(key->GetClassName());
+    if (!cl) {
+      continue;
+    }
+    if (cl->InheritsFrom(TDirectory::Class())) {
+      TDirectory* sub = target->GetDirectory(name);
+      if (!sub) { sub = target->mkdir(name); }
+      MergeDirectory(sub, source->GetDirectory(name), worker, 0);
+    } else if (cl->InheritsFrom(TH1::Class())) {
+      TH1* h = static_cast<TH1*>(key->ReadObj());
+      h->SetDirectory(0);
+      TH1* merged = 0;
+      if (target->GetListOfKeys()->FindObject(name)) {
+        merged = dynamic_cast<TH1*>(target->Get(name));
+      }
+      target->cd();
+      if (!merged) {
+        h->Write(name);
+      } else {
+        merged->SetDirectory(0);
+        TH1* sum = Combine(name, merged, h);
+        if (sum) {
+          sum->Write(name, TObject::kOverwrite);
+          delete sum;
+        } else {
+          LOG(WARNING) << "FairRunAnaMP: " << name << " of worker " << worker
+                       << " has a different binning, it is stored separately" << FairLogger::endl;
+          h->Write(Form("%s_worker%d", name.Data(), worker));
+          delete merged;
+        }
+      }
+      delete h;
+    } else if (!target->GetListOfKeys()->FindObject(name)) {
+      TObject* obj = key->ReadObj();
+      target->cd();
+      obj->Write(name);
+      delete obj;
+    }
+  }
+}
+}
+
+//_____________________________________________________________________________
+FairRunAnaMP* FairRunAnaMP::fgMPInstance = 0;
+//_____________________________________________________________________________
+FairRunAnaMP* FairRunAnaMP::Instance()
+{
+  return fgMPInstance;
+}
+//_____________________________________________________________________________
+
+//_____________________________________________________________________________
+FairRunAnaMP::FairRunAnaMP(Int_t nWorkers)
+  : FairRunAna(),
+    fNWorkers(nWorkers),
+    fKeepWorkerFiles(kFALSE),
+    fOutFileName("")
+{
+  fgMPInstance = this;
+}
+//_____________________________________________________________________________
+
+//_____________________________________________________________________________
+FairRunAnaMP::~FairRunAnaMP()
+{
+}
+//_____________________________________________________________________________
+
+//_____________________________________________________________________________
+void FairRunAnaMP::Run(Int_t Ev_start, Int_t Ev_end)
+{
+  if (fTimeStamps || !fInFileIsOpen || fNWorkers <= 1) {
+    LOG(INFO) << "FairRunAnaMP: running in one process" << FairLogger::endl;
+    FairRunAna::Run(Ev_start, Ev_end);
+    return;
+  }
+
+  Int_t MaxAllowed = fRootManager->CheckMaxEventNo(Ev_end);
+  if (MaxAllowed == -1) {
+    LOG(WARNING) << "FairRunAnaMP: the number of events is unknown, running in one process" << FairLogger::endl;
+    FairRunAna::Run(Ev_start, Ev_end);
+    return;
+  }
+  if (Ev_end == 0) {
+    if (Ev_start == 0) {
+      Ev_end = MaxAllowed;
+    } else {
+      Ev_end = Ev_start;
+      Ev_start = 0;
+    }
+  }
+  if (Ev_end > MaxAllowed) {
+    LOG(WARNING) << "FairRunAnaMP: File has less events than requested, the number of events is set to "
+                 << MaxAllowed << FairLogger::endl;
+    Ev_end = MaxAllowed;
+  }
+  Int_t nEvents = Ev_end - Ev_start;
+  if (nEvents <= 0) {
+    LOG(WARNING) << "FairRunAnaMP: no events to process" << FairLogger::endl;
+    return;
+  }
+  Int_t nWorkers = fNWorkers < nEvents ? fNWorkers : nEvents;
+  fOutFileName = fRootManager->GetOutFile()->GetName();
+
+  LOG(INFO) << "FairRunAnaMP: processing events " << Ev_start << " to " << Ev_end << " in "
+            << nWorkers << " processes" << FairLogger::endl;
+  TStopwatch timer;
+
+  // nothing buffered by the parent may be written again by the workers
+  std::cout.flush();
+  fflush(stdout);
+  fflush(stderr);
+
+  std::vector<pid_t> pids;
+  for (Int_t i = 0; i < nWorkers; i++) {
+    Int_t first = Ev_start + static_cast<Int_t>(static_cast<Long64_t>(nEvents) * i / nWorkers);
+    Int_t last = Ev_start + static_cast<Int_t>(static_cast<Long64_t>(nEvents) * (i + 1) / nWorkers);
+    pid_t pid = fork();
+    if (pid == 0) {
+      RunWorker(i, first, last);
+    }
+    if (pid < 0) {
+      LOG(ERROR) << "FairRunAnaMP: Could not start worker " << i << FairLogger::endl;
+      break;
+    }
+    pids.push_back(pid);
+  }
+
+  std::vector<Int_t> workers;
+  for (size_t i = 0; i < pids.size(); i++) {
+    int status = 0;
+    if (waitpid(pids[i], &status, 0) == pids[i] && WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+      workers.push_back(i);
+    } else {
+      LOG(ERROR) << "FairRunAnaMP: worker " << i << " failed, its events are missing in the output"
+                 << FairLogger::endl;
+    }
+  }
+  Double_t processTime = timer.RealTime();
+  timer.Start();
+
+  if (MergeWorkers(workers) && workers.size() == static_cast<size_t>(nWorkers) && !fKeepWorkerFiles) {
+    for (Int_t i = 0; i < nWorkers; i++) {
+      gSystem->Unlink(GetWorkerFileName(i));
+      if (fGenerateRunInfo) { gSystem->Unlink(RunInfoFileName(GetWorkerFileName(i))); }
+    }
+  }
+  fRootManager->Write();
+
+  LOG(INFO) << "FairRunAnaMP: " << nEvents << " events in " << nWorkers << " processes, "
+            << processTime << " s (" << nEvents / processTime << " events/s), merged in "
+            << timer.RealTime() << " s" << FairLogger::endl;
+}
+//_____________________________________________________________________________
+
+//_____________________________________________________________________________
+void FairRunAnaMP::RunWorker(Int_t worker, Int_t NStart, Int_t NStop)
+{
+  if (!ReopenInputFiles()) {
+    _exit(1);
+  }
+
+  // the output file of the parent is not touched by the worker
+  TFile* parentFile = fRootManager->GetOutFile();
+  gROOT->GetListOfFiles()->Remove(parentFile);
+  TFile* outFile = new TFile(GetWorkerFileName(worker), "RECREATE");
+  if (outFile->IsZombie()) {
+    LOG(ERROR) << "FairRunAnaMP: Could not open " << outFile->GetName() << FairLogger::endl;
+    _exit(1);
+  }
+  fRootManager->GetOutTree()->SetDirectory(outFile);
+  fRootManager->SetOutFile(outFile);
+  fOutFile = outFile;
+  outFile->cd();
+
+  LOG(INFO) << "FairRunAnaMP: worker " << worker << " (pid " << gSystem->GetPid() << ") processes events "
+            << NStart << " to " << NStop << FairLogger::endl;
+  FairRunAna::Run(NStart, NStop);
+  outFile->Close();
+
+  // exit without the destructors and atexit handlers, they belong to the parent
+  std::cout.flush();
+  fflush(stdout);
+  fflush(stderr);
+  _exit(0);
+}
+//_____________________________________________________________________________
+
+//_____________________________________________________________________________
+Bool_t FairRunAnaMP::MergeWorkers(const std::vector<Int_t>& workers)
+{
+  TFile* outFile = fRootManager->GetOutFile();
+  TTree* outTree = fRootManager->GetOutTree();
+  TFile* runInfoFile = 0;
+  if (fGenerateRunInfo) {
+    runInfoFile = new TFile(RunInfoFileName(fOutFileName), "RECREATE");
+  }
+
+  Bool_t ok = kTRUE;
+  for (size_t i = 0; i < workers.size(); i++) {
+    TString fileName = GetWorkerFileName(workers[i]);
+    TFile* in = TFile::Open(fileName);
+    if (!in || in->IsZombie()) {
+      LOG(ERROR) << "FairRunAnaMP: Could not open " << fileName << FairLogger::endl;
+      delete in;
+      ok = kFALSE;
+      continue;
+    }
+    // the workers process consecutive entry ranges, appended in their order
+    TTree* tree = dynamic_cast<TTree*>(in->Get(outTree->GetName()));
+    if (tree) {
+      outFile->cd();
+      outTree->CopyEntries(tree, -1, "fast");
+    }
+    MergeDirectory(outFile, in, workers[i], outTree->GetName());
+    delete in;
+
+    if (runInfoFile) {
+      TFile* info = TFile::Open(RunInfoFileName(fileName));
+      if (info && !info->IsZombie()) {
+        MergeDirectory(runInfoFile, info, workers[i], 0);
+      }
+      delete info;
+    }
+  }
+
+  if (runInfoFile) {
+    runInfoFile->Close();
+    delete runInfoFile;
+  }
+  outFile->cd();
+  LOG(INFO) << "FairRunAnaMP: merged " << outTree->GetEntries() << " entries of " << workers.size()
+            << " workers into " << fOutFileName << FairLogger::endl;
+  return ok;
+}
+//_____________________________________________________________________________
+
+//_____________________________________________________________________________
+TString FairRunAnaMP::GetWorkerFileName(Int_t worker) const
+{
+  TString name = fOutFileName;
+  if (name.EndsWith(".root")) {
+    name.Remove(name.Length() - 5);
+  }
+  name += Form("_worker%d.root", worker);
+  return name;
+}
+//_____________________________________________________________________________
+
+ClassImp(FairRunAnaMP)
@@ -0,0 +1,77 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#ifndef FAIRRUNANAMP_H
+#define FAIRRUNANAMP_H
+
+/**
+ * Runs the analysis in several local processes, without PROOF.
+ *
+ * Init() is done once, as for FairRunAna. Run() then forks the worker
+ * processes, which share the geometry, the parameters and the initialized
+ * tasks with the parent (copy on write). Each worker processes a contiguous
+ * part of the requested entry range with the usual task chain and writes its
+ * own output file. The parent waits for the workers and appends their output
+ * trees in the order of the entries to the output tree, merges the histograms
+ * of the output files (e.g. the FairMonitor results) and the FairRunInfo
+ * files, and removes the worker files.
+ *
+ * Only local input files can be read, the workers reopen them to get their
+ * own file offsets.
+ */
+
+#include "FairRunAna.h"                 // for FairRunAna
+
+#include "Rtypes.h"                     // for Int_t, Bool_t, etc
+#include "TString.h"                    // for TString
+
+#include <vector>                       // for vector
+
+class FairRunAnaMP : public FairRunAna
+{
+
+  public:
+
+    static FairRunAnaMP* Instance();
+    FairRunAnaMP(Int_t nWorkers = 4);
+    virtual ~FairRunAnaMP();
+
+    using FairRunAna::Run;
+    /**Run from event number NStart to event number NStop in the worker processes*/
+    void        Run(Int_t NStart=0, Int_t NStop=0);
+
+    /** Number of worker processes */
+    void        SetNWorkers(Int_t nWorkers) { fNWorkers = nWorkers; }
+    Int_t       GetNWorkers() const { return fNWorkers; }
+    /** Keep the output files of the workers after merging them */
+    void        SetKeepWorkerFiles(Bool_t keep = kTRUE) { fKeepWorkerFiles = keep; }
+
+  private:
+
+    /** event loop of a worker process, does not return */
+    void        RunWorker(Int_t worker, Int_t NStart, Int_t NStop);
+    /** merge the worker outputs into the output file */
+    Bool_t      MergeWorkers(const std::vector<Int_t>& workers);
+    /** output file name of a worker */
+    TString     GetWorkerFileName(Int_t worker) const;
+
+    FairRunAnaMP(const FairRunAnaMP&);
+    FairRunAnaMP& operator=(const FairRunAnaMP&);
+
+    static FairRunAnaMP*                    fgMPInstance;
+    /** number of worker processes */
+    Int_t                                   fNWorkers;
+    /** keep the worker output files */
+    Bool_t                                  fKeepWorkerFiles;
+    /** name of the output file */
+    TString                                 fOutFileName; //!
+
+    ClassDef(FairRunAnaMP ,1)
+
+};
+
+#endif //FAIRRUNANAMP_H
@@ -87,6 +87,17 @@ class FairRunSim : public FairRun
     /** Set the material file name to be used */
     void    SetMaterials(const char* MatFileName);
 
+    /** return the full path of the material file */
+    const char* GetMaterialFile() { return MatFname.Data(); }
+
+    /**
+     * Use a geometry cache file. If it was written for the same media and
+     * geometry files the modules do not construct their geometry, otherwise
+     * it is (re)written after the construction.
+     */
+    void    SetGeometryCache(const char* fileName) { fGeoCacheFile = fileName; }
+    TString GetGeometryCache() { return fGeoCacheFile; }
+
     /**switch On/Off the track visualisation */
     void SetStoreTraj(Bool_t storeTraj=kTRUE) {fStoreTraj = storeTraj;}
 
@@ -187,9 +198,10 @@ class FairRunSim : public FairRun
     TObjArray*             fMeshList; //!                          /** radiation grid scoring
     TString                fUserConfig; //!                        /** Macro for geant configuration*/
     TString                fUserCuts; //!                          /** Macro for geant cuts*/
+    TString                fGeoCacheFile; //!                      /** Geometry cache file */
 
 
-    ClassDef(FairRunSim ,2)
+    ClassDef(FairRunSim ,3)
 
 };
 
@@ -17,6 +17,8 @@
 #include "TTree.h"                      // for TTree
 
 #include <stddef.h>                     // for NULL
+#include <algorithm>                    // for upper_bound
+#include <typeinfo>                     // for typeid
 
 ClassImp(FairTSBufferFunctional);
 
@@ -31,7 +33,12 @@ FairTSBufferFunctional::FairTSBufferFunctional(TString branchName, TTree* source
    fBranch(NULL),
    fBranchIndex(-1),
    fTerminate(kFALSE),
-   fVerbose(0)
+   fVerbose(0),
+   fUseTimeIndex(kTRUE),
+   fTimeIndexBuilt(kFALSE),
+   fTimeOrdered(kFALSE),
+   fEntryStart(),
+   fTimes()
 {
   fBranch = sourceTree->GetBranch(branchName.Data());
   if (fBranch == 0) {
@@ -59,6 +66,10 @@ TClonesArray* FairTSBufferFunctional::GetData(Double_t stopParameter)
     std::cout << "-I- FairTSBufferFunctional::GetData for stopParameter: " << stopParameter << std::endl;
   }
 
+  if (UseTimeIndex(fStopFunction)) {
+    return GetDataFromTimeIndex(stopParameter);
+  }
+
   //if the BufferArray is empty fill it
   if (fBufferArray->GetEntriesFast() == 0) {
     if (fVerbose > 1) {
@@ -133,7 +144,9 @@ TClonesArray* FairTSBufferFunctional::GetData(Double_t startParameter, Double_t
   if (fStartFunction != 0) {
     fBufferArray->Clear();
     Int_t startIndex = FindStartIndex(startParameter);
-    std::cout << "StartIndex: " << startIndex << "/" << GetBranchIndex() << std::endl;
+    if (fVerbose > 0) {
+      std::cout << "StartIndex: " << startIndex << "/" << GetBranchIndex() << std::endl;
+    }
     if (startIndex > -1) {
       ReadInEntry(fBranchIndex);
       fBufferArray->AbsorbObjects(fInputArray, startIndex, fInputArray->GetEntries() -1);
@@ -144,6 +157,13 @@ TClonesArray* FairTSBufferFunctional::GetData(Double_t startParameter, Double_t
 
 Int_t FairTSBufferFunctional::FindStartIndex(Double_t startParameter)
 {
+  if (fUseTimeIndex && !fTimeIndexBuilt && fStartFunction != 0 && typeid(*fStartFunction) == typeid(StopTime)) {
+    BuildTimeIndex();
+  }
+  if (UseTimeIndex(fStartFunction)) {
+    return FindStartIndexInTimeIndex(startParameter);
+  }
+
   FairTimeStamp* dataPoint;
   Int_t tempIndex = fBranchIndex;
   Bool_t runBackwards = kTRUE;
@@ -209,6 +229,19 @@ void FairTSBufferFunctional::ReadInNextFilledEntry()
 {
   fInputArray->Delete();
 
+  if (fTimeIndexBuilt) {
+    // the next filled entry is the one after the last entry starting at the same position as fBranchIndex + 1
+    Long64_t nextData = fEntryStart[fBranchIndex + 1];
+    Int_t nextEntry = std::upper_bound(fEntryStart.begin() + fBranchIndex + 1, fEntryStart.end(), nextData) - fEntryStart.begin() - 1;
+    if (nextEntry + 1 < static_cast<Int_t>(fEntryStart.size())) {
+      fBranchIndex = nextEntry;
+      ReadInEntry(fBranchIndex);
+    } else if (fBranch->GetEntries() > 0) {
+      fBranchIndex = fBranch->GetEntries() - 1;
+    }
+    return;
+  }
+
   if (fVerbose > 1) {
     std::cout << "-I- FairTSBufferFunctional::ReadInNextFilledEntry: Entries in InputArray " << fInputArray->GetEntriesFast() << " Branch Entries: " << fBranch->GetEntries() << std::endl;
   }
@@ -277,3 +310,98 @@ Bool_t FairTSBufferFunctional::AllDataProcessed()
     } else { return kFALSE; }
   } else { return kFALSE; }
 }
+
+void FairTSBufferFunctional::BuildTimeIndex()
+{
+  fTimeIndexBuilt = kTRUE;
+  fTimeOrdered = kTRUE;
+  Int_t nEntries = fBranch->GetEntries();
+  fEntryStart.assign(1, 0);
+  fEntryStart.reserve(nEntries + 1);
+  fTimes.clear();
+
+  for (Int_t entry = 0; entry < nEntries; entry++) {
+    fInputArray->Delete();
+    fBranch->GetEntry(entry);
+    for (Int_t i = 0; i < fInputArray->GetEntriesFast(); i++) {
+      Double_t time = ((FairTimeStamp*) fInputArray->At(i))->GetTimeStamp();
+      if (!fTimes.empty() && time < fTimes.back()) {
+        fTimeOrdered = kFALSE;
+      }
+      fTimes.push_back(time);
+    }
+    fEntryStart.push_back(fTimes.size());
+  }
+  fInputArray->Delete();
+
+  if (fVerbose > 0 || !fTimeOrdered) {
+    std::cout << "-I- FairTSBufferFunctional::BuildTimeIndex for branch " << fBranch->GetName() << ": " << fTimes.size()
+              << " data in " << nEntries << " entries" << (fTimeOrdered ? "" : " are not time ordered, the index is not used") << std::endl;
+  }
+}
+
+Bool_t FairTSBufferFunctional::UseTimeIndex(BinaryFunctor* function)
+{
+  return fUseTimeIndex && fTimeIndexBuilt && fTimeOrdered && function != 0 && typeid(*function) == typeid(StopTime);
+}
+
+Int_t FairTSBufferFunctional::FindStartIndexInTimeIndex(Double_t startParameter)
+{
+  // the first data which is later than the start time, as found by the linear search for ordered data
+  Long64_t startData = std::upper_bound(fTimes.begin(), fTimes.end(), startParameter) - fTimes.begin();
+
+  if (fTimes.empty()) {
+    std::cout << "-I- FairTSBufferFunctional::FindStartIndex: All entries are empty!" << std::endl;
+  } else {
+    // the functor has to see the request as it does in the linear search
+    FairTimeStamp probe(fTimes[startData < static_cast<Long64_t>(fTimes.size()) ? startData : fTimes.size() - 1]);
+    (*fStartFunction)(&probe, startParameter);
+  }
+
+  fInputArray->Delete();
+  if (startData == static_cast<Long64_t>(fTimes.size())) {
+    fBranchIndex = fBranch->GetEntries() - 1;
+    return -1;
+  }
+  fBranchIndex = std::upper_bound(fEntryStart.begin(), fEntryStart.end(), startData) - fEntryStart.begin() - 1;
+  return startData - fEntryStart[fBranchIndex];
+}
+
+TClonesArray* FairTSBufferFunctional::GetDataFromTimeIndex(Double_t stopParameter)
+{
+  if (fBufferArray->GetEntriesFast() == 0) {
+    ReadInNextFilledEntry();
+    AbsorbDataBufferArray();
+  }
+  Int_t nBuffer = fBufferArray->GetEntriesFast();
+  if (nBuffer == 0) {
+    if (fVerbose > 0) {
+      std::cout << "-I- FairTSBufferFunctional::GetData dataPoint is empty ==> All Data read in" << std::endl;
+    }
+    return fOutputArray;
+  }
+
+  // the buffer always ends with the last data of the entry fBranchIndex
+  Long64_t bufferStart = fEntryStart[fBranchIndex + 1] - nBuffer;
+  Long64_t stopData = std::upper_bound(fTimes.begin() + bufferStart, fTimes.end(), stopParameter) - fTimes.begin();
+
+  FairTimeStamp probe(fTimes[stopData < static_cast<Long64_t>(fTimes.size()) ? stopData : fTimes.size() - 1]);
+  (*fStopFunction)(&probe, stopParameter);
+  if (stopData == bufferStart) {
+    return fOutputArray;
+  }
+
+  // read in the entries up to the one with the first data after the stop time
+  while (fEntryStart[fBranchIndex + 1] <= stopData && fBranchIndex + 1 < fBranch->GetEntries()) {
+    ReadInNextFilledEntry();
+    AbsorbDataBufferArray();
+  }
+
+  Int_t posBuffer = stopData - bufferStart;
+  if (fVerbose > 1) {
+    std::cout << "-I- FairTSBufferFunctional::GetData absorb BufferArray up to posBuffer " << posBuffer << " of "
+              << fBufferArray->GetEntriesFast() << " into fOutputArray" << std::endl;
+  }
+  fOutputArray->AbsorbObjects(fBufferArray, 0, posBuffer - 1);
+  return fOutputArray;
+}
@@ -17,6 +17,7 @@
 
 #include <functional>                   // for binary_function
 #include <iostream>                     // for operator<<, basic_ostream, etc
+#include <vector>                       // for vector
 
 class TBranch;
 class TClonesArray;
@@ -146,6 +147,11 @@ class TimeGap : public BinaryFunctor
  * Addition: This is not true anymore. GetData(Double_t, Double_t) is able to get also data which is older but this only works if you request a fixed time
  * via StopTime functor. For other functors the behavior is unpredictable.
  *
+ * With StopTime functors GetData(Double_t, Double_t) builds at the first call an index of the time stamps of all entries of the branch.
+ * If the data is time ordered the start and the end of the requested window are then found by a binary search in the index and empty
+ * entries are skipped without reading them, instead of checking the data element by element and reading the entries back and forth.
+ * The index can be switched off with SetTimeIndex(kFALSE).
+ *
  *  Created on: Feb 18, 201
  *      Author: stockman
  */
@@ -166,6 +172,8 @@ class FairTSBufferFunctional : public TObject
     void SetStopFunction(BinaryFunctor* function)  { fStopFunction  = function;}
     Bool_t AllDataProcessed();
     void Terminate(){ fTerminate = kTRUE; }
+    /** Use the time index for StopTime functors, on by default */
+    void SetTimeIndex(Bool_t use) { fUseTimeIndex = use; }
 
     Bool_t TimeOut() {
       Bool_t stopTimeOut = fStopFunction->TimeOut();
@@ -192,6 +200,11 @@ class FairTSBufferFunctional : public TObject
     void ReadInEntry(Int_t number);
     void AbsorbDataBufferArray(); //< Absorbs the complete data from fInputArray to fBufferArray
 
+    void BuildTimeIndex();        //< Reads all entries once and fills fEntryStart and fTimes
+    Bool_t UseTimeIndex(BinaryFunctor* function); //< True if the index is built and valid for the functor
+    Int_t FindStartIndexInTimeIndex(Double_t startParameter);
+    TClonesArray* GetDataFromTimeIndex(Double_t stopParameter);
+
     TClonesArray* fOutputArray;
     TClonesArray* fBufferArray;
     TClonesArray* fInputArray;
@@ -206,6 +219,12 @@ class FairTSBufferFunctional : public TObject
 
     Int_t fVerbose;
 
+    Bool_t fUseTimeIndex;
+    Bool_t fTimeIndexBuilt;
+    Bool_t fTimeOrdered;                  //< all time stamps in fTimes are in ascending order
+    std::vector<Long64_t> fEntryStart;    //! position of the first data of each entry in fTimes, one more for the end
+    std::vector<Double_t> fTimes;         //! time stamps of all data of the branch in the order of the entries
+
     FairTSBufferFunctional(const FairTSBufferFunctional&);
     FairTSBufferFunctional& operator=(const FairTSBufferFunctional&);
 
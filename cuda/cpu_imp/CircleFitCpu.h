@@ -0,0 +1,60 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * CircleFitCpu.h
+ *
+ * CPU implementation of the batched circle fit of cuda_imp/trackfit_kernel.cu.
+ * The input layout is the same as for CircleFitGAllD/CircleFitGAllF: HIT hits
+ * per track stored contiguously, track after track, 8 result values per track.
+ *
+ * Two kernels are provided: a scalar reference which fits one track after the
+ * other, and a vector kernel which fits CIRCLEFIT_LANES tracks at a time with
+ * the track index as the innermost loop. Both perform the same floating point
+ * operations in the same order for every track, so their results agree bit by
+ * bit (the library is compiled with -ffp-contract=off for that reason).
+ * Batches of tracks are distributed over a pool of worker threads.
+ */
+
+#ifndef _CIRCLEFITCPU_H_
+#define _CIRCLEFITCPU_H_
+
+#include "../cuda_imp/HitTrk.h"
+
+#define CIRCLEFIT_LANES 8
+
+/// Kernel used by the CPU circle fit
+enum CircleFitCMode
+{
+    kCircleFitScalar = 0,
+    kCircleFitVector = 1
+};
+
+/// Fits TRK tracks with the kernel and number of threads set by CircleFitCSetMode/CircleFitCSetNumThreads
+extern "C" void CircleFitCAllD(double X[TRK*HIT], double Y[TRK*HIT], double Z[TRK*HIT], double Zerr[TRK*HIT], double Mx[TRK], double My[TRK], double M0[TRK], double result[8*TRK]);
+
+extern "C" void CircleFitCAllF(float X[TRK*HIT], float Y[TRK*HIT], float Z[TRK*HIT], float Zerr[TRK*HIT], float Mx[TRK], float My[TRK], float M0[TRK], float result[8*TRK]);
+
+/// Fits nTracks tracks with an explicit kernel and number of threads (0 = use CircleFitCSetNumThreads)
+extern "C" void CircleFitCBatchD(const double* X, const double* Y, const double* Z, const double* Zerr, const double* Mx, const double* My, const double* M0, double* result, int nTracks, int mode, int nThreads);
+
+extern "C" void CircleFitCBatchF(const float* X, const float* Y, const float* Z, const float* Zerr, const float* Mx, const float* My, const float* M0, float* result, int nTracks, int mode, int nThreads);
+
+/// Fits one track in the calling thread, the chi2 is normalised as by CircleFitG/CircleFitGF
+extern "C" void CircleFitCD(const double* X, const double* Y, const double* Z, const double* Zerr, const double* Mx, const double* My, const double* M0, double* result, int mode);
+
+extern "C" void CircleFitCF(const float* X, const float* Y, const float* Z, const float* Zerr, const float* Mx, const float* My, const float* M0, float* result, int mode);
+
+/// Selects the kernel used by CircleFitCAllD/CircleFitCAllF (default: kCircleFitVector if compiled for AVX, kCircleFitScalar otherwise)
+extern "C" void CircleFitCSetMode(int mode);
+
+extern "C" int CircleFitCGetMode();
+
+/// Sets the number of threads (default: number of hardware threads, 1 = run in the calling thread)
+extern "C" void CircleFitCSetNumThreads(int nThreads);
+
+#endif // _CIRCLEFITCPU_H_
@@ -0,0 +1,83 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * CircleFitCpuInput.h
+ *
+ * Reproducible helix-like tracks for the test and the benchmark of the CPU circle fit.
+ */
+
+#ifndef _CIRCLEFITCPUINPUT_H_
+#define _CIRCLEFITCPUINPUT_H_
+
+#include "CircleFitCpu.h"
+
+#include <cmath>
+#include <vector>
+
+template<typename T>
+struct CircleFitInput
+{
+    std::vector<T> X, Y, Z, Zerr, Mx, My, M0;
+
+    explicit CircleFitInput(int nTracks)
+        : X(HIT * nTracks), Y(HIT * nTracks), Z(HIT * nTracks), Zerr(HIT * nTracks)
+        , Mx(nTracks), My(nTracks), M0(nTracks)
+        , fSeed(4711)
+    {
+        for (int trk = 0; trk < nTracks; trk++)
+        {
+            double radius = 20. + 480. * Uniform();
+            double phi0 = 2. * M_PI * Uniform();
+            double slope = 2. * Uniform() - 1.;
+            double offset = 10. * Uniform() - 5.;
+            double cx = radius * cos(phi0);
+            double cy = radius * sin(phi0);
+
+            double sumX = 0., sumY = 0.;
+            for (int i = 0; i < HIT; i++)
+            {
+                // hits along the arc starting at the origin, with some smearing
+                double phi = phi0 + M_PI + (i + 1) * 40. / radius / HIT;
+                double x = cx + radius * cos(phi) + 0.01 * (Uniform() - 0.5);
+                double y = cy + radius * sin(phi) + 0.01 * (Uniform() - 0.5);
+                double rho = sqrt(x * x + y * y);
+                X[i + HIT * trk] = x;
+                Y[i + HIT * trk] = y;
+                Z[i + HIT * trk] = slope * rho + offset + 0.1 * (Uniform() - 0.5);
+                // every 7th hit has no z information
+                Zerr[i + HIT * trk] = (i % 7 == 3) ? 0. : 0.05 + 0.1 * Uniform();
+                sumX += x;
+                sumY += y;
+            }
+            Mx[trk] = sumX / HIT;
+            My[trk] = sumY / HIT;
+            M0[trk] = HIT;
+        }
+    }
+
+  private:
+    double Uniform()
+    {
+        fSeed = fSeed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (fSeed >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    unsigned long long fSeed;
+};
+
+inline void CircleFitCBatch(const CircleFitInput<double>& in, double* result, int nTracks, int mode, int nThreads)
+{
+    CircleFitCBatchD(&in.X[0], &in.Y[0], &in.Z[0], &in.Zerr[0], &in.Mx[0], &in.My[0], &in.M0[0], result, nTracks, mode, nThreads);
+}
+
+inline void CircleFitCBatch(const CircleFitInput<float>& in, float* result, int nTracks, int mode, int nThreads)
+{
+    CircleFitCBatchF(&in.X[0], &in.Y[0], &in.Z[0], &in.Zerr[0], &in.Mx[0], &in.My[0], &in.M0[0], result, nTracks, mode, nThreads);
+}
+
+#endif // _CIRCLEFITCPUINPUT_H_
@@ -0,0 +1,65 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * benchCircleFitCpu.cxx
+ *
+ * Throughput of the CPU circle fit in tracks per second.
+ * Usage: benchCircleFitCpu [repetitions] [threads]
+ */
+
+#include "CircleFitCpu.h"
+#include "CircleFitCpuInput.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <boost/thread.hpp>
+#include <boost/chrono.hpp>
+
+using namespace std;
+
+template<typename T>
+void Measure(const char* type, const char* name, int mode, int nThreads, int nRepetitions)
+{
+    CircleFitInput<T> in(TRK);
+    vector<T> result(8 * TRK, 0);
+
+    // warm up the pool and the caches
+    CircleFitCBatch(in, &result[0], TRK, mode, nThreads);
+
+    boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+    for (int i = 0; i < nRepetitions; i++)
+    {
+        CircleFitCBatch(in, &result[0], TRK, mode, nThreads);
+    }
+    double seconds = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+
+    printf("%-7s %-7s %3d thread(s): %12.0f tracks/s\n", type, name, nThreads, double(TRK) * nRepetitions / seconds);
+}
+
+int main(int argc, char** argv)
+{
+    int nRepetitions = argc > 1 ? atoi(argv[1]) : 200;
+    int nThreads = argc > 2 ? atoi(argv[2]) : boost::thread::hardware_concurrency();
+    if (nThreads < 1)
+    {
+        nThreads = 1;
+    }
+
+    CircleFitCSetNumThreads(nThreads);
+
+    Measure<double>("double", "scalar", kCircleFitScalar, 1, nRepetitions);
+    Measure<double>("double", "vector", kCircleFitVector, 1, nRepetitions);
+    Measure<double>("double", "vector", kCircleFitVector, nThreads, nRepetitions);
+    Measure<float>("float", "scalar", kCircleFitScalar, 1, nRepetitions);
+    Measure<float>("float", "vector", kCircleFitVector, 1, nRepetitions);
+    Measure<float>("float", "vector", kCircleFitVector, nThreads, nRepetitions);
+
+    return 0;
+}
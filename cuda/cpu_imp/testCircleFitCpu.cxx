@@ -0,0 +1,141 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * testCircleFitCpu.cxx
+ *
+ * Checks that the vector kernel and the threaded fit of the CPU circle fit
+ * agree bit by bit with the scalar reference, and that the single track fits
+ * normalise the chi2 of the line errors as the single track GPU kernels do.
+ */
+
+#include "CircleFitCpu.h"
+#include "CircleFitCpuInput.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+template<typename T>
+int Compare(const char* name, const vector<T>& reference, const vector<T>& result)
+{
+    int nBad = 0;
+    for (size_t i = 0; i < reference.size(); i++)
+    {
+        if (memcmp(&reference[i], &result[i], sizeof(T)) != 0)
+        {
+            if (nBad < 10)
+            {
+                printf("%s: track %d, value %d differs: %.17g != %.17g\n", name, int(i / 8), int(i % 8), double(reference[i]), double(result[i]));
+            }
+            ++nBad;
+        }
+    }
+    if (nBad > 0)
+    {
+        printf("%s: %d of %d values differ\n", name, nBad, int(reference.size()));
+    }
+    return nBad;
+}
+
+template<typename T>
+int Check(const char* type, int nTracks)
+{
+    CircleFitInput<T> in(nTracks);
+
+    vector<T> reference(8 * nTracks, 0);
+    CircleFitCBatch(in, &reference[0], nTracks, kCircleFitScalar, 1);
+
+    int nBad = 0;
+
+    vector<T> vector1(8 * nTracks, 0);
+    CircleFitCBatch(in, &vector1[0], nTracks, kCircleFitVector, 1);
+    nBad += Compare((string(type) + " vector").c_str(), reference, vector1);
+
+    vector<T> vector4(8 * nTracks, 0);
+    CircleFitCBatch(in, &vector4[0], nTracks, kCircleFitVector, 4);
+    nBad += Compare((string(type) + " vector 4 threads").c_str(), reference, vector4);
+
+    vector<T> scalar4(8 * nTracks, 0);
+    CircleFitCBatch(in, &scalar4[0], nTracks, kCircleFitScalar, 4);
+    nBad += Compare((string(type) + " scalar 4 threads").c_str(), reference, scalar4);
+
+    return nBad;
+}
+
+inline void CircleFitC(const double* X, const double* Y, const double* Z, const double* Zerr, const double* Mx, const double* My, const double* M0, double* result, int mode)
+{
+    CircleFitCD(X, Y, Z, Zerr, Mx, My, M0, result, mode);
+}
+
+inline void CircleFitC(const float* X, const float* Y, const float* Z, const float* Zerr, const float* Mx, const float* My, const float* M0, float* result, int mode)
+{
+    CircleFitCF(X, Y, Z, Zerr, Mx, My, M0, result, mode);
+}
+
+/// The single track fit has to give the batched result with the line errors scaled
+/// by sqrt(25 / chi2Norm), chi2Norm being the one of the GPU kernel CircleFitG/CircleFitGF
+template<typename T>
+int CheckSingle(const char* type, double chi2Norm, double tolerance, int nTracks)
+{
+    CircleFitInput<T> in(nTracks);
+
+    vector<T> batch(8 * nTracks, 0);
+    CircleFitCBatch(in, &batch[0], nTracks, kCircleFitScalar, 1);
+
+    int nBad = 0;
+    for (int mode = kCircleFitScalar; mode <= kCircleFitVector; mode++)
+    {
+        for (int trk = 0; trk < nTracks; trk++)
+        {
+            T single[8] = { 0 };
+            CircleFitC(&in.X[HIT * trk], &in.Y[HIT * trk], &in.Z[HIT * trk], &in.Zerr[HIT * trk], &in.Mx[trk], &in.My[trk], &in.M0[trk], single, mode);
+
+            const T* reference = &batch[8 * trk];
+            for (int i = 0; i < 8; i++)
+            {
+                double expected = i < 6 ? double(reference[i]) : reference[i] * sqrt(25. / chi2Norm);
+                if (fabs(single[i] - expected) > tolerance * fabs(expected))
+                {
+                    if (nBad < 10)
+                    {
+                        printf("%s single, mode %d: track %d, value %d differs: %.17g != %.17g\n", type, mode, trk, i, double(single[i]), expected);
+                    }
+                    ++nBad;
+                }
+            }
+        }
+    }
+    return nBad;
+}
+
+int main(int argc, char** argv)
+{
+    CircleFitCSetNumThreads(4);
+
+    int nBad = 0;
+    // full batch as used by CircleFitCAllD/F and a size which leaves a partial block of lanes
+    nBad += Check<double>("double", TRK);
+    nBad += Check<double>("double", 1003);
+    nBad += Check<float>("float", TRK);
+    nBad += Check<float>("float", 1003);
+    nBad += CheckSingle<double>("double", 30., 1.e-12, 100);
+    nBad += CheckSingle<float>("float", 13., 1.e-5, 100);
+
+    if (nBad > 0)
+    {
+        printf("CircleFit CPU test failed\n");
+        return 1;
+    }
+
+    printf("CircleFit CPU test successfull\n");
+    return 0;
+}
@@ -0,0 +1,687 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * trackfit_cpu.cxx
+ *
+ * CPU port of the circle fit in trackfit_kernel.cu. The arithmetic follows the
+ * single track Fit/FitF kernels (moments summed over all hits of a track in hit
+ * order). The kernels normalise the chi2 differently for the errors of the line
+ * fit, the CPU functions use the one of the kernel they replace.
+ */
+
+#include "CircleFitCpu.h"
+
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+#include <boost/thread.hpp>
+#include <boost/function.hpp>
+#include <boost/bind/bind.hpp>
+#include <boost/shared_ptr.hpp>
+
+using namespace std;
+
+namespace
+{
+
+/// Number of tracks handed to a worker thread at a time
+const int kTracksPerBatch = 16 * CIRCLEFIT_LANES;
+
+/// chi2 normalisations of the batched FitAllD/FitAllF and the single track Fit/FitF kernels
+const double kChi2NormBatch = 25.;
+const double kChi2NormSingleD = 30.;
+const double kChi2NormSingleF = 13.;
+
+// The vector kernel is faster than the scalar one only with wide vector units,
+// with the baseline SSE2 of x86-64 it is slower.
+#if defined(__AVX__)
+int gMode = kCircleFitVector;
+#else
+int gMode = kCircleFitScalar;
+#endif
+
+template<typename T>
+inline T Weight(T zErr)
+{
+    if (zErr > 0.001)
+    {
+        return 1 / (zErr * zErr);
+    }
+    return 0.0;
+}
+
+/// Coefficients of the characteristic polynomial solved by the Newton iteration
+template<typename T>
+struct Polynomial
+{
+    T Mz, Cov_xy, A0, A1, A2, A22;
+
+    Polynomial(T Mxx, T Myy, T Mxy, T Mxz, T Myz, T Mzz)
+    {
+        T Mxz2, Myz2;
+        Mz = Mxx + Myy;
+        Cov_xy = Mxx * Myy - Mxy * Mxy;
+        Mxz2 = Mxz * Mxz;
+        Myz2 = Myz * Myz;
+
+        A2 = 4. * Cov_xy - 3. * Mz * Mz - Mzz;
+        A1 = Mzz * Mz + 4. * Cov_xy * Mz - Mxz2 - Myz2 - Mz * Mz * Mz;
+        A0 = Mxz2 * Myy + Myz2 * Mxx - Mzz * Cov_xy - 2. * Mxz * Myz * Mxy + Mz * Mz * Cov_xy;
+
+        A22 = A2 + A2;
+    }
+};
+
+const int kIterMax = 20;
+
+template<typename T>
+inline T Epsilon()
+{
+    return 0.000000000001;
+}
+
+template<typename T>
+inline T YOld()
+{
+    return 100000000000.;
+}
+
+/// Circle center and radius from the Newton root, same early returns as the kernel
+template<typename T>
+inline void CircleParameters(const Polynomial<T>& p, T Mxx, T Myy, T Mxy, T Mxz, T Myz, T xnew, T* result)
+{
+    T GAM, DET;
+
+    GAM = -p.Mz - xnew - xnew;
+    DET = xnew * xnew - xnew * p.Mz + p.Cov_xy;
+    if (DET == 0)
+    {
+        return;
+    }
+
+    result[0] = (Mxz * (Myy - xnew) - Myz * Mxy) / DET / 2.;
+    result[1] = (Myz * (Mxx - xnew) - Mxz * Mxy) / DET / 2.;
+    if ((result[0] * result[0] + result[1] * result[1] - GAM) < 0.)
+    {
+        return;
+    }
+
+    result[2] = sqrt(result[0] * result[0] + result[1] * result[1] - GAM);
+}
+
+/// Straight line fit in the rho-z plane, returns the determinant
+template<typename T>
+inline T LineParameters(T wsum, T wx, T wy, T wxx, T wxy, T* result)
+{
+    T mm = 0.;
+    T qq = 0.;
+    T det = wsum * wxx - wx * wx;
+    if (det > 0.00001)
+    {
+        mm = (wxy * wsum - wy * wx) / det;
+        qq = (wy * wxx - wxy * wx) / det;
+    }
+    else
+    {
+        mm = 1000.;
+        qq = 1000.;
+    }
+
+    result[3] = -mm;
+    result[4] = qq;
+    return det;
+}
+
+template<typename T>
+inline void LineErrors(T wsum, T wxx, T det, T chi2, double chi2Norm, T* result)
+{
+    result[5] = chi2;
+
+    if (det > 0.00001)
+    {
+        T varsq = sqrt(chi2 / chi2Norm);
+        result[6] = varsq * sqrt(wsum / det);
+        result[7] = varsq * sqrt(wxx / det);
+    }
+    else
+    {
+        result[6] = 0;
+        result[7] = 0;
+    }
+}
+
+/// Scalar reference: one track at a time
+template<typename T>
+void FitTrack(const T* X, const T* Y, const T* Z1, const T* Z1err, const T* Mx, const T* My, const T* M0, T* result, double chi2Norm, int trk)
+{
+    T Xis[HIT];
+    T Yis[HIT];
+    T Zis[HIT];
+    T Z1s[HIT];
+    T rho[HIT];
+    T fZWeight[HIT];
+
+    for (int i = 0; i < HIT; i++)
+    {
+        Xis[i] = X[i + HIT * trk] - Mx[trk];
+        Yis[i] = Y[i + HIT * trk] - My[trk];
+        Zis[i] = Xis[i] * Xis[i] + Yis[i] * Yis[i];
+        rho[i] = sqrt(Zis[i]);
+        Z1s[i] = Z1[i + HIT * trk];
+        fZWeight[i] = Weight(Z1err[i + HIT * trk]);
+    }
+
+    T Mxx = 0, Myy = 0, Mxy = 0, Mxz = 0, Myz = 0, Mzz = 0;
+    T wsum = 0., wx = 0., wy = 0., wxx = 0., wxy = 0.;
+
+    for (int i = 0; i < HIT; i++)
+    {
+        Mxy += Xis[i] * Yis[i];
+        Mxx += Xis[i] * Xis[i];
+        Myy += Yis[i] * Yis[i];
+        Mxz += Xis[i] * Zis[i];
+        Myz += Yis[i] * Zis[i];
+        Mzz += Zis[i] * Zis[i];
+
+        wsum += fZWeight[i];
+        wx += fZWeight[i] * rho[i];
+        wy += fZWeight[i] * Z1s[i];
+        wxx += fZWeight[i] * rho[i] * rho[i];
+        wxy += fZWeight[i] * rho[i] * Z1s[i];
+    }
+
+    Mxx /= M0[trk];
+    Myy /= M0[trk];
+    Mxy /= M0[trk];
+    Mxz /= M0[trk];
+    Myz /= M0[trk];
+    Mzz /= M0[trk];
+
+    T* res = result + 8 * trk;
+
+    // Newton's method starting at x=0
+    Polynomial<T> p(Mxx, Myy, Mxy, Mxz, Myz, Mzz);
+    T Dy, xnew, xold, ynew;
+    T yold = YOld<T>();
+    T epsilon = Epsilon<T>();
+    xnew = 0.;
+
+    int iter;
+    for (iter = 0; iter < kIterMax; iter++)
+    {
+        ynew = p.A0 + xnew * (p.A1 + xnew * (p.A2 + 4. * xnew * xnew));
+
+        if (fabs(ynew) > fabs(yold))
+        {
+            xnew = 0.;
+            break;
+        }
+
+        Dy = p.A1 + xnew * (p.A22 + 16. * xnew * xnew);
+        xold = xnew;
+        xnew = xold - ynew / Dy;
+
+        if (fabs(xnew) < epsilon)
+        {
+            break;
+        }
+        if (fabs((xnew - xold) / xnew) < epsilon)
+        {
+            break;
+        }
+    }
+
+    if (iter == kIterMax - 1)
+    {
+        xnew = 0.;
+    }
+
+    CircleParameters(p, Mxx, Myy, Mxy, Mxz, Myz, xnew, res);
+
+    T det = LineParameters(wsum, wx, wy, wxx, wxy, res);
+
+    T r1;
+    T chi2 = 0.;
+    for (int i = 0; i < HIT; i++)
+    {
+        r1 = Z1s[i] + res[3] * rho[i] - res[4];
+        chi2 += fZWeight[i] * (r1 * r1);
+    }
+
+    LineErrors(wsum, wxx, det, chi2, chi2Norm, res);
+}
+
+/// Vector kernel: CIRCLEFIT_LANES tracks at a time, the lane is the innermost loop.
+/// nLanes < CIRCLEFIT_LANES for the last block, the unused lanes repeat the first track.
+template<typename T>
+void FitBlock(const T* X, const T* Y, const T* Z1, const T* Z1err, const T* Mx, const T* My, const T* M0, T* result, double chi2Norm, int first, int nLanes)
+{
+    const int L = CIRCLEFIT_LANES;
+
+    // transpose the block into hit-major order so that the lane loops are contiguous
+    T Xs[HIT][L];
+    T Ys[HIT][L];
+    T Z1s[HIT][L];
+    T Errs[HIT][L];
+    T mx[L], my[L], m0[L];
+
+    for (int l = 0; l < L; l++)
+    {
+        int trk = first + (l < nLanes ? l : 0);
+        for (int i = 0; i < HIT; i++)
+        {
+            Xs[i][l] = X[i + HIT * trk];
+            Ys[i][l] = Y[i + HIT * trk];
+            Z1s[i][l] = Z1[i + HIT * trk];
+            Errs[i][l] = Z1err[i + HIT * trk];
+        }
+        mx[l] = Mx[trk];
+        my[l] = My[trk];
+        m0[l] = M0[trk];
+    }
+
+    T rho[HIT][L];
+    T fZWeight[HIT][L];
+    T Mxx[L], Myy[L], Mxy[L], Mxz[L], Myz[L], Mzz[L];
+    T wsum[L], wx[L], wy[L], wxx[L], wxy[L];
+
+    for (int l = 0; l < L; l++)
+    {
+        Mxx[l] = 0; Myy[l] = 0; Mxy[l] = 0; Mxz[l] = 0; Myz[l] = 0; Mzz[l] = 0;
+        wsum[l] = 0.; wx[l] = 0.; wy[l] = 0.; wxx[l] = 0.; wxy[l] = 0.;
+    }
+
+    for (int i = 0; i < HIT; i++)
+    {
+        for (int l = 0; l < L; l++)
+        {
+            T Xis = Xs[i][l] - mx[l];
+            T Yis = Ys[i][l] - my[l];
+            T Zis = Xis * Xis + Yis * Yis;
+            T r = sqrt(Zis);
+            // divide unconditionally and select afterwards, this keeps the loop free of branches
+            T inverse = 1 / (Errs[i][l] * Errs[i][l]);
+            T w = Errs[i][l] > 0.001 ? inverse : T(0.0);
+            rho[i][l] = r;
+            fZWeight[i][l] = w;
+
+            Mxy[l] += Xis * Yis;
+            Mxx[l] += Xis * Xis;
+            Myy[l] += Yis * Yis;
+            Mxz[l] += Xis * Zis;
+            Myz[l] += Yis * Zis;
+            Mzz[l] += Zis * Zis;
+
+            wsum[l] += w;
+            wx[l] += w * r;
+            wy[l] += w * Z1s[i][l];
+            wxx[l] += w * r * r;
+            wxy[l] += w * r * Z1s[i][l];
+        }
+    }
+
+    T A0[L], A1[L], A2[L], A22[L];
+    for (int l = 0; l < L; l++)
+    {
+        Mxx[l] /= m0[l];
+        Myy[l] /= m0[l];
+        Mxy[l] /= m0[l];
+        Mxz[l] /= m0[l];
+        Myz[l] /= m0[l];
+        Mzz[l] /= m0[l];
+
+        Polynomial<T> p(Mxx[l], Myy[l], Mxy[l], Mxz[l], Myz[l], Mzz[l]);
+        A0[l] = p.A0;
+        A1[l] = p.A1;
+        A2[l] = p.A2;
+        A22[l] = p.A22;
+    }
+
+    // Newton's method starting at x=0, a lane stops where the scalar loop would break
+    T xnew[L];
+    int stop[L];
+    bool active[L];
+    const T yold = YOld<T>();
+    const T epsilon = Epsilon<T>();
+
+    for (int l = 0; l < L; l++)
+    {
+        xnew[l] = 0.;
+        stop[l] = kIterMax;
+        active[l] = true;
+    }
+
+    int nActive = L;
+    for (int iter = 0; iter < kIterMax && nActive > 0; iter++)
+    {
+        nActive = 0;
+        for (int l = 0; l < L; l++)
+        {
+            T x = xnew[l];
+            T ynew = A0[l] + x * (A1[l] + x * (A2[l] + 4. * x * x));
+            T Dy = A1[l] + x * (A22[l] + 16. * x * x);
+            T next = x - ynew / Dy;
+
+            // bitwise operators instead of && and || to avoid branches
+            bool wrong = fabs(ynew) > fabs(yold);
+            bool converged = (fabs(next) < epsilon) | (fabs((next - x) / next) < epsilon);
+            bool run = active[l];
+
+            xnew[l] = run ? (wrong ? T(0.) : next) : x;
+            stop[l] = (run & (wrong | converged)) ? iter : stop[l];
+            active[l] = run & !wrong & !converged;
+            nActive += active[l];
+        }
+    }
+
+    T det[L];
+    for (int l = 0; l < nLanes; l++)
+    {
+        T* res = result + 8 * (first + l);
+        T x = (stop[l] == kIterMax - 1) ? T(0.) : xnew[l];
+
+        Polynomial<T> p(Mxx[l], Myy[l], Mxy[l], Mxz[l], Myz[l], Mzz[l]);
+        CircleParameters(p, Mxx[l], Myy[l], Mxy[l], Mxz[l], Myz[l], x, res);
+        det[l] = LineParameters(wsum[l], wx[l], wy[l], wxx[l], wxy[l], res);
+    }
+
+    T slope[L], offset[L], chi2[L];
+    for (int l = 0; l < L; l++)
+    {
+        int trk = first + (l < nLanes ? l : 0);
+        slope[l] = result[3 + 8 * trk];
+        offset[l] = result[4 + 8 * trk];
+        chi2[l] = 0.;
+    }
+
+    for (int i = 0; i < HIT; i++)
+    {
+        for (int l = 0; l < L; l++)
+        {
+            T r1 = Z1s[i][l] + slope[l] * rho[i][l] - offset[l];
+            chi2[l] += fZWeight[i][l] * (r1 * r1);
+        }
+    }
+
+    for (int l = 0; l < nLanes; l++)
+    {
+        LineErrors(wsum[l], wxx[l], det[l], chi2[l], chi2Norm, result + 8 * (first + l));
+    }
+}
+
+template<typename T>
+void FitRange(const T* X, const T* Y, const T* Z1, const T* Z1err, const T* Mx, const T* My, const T* M0, T* result, double chi2Norm, int mode, int first, int nTracks)
+{
+    int last = first + nTracks;
+
+    if (mode == kCircleFitScalar)
+    {
+        for (int trk = first; trk < last; trk++)
+        {
+            FitTrack(X, Y, Z1, Z1err, Mx, My, M0, result, chi2Norm, trk);
+        }
+        return;
+    }
+
+    for (int trk = first; trk < last; trk += CIRCLEFIT_LANES)
+    {
+        FitBlock(X, Y, Z1, Z1err, Mx, My, M0, result, chi2Norm, trk, min(CIRCLEFIT_LANES, last - trk));
+    }
+}
+
+/// Persistent pool of worker threads, the calling thread takes part in the work
+class CircleFitPool
+{
+  public:
+    typedef boost::function<void(int, int)> Job;
+
+    static CircleFitPool& Instance()
+    {
+        static CircleFitPool pool;
+        return pool;
+    }
+
+    int GetNumThreads() const
+    {
+        return fNumThreads;
+    }
+
+    void SetNumThreads(int nThreads)
+    {
+        boost::lock_guard<boost::mutex> runLock(fRunMutex);
+        Stop();
+        fNumThreads = max(1, nThreads);
+        Start();
+    }
+
+    /// Runs job(first, n) over [0, nTracks) in batches, using at most nThreads threads
+    void Run(int nTracks, int nThreads, Job job)
+    {
+        boost::lock_guard<boost::mutex> runLock(fRunMutex);
+
+        int nBatches = (nTracks + kTracksPerBatch - 1) / kTracksPerBatch;
+        if (nThreads <= 0)
+        {
+            nThreads = fNumThreads;
+        }
+        if (nThreads == 1 || nBatches <= 1 || fNumThreads == 1)
+        {
+            job(0, nTracks);
+            return;
+        }
+
+        {
+            boost::lock_guard<boost::mutex> lock(fMutex);
+            fJob = job;
+            fNumTracks = nTracks;
+            fNextBatch = 0;
+            fNumBatches = nBatches;
+            fPending = nBatches;
+            fMaxWorkers = nThreads - 1;
+            ++fGeneration;
+        }
+        fWorkCondition.notify_all();
+
+        Work();
+
+        boost::unique_lock<boost::mutex> lock(fMutex);
+        while (fPending > 0)
+        {
+            fDoneCondition.wait(lock);
+        }
+        fJob.clear();
+    }
+
+  private:
+    CircleFitPool()
+        : fNumThreads(max(1u, boost::thread::hardware_concurrency()))
+        , fThreads()
+        , fMutex()
+        , fRunMutex()
+        , fWorkCondition()
+        , fDoneCondition()
+        , fJob()
+        , fNumTracks(0)
+        , fNextBatch(0)
+        , fNumBatches(0)
+        , fPending(0)
+        , fMaxWorkers(0)
+        , fNumWorking(0)
+        , fGeneration(0)
+        , fStop(false)
+    {
+        Start();
+    }
+
+    ~CircleFitPool()
+    {
+        Stop();
+    }
+
+    void Start()
+    {
+        fStop = false;
+        for (int i = 1; i < fNumThreads; i++)
+        {
+            fThreads.push_back(boost::shared_ptr<boost::thread>(new boost::thread(boost::bind(&CircleFitPool::Worker, this))));
+        }
+    }
+
+    void Stop()
+    {
+        {
+            boost::lock_guard<boost::mutex> lock(fMutex);
+            fStop = true;
+        }
+        fWorkCondition.notify_all();
+        for (size_t i = 0; i < fThreads.size(); i++)
+        {
+            fThreads[i]->join();
+        }
+        fThreads.clear();
+    }
+
+    /// Processes batches until none is left
+    void Work()
+    {
+        boost::unique_lock<boost::mutex> lock(fMutex);
+        while (fNextBatch < fNumBatches)
+        {
+            int first = fNextBatch++ * kTracksPerBatch;
+            int n = min(kTracksPerBatch, fNumTracks - first);
+            Job job = fJob;
+
+            lock.unlock();
+            job(first, n);
+            lock.lock();
+
+            if (--fPending == 0)
+            {
+                fDoneCondition.notify_all();
+            }
+        }
+    }
+
+    void Worker()
+    {
+        unsigned int seen = 0;
+        boost::unique_lock<boost::mutex> lock(fMutex);
+        while (true)
+        {
+            while (!fStop && (seen == fGeneration || fNumWorking >= fMaxWorkers))
+            {
+                // a job which already has enough workers is skipped
+                seen = fGeneration;
+                fWorkCondition.wait(lock);
+            }
+            if (fStop)
+            {
+                return;
+            }
+            seen = fGeneration;
+            ++fNumWorking;
+            lock.unlock();
+            Work();
+            lock.lock();
+            --fNumWorking;
+        }
+    }
+
+    int fNumThreads;
+    vector<boost::shared_ptr<boost::thread> > fThreads;
+    boost::mutex fMutex;
+    boost::mutex fRunMutex;
+    boost::condition_variable fWorkCondition;
+    boost::condition_variable fDoneCondition;
+
+    Job fJob;
+    int fNumTracks;
+    int fNextBatch;
+    int fNumBatches;
+    int fPending;
+    int fMaxWorkers;
+    int fNumWorking;
+    unsigned int fGeneration;
+    bool fStop;
+};
+
+/// Binds the arrays of one call so that the pool only has to pass the track range
+template<typename T>
+struct FitJob
+{
+    const T* X;
+    const T* Y;
+    const T* Z1;
+    const T* Z1err;
+    const T* Mx;
+    const T* My;
+    const T* M0;
+    T* result;
+    double chi2Norm;
+    int mode;
+
+    void operator()(int first, int nTracks) const
+    {
+        FitRange(X, Y, Z1, Z1err, Mx, My, M0, result, chi2Norm, mode, first, nTracks);
+    }
+};
+
+template<typename T>
+void FitBatch(const T* X, const T* Y, const T* Z1, const T* Z1err, const T* Mx, const T* My, const T* M0, T* result, int nTracks, int mode, int nThreads)
+{
+    FitJob<T> job = { X, Y, Z1, Z1err, Mx, My, M0, result, kChi2NormBatch, mode };
+    CircleFitPool::Instance().Run(nTracks, nThreads, job);
+}
+
+} // namespace
+
+extern "C" void CircleFitCBatchD(const double* X, const double* Y, const double* Z, const double* Zerr, const double* Mx, const double* My, const double* M0, double* result, int nTracks, int mode, int nThreads)
+{
+    FitBatch(X, Y, Z, Zerr, Mx, My, M0, result, nTracks, mode, nThreads);
+}
+
+extern "C" void CircleFitCBatchF(const float* X, const float* Y, const float* Z, const float* Zerr, const float* Mx, const float* My, const float* M0, float* result, int nTracks, int mode, int nThreads)
+{
+    FitBatch(X, Y, Z, Zerr, Mx, My, M0, result, nTracks, mode, nThreads);
+}
+
+extern "C" void CircleFitCAllD(double X[TRK*HIT], double Y[TRK*HIT], double Z[TRK*HIT], double Zerr[TRK*HIT], double Mx[TRK], double My[TRK], double M0[TRK], double result[8*TRK])
+{
+    FitBatch<double>(X, Y, Z, Zerr, Mx, My, M0, result, TRK, gMode, 0);
+}
+
+extern "C" void CircleFitCAllF(float X[TRK*HIT], float Y[TRK*HIT], float Z[TRK*HIT], float Zerr[TRK*HIT], float Mx[TRK], float My[TRK], float M0[TRK], float result[8*TRK])
+{
+    FitBatch<float>(X, Y, Z, Zerr, Mx, My, M0, result, TRK, gMode, 0);
+}
+
+extern "C" void CircleFitCD(const double* X, const double* Y, const double* Z, const double* Zerr, const double* Mx, const double* My, const double* M0, double* result, int mode)
+{
+    FitRange(X, Y, Z, Zerr, Mx, My, M0, result, kChi2NormSingleD, mode, 0, 1);
+}
+
+extern "C" void CircleFitCF(const float* X, const float* Y, const float* Z, const float* Zerr, const float* Mx, const float* My, const float* M0, float* result, int mode)
+{
+    FitRange(X, Y, Z, Zerr, Mx, My, M0, result, kChi2NormSingleF, mode, 0, 1);
+}
+
+extern "C" void CircleFitCSetMode(int mode)
+{
+    gMode = (mode == kCircleFitScalar) ? kCircleFitScalar : kCircleFitVector;
+}
+
+extern "C" int CircleFitCGetMode()
+{
+    return gMode;
+}
+
+extern "C" void CircleFitCSetNumThreads(int nThreads)
+{
+    CircleFitPool::Instance().SetNumThreads(nThreads);
+}
@@ -9,9 +9,10 @@
 #define _FAIRCUDA_H_
 
 #include "../cuda_imp/HitTrk.h"
+#include "../cpu_imp/CircleFitCpu.h"
 #include "Rtypes.h"
 #include "TObject.h"
-#include "iostream.h"
+#include <iostream>
 #include "TMatrixD.h"
 //extern "C" Float_t denlan_(Float_t *x);
 extern "C" void IncrementArray(Int_t device);
@@ -36,34 +37,86 @@ extern "C" void CircleFitGF(Float_t X[HIT], Float_t Y[HIT], Float_t Z[HIT], Floa
 class FairCuda : public TObject
 {
   public:
-    FairCuda() {;}
+    /// Implementation used by the circle fits
+    enum Backend
+    {
+      kGPU = 0,       ///< CUDA kernels in cuda_imp
+      kCPU = 1,       ///< multi-threaded CPU kernel in cpu_imp, vectorized if built for AVX
+      kCPUScalar = 2  ///< scalar CPU reference in cpu_imp
+    };
+
+#ifdef FAIRCUDA_CPU_ONLY
+    FairCuda() : fBackend(kCPU) {;}
+#else
+    FairCuda() : fBackend(kGPU) {;}
+#endif
     virtual ~FairCuda() {;}
 
-    void IncrementArray_(Int_t device) {return IncrementArray(device);}
-    void DeviceInfo_() {return DeviceInfo();}
+    /// Selects the implementation of the circle fits, kGPU is not available in builds without CUDA
+    void SetBackend(Int_t backend) {
+#ifdef FAIRCUDA_CPU_ONLY
+      if (backend == kGPU) {
+        std::cout << "FairCuda: built without CUDA, using the CPU backend" << std::endl;
+        backend = kCPU;
+      }
+#endif
+      fBackend = backend;
+    }
+    Int_t GetBackend() const {return fBackend;}
+
+    /// Number of threads used by the CPU backends
+    void SetNumThreads(Int_t nThreads) {CircleFitCSetNumThreads(nThreads);}
+
+    void IncrementArray_(Int_t device) {
+#ifndef FAIRCUDA_CPU_ONLY
+      return IncrementArray(device);
+#endif
+    }
+    void DeviceInfo_() {
+#ifndef FAIRCUDA_CPU_ONLY
+      return DeviceInfo();
+#endif
+    }
 // void runTest_(Int_t argc){return runTest(argc);}
 //  void Filter(){cout << "Cuda Filter "<< endl;}
     void Filter(TMatrixD* h, TMatrixD* fM, TMatrixD* pull, TMatrixD* fH, TMatrixD* preC, TMatrixD* prea, TMatrixD* av, TMatrixD* curC, TMatrixD* fV, TMatrixD* fR, TMatrixD* fResVec, double* fDeltaChi2) {
+#ifndef FAIRCUDA_CPU_ONLY
       return CudaFilter(h,fM, pull, fH, preC, prea,av,curC, fV, fR,fResVec,fDeltaChi2);
+#endif
     }
 
 
     void CircleFit(Double_t X[HIT], Double_t Y[HIT],Double_t Z[HIT], Double_t Zerr[HIT], Double_t* Mx,Double_t* My,Double_t* M0, Double_t result[8]) {
       //  printf("\n Cuda  Mx = %f  My = %f\n ", Mx[0], My[0]);
-      return CircleFitG(X,Y,Z,Zerr,Mx,My,M0,result);
+#ifndef FAIRCUDA_CPU_ONLY
+      if (fBackend == kGPU) {
+        return CircleFitG(X,Y,Z,Zerr,Mx,My,M0,result);
+      }
+#endif
+      return CircleFitCD(X,Y,Z,Zerr,Mx,My,M0,result,CpuMode());
     }
 
 
     void CircleFitAllD(Double_t X[TRK* HIT], Double_t Y[TRK* HIT],Double_t Z[TRK* HIT], Double_t Zerr[TRK* HIT], Double_t Mx[TRK],Double_t My[TRK],Double_t M0[TRK], Double_t result[8*TRK]) {
       //    printf("\n Fair Cuda  : Call GPU function \n ");
-      return CircleFitGAllD(X,Y,Z,Zerr,Mx,My,M0,result);
+#ifndef FAIRCUDA_CPU_ONLY
+      if (fBackend == kGPU) {
+        return CircleFitGAllD(X,Y,Z,Zerr,Mx,My,M0,result);
+      }
+#endif
+      return CircleFitCBatchD(X,Y,Z,Zerr,Mx,My,M0,result,TRK,CpuMode(),0);
 //       printf("\n Fair Cuda  : Back to Application \n ");
 
     }
 
     void CircleFitAllF(Float_t X[TRK* HIT], Float_t Y[TRK* HIT],Float_t Z[TRK* HIT], Float_t Zerr[TRK* HIT], Float_t Mx[TRK],Float_t My[TRK],Float_t M0[TRK], Float_t result[8*TRK]) {
 //       printf("\n Fair Cuda  : Call GPU function \n ");
-      return CircleFitGAllF(X,Y,Z,Zerr,Mx,My,M0,result);
+#ifndef FAIRCUDA_CPU_ONLY
+      if (fBackend == kGPU) {
+        return CircleFitGAllF(X,Y,Z,Zerr,Mx,My,M0,result);
+      }
+#endif
+      return CircleFitCBatchF(X,Y,Z,Zerr,Mx,My,M0,result,TRK,CpuMode(),0);
 //       printf("\n Fair Cuda  : Back to Application \n ");
 
     }
@@ -72,13 +125,21 @@ class FairCuda : public TObject
 
     void CircleFitF (Float_t X[HIT], Float_t Y[HIT],Float_t Z[HIT], Float_t Zerr[HIT], Float_t* Mx,Float_t* My,Float_t* M0, Float_t result[8]) {
       //  printf("\n Cuda  Mx = %f  My = %f\n ", Mx[0], My[0]);
-      return CircleFitGF(X,Y,Z,Zerr,Mx,My,M0,result);
+#ifndef FAIRCUDA_CPU_ONLY
+      if (fBackend == kGPU) {
+        return CircleFitGF(X,Y,Z,Zerr,Mx,My,M0,result);
+      }
+#endif
+      return CircleFitCF(X,Y,Z,Zerr,Mx,My,M0,result,CpuMode());
     }
 
-    ClassDef(FairCuda, 1)
-};
+  private:
+    Int_t CpuMode() const {return fBackend == kCPUScalar ? kCircleFitScalar : CircleFitCGetMode();}
 
+    Int_t fBackend;
 
-#endif
+    ClassDef(FairCuda, 2)
+};
 
 
+#endif
@@ -15,6 +15,7 @@
 #include "FairMCDataCrawler.h"
 
 #include "FairLink.h"                   // for FairLink, operator<<
+#include "FairMCLinkGraph.h"            // for FairMCLinkGraph
 #include "FairRootManager.h"            // for FairRootManager
 
 #include "Riosfwd.h"                    // for ostream
@@ -23,18 +24,50 @@
 
 ClassImp(FairMCDataCrawler);
 
+namespace
+{
+/** link graph which reads the data of the nodes with the crawler when they are reached */
+class CrawlerLinkGraph : public FairMCLinkGraph
+{
+  public:
+    CrawlerLinkGraph(FairMCDataCrawler* crawler)
+      : FairMCLinkGraph(kTRUE),
+        fCrawler(crawler) {
+    }
+
+  protected:
+    virtual void ExpandNode(Int_t node) {
+      FairMultiLinkedData* data = fCrawler->GetEntry(GetNodeLink(node));
+      if (data != 0) {
+        SetEntry(node, data->GetLinks(), 1.);
+        delete data;
+      }
+    }
+
+  private:
+    FairMCDataCrawler* fCrawler;
+
+    CrawlerLinkGraph(const CrawlerLinkGraph&);
+    CrawlerLinkGraph& operator=(const CrawlerLinkGraph&);
+};
+}
+
 FairMCDataCrawler::FairMCDataCrawler()
   : fIoman(FairRootManager::Instance()),
     fFinalStage(),
     fUltimateStage(0),
     fVerbose(0),
     fStoreAllEndpoints(kTRUE),
-    fStoreIntermediate(kTRUE)
+    fStoreIntermediate(kTRUE),
+    fUseLinkGraph(kTRUE),
+    fLinkGraph(0),
+    fLinkGraphEntryNr(-1)
 {
 }
 
 FairMCDataCrawler::~FairMCDataCrawler()
 {
+  delete fLinkGraph;
 }
 
 void FairMCDataCrawler::Init()
@@ -117,7 +150,24 @@ FairMultiLinkedData FairMCDataCrawler::GetInfo(FairMultiLinkedData startLink, In
     std::cout << "StartLink: " << startLink;
   }
   if (fVerbose > 1) { std::cout << "StopStageLink: " << fIoman->GetBranchName(stopStageId) << std::endl; }
-  GetNextStage(startLink, stopStageId);
+  if (fUseLinkGraph) {
+    // the data read are kept until the next event
+    if (fLinkGraph == 0) {
+      fLinkGraph = new CrawlerLinkGraph(this);
+    }
+    if (fLinkGraphEntryNr != fIoman->GetEntryNr()) {
+      fLinkGraph->Clear();
+      fLinkGraphEntryNr = fIoman->GetEntryNr();
+    }
+    fLinkGraph->SetUltimateStage(fUltimateStage, kTRUE);
+    fLinkGraph->SetEndpointType(fIoman->GetBranchId("EventHeader."));
+    fLinkGraph->SetStoreAllEndpoints(fStoreAllEndpoints);
+    fLinkGraph->SetStoreIntermediate(fStoreIntermediate);
+    fLinkGraph->GetLinksBackward(startLink, stopStageId, fFinalStage, kFALSE);
+    if (fVerbose > 0) { fLinkGraph->PrintLinksBackward(startLink, stopStageId); }
+  } else {
+    GetNextStage(startLink, stopStageId);
+  }
   if (fVerbose > 1) { std::cout << "FinalStage: " << fFinalStage << std::endl; }
   return fFinalStage;
 }
@@ -236,6 +286,7 @@ void FairMCDataCrawler::GetNextStage(FairMultiLinkedData& startStage, Int_t stop
       //        std::cout<< "TempStage Stop: " << *tempStage << std::endl;
 
       GetNextStage(*tempStage, stopStage);
+      delete tempStage;
     }
   }
 }
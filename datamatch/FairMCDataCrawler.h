@@ -23,6 +23,7 @@
 #include "TString.h"                    // for TString
 
 class FairLink;
+class FairMCLinkGraph;
 class FairRootManager;
 
 class FairMCDataCrawler : public TObject
@@ -39,6 +40,8 @@ class FairMCDataCrawler : public TObject
 
     void SetStoreIntermediate(Bool_t val = kTRUE) {fStoreIntermediate = val;}
     void SetStoreAllEndpoints(Bool_t val = kTRUE) {fStoreAllEndpoints = val;}
+    /** Keeps the data read and the results of the traversals for all GetInfo calls of an event (default), with fVerbose > 0 the links followed are printed */
+    void SetUseLinkGraph(Bool_t val = kTRUE) {fUseLinkGraph = val;}
 
     void Init();
 
@@ -57,6 +60,10 @@ class FairMCDataCrawler : public TObject
     Int_t fVerbose;
     Bool_t fStoreAllEndpoints; ///< true if non-stop-stage data is stored in results
     Bool_t fStoreIntermediate; ///< true if all intermediate steps should be stored
+    Bool_t fUseLinkGraph; ///< true if the links are followed with a link graph of the event
+
+    FairMCLinkGraph* fLinkGraph; //!
+    Int_t fLinkGraphEntryNr; //! event of the link graph
 
     void GetNextStage(FairMultiLinkedData& startEntry, Int_t stopStage);
     void AddToFinalStage(FairLink link, Float_t mult);
@@ -65,7 +72,7 @@ class FairMCDataCrawler : public TObject
     FairMCDataCrawler(const FairMCDataCrawler&);
     FairMCDataCrawler& operator=(const FairMCDataCrawler&);
 
-    ClassDef(FairMCDataCrawler, 1);
+    ClassDef(FairMCDataCrawler, 2);
 };
 
 #endif /* PNDMCDATACRAWLER_H_ */
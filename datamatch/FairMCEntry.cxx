@@ -31,6 +31,7 @@ FairMCEntry::~FairMCEntry()
 void FairMCEntry::RemoveType(Int_t type)
 {
  // std::set<FairLink>::iterator endIter = fLinks.end();
+  LoadLinks();
   std::set<FairLink>::iterator it = fLinks.begin();
   for (; it!=fLinks.end();) {
     if (it->GetType() == type) {
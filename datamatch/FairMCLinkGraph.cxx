@@ -0,0 +1,556 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/*
+ * FairMCLinkGraph.cxx
+ */
+
+#include "FairMCLinkGraph.h"
+
+#include "FairLinkManager.h"            // for FairLinkManager
+#include "FairMCEntry.h"                // for FairMCEntry
+#include "FairMCStage.h"                // for FairMCStage
+#include "FairMultiLinkedData.h"        // for FairMultiLinkedData
+
+#include <algorithm>                    // for lower_bound, sort, unique
+#include <iostream>                     // for operator<<, basic_ostream, etc
+#include <string>                       // for string
+
+namespace
+{
+enum { kOpen = 0, kVisiting, kDone };
+
+Bool_t IsIgnoreType(Int_t type)
+{
+  FairLinkManager* linkManager = FairLinkManager::Instance();
+  return linkManager != 0 && linkManager->IsIgnoreType(type);
+}
+
+struct NodeLess {
+  bool operator()(const std::pair<Int_t, Double_t>& a, Int_t node) const { return a.first < node; }
+};
+}
+
+FairMCLinkGraph::FairMCLinkGraph(Bool_t keepFileAndEntry)
+  : fKeepFileAndEntry(keepFileAndEntry),
+    fNodeLinks(),
+    fLinkSeen(),
+    fFirst(),
+    fNLinks(),
+    fStageWeights(),
+    fTargets(),
+    fWeights(),
+    fStageOffset(),
+    fStageSize(),
+    fOtherNodes(),
+    fBuiltStages(),
+    fReverseFirst(),
+    fReverseSources(),
+    fReverseBuilt(kFALSE),
+    fResults(),
+    fForwardResults(),
+    fStop(-1),
+    fForwardStop(-1),
+    fUltimateStage(0),
+    fUltimateIsEndpoint(kFALSE),
+    fEndpointType(-1),
+    fStoreAllEndpoints(kTRUE),
+    fStoreIntermediate(kFALSE)
+{
+}
+
+FairMCLinkGraph::~FairMCLinkGraph()
+{
+}
+
+void FairMCLinkGraph::Clear()
+{
+  fNodeLinks.clear();
+  fLinkSeen.clear();
+  fFirst.clear();
+  fNLinks.clear();
+  fStageWeights.clear();
+  fTargets.clear();
+  fWeights.clear();
+  fStageOffset.clear();
+  fStageSize.clear();
+  fOtherNodes.clear();
+  fBuiltStages.clear();
+  fReverseFirst.clear();
+  fReverseSources.clear();
+  fReverseBuilt = kFALSE;
+  fResults.clear();
+  fForwardResults.clear();
+}
+
+void FairMCLinkGraph::Build(const std::map<Int_t, FairMCStage*>& stages)
+{
+  Clear();
+
+  // the entries of the stages are the first nodes, in the order of the stages
+  Int_t maxType = -1;
+  for (std::map<Int_t, FairMCStage*>::const_iterator iter = stages.begin(); iter != stages.end(); iter++) {
+    if (iter->second != 0 && iter->first > maxType) { maxType = iter->first; }
+  }
+  fStageOffset.assign(maxType + 1, -1);
+  fStageSize.assign(maxType + 1, 0);
+  for (std::map<Int_t, FairMCStage*>::const_iterator iter = stages.begin(); iter != stages.end(); iter++) {
+    FairMCStage* stage = iter->second;
+    if (stage == 0) { continue; }
+    fBuiltStages.push_back(std::make_pair(iter->first, std::make_pair(stage->GetNEntries(), stage->GetWeight())));
+    if (iter->first < 0) { continue; }
+    fStageOffset[iter->first] = fNodeLinks.size();
+    fStageSize[iter->first] = stage->GetNEntries();
+    for (Int_t i = 0; i < stage->GetNEntries(); i++) {
+      fNodeLinks.push_back(FairLink(iter->first, i));
+      fLinkSeen.push_back(kFALSE);
+      fFirst.push_back(0);
+      fNLinks.push_back(0);
+      fStageWeights.push_back(stage->GetWeight());
+    }
+  }
+  fResults.resize(fNodeLinks.size());
+
+  for (std::map<Int_t, FairMCStage*>::const_iterator iter = stages.begin(); iter != stages.end(); iter++) {
+    FairMCStage* stage = iter->second;
+    if (stage == 0) { continue; }
+    for (Int_t i = 0; i < stage->GetNEntries(); i++) {
+      FairMCEntry entry = stage->GetEntry(i);
+      SetEntry(GetNode(FairLink(iter->first, i)), entry.GetLinks(), stage->GetWeight());
+    }
+  }
+}
+
+Bool_t FairMCLinkGraph::IsBuiltFrom(const std::map<Int_t, FairMCStage*>& stages) const
+{
+  size_t i = 0;
+  for (std::map<Int_t, FairMCStage*>::const_iterator iter = stages.begin(); iter != stages.end(); iter++) {
+    FairMCStage* stage = iter->second;
+    if (stage == 0) { continue; }
+    if (i >= fBuiltStages.size()
+        || fBuiltStages[i].first != iter->first
+        || fBuiltStages[i].second.first != stage->GetNEntries()
+        || fBuiltStages[i].second.second != stage->GetWeight()) {
+      return kFALSE;
+    }
+    i++;
+  }
+  return i == fBuiltStages.size();
+}
+
+void FairMCLinkGraph::SetUltimateStage(Int_t type, Bool_t isEndpoint)
+{
+  if (type != fUltimateStage || isEndpoint != fUltimateIsEndpoint) {
+    fUltimateStage = type;
+    fUltimateIsEndpoint = isEndpoint;
+    ResetResults(fStop);
+  }
+}
+
+void FairMCLinkGraph::SetEndpointType(Int_t type)
+{
+  if (type != fEndpointType) {
+    fEndpointType = type;
+    ResetResults(fStop);
+  }
+}
+
+void FairMCLinkGraph::SetStoreAllEndpoints(Bool_t val)
+{
+  if (val != fStoreAllEndpoints) {
+    fStoreAllEndpoints = val;
+    ResetResults(fStop);
+  }
+}
+
+void FairMCLinkGraph::SetStoreIntermediate(Bool_t val)
+{
+  if (val != fStoreIntermediate) {
+    fStoreIntermediate = val;
+    ResetResults(fStop);
+  }
+}
+
+FairMCLinkGraph::TLinkKey FairMCLinkGraph::GetKey(const FairLink& link) const
+{
+  if (fKeepFileAndEntry) {
+    return std::make_pair(std::make_pair(link.GetFile(), link.GetEntry()), std::make_pair(link.GetType(), link.GetIndex()));
+  }
+  return std::make_pair(std::make_pair(-1, -1), std::make_pair(link.GetType(), link.GetIndex()));
+}
+
+Int_t FairMCLinkGraph::FindNode(const FairLink& link) const
+{
+  Int_t type = link.GetType();
+  Int_t index = link.GetIndex();
+  if (!fKeepFileAndEntry && type >= 0 && type < (Int_t)fStageOffset.size() && fStageOffset[type] >= 0
+      && index >= 0 && index < fStageSize[type]) {
+    return fStageOffset[type] + index;
+  }
+  std::map<TLinkKey, Int_t>::const_iterator iter = fOtherNodes.find(GetKey(link));
+  if (iter != fOtherNodes.end()) {
+    return iter->second;
+  }
+  return -1;
+}
+
+Int_t FairMCLinkGraph::GetNode(const FairLink& link)
+{
+  Int_t node = FindNode(link);
+  if (node < 0) {
+    node = fNodeLinks.size();
+    fNodeLinks.push_back(FairLink(link.GetFile(), link.GetEntry(), link.GetType(), link.GetIndex()));
+    fLinkSeen.push_back(kTRUE);
+    fFirst.push_back(0);
+    fNLinks.push_back(-1);
+    fStageWeights.push_back(1.);
+    fResults.resize(fNodeLinks.size());
+    fOtherNodes[GetKey(link)] = node;
+    fReverseBuilt = kFALSE;
+  }
+  return node;
+}
+
+void FairMCLinkGraph::SetEntry(Int_t node, const std::set<FairLink>& links, Double_t weight)
+{
+  fFirst[node] = fTargets.size();
+  fNLinks[node] = links.size();
+  fStageWeights[node] = weight;
+  for (std::set<FairLink>::const_iterator iter = links.begin(); iter != links.end(); iter++) {
+    Int_t target = GetNode(*iter);
+    if (!fLinkSeen[target]) {
+      // the results give the links as they are stored in the data
+      fNodeLinks[target] = FairLink(iter->GetFile(), iter->GetEntry(), iter->GetType(), iter->GetIndex());
+      fLinkSeen[target] = kTRUE;
+    }
+    fTargets.push_back(target);
+    fWeights.push_back(iter->GetWeight());
+  }
+  fReverseBuilt = kFALSE;
+}
+
+void FairMCLinkGraph::ResetResults(Int_t stop)
+{
+  fStop = stop;
+  fResults.assign(fNodeLinks.size(), Result());
+}
+
+//_____________________________________________________________________________
+// Backward traversal
+//
+// FairMCMatch::GetNextStage gives to the data behind a link with the weight
+// lw, from an entry with n links, a stage weight sw, the weight
+//   w * sw * lw           if sw * lw != 0
+//   w * sw * sw + lw / n  otherwise
+// for each of its links with the weight w, and adds the data without links
+// with the weight lw to the result. The result of a node is therefore
+//   lw * fLinear (/ n if fPerLink) + fConstant    for lw != 0
+//   fZero                                          for lw == 0
+// which is kept for all further links to the node.
+
+void FairMCLinkGraph::GetLinksBackward(const FairMultiLinkedData& start, Int_t stop, FairMultiLinkedData& result, Bool_t bypass)
+{
+  if (stop != fStop) {
+    ResetResults(stop);
+  }
+
+  std::set<FairLink> links = start.GetLinks();
+  std::vector<Int_t> nodes;
+  nodes.reserve(links.size());
+  for (std::set<FairLink>::const_iterator iter = links.begin(); iter != links.end(); iter++) {
+    Int_t node = GetNode(*iter);
+    Resolve(node, stop);
+    nodes.push_back(node);
+  }
+
+  TNodeWeights total;
+  Int_t i = 0;
+  for (std::set<FairLink>::const_iterator iter = links.begin(); iter != links.end(); iter++, i++) {
+    AddLinkResult(fResults[nodes[i]], nodes[i], links.size(), iter->GetWeight(), total);
+  }
+
+  for (size_t j = 0; j < total.size(); j++) {
+    FairLink link = fNodeLinks[total[j].first];
+    link.SetWeight(total[j].second);
+    result.AddLink(link, bypass);
+  }
+}
+
+void FairMCLinkGraph::Resolve(Int_t node, Int_t stop)
+{
+  if (fResults[node].fState != kOpen) {
+    return;
+  }
+  fResults[node].fState = kVisiting;
+
+  Result result;
+  Int_t type = fNodeLinks[node].GetType();
+  Bool_t isEndpoint = kFALSE;
+  Bool_t isStop = kFALSE;
+  if (type < 0) {
+    isEndpoint = kTRUE;
+  } else if (type == stop) {
+    isStop = kTRUE;
+  } else if (type == fUltimateStage) {
+    isEndpoint = fUltimateIsEndpoint;
+  } else if (type == fEndpointType) {
+    isEndpoint = kTRUE;
+  } else {
+    if (fNLinks[node] < 0) {
+      fNLinks[node] = 0;
+      ExpandNode(node);
+    }
+    if (fNLinks[node] == 0) {
+      isEndpoint = kTRUE;
+    } else {
+      Int_t first = fFirst[node];
+      Int_t nLinks = fNLinks[node];
+      Double_t stageWeight = fStageWeights[node];
+      for (Int_t i = first; i < first + nLinks; i++) {
+        Resolve(fTargets[i], stop);
+      }
+
+      result.fPerLink = (stageWeight == 0);
+      result.fIntermediate = fStoreIntermediate;
+      if (fStoreIntermediate) {
+        Add(result.fZero, node, 0.);
+      }
+      for (Int_t i = first; i < first + nLinks; i++) {
+        Int_t target = fTargets[i];
+        Double_t weight = fWeights[i];
+        Result circular;
+        if (fResults[target].fState == kVisiting) {
+          // the link is not followed a second time
+          std::cout << "-W- FairMCLinkGraph: circular link to " << fNodeLinks[target] << std::endl;
+          if (fStoreAllEndpoints) {
+            Add(circular.fLinear, target, 1.);
+            Add(circular.fZero, target, 0.);
+          }
+        }
+        const Result& link = fResults[target].fState == kVisiting ? circular : fResults[target];
+        if (stageWeight == 0) {
+          AddLinear(link, target, nLinks, 1., result.fLinear);
+          Add(result.fConstant, link.fConstant);
+        } else if (weight != 0) {
+          AddLinear(link, target, nLinks, weight * stageWeight, result.fLinear);
+          Add(result.fConstant, link.fConstant);
+        } else {
+          Add(result.fConstant, link.fZero);
+        }
+        AddLinkResult(link, target, nLinks, weight * stageWeight * stageWeight, result.fZero);
+      }
+    }
+  }
+  if (isStop || (isEndpoint && fStoreAllEndpoints)) {
+    Add(result.fLinear, node, 1.);
+    Add(result.fZero, node, 0.);
+  }
+
+  result.fState = kDone;
+  fResults[node] = result;
+}
+
+void FairMCLinkGraph::PrintLinksBackward(const FairMultiLinkedData& start, Int_t stop, std::ostream& out) const
+{
+  std::vector<Bool_t> printed(fNodeLinks.size(), kFALSE);
+  std::set<FairLink> links = start.GetLinks();
+  for (std::set<FairLink>::const_iterator iter = links.begin(); iter != links.end(); iter++) {
+    Int_t node = FindNode(*iter);
+    if (node < 0) {
+      out << "  " << *iter << " not reached" << std::endl;
+    } else {
+      PrintNode(node, stop, 1, printed, out);
+    }
+  }
+}
+
+void FairMCLinkGraph::PrintNode(Int_t node, Int_t stop, Int_t depth, std::vector<Bool_t>& printed, std::ostream& out) const
+{
+  Int_t type = fNodeLinks[node].GetType();
+  out << std::string(2 * depth, ' ') << fNodeLinks[node];
+  // the same order of the checks as in Resolve
+  if (type < 0) {
+    out << " endpoint" << std::endl;
+  } else if (type == stop) {
+    out << " stop stage" << std::endl;
+  } else if (type == fUltimateStage || type == fEndpointType) {
+    out << " endpoint" << std::endl;
+  } else if (fNLinks[node] < 0) {
+    out << " not read" << std::endl;
+  } else if (fNLinks[node] == 0) {
+    out << " no links" << std::endl;
+  } else if (printed[node]) {
+    out << " --> " << fNLinks[node] << " links, see above" << std::endl;
+  } else {
+    printed[node] = kTRUE;
+    out << " --> " << fNLinks[node] << " links" << std::endl;
+    for (Int_t i = fFirst[node]; i < fFirst[node] + fNLinks[node]; i++) {
+      PrintNode(fTargets[i], stop, depth + 1, printed, out);
+    }
+  }
+}
+
+void FairMCLinkGraph::AddLinear(const Result& link, Int_t node, Int_t nLinks, Double_t weight, TNodeWeights& result)
+{
+  Add(result, link.fLinear, link.fPerLink ? weight / nLinks : weight);
+  if (link.fIntermediate) {
+    Add(result, node, weight);
+  }
+}
+
+void FairMCLinkGraph::AddLinkResult(const Result& link, Int_t node, Int_t nLinks, Double_t weight, TNodeWeights& result)
+{
+  if (weight == 0) {
+    Add(result, link.fZero);
+    return;
+  }
+  AddLinear(link, node, nLinks, weight, result);
+  Add(result, link.fConstant);
+}
+
+//_____________________________________________________________________________
+// Forward traversal
+//
+// As FairMCMatch::FindStagesPointingToLinks the data pointing to the links
+// of a level are collected, as often as they are pointed to by different
+// data of the level, and form the next level. Only data of the stages with
+// the same or a higher type than the link are searched.
+
+void FairMCLinkGraph::BuildReverse()
+{
+  Int_t nNodes = fNodeLinks.size();
+  std::vector<std::pair<Int_t, Int_t> > reverse;
+  reverse.reserve(fTargets.size());
+  for (Int_t source = 0; source < nNodes; source++) {
+    Int_t sourceType = fNodeLinks[source].GetType();
+    if (fNLinks[source] <= 0 || IsIgnoreType(sourceType)) { continue; }
+    for (Int_t i = fFirst[source]; i < fFirst[source] + fNLinks[source]; i++) {
+      Int_t targetType = fNodeLinks[fTargets[i]].GetType();
+      if (targetType < 0 || targetType >= (Int_t)fStageOffset.size() || fStageOffset[targetType] < 0) { continue; }
+      if (sourceType < targetType) { continue; }
+      reverse.push_back(std::make_pair(fTargets[i], source));
+    }
+  }
+  std::sort(reverse.begin(), reverse.end());
+  reverse.erase(std::unique(reverse.begin(), reverse.end()), reverse.end());
+
+  fReverseFirst.assign(nNodes + 1, 0);
+  fReverseSources.resize(reverse.size());
+  for (size_t i = 0; i < reverse.size(); i++) {
+    fReverseFirst[reverse[i].first + 1]++;
+    fReverseSources[i] = reverse[i].second;
+  }
+  for (Int_t node = 0; node < nNodes; node++) {
+    fReverseFirst[node + 1] += fReverseFirst[node];
+  }
+  fReverseBuilt = kTRUE;
+}
+
+void FairMCLinkGraph::GetLinksForward(const FairLink& start, Int_t stop, FairMultiLinkedData& result)
+{
+  if (IsIgnoreType(start.GetType())) {
+    return;
+  }
+  Int_t startNode = FindNode(start);
+  if (startNode < 0) {
+    result.AddLink(start, true);
+    return;
+  }
+  if (!fReverseBuilt) {
+    BuildReverse();
+  }
+  if (stop != fForwardStop) {
+    fForwardResults.clear();
+    fForwardStop = stop;
+  }
+  if ((Int_t)fForwardResults.size() < (Int_t)fNodeLinks.size()) {
+    fForwardResults.resize(fNodeLinks.size(), std::make_pair(-1, TNodeWeights()));
+  }
+
+  // the start link is added with its weight once for each time it is an endpoint
+  if (fForwardResults[startNode].first < 0) {
+    Int_t nStart = 0;
+    TNodeWeights others;
+    std::map<Int_t, Double_t> level;
+    level[startNode] = 0;
+    for (Int_t depth = 0; !level.empty() && depth <= (Int_t)fNodeLinks.size(); depth++) {
+      std::map<Int_t, Double_t> next;
+      for (std::map<Int_t, Double_t>::const_iterator iter = level.begin(); iter != level.end(); iter++) {
+        Int_t node = iter->first;
+        Int_t first = fReverseFirst[node];
+        Int_t last = fReverseFirst[node + 1];
+        Int_t nEndpoint = 0;
+        if (first == last) {
+          nEndpoint = 1;
+        }
+        for (Int_t i = first; i < last; i++) {
+          Int_t source = fReverseSources[i];
+          Int_t sourceType = fNodeLinks[source].GetType();
+          if (sourceType == stop) {
+            Add(others, source, 1.);
+          } else if (sourceType > stop) {
+            nEndpoint++;
+          } else {
+            next[source] += 1.;
+          }
+        }
+        if (depth == 0) {
+          nStart = nEndpoint;
+        } else if (nEndpoint > 0) {
+          Add(others, node, nEndpoint * iter->second);
+        }
+      }
+      level.swap(next);
+    }
+    fForwardResults[startNode] = std::make_pair(nStart, others);
+  }
+
+  const std::pair<Int_t, TNodeWeights>& forward = fForwardResults[startNode];
+  if (forward.first > 0) {
+    FairLink link = start;
+    link.SetWeight(start.GetWeight() * forward.first);
+    result.AddLink(link, true);
+  }
+  for (size_t i = 0; i < forward.second.size(); i++) {
+    const FairLink& node = fNodeLinks[forward.second[i].first];
+    result.AddLink(FairLink(node.GetType(), node.GetIndex(), forward.second[i].second), true);
+  }
+}
+
+//_____________________________________________________________________________
+void FairMCLinkGraph::Add(TNodeWeights& to, const TNodeWeights& from, Double_t factor)
+{
+  if (from.empty()) {
+    return;
+  }
+  TNodeWeights sum;
+  sum.reserve(to.size() + from.size());
+  size_t i = 0, j = 0;
+  while (i < to.size() || j < from.size()) {
+    if (j == from.size() || (i < to.size() && to[i].first < from[j].first)) {
+      sum.push_back(to[i++]);
+    } else if (i == to.size() || from[j].first < to[i].first) {
+      sum.push_back(std::make_pair(from[j].first, factor * from[j].second));
+      j++;
+    } else {
+      sum.push_back(std::make_pair(to[i].first, to[i].second + factor * from[j].second));
+      i++;
+      j++;
+    }
+  }
+  to.swap(sum);
+}
+
+void FairMCLinkGraph::Add(TNodeWeights& to, Int_t node, Double_t weight)
+{
+  TNodeWeights::iterator iter = std::lower_bound(to.begin(), to.end(), node, NodeLess());
+  if (iter != to.end() && iter->first == node) {
+    iter->second += weight;
+  } else {
+    to.insert(iter, std::make_pair(node, weight));
+  }
+}
@@ -0,0 +1,147 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/*
+ * FairMCLinkGraph.h
+ *
+ * Link graph of the data of one event for repeated link traversals.
+ *
+ * The nodes are the (type, index) pairs of the data, the links of all nodes
+ * are stored in flat arrays, with the links of a node one after the other.
+ * The entries of a stage get consecutive node numbers, a link to a stage
+ * entry is resolved with the offset of the stage, other links with a map.
+ *
+ * GetLinksBackward follows the links with the weighting of
+ * FairMCMatch::GetNextStage and keeps the result of every node for the
+ * following calls, GetLinksForward follows the links in the opposite
+ * direction as FairMCMatch::FindStagesPointingToLinks. PrintLinksBackward
+ * prints the links followed by GetLinksBackward as a tree.
+ * The kept results are valid until Clear() or until the stop stage or the
+ * traversal options change.
+ */
+
+#ifndef FAIRMCLINKGRAPH_H_
+#define FAIRMCLINKGRAPH_H_
+
+#include "FairLink.h"                   // for FairLink
+
+#include "Rtypes.h"                     // for Int_t, Double_t, etc
+
+#include <iostream>                     // for ostream, cout
+#include <map>                          // for map
+#include <set>                          // for set
+#include <utility>                      // for pair
+#include <vector>                       // for vector
+
+class FairMCStage;
+class FairMultiLinkedData;
+
+class FairMCLinkGraph
+{
+  public:
+    /** with keepFileAndEntry the file and entry number of the links are part of the node */
+    FairMCLinkGraph(Bool_t keepFileAndEntry = kFALSE);
+    virtual ~FairMCLinkGraph();
+
+    /** removes all nodes and kept results */
+    void Clear();
+
+    /** nodes and links of all entries of the stages */
+    void Build(const std::map<Int_t, FairMCStage*>& stages);
+    /** kTRUE if the graph was built from the stages with their current sizes and weights */
+    Bool_t IsBuiltFrom(const std::map<Int_t, FairMCStage*>& stages) const;
+
+    /** Data of this type are not followed. If isEndpoint they are added to the result as other endpoints */
+    void SetUltimateStage(Int_t type, Bool_t isEndpoint = kFALSE);
+    /** Data of this type are endpoints, e.g. the event header */
+    void SetEndpointType(Int_t type);
+    /** Adds the data without links or of types which are not followed to the result */
+    void SetStoreAllEndpoints(Bool_t val = kTRUE);
+    /** Adds the data which are passed to the result */
+    void SetStoreIntermediate(Bool_t val = kTRUE);
+
+    /** adds the links of type stop, which are reached from the links of start, to result */
+    void GetLinksBackward(const FairMultiLinkedData& start, Int_t stop, FairMultiLinkedData& result, Bool_t bypass = kTRUE);
+    /** adds the links of type stop, which point to start, to result */
+    void GetLinksForward(const FairLink& start, Int_t stop, FairMultiLinkedData& result);
+    /** prints the links reached from the links of start after GetLinksBackward, one per line,
+        indented by their depth; the links below data printed before are not repeated */
+    void PrintLinksBackward(const FairMultiLinkedData& start, Int_t stop, std::ostream& out = std::cout) const;
+
+    Int_t GetNNodes() const { return fNodeLinks.size(); }
+    Int_t GetNLinks() const { return fTargets.size(); }
+
+  protected:
+    /** node of the link, a new node if the link is not known yet */
+    Int_t GetNode(const FairLink& link);
+    FairLink GetNodeLink(Int_t node) const { return fNodeLinks[node]; }
+    /** sets the links of a node, the weight is the weight of its stage */
+    void SetEntry(Int_t node, const std::set<FairLink>& links, Double_t weight);
+    /** called once for each node reached without links, SetEntry has to be called if the node has data */
+    virtual void ExpandNode(Int_t /*node*/) {}
+
+  private:
+    typedef std::vector<std::pair<Int_t, Double_t> > TNodeWeights;
+    typedef std::pair<std::pair<Int_t, Int_t>, std::pair<Int_t, Int_t> > TLinkKey;
+
+    /** traversal result of a node, see GetLinksBackward */
+    struct Result {
+      Result() : fState(0), fPerLink(kFALSE), fIntermediate(kFALSE), fLinear(), fConstant(), fZero() {}
+      Int_t fState;
+      Bool_t fPerLink;          ///< the weight is shared by the links of the entry pointing to the node
+      Bool_t fIntermediate;     ///< the node itself is added with the link weight
+      TNodeWeights fLinear;     ///< result per unit link weight
+      TNodeWeights fConstant;   ///< result independent of the link weight
+      TNodeWeights fZero;       ///< result for a link weight of zero
+    };
+
+    Int_t FindNode(const FairLink& link) const;
+    TLinkKey GetKey(const FairLink& link) const;
+    void Resolve(Int_t node, Int_t stop);
+    void PrintNode(Int_t node, Int_t stop, Int_t depth, std::vector<Bool_t>& printed, std::ostream& out) const;
+    static void AddLinear(const Result& link, Int_t node, Int_t nLinks, Double_t weight, TNodeWeights& result);
+    static void AddLinkResult(const Result& link, Int_t node, Int_t nLinks, Double_t weight, TNodeWeights& result);
+    void BuildReverse();
+    void ResetResults(Int_t stop);
+    static void Add(TNodeWeights& to, const TNodeWeights& from, Double_t factor = 1.);
+    static void Add(TNodeWeights& to, Int_t node, Double_t weight);
+
+    Bool_t fKeepFileAndEntry;
+
+    std::vector<FairLink> fNodeLinks;       ///< link of each node
+    std::vector<Bool_t> fLinkSeen;          ///< the node link was taken from a link to the node
+    std::vector<Int_t> fFirst;              ///< first link of each node
+    std::vector<Int_t> fNLinks;             ///< number of links of each node, -1 if not expanded
+    std::vector<Double_t> fStageWeights;    ///< stage weight of each node
+    std::vector<Int_t> fTargets;            ///< link targets
+    std::vector<Float_t> fWeights;          ///< link weights
+
+    std::vector<Int_t> fStageOffset;        ///< first node of the stage with the type as index, -1 if none
+    std::vector<Int_t> fStageSize;          ///< number of entries of the stage with the type as index
+    std::map<TLinkKey, Int_t> fOtherNodes;  ///< nodes which are no stage entries
+    std::vector<std::pair<Int_t, std::pair<Int_t, Double_t> > > fBuiltStages; ///< type, size and weight of the stages
+
+    std::vector<Int_t> fReverseFirst;       ///< first node pointing to each node
+    std::vector<Int_t> fReverseSources;     ///< nodes pointing to the nodes
+    Bool_t fReverseBuilt;
+
+    std::vector<Result> fResults;
+    std::vector<std::pair<Int_t, TNodeWeights> > fForwardResults;
+    Int_t fStop;
+    Int_t fForwardStop;
+
+    Int_t fUltimateStage;
+    Bool_t fUltimateIsEndpoint;
+    Int_t fEndpointType;
+    Bool_t fStoreAllEndpoints;
+    Bool_t fStoreIntermediate;
+
+    FairMCLinkGraph(const FairMCLinkGraph&);
+    FairMCLinkGraph& operator=(const FairMCLinkGraph&);
+};
+
+#endif /* FAIRMCLINKGRAPH_H_ */
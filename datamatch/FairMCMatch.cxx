@@ -15,6 +15,7 @@
 #include "FairMCMatch.h"
 
 #include "FairLink.h"                   // for FairLink
+#include "FairMCLinkGraph.h"            // for FairMCLinkGraph
 #include "FairRootManager.h"            // for FairRootManager
 
 #include "TClonesArray.h"               // for TClonesArray
@@ -28,7 +29,10 @@ FairMCMatch::FairMCMatch()
     fUltimateStage(0),
     fList(),
     fFinalStageML(),
-    fVerbose(0)
+    fVerbose(0),
+    fUseLinkGraph(kTRUE),
+    fLinkGraph(0),
+    fLinkGraphDirty(kTRUE)
 {
   fFinalStageML.SetPersistanceCheck(kFALSE);
 }
@@ -39,6 +43,7 @@ FairMCMatch::~FairMCMatch()
     delete(iter->second);
   }
   fList.clear();
+  delete fLinkGraph;
 }
 
 void FairMCMatch::AddElement(Int_t sourceType, int index, Int_t targetType, int link)
@@ -50,6 +55,7 @@ void FairMCMatch::AddElement(Int_t sourceType, int index, Int_t targetType, int
 void FairMCMatch::AddElement(Int_t type, int index, FairLink link)
 {
   fList[type]->AddLink(link, index);
+  fLinkGraphDirty = kTRUE;
 }
 
 
@@ -57,6 +63,7 @@ void FairMCMatch::AddElement(Int_t type, int index, FairLink link)
 void FairMCMatch::SetElements(Int_t sourceType, int index, FairMultiLinkedData* links)
 {
   fList[sourceType]->SetEntry(links, index);
+  fLinkGraphDirty = kTRUE;
 }
 
 void FairMCMatch::InitStage(Int_t type, std::string fileName, std::string branchName)
@@ -64,6 +71,7 @@ void FairMCMatch::InitStage(Int_t type, std::string fileName, std::string branch
   if (fList[type] == 0) {
     FairMCStage* newStage = new FairMCStage(type, fileName, branchName);
     fList[type] = newStage;
+    fLinkGraphDirty = kTRUE;
     if (fVerbose > 1) {
       std::cout << "InitStages: " << *newStage;
     }
@@ -90,6 +98,7 @@ void FairMCMatch::InitStage(std::string branchName, std::string fileName)
 void FairMCMatch::RemoveStage(Int_t type)
 {
   fList.erase(type);
+  fLinkGraphDirty = kTRUE;
 }
 
 
@@ -147,9 +156,9 @@ FairMCEntry FairMCMatch::GetMCInfoSingle(FairLink aLink, Int_t stop)
 FairMCResult FairMCMatch::GetMCInfoForward(Int_t start, Int_t stop)
 {
   FairMCResult result(start, stop);
-  FairMCStage startVec = *(fList[start]);
-  for (int i = 0; i < startVec.GetNEntries(); i++) {
-    FairLink tempLink(startVec.GetStageId(), i);
+  FairMCStage* startVec = fList[start];
+  for (int i = 0; i < startVec->GetNEntries(); i++) {
+    FairLink tempLink(startVec->GetStageId(), i);
 
     FairMCEntry tempEntry(GetMCInfoForwardSingle(tempLink, stop));
     if (tempEntry.GetNLinks() > 0)
@@ -168,6 +177,13 @@ FairMCEntry FairMCMatch::GetMCInfoForwardSingle(FairLink link, Int_t stop)
   FairMCEntry result;
   ClearFinalStage();
 
+  if (fUseLinkGraph) {
+    UpdateLinkGraph();
+    fLinkGraph->GetLinksForward(link, stop, fFinalStageML);
+    result.SetLinks(fFinalStageML);
+    return result;
+  }
+
   FairMultiLinkedData tempStage;
   tempStage.SetPersistanceCheck(kFALSE);
   tempStage.AddLink(link, true);
@@ -179,10 +195,10 @@ FairMCEntry FairMCMatch::GetMCInfoForwardSingle(FairLink link, Int_t stop)
 FairMCResult FairMCMatch::GetMCInfoBackward(Int_t start, Int_t stop)
 {
   FairMCResult result(start, stop);
-  FairMCStage startVec = *(fList[start]);
-  for (int i = 0; i < startVec.GetNEntries(); i++) {
+  FairMCStage* startVec = fList[start];
+  for (int i = 0; i < startVec->GetNEntries(); i++) {
     FairLink tempLink(start, i);
-    GetMCInfoBackwardSingle(tempLink, stop, startVec.GetWeight());
+    GetMCInfoBackwardSingle(tempLink, stop, startVec->GetWeight());
     result.SetEntry(&fFinalStageML, result.GetNEntries());
   }
   return result;
@@ -195,7 +211,12 @@ FairMCEntry FairMCMatch::GetMCInfoBackwardSingle(FairLink aLink, Int_t stop, Dou
 
   ClearFinalStage();
   multiLink.MultiplyAllWeights(weight);
-  GetNextStage(multiLink, stop);
+  if (fUseLinkGraph) {
+    UpdateLinkGraph();
+    fLinkGraph->GetLinksBackward(multiLink, stop, fFinalStageML);
+  } else {
+    GetNextStage(multiLink, stop);
+  }
   result.SetLinks(fFinalStageML);
 
   return result;
@@ -280,6 +301,7 @@ void FairMCMatch::CreateArtificialStage(Int_t stage, std::string fileName, std::
       }
     }
     fList[stage]->SetLoaded(kTRUE);
+    fLinkGraphDirty = kTRUE;
 
   }
 }
@@ -381,6 +403,7 @@ void FairMCMatch::ClearMCList()
     } 
   }
   fList.clear();
+  fLinkGraphDirty = kTRUE;
 }
 
 bool FairMCMatch::IsTypeInList(Int_t type)
@@ -402,4 +425,17 @@ void FairMCMatch::LoadInMCLists(TClonesArray* myLinkArray)
       fList[(Int_t)myLink->GetSource()]->SetLoaded(kTRUE);
     }
   }
+  fLinkGraphDirty = kTRUE;
+}
+
+void FairMCMatch::UpdateLinkGraph()
+{
+  if (fLinkGraph == 0) {
+    fLinkGraph = new FairMCLinkGraph();
+  }
+  fLinkGraph->SetUltimateStage(fUltimateStage);
+  if (fLinkGraphDirty || !fLinkGraph->IsBuiltFrom(fList)) {
+    fLinkGraph->Build(fList);
+    fLinkGraphDirty = kFALSE;
+  }
 }
@@ -34,6 +34,7 @@
 #include <utility>                      // for pair
 
 class FairLink;
+class FairMCLinkGraph;
 
 typedef std::map<Int_t, FairMCStage*>::iterator TListIterator;
 typedef std::map<Int_t, FairMCStage*>::const_iterator TListIteratorConst;
@@ -47,7 +48,10 @@ class FairMCMatch: public TNamed
         fUltimateStage(0),
         fList(),
         fFinalStageML(),
-        fVerbose(0) {
+        fVerbose(0),
+        fUseLinkGraph(kTRUE),
+        fLinkGraph(0),
+        fLinkGraphDirty(kTRUE) {
       fFinalStageML.SetPersistanceCheck(kFALSE);
     }
 
@@ -64,6 +68,9 @@ class FairMCMatch: public TNamed
 
     void SetCommonWeightStages(Float_t weight);
 
+    /** Follows the links with a link graph of the stages, which is built once per event and keeps the results of the traversals (default) */
+    void SetUseLinkGraph(Bool_t val = kTRUE) {fUseLinkGraph = val;}
+
     FairMCEntry GetEntry(Int_t type, int index);
     FairMCEntry GetEntry(FairLink link);
 
@@ -82,6 +89,8 @@ class FairMCMatch: public TNamed
       return (iter->second);
     }
 
+    /** The link graph sees changes of the weight and the number of entries of the stage,
+        other changes of its entries have to be made with AddElement or SetElements */
     FairMCStage* GetMCStageType(TString branch) {
       FairRootManager* ioman = FairRootManager::Instance();
       if (ioman->GetBranchId(branch) > 0) {
@@ -120,7 +129,14 @@ class FairMCMatch: public TNamed
     std::map<Int_t, FairMCStage*> fList;
     FairMultiLinkedData fFinalStageML;
     Int_t fVerbose;
+    Bool_t fUseLinkGraph;
+    FairMCLinkGraph* fLinkGraph; //!
+    Bool_t fLinkGraphDirty; //!
+
+    FairMCMatch(const FairMCMatch&);
+    FairMCMatch& operator=(const FairMCMatch&);
 
+    void UpdateLinkGraph();
     void FindStagesPointingToLinks(FairMultiLinkedData links, Int_t stop);
     FairMultiLinkedData FindStagesPointingToLink(FairLink link);
 
@@ -133,7 +149,7 @@ class FairMCMatch: public TNamed
     void AddToFinalStage(FairLink link, Float_t mult);
     void ClearFinalStage();
 
-    ClassDef(FairMCMatch, 1);
+    ClassDef(FairMCMatch, 2);
 };
 
 #endif /* PNDMCMATCH_H_ */
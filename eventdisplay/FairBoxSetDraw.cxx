@@ -22,6 +22,7 @@
 #include "TClonesArray.h"               // for TClonesArray
 #include "TEveBoxSet.h"
 #include "TEveManager.h"                // for TEveManager, gEve
+#include "TMath.h"                      // for Floor
 #include "TVector3.h"                   // for TVector3
 
 #include <stddef.h>                     // for NULL
@@ -48,6 +49,7 @@ FairBoxSetDraw::FairBoxSetDraw()
     fTimeWindowMinus(0.),
     fStartTime(0.),
     fUseEventTime(kTRUE),
+    fFilledCells(),
     fStartFunctor(),
     fStopFunctor()
 {
@@ -71,6 +73,7 @@ FairBoxSetDraw::FairBoxSetDraw(const char* name, Int_t iVerbose)
     fTimeWindowMinus(0.),
     fStartTime(0.),
     fUseEventTime(kTRUE),
+    fFilledCells(),
     fStartFunctor(),
     fStopFunctor()
 {
@@ -109,9 +112,15 @@ void FairBoxSetDraw::Exec(Option_t* option)
 {
   if(IsActive()) {
     TObject* p;
-    Reset();
     //  cout<<  "FairBoxSetDraw::Init() Exec! " << fList->GetEntriesFast() << endl;
-    CreateBoxSet();
+    // the box set of the last event is refilled
+    if (fq==0) {
+      CreateBoxSet();
+      gEve->AddElement(fq, fEventManager );
+    } else {
+      fq->Reset();
+    }
+    fFilledCells.clear();
     if (FairRunAna::Instance()->IsTimeStamp()) {
       fList->Clear();
       Double_t eventTime = FairRootManager::Instance()->GetEventTime();
@@ -134,7 +143,7 @@ void FairBoxSetDraw::Exec(Option_t* option)
       }
       AddBoxes(fq, p, i);
     }
-    gEve->AddElement(fq, fEventManager );
+    fq->ElementChanged();
     gEve->Redraw3D(kFALSE);
   }
 }
@@ -142,6 +151,14 @@ void FairBoxSetDraw::Exec(Option_t* option)
 void FairBoxSetDraw::AddBoxes(FairBoxSet* set, TObject* obj, Int_t i)
 {
   TVector3 point = GetVector(obj);
+  Double_t size = fEventManager->GetLevelOfDetail();
+  if (size > 0.) {
+    // one box per cell of the given size, the cell indices are taken modulo 2^21
+    Long64_t ix = static_cast<Long64_t>(TMath::Floor(point.X() / size)) & 0x1FFFFF;
+    Long64_t iy = static_cast<Long64_t>(TMath::Floor(point.Y() / size)) & 0x1FFFFF;
+    Long64_t iz = static_cast<Long64_t>(TMath::Floor(point.Z() / size)) & 0x1FFFFF;
+    if (!fFilledCells.insert(ix | (iy << 21) | (iz << 42)).second) { return; }
+  }
   set->AddBox(point.X(),point.Y(),point.Z());
   set->DigitValue(GetValue(obj, i));
   if(fVerbose>2) {
@@ -197,6 +214,7 @@ void FairBoxSetDraw::Reset()
   if(fq!=0) {
     fq->Reset();
     gEve->RemoveElement(fq, fEventManager );
+    fq=0;
   }
 }
 
@@ -31,6 +31,8 @@
 
 #include "Rtypes.h"                     // for Double_t, Int_t, Bool_t, etc
 
+#include <set>                          // for set
+
 class FairBoxSet;
 class TObject;
 class TVector3;
@@ -102,6 +104,9 @@ class FairBoxSetDraw : public FairTask
     Double_t fStartTime;
     Bool_t fUseEventTime;
 
+    /** cells of the level of detail grid which already have a box **/
+    std::set<Long64_t> fFilledCells;  //!
+
 
   private:
     FairBoxSetDraw(const FairBoxSetDraw&);
@@ -109,7 +114,7 @@ class FairBoxSetDraw : public FairTask
     BinaryFunctor* fStartFunctor;
     BinaryFunctor* fStopFunctor;
 
-    ClassDef(FairBoxSetDraw,1);
+    ClassDef(FairBoxSetDraw,2);
 
 };
 
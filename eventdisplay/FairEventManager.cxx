@@ -12,6 +12,7 @@
 **/
 #include "FairEventManager.h"
 
+#include "FairLogger.h"                 // for FairLogger, MESSAGE_ORIGIN
 #include "FairRootManager.h"            // for FairRootManager
 #include "FairRunAna.h"                 // for FairRunAna
 
@@ -19,6 +20,7 @@
 #include "TEveGeoNode.h"                // for TEveGeoTopNode
 #include "TEveManager.h"                // for TEveManager, gEve
 #include "TGeoManager.h"                // for gGeoManager, TGeoManager
+#include "TStopwatch.h"                 // for TStopwatch
 
 class TGeoNode;
 
@@ -43,7 +45,9 @@ FairEventManager::FairEventManager()
    fMinEnergy(0),
    fMaxEnergy(25),
    fEvtMinEnergy(0),
-   fEvtMaxEnergy(10)
+   fEvtMaxEnergy(10),
+   fEventCacheSize(0),
+   fLevelOfDetail(0.)
 
 {
   fgRinstance=this;
@@ -79,20 +83,30 @@ void FairEventManager::Open()
 //______________________________________________________________________________
 void FairEventManager::GotoEvent(Int_t event)
 {
-  fEntry=event;
-  fRunAna->Run((Long64_t)event);
+  DisplayEvent(event);
 }
 //______________________________________________________________________________
 void FairEventManager::NextEvent()
 {
-  fEntry+=1;
-  fRunAna->Run((Long64_t)fEntry);
+  DisplayEvent(fEntry+1);
 }
 //______________________________________________________________________________
 void FairEventManager::PrevEvent()
 {
-  fEntry-=1;
-  fRunAna->Run((Long64_t)fEntry);
+  DisplayEvent(fEntry-1);
+}
+//______________________________________________________________________________
+void FairEventManager::DisplayEvent(Int_t event)
+{
+  // reads the event, runs the display tasks and reports the time it took
+  TStopwatch timer;
+  timer.Start();
+  fEntry=event;
+  fRunAna->Run((Long64_t)event);
+  timer.Stop();
+  LOG(INFO) << "FairEventManager: event " << event << " displayed in "
+            << timer.RealTime()*1000. << " ms (" << timer.CpuTime()*1000. << " ms CPU)"
+            << FairLogger::endl;
 }
 //______________________________________________________________________________
 void FairEventManager::Close()
@@ -50,10 +50,18 @@ class FairEventManager : public TEveEventManager
     virtual Float_t GetEvtMinEnergy() {return fEvtMinEnergy ;}
     virtual Float_t GetMaxEnergy() {return fMaxEnergy;}
     virtual Float_t GetMinEnergy() {return fMinEnergy;}
+    /** Number of recently displayed events whose display objects are kept,
+     ** 0 rebuilds every event from the input */
+    virtual void SetEventCacheSize(Int_t n) {fEventCacheSize = n;}  // *MENU*
+    virtual Int_t GetEventCacheSize() {return fEventCacheSize;}
+    /** Size [cm] below which trajectory points and boxes are merged for
+     ** drawing, 0 draws all of them */
+    virtual void SetLevelOfDetail(Double_t size) {fLevelOfDetail = size;}  // *MENU*
+    virtual Double_t GetLevelOfDetail() {return fLevelOfDetail;}
     void UpdateEditor();
     virtual void AddParticlesToPdgDataBase(Int_t pdg=0);
 
-    ClassDef(FairEventManager,1);
+    ClassDef(FairEventManager,2);
   private:
     FairRootManager* fRootManager; //!
     Int_t fEntry;                 //!
@@ -65,6 +73,10 @@ class FairEventManager : public TEveEventManager
     Float_t fMaxEnergy;         //!
     Float_t fEvtMinEnergy;         //!
     Float_t fEvtMaxEnergy;         //!
+    Int_t fEventCacheSize;        //!
+    Double_t fLevelOfDetail;      //!
+
+    void DisplayEvent(Int_t event);
 
     static FairEventManager*    fgRinstance; //!
 
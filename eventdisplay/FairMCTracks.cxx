@@ -26,10 +26,36 @@
 #include "TMathBase.h"                  // for Max, Min
 #include "TObjArray.h"                  // for TObjArray
 #include "TParticle.h"                  // for TParticle
+#include "TString.h"                    // for Form, TString
 
 #include <string.h>                     // for NULL, strcmp
 #include <iostream>                     // for operator<<, basic_ostream, etc
 
+namespace
+{
+// most points merged into one segment, bounds the cost of the merging
+const Int_t kMaxMergedPoints = 64;
+
+Double_t SquaredDistanceToSegment(const Double_t* p, const Double_t* a, const Double_t* b)
+{
+  Double_t ab[3], ap[3];
+  Double_t ab2=0., proj=0.;
+  for (Int_t i=0; i<3; i++) {
+    ab[i]=b[i]-a[i];
+    ap[i]=p[i]-a[i];
+    ab2+=ab[i]*ab[i];
+    proj+=ap[i]*ab[i];
+  }
+  Double_t t= ab2>0. ? TMath::Min(1., TMath::Max(0., proj/ab2)) : 0.;
+  Double_t d2=0.;
+  for (Int_t i=0; i<3; i++) {
+    Double_t d=ap[i]-t*ab[i];
+    d2+=d*d;
+  }
+  return d2;
+}
+}
+
 
 // -----   Default constructor   -------------------------------------------
 FairMCTracks::FairMCTracks()
@@ -42,7 +68,11 @@ FairMCTracks::FairMCTracks()
     fTrList(NULL),
     MinEnergyLimit(-1.),
     MaxEnergyLimit(-1.),
-    PEnergy(-1.)
+    PEnergy(-1.),
+    fEventCache(),
+    fCachedEvents(),
+    fCacheKey(""),
+    fPoints()
 {
 }
 // -------------------------------------------------------------------------
@@ -59,7 +89,11 @@ FairMCTracks::FairMCTracks(const char* name, Int_t iVerbose)
     fTrList(NULL),
     MinEnergyLimit(-1.),
     MaxEnergyLimit(-1.),
-    PEnergy(-1.)
+    PEnergy(-1.),
+    fEventCache(),
+    fCachedEvents(),
+    fCacheKey(""),
+    fPoints()
 {
 }
 // -------------------------------------------------------------------------
@@ -93,51 +127,65 @@ void FairMCTracks::Exec(Option_t* option)
     TGeoTrack* tr;
     const Double_t* point;
 
-    Reset();
+    TString key=CacheKey();
+    if (key!=fCacheKey) {
+      ClearCache();
+      fCacheKey=key;
+    }
 
-    for (Int_t i=0; i<fTrackList->GetEntriesFast(); i++)  {
-      LOG(DEBUG3) << "FairMCTracks::Exec "<< i << FairLogger::endl; 
-      tr=(TGeoTrack*)fTrackList->At(i);
-      TParticle* P=(TParticle*)tr->GetParticle();
-      PEnergy=P->Energy();
-      MinEnergyLimit=TMath::Min(PEnergy,MinEnergyLimit) ;
-      MaxEnergyLimit=TMath::Max(PEnergy,MaxEnergyLimit) ;
-      LOG(DEBUG3)<< "MinEnergyLimit " << MinEnergyLimit << " MaxEnergyLimit " << MaxEnergyLimit << FairLogger::endl; 
-      if (fEventManager->IsPriOnly() && P->GetMother(0)>-1) { continue; }
-      if(fEventManager->GetCurrentPDG()!=0 && fEventManager->GetCurrentPDG()!= tr->GetPDG()) { continue; }
-      LOG(DEBUG3) << "PEnergy " << PEnergy << " Min "  << fEventManager->GetMinEnergy() << " Max " << fEventManager->GetMaxEnergy() << FairLogger::endl; 
-      if( (PEnergy<fEventManager->GetMinEnergy()) || (PEnergy >fEventManager->GetMaxEnergy())) { continue; }
-
-      Int_t Np=tr->GetNpoints();
-      fTrList= GetTrGroup(P);
-      TEveTrack* track= new TEveTrack(P, tr->GetPDG(), fTrPr);
-      track->SetLineColor(fEventManager->Color(tr->GetPDG()));
-      for (Int_t n=0; n<Np; n++) {
-        point=tr->GetPoint(n);
-        track->SetPoint(n,point[0],point[1],point[2]);
-        TEveVector pos= TEveVector(point[0], point[1],point[2]);
-        TEvePathMark* path = new TEvePathMark();
-        path->fV=pos ;
-        path->fTime= point[3];
-        if(n==0) {
-          TEveVector Mom= TEveVector(P->Px(), P->Py(),P->Pz());
-          path->fP=Mom;
-        }
-        LOG(DEBUG4) << "Path marker added " << path << FairLogger::endl; 
+    Reset();
 
-        track->AddPathMark(*path);
+    Int_t entry=fEventManager->GetCurrentEvent();
+    if (!DisplayCachedEvent(entry)) {
+      Double_t size=fEventManager->GetLevelOfDetail();
+      TEvePathMark path;
+      for (Int_t i=0; i<fTrackList->GetEntriesFast(); i++)  {
+        LOG(DEBUG3) << "FairMCTracks::Exec "<< i << FairLogger::endl; 
+        tr=(TGeoTrack*)fTrackList->At(i);
+        TParticle* P=(TParticle*)tr->GetParticle();
+        PEnergy=P->Energy();
+        MinEnergyLimit=TMath::Min(PEnergy,MinEnergyLimit) ;
+        MaxEnergyLimit=TMath::Max(PEnergy,MaxEnergyLimit) ;
+        LOG(DEBUG3)<< "MinEnergyLimit " << MinEnergyLimit << " MaxEnergyLimit " << MaxEnergyLimit << FairLogger::endl; 
+        if (fEventManager->IsPriOnly() && P->GetMother(0)>-1) { continue; }
+        if(fEventManager->GetCurrentPDG()!=0 && fEventManager->GetCurrentPDG()!= tr->GetPDG()) { continue; }
+        LOG(DEBUG3) << "PEnergy " << PEnergy << " Min "  << fEventManager->GetMinEnergy() << " Max " << fEventManager->GetMaxEnergy() << FairLogger::endl; 
+        if( (PEnergy<fEventManager->GetMinEnergy()) || (PEnergy >fEventManager->GetMaxEnergy())) { continue; }
 
-        LOG(DEBUG4) << "Path marker added " << path << FairLogger::endl; 
+        fTrList= GetTrGroup(P);
+        TEveTrack* track= new TEveTrack(P, tr->GetPDG(), fTrList->GetPropagator());
+        track->SetLineColor(fEventManager->Color(tr->GetPDG()));
+        SelectPoints(tr, size);
+        for (size_t n=0; n<fPoints.size(); n++) {
+          point=tr->GetPoint(fPoints[n]);
+          track->SetPoint(n,point[0],point[1],point[2]);
+          path.fV= TEveVector(point[0], point[1],point[2]);
+          path.fTime= point[3];
+          if(n==0) {
+            path.fP= TEveVector(P->Px(), P->Py(),P->Pz());
+          } else {
+            path.fP= TEveVector();
+          }
+          track->AddPathMark(path);
+          LOG(DEBUG4) << "Path marker added " << fPoints[n] << FairLogger::endl; 
+        }
+        fTrList->AddElement(track);
+        LOG(DEBUG3) << "track added " << track->GetName() << FairLogger::endl; 
 
-        delete path;
       }
-      fTrList->AddElement(track);
-      LOG(DEBUG3) << "track added " << track->GetName() << FairLogger::endl; 
-
-    }
-    for (Int_t i=0; i<fEveTrList->GetEntriesFast(); i++) {
-      // TEveTrackList *TrListIn=( TEveTrackList *) fEveTrList->At(i);
-      //TrListIn->FindMomentumLimits(TrListIn, kFALSE);
+      if (fEventManager->GetEventCacheSize()>0) {
+        CacheEvent(entry);
+      } else {
+        // groups kept from the last event without tracks in this one
+        for (Int_t i=0; i<fEveTrList->GetEntriesFast(); i++) {
+          TEveTrackList* ele=( TEveTrackList*) fEveTrList->At(i);
+          if (ele->NumChildren()==0) {
+            gEve->RemoveElement(ele,fEventManager);
+            fEveTrList->RemoveAt(i);
+          }
+        }
+        fEveTrList->Compress();
+      }
     }
     fEventManager->SetEvtMaxEnergy(MaxEnergyLimit);
     fEventManager->SetEvtMinEnergy(MinEnergyLimit);
@@ -147,6 +195,10 @@ void FairMCTracks::Exec(Option_t* option)
 // -----   Destructor   ----------------------------------------------------
 FairMCTracks::~FairMCTracks()
 {
+  // the track lists themselves belong to Eve
+  for (std::map<Int_t, TObjArray*>::iterator it=fEventCache.begin(); it!=fEventCache.end(); ++it) {
+    delete it->second;
+  }
 }
 // -------------------------------------------------------------------------
 void FairMCTracks::SetParContainers()
@@ -162,6 +214,15 @@ void FairMCTracks::Finish()
 // -------------------------------------------------------------------------
 void FairMCTracks::Reset()
 {
+  if (fEventManager && fEventManager->GetEventCacheSize()==0) {
+    // the groups and their propagators are reused for the next event
+    for (Int_t i=0; i<fEveTrList->GetEntriesFast(); i++) {
+      TEveTrackList*  ele=( TEveTrackList*) fEveTrList->At(i);
+      ele->DestroyElements();
+    }
+    return;
+  }
+  // cached groups are kept alive by the cache
   for (Int_t i=0; i<fEveTrList->GetEntriesFast(); i++) {
     TEveTrackList*  ele=( TEveTrackList*) fEveTrList->At(i);
     gEve->RemoveElement(ele,fEventManager);
@@ -191,6 +252,95 @@ TEveTrackList* FairMCTracks::GetTrGroup(TParticle* P)
   return fTrList;
 }
 
+// -------------------------------------------------------------------------
+TString FairMCTracks::CacheKey()
+{
+  return Form("%d %d %d %g %g %g", fEventManager->GetEventCacheSize()>0,
+              fEventManager->IsPriOnly(), fEventManager->GetCurrentPDG(),
+              fEventManager->GetMinEnergy(), fEventManager->GetMaxEnergy(),
+              fEventManager->GetLevelOfDetail());
+}
+// -------------------------------------------------------------------------
+Bool_t FairMCTracks::DisplayCachedEvent(Int_t entry)
+{
+  std::map<Int_t, TObjArray*>::iterator it=fEventCache.find(entry);
+  if (it==fEventCache.end()) { return kFALSE; }
+
+  TObjArray* lists=it->second;
+  for (Int_t i=0; i<lists->GetEntriesFast(); i++) {
+    TEveTrackList* ele=( TEveTrackList*) lists->At(i);
+    fEveTrList->Add(ele);
+    gEve->AddElement(ele,fEventManager);
+  }
+  fCachedEvents.remove(entry);
+  fCachedEvents.push_back(entry);
+  LOG(DEBUG) << "FairMCTracks: tracks of event " << entry << " taken from the cache" << FairLogger::endl;
+  return kTRUE;
+}
+// -------------------------------------------------------------------------
+void FairMCTracks::CacheEvent(Int_t entry)
+{
+  TObjArray* lists=new TObjArray(fEveTrList->GetEntriesFast());
+  for (Int_t i=0; i<fEveTrList->GetEntriesFast(); i++) {
+    TEveTrackList* ele=( TEveTrackList*) fEveTrList->At(i);
+    ele->IncDenyDestroy();
+    lists->Add(ele);
+  }
+  fEventCache[entry]=lists;
+  fCachedEvents.push_back(entry);
+  while (static_cast<Int_t>(fCachedEvents.size())>fEventManager->GetEventCacheSize()) {
+    DropOldestEvent();
+  }
+}
+// -------------------------------------------------------------------------
+void FairMCTracks::DropOldestEvent()
+{
+  // lists which are not displayed any more are destroyed by Eve
+  Int_t entry=fCachedEvents.front();
+  fCachedEvents.pop_front();
+  TObjArray* lists=fEventCache[entry];
+  fEventCache.erase(entry);
+  for (Int_t i=0; i<lists->GetEntriesFast(); i++) {
+    ((TEveTrackList*) lists->At(i))->DecDenyDestroy();
+  }
+  delete lists;
+}
+// -------------------------------------------------------------------------
+void FairMCTracks::ClearCache()
+{
+  while (!fCachedEvents.empty()) {
+    DropOldestEvent();
+  }
+}
+// -------------------------------------------------------------------------
+void FairMCTracks::SelectPoints(TGeoTrack* tr, Double_t size)
+{
+  // A point is left out when it and the points left out before it are
+  // closer than size to the segment between the drawn points around them.
+  // The first and the last point are always drawn.
+  fPoints.clear();
+  Int_t Np=tr->GetNpoints();
+  if (Np==0) { return; }
+  fPoints.push_back(0);
+  if (size<=0.) {
+    for (Int_t n=1; n<Np; n++) { fPoints.push_back(n); }
+    return;
+  }
+  Double_t size2=size*size;
+  Int_t last=0;
+  for (Int_t n=2; n<Np; n++) {
+    Bool_t merge= n-last<=kMaxMergedPoints;
+    for (Int_t m=last+1; merge && m<n; m++) {
+      merge= SquaredDistanceToSegment(tr->GetPoint(m), tr->GetPoint(last), tr->GetPoint(n))<size2;
+    }
+    if (!merge) {
+      last=n-1;
+      fPoints.push_back(last);
+    }
+  }
+  if (Np>1) { fPoints.push_back(Np-1); }
+}
+
 ClassImp(FairMCTracks)
 
 
@@ -27,9 +27,14 @@
 #include "TEveTrackPropagator.h"        // IWYU pragma: keep needed by cint
 #include "TString.h"                    // for TString
 
+#include <list>                         // for list
+#include <map>                          // for map
+#include <vector>                       // for vector
+
 class FairEventManager;
 class TClonesArray;
 class TEveTrackList;
+class TGeoTrack;
 class TObjArray;
 class TParticle;
 
@@ -62,6 +67,8 @@ class FairMCTracks : public FairTask
     virtual void Finish();
     void Reset();
     TEveTrackList* GetTrGroup(TParticle* P);
+    /** Forget the track lists of all cached events **/
+    void ClearCache();
 
   protected:
 
@@ -79,10 +86,25 @@ class FairMCTracks : public FairTask
     Double_t PEnergy;
 
   private:
+    /** track lists of the recently displayed events, by entry **/
+    std::map<Int_t, TObjArray*> fEventCache;  //!
+    /** cached entries, the most recently displayed last **/
+    std::list<Int_t> fCachedEvents;  //!
+    /** display settings the cached track lists were made with **/
+    TString fCacheKey;  //!
+    /** indices of the trajectory points which are drawn **/
+    std::vector<Int_t> fPoints;  //!
+
+    TString CacheKey();
+    Bool_t DisplayCachedEvent(Int_t entry);
+    void CacheEvent(Int_t entry);
+    void DropOldestEvent();
+    void SelectPoints(TGeoTrack* tr, Double_t size);
+
     FairMCTracks(const FairMCTracks&);
     FairMCTracks& operator=(const FairMCTracks&);
 
-    ClassDef(FairMCTracks,1);
+    ClassDef(FairMCTracks,2);
 
 };
 
@@ -10,6 +10,10 @@
 
 #include "FairMQProgOptions.h"
 
+#include "RVersion.h"
+#include "TROOT.h"
+#include "TThread.h"
+
 inline int InitConfig(FairMQProgOptions& config, int argc, char** argv)
 {
     namespace po = boost::program_options;
@@ -18,6 +22,8 @@ inline int InitConfig(FairMQProgOptions& config, int argc, char** argv)
         ("digi-classname", po::value<std::string>()->default_value("MyDigi"), "Digi class name for initializing TClonesArray")
         ("hit-classname",  po::value<std::string>()->default_value("MyHit"),  "Hit class name for initializing TClonesArray")
         ("data-format",    po::value<std::string>()->default_value("Binary"), "Data format (binary/boost/protobuf/tmessage)")
+        ("num-workers",    po::value<int>()->default_value(1),                "Number of processing threads, each with its own set of policies")
+        ("ordered-output", po::value<int>()->default_value(0),                "Send in the order of receiving when using several workers (1/0)")
     ;
 
     config.AddToCmdLineOptions(processor_options);
@@ -28,6 +34,16 @@ inline int InitConfig(FairMQProgOptions& config, int argc, char** argv)
         return 1;
     }
 
+    if (config.GetValue<int>("num-workers") > 1)
+    {
+        // the policies of the workers create and fill ROOT objects concurrently
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,6,0)
+        ROOT::EnableThreadSafety();
+#else
+        TThread::Initialize();
+#endif
+    }
+
     return 0;
 }
 
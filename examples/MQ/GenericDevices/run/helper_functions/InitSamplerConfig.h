@@ -23,7 +23,9 @@ inline int InitConfig(FairMQProgOptions& config, int argc, char** argv)
         ("input.file.tree",         po::value<std::string>()->default_value("cbmsim"),                    "Name of the tree")
         ("input.file.branch",       po::value<std::string>()->default_value("digidata"),                  "Name of the Branch")
         ("data-format",             po::value<std::string>()->default_value("Binary"),                    "Data format (binary/boost/protobuf/tmessage)")
-        ("source-type",             po::value<std::string>()->default_value("FairMQFileSource"),          "Source implementation type : FairFileSource or SimpleTreeReader")
+        ("source-type",             po::value<std::string>()->default_value("FairMQFileSource"),          "Source implementation type : FairFileSource, SimpleTreeReader or PrefetchTreeReader")
+        ("serializer-threads",      po::value<int>()->default_value(4),                                   "Number of serializer threads of the PrefetchTreeReader")
+        ("prefetch-cache-size",     po::value<int>()->default_value(30000000),                            "Size in bytes of the tree cache of each PrefetchTreeReader thread")
     ;
 
     config.AddToCmdLineOptions(sampler_options);
@@ -37,6 +37,8 @@ inline void runProcessor(FairMQProgOptions& config)
     TProcessor processor;
     processor.InitInputContainer(diginame);
     processor.InitTask(hitname);
+    processor.SetProperty(TProcessor::NumWorkers, config.GetValue<int>("num-workers"));
+    processor.SetProperty(TProcessor::OrderedOutput, config.GetValue<int>("ordered-output"));
     runStateMachine(processor, config);
 }
 
@@ -49,6 +51,8 @@ inline void runProcessor<TProcessorBoost>(FairMQProgOptions& config)
     TProcessorBoost processor;
     processor.InitInputContainer(diginame.c_str());
     processor.InitTask(hitname);
+    processor.SetProperty(TProcessorBoost::NumWorkers, config.GetValue<int>("num-workers"));
+    processor.SetProperty(TProcessorBoost::OrderedOutput, config.GetValue<int>("ordered-output"));
     runStateMachine(processor, config);
 }
 
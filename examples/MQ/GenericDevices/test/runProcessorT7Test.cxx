@@ -82,6 +82,8 @@ inline void runProcessor(FairMQProgOptions& config)
     TProcessor processor;
     processor.InitInputContainer(diginame);
     processor.InitTask(hitname);
+    processor.SetProperty(TProcessor::NumWorkers, config.GetValue<int>("num-workers"));
+    processor.SetProperty(TProcessor::OrderedOutput, config.GetValue<int>("ordered-output"));
     runNonInteractiveStateMachine(processor, config);
 }
 
@@ -94,6 +96,8 @@ inline void runProcessor<TProcessorBoostTest>(FairMQProgOptions& config)
     TProcessorBoostTest processor;
     processor.InitInputContainer(diginame.c_str());
     processor.InitTask(hitname);
+    processor.SetProperty(TProcessorBoostTest::NumWorkers, config.GetValue<int>("num-workers"));
+    processor.SetProperty(TProcessorBoostTest::OrderedOutput, config.GetValue<int>("ordered-output"));
     runNonInteractiveStateMachine(processor, config);
 }
 
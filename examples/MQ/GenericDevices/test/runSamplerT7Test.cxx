@@ -22,6 +22,7 @@
 
  #include "FairMQFileSource.h"
  #include "SimpleTreeReader.h"
+ #include "PrefetchTreeReader.h"
 
 // FairRoot - Tutorial 7
 #include "InitSamplerConfig.h"
@@ -49,6 +50,15 @@ typedef GenericSampler<TreeReader_t, MyDigiSerializer_t>       TSamplerBin2;
 typedef GenericSampler<TreeReader_t, BoostSerializer<MyDigi> > TSamplerBoost2;
 typedef GenericSampler<TreeReader_t, RootSerializer>           TSamplerTMessage2;
 
+// the prefetch reader serializes the events in its own threads, with its own serializers
+typedef PrefetchTreeReader<TClonesArray, MyDigiSerializer_t>       PrefetchReaderBin_t;
+typedef PrefetchTreeReader<TClonesArray, BoostSerializer<MyDigi> > PrefetchReaderBoost_t;
+typedef PrefetchTreeReader<TClonesArray, RootSerializer>           PrefetchReaderTMessage_t;
+
+typedef GenericSampler<PrefetchReaderBin_t, MyDigiSerializer_t>            TSamplerBin3;
+typedef GenericSampler<PrefetchReaderBoost_t, BoostSerializer<MyDigi> >    TSamplerBoost3;
+typedef GenericSampler<PrefetchReaderTMessage_t, RootSerializer>           TSamplerTMessage3;
+
 
 // define some helper functions
 template<typename T, typename U>
@@ -67,6 +77,35 @@ struct SetSource
         
         sampler.SetFileProperties(filename, treename, branchname);
     }
+    // source policy "PrefetchTreeReader" needs in addition the number of serializer threads
+    template<typename TSampler, enable_if_base<PrefetchReaderBin_t,TSampler> = 0>
+    void Property(TSampler& sampler, FairMQProgOptions& config)
+    {
+        PrefetchProperty(sampler, config);
+    }
+    template<typename TSampler, enable_if_base<PrefetchReaderBoost_t,TSampler> = 0>
+    void Property(TSampler& sampler, FairMQProgOptions& config)
+    {
+        PrefetchProperty(sampler, config);
+    }
+    template<typename TSampler, enable_if_base<PrefetchReaderTMessage_t,TSampler> = 0>
+    void Property(TSampler& sampler, FairMQProgOptions& config)
+    {
+        PrefetchProperty(sampler, config);
+    }
+    template<typename TSampler>
+    void PrefetchProperty(TSampler& sampler, FairMQProgOptions& config)
+    {
+        std::string filename = config.GetValue<std::string>("input.file.name");
+        std::string treename = config.GetValue<std::string>("input.file.tree");
+        std::string branchname = config.GetValue<std::string>("input.file.branch");
+        int threads = config.GetValue<int>("serializer-threads");
+        int cacheSize = config.GetValue<int>("prefetch-cache-size");
+
+        sampler.SetFileProperties(filename, treename, branchname);
+        sampler.SetParallelism(threads);
+        sampler.SetCacheSize(cacheSize);
+    }
     // source policy "FairMQFileSource_t" needs filename, and branchname
     template<typename TSampler, enable_if_base<FairMQFileSource_t,TSampler> = 0>
     void Property(TSampler& sampler, FairMQProgOptions& config) 
@@ -122,9 +161,20 @@ int main(int argc, char** argv)
                     return 1;
                 }
             }
+            else if(source == "PrefetchTreeReader")
+            {
+                if (format == "Bin") { runSampler<TSamplerBin3>(config); }
+                else if (format == "Boost") { runSampler<TSamplerBoost3>(config); }
+                else if (format == "Root") { runSampler<TSamplerTMessage3>(config); }
+                else
+                {
+                    LOG(ERROR) << "No valid data format provided. (--data-format binary|boost|tmessage). ";
+                    return 1;
+                }
+            }
             else
             {
-                LOG(ERROR) << "No valid source provided. (--source-type FairMQFileSource|SimpleTreeReader). ";
+                LOG(ERROR) << "No valid source provided. (--source-type FairMQFileSource|SimpleTreeReader|PrefetchTreeReader). ";
             }
     }
     catch (std::exception& e)
@@ -31,9 +31,15 @@ int main(int argc, char** argv)
         
         // sampler-specific commandline configuration
         std::string filename;
+        int fileRepeat;
+        int batchSize;
+        int batchTimeout;
         po::options_description sampler_options("Sampler options");
         sampler_options.add_options()
-            ("input-file-name", po::value<std::string>(&filename), "Path to the input file")
+            ("input-file-name",   po::value<std::string>(&filename),              "Path to the input file")
+            ("input-file-repeat", po::value<int>(&fileRepeat)->default_value(1),  "Number of times the input file is read (for benchmarks)")
+            ("batch-size",        po::value<int>(&batchSize)->default_value(0),   "Maximum number of sub-events per message, 0 sends each sub-event as size and data part")
+            ("batch-timeout",     po::value<int>(&batchTimeout)->default_value(0),"Maximum time in ms a sub-event waits for its batch to be sent, 0 for no limit")
         ;
 
         short type;
@@ -63,7 +69,11 @@ int main(int argc, char** argv)
         }
 
         FairMQLmdSampler sampler;
-        sampler.AddFile(filename);
+        for (int i = 0; i < fileRepeat; ++i)
+        {
+            sampler.AddFile(filename);
+        }
+        sampler.SetBatching(batchSize, batchTimeout);
         // combination of sub-event header value = one special channel
         // this channel MUST be defined in the json file for the MQ configuration
         sampler.AddSubEvtKey(type, subType, procId, subCrate, control, chanName);
@@ -51,6 +51,13 @@ int main(int argc, char** argv)
             ("LmdHeader.Tutorial8.control",     po::value<short>(&control),         "sub-event control")
         ;
 
+        bool batched;
+        po::options_description unpacker_options("Unpacker options");
+        unpacker_options.add_options()
+            ("batched", po::value<bool>(&batched)->default_value(false), "Receive the sub-events in batches (sampler --batch-size > 0)")
+        ;
+
+        config.AddToCmdLineOptions(unpacker_options);
         config.AddToCfgFileOptions(lmd_header_def);
 
         if (config.ParseAll(argc, argv, true))
@@ -62,6 +69,7 @@ int main(int argc, char** argv)
         // combination of sub-event header value = one special channel
         // this channel MUST be defined in the json file for the MQ configuration
         unpacker.AddSubEvtKey(type, subType, procId, subCrate, control, chanName);
+        unpacker.SetBatched(batched);
         runStateMachine(unpacker, config);
     }
     catch (std::exception& e)
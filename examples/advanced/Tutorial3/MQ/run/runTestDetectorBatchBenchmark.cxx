@@ -0,0 +1,186 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * runTestDetectorBatchBenchmark.cxx
+ *
+ * @since 2016-03-21
+ */
+
+// Event throughput of sampler -> processor with one message per event and with
+// event batches (FairMQSampler EventsPerMessage, FairMQProcessor BatchedInput),
+// for event sizes from 1 KB to 1 MB. The sender serializes every event with a
+// copy, as the sampler tasks do, the receiver runs a processor task that reads
+// the whole event and replaces it with a small output, unpacking the batches
+// with FairMQProcessorTask::ExecBatch().
+// usage: testDetectorBatchBenchmark [events per message] [MB per event size] [address]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FairMQLogger.h"
+#include "FairMQEventBatch.h"
+#include "FairMQProcessorTask.h"
+
+#ifdef NANOMSG
+#include "nanomsg/FairMQTransportFactoryNN.h"
+#else
+#include "zeromq/FairMQTransportFactoryZMQ.h"
+#endif
+
+using namespace std;
+
+namespace
+{
+
+// reads the event and replaces it with its checksum, like a task that reduces digis to hits
+class ChecksumTask : public FairMQProcessorTask
+{
+  public:
+    virtual void Exec(Option_t* /*opt*/ = "0")
+    {
+        const unsigned char* data = static_cast<const unsigned char*>(fPayload->GetData());
+        uint64_t sum = 0;
+        for (size_t i = 0; i < fPayload->GetSize(); ++i)
+        {
+            sum += data[i];
+        }
+        fPayload->Rebuild(sizeof(sum));
+        memcpy(fPayload->GetData(), &sum, sizeof(sum));
+    }
+};
+
+void SendEvents(FairMQTransportFactory* factory, FairMQSocket* socket, const vector<char>& event, int numEvents, int eventsPerMessage)
+{
+    FairMQEventBatch batch;
+    for (int sent = 0; sent < numEvents; sent += eventsPerMessage)
+    {
+        unique_ptr<FairMQMessage> msg;
+        if (eventsPerMessage == 1)
+        {
+            msg.reset(factory->CreateMessage(event.size()));
+            memcpy(msg->GetData(), &event[0], event.size());
+        }
+        else
+        {
+            for (int i = sent; i < sent + eventsPerMessage && i < numEvents; ++i)
+            {
+                batch.Add(&event[0], event.size());
+            }
+            msg.reset(factory->CreateMessage(batch.GetMessageSize()));
+            batch.Write(msg->GetData());
+            batch.Clear();
+        }
+        socket->Send(msg.get(), "");
+    }
+}
+
+void Run(FairMQTransportFactory* factory, FairMQSocket* push, FairMQSocket* pull, size_t eventSize, int numEvents, int eventsPerMessage)
+{
+    vector<char> event(eventSize);
+    for (size_t i = 0; i < eventSize; ++i)
+    {
+        event[i] = static_cast<char>(i);
+    }
+
+    ChecksumTask task;
+    int processed = 0;
+    int outputs = 0;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    thread sender(SendEvents, factory, push, cref(event), numEvents, eventsPerMessage);
+
+    while (processed < numEvents)
+    {
+        unique_ptr<FairMQMessage> msg(factory->CreateMessage());
+        if (pull->Receive(msg.get(), "") < 0)
+        {
+            break;
+        }
+        task.SetPayload(msg.get());
+        if (eventsPerMessage == 1)
+        {
+            task.Exec();
+            ++outputs;
+            ++processed;
+        }
+        else
+        {
+            // the outputs would be sent to the sink one by one, as FairMQProcessor does without BatchedOutput
+            int n = task.ExecBatch(factory, [&outputs](FairMQMessage*) { ++outputs; });
+            if (n < 0)
+            {
+                break;
+            }
+            processed += n;
+        }
+    }
+
+    sender.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    char what[64];
+    snprintf(what, sizeof(what), "%zu KB, %d event(s)/msg", eventSize / 1024, eventsPerMessage);
+    printf("%-30s %10.3f s %12.1f events/s %10.1f MB/s %10d outputs\n",
+           what, seconds, processed / seconds, processed * (eventSize / 1.e6) / seconds, outputs);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    int eventsPerMessage = argc > 1 ? atoi(argv[1]) : 100;
+    double megabytes = argc > 2 ? atof(argv[2]) : 256.;
+    string address = argc > 3 ? argv[3] : "tcp://127.0.0.1:5599";
+    if (eventsPerMessage < 1)
+    {
+        eventsPerMessage = 1;
+    }
+
+#ifdef NANOMSG
+    FairMQTransportFactory* factory = new FairMQTransportFactoryNN();
+#else
+    FairMQTransportFactory* factory = new FairMQTransportFactoryZMQ();
+#endif
+
+    FairMQSocket* push = factory->CreateSocket("push", "batch-benchmark-push", 1);
+    FairMQSocket* pull = factory->CreateSocket("pull", "batch-benchmark-pull", 1);
+    if (!push->Bind(address))
+    {
+        LOG(ERROR) << "could not bind " << address;
+        return 1;
+    }
+    pull->Connect(address);
+
+    printf("%.0f MB per event size, %d events per batch\n", megabytes, eventsPerMessage);
+    for (size_t eventSize = 1024; eventSize <= 1024 * 1024; eventSize *= 4)
+    {
+        int numEvents = static_cast<int>(megabytes * 1.e6 / eventSize);
+        if (numEvents < eventsPerMessage)
+        {
+            numEvents = eventsPerMessage;
+        }
+        Run(factory, push, pull, eventSize, numEvents, 1);
+        Run(factory, push, pull, eventSize, numEvents, eventsPerMessage);
+    }
+
+    pull->Close();
+    push->Close();
+    delete pull;
+    delete push;
+    delete factory;
+
+    return 0;
+}
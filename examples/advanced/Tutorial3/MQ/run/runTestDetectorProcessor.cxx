@@ -69,7 +69,8 @@ typedef struct DeviceOptions
     DeviceOptions() :
         id(), ioThreads(0), dataFormat(), processorTask(),
         inputSocketType(), inputBufSize(0), inputMethod(), inputAddress(),
-        outputSocketType(), outputBufSize(0), outputMethod(), outputAddress() {}
+        outputSocketType(), outputBufSize(0), outputMethod(), outputAddress(),
+        numWorkers(1), orderedOutput(0), batchedInput(0), batchedOutput(0) {}
 
     string id;
     int ioThreads;
@@ -83,6 +84,10 @@ typedef struct DeviceOptions
     int outputBufSize;
     string outputMethod;
     string outputAddress;
+    int numWorkers;
+    int orderedOutput;
+    int batchedInput;
+    int batchedOutput;
 } DeviceOptions_t;
 
 inline bool parse_cmd_line(int _argc, char* _argv[], DeviceOptions* _options)
@@ -105,6 +110,10 @@ inline bool parse_cmd_line(int _argc, char* _argv[], DeviceOptions* _options)
         ("output-buff-size", bpo::value<int>()->required(), "Output buffer size in number of messages (ZeroMQ)/bytes(nanomsg)")
         ("output-method", bpo::value<string>()->required(), "Output method: bind/connect")
         ("output-address", bpo::value<string>()->required(), "Output address, e.g.: \"tcp://localhost:5555\"")
+        ("num-workers", bpo::value<int>()->default_value(1), "Number of worker threads, each with its own task clone")
+        ("ordered-output", bpo::value<int>()->default_value(0), "Send in the order of receiving when using several workers (1/0)")
+        ("batched-input", bpo::value<int>()->default_value(0), "Receive event batches from a sampler with --events-per-message > 1 (1/0)")
+        ("batched-output", bpo::value<int>()->default_value(0), "Send the events of a batch as one batch instead of one message per event (1/0)")
         ("help", "Print help messages");
 
     bpo::variables_map vm;
@@ -130,6 +139,10 @@ inline bool parse_cmd_line(int _argc, char* _argv[], DeviceOptions* _options)
     if (vm.count("output-buff-size"))   { _options->outputBufSize    = vm["output-buff-size"].as<int>(); }
     if (vm.count("output-method"))      { _options->outputMethod     = vm["output-method"].as<string>(); }
     if (vm.count("output-address"))     { _options->outputAddress    = vm["output-address"].as<string>(); }
+    if (vm.count("num-workers"))        { _options->numWorkers       = vm["num-workers"].as<int>(); }
+    if (vm.count("ordered-output"))     { _options->orderedOutput    = vm["ordered-output"].as<int>(); }
+    if (vm.count("batched-input"))      { _options->batchedInput     = vm["batched-input"].as<int>(); }
+    if (vm.count("batched-output"))     { _options->batchedOutput    = vm["batched-output"].as<int>(); }
 
     return true;
 }
@@ -164,11 +177,15 @@ void runProcessor(const DeviceOptions_t& options)
 
     processor.SetProperty(FairMQProcessor::Id, options.id);
     processor.SetProperty(FairMQProcessor::NumIoThreads, options.ioThreads);
+    processor.SetProperty(FairMQProcessor::NumWorkers, options.numWorkers);
+    processor.SetProperty(FairMQProcessor::OrderedOutput, options.orderedOutput);
+    processor.SetProperty(FairMQProcessor::BatchedInput, options.batchedInput);
+    processor.SetProperty(FairMQProcessor::BatchedOutput, options.batchedOutput);
 
     if (strcmp(options.processorTask.c_str(), "FairTestDetectorMQRecoTask") == 0)
     {
-        T* task = new T();
-        processor.SetTask(task);
+        // every worker thread gets its own task instance
+        processor.SetTaskFactory([]() { return new T(); });
     }
     else
     {
@@ -58,7 +58,7 @@ using TSamplerTMessage = FairMQSampler<FairTestDetectorDigiLoader<FairTestDetect
 typedef struct DeviceOptions
 {
     DeviceOptions() :
-        id(), ioThreads(0), dataFormat(), inputFile(), parameterFile(), branch(), eventRate(0),
+        id(), ioThreads(0), dataFormat(), inputFile(), parameterFile(), branch(), eventRate(0), eventsPerMessage(1),
         outputSocketType(), outputBufSize(0), outputMethod(), outputAddress() {}
 
     string id;
@@ -68,6 +68,7 @@ typedef struct DeviceOptions
     string parameterFile;
     string branch;
     int eventRate;
+    int eventsPerMessage;
     string outputSocketType;
     int outputBufSize;
     string outputMethod;
@@ -89,6 +90,7 @@ inline bool parse_cmd_line(int _argc, char* _argv[], DeviceOptions* _options)
         ("parameter-file", bpo::value<string>()->required(), "path to the parameter file")
         ("branch", bpo::value<string>()->default_value("FairTestDetectorDigi"), "Name of the Branch")
         ("event-rate", bpo::value<int>()->default_value(0), "Event rate limit in maximum number of events per second")
+        ("events-per-message", bpo::value<int>()->default_value(1), "Number of events sent in one message (processor needs --batched-input 1 for > 1)")
         ("output-socket-type", bpo::value<string>()->required(), "Output socket type: pub/push")
         ("output-buff-size", bpo::value<int>()->required(), "Output buffer size in number of messages (ZeroMQ)/bytes(nanomsg)")
         ("output-method", bpo::value<string>()->required(), "Output method: bind/connect")
@@ -113,6 +115,7 @@ inline bool parse_cmd_line(int _argc, char* _argv[], DeviceOptions* _options)
     if (vm.count("parameter-file"))     { _options->parameterFile    = vm["parameter-file"].as<string>(); }
     if (vm.count("branch"))             { _options->branch           = vm["branch"].as<string>(); }
     if (vm.count("event-rate"))         { _options->eventRate        = vm["event-rate"].as<int>(); }
+    if (vm.count("events-per-message")) { _options->eventsPerMessage = vm["events-per-message"].as<int>(); }
     if (vm.count("output-socket-type")) { _options->outputSocketType = vm["output-socket-type"].as<string>(); }
     if (vm.count("output-buff-size"))   { _options->outputBufSize    = vm["output-buff-size"].as<int>(); }
     if (vm.count("output-method"))      { _options->outputMethod     = vm["output-method"].as<string>(); }
@@ -147,6 +150,7 @@ void runSampler(const DeviceOptions_t& options)
     sampler.SetProperty(T::ParFile, options.parameterFile);
     sampler.SetProperty(T::Branch, options.branch);
     sampler.SetProperty(T::EventRate, options.eventRate);
+    sampler.SetProperty(T::EventsPerMessage, options.eventsPerMessage);
     sampler.SetProperty(T::NumIoThreads, options.ioThreads);
 
     sampler.ChangeState("INIT_DEVICE");
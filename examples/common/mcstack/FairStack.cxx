@@ -58,6 +58,19 @@ FairStack::FairStack(Int_t size)
 
 
 
+// -----   Virtual public method CloneStack   ------------------------------
+FairGenericStack* FairStack::CloneStack() const
+{
+  // the worker stacks have to apply the same selection as the master stack
+  FairStack* stack = new FairStack();
+  stack->StoreSecondaries(fStoreSecondaries);
+  stack->SetMinPoints(fMinPoints);
+  stack->SetEnergyCut(fEnergyCut);
+  stack->StoreMothers(fStoreMothers);
+  return stack;
+}
+// -------------------------------------------------------------------------
+
 // -----   Destructor   ----------------------------------------------------
 FairStack::~FairStack()
 {
@@ -203,7 +203,7 @@ class FairStack : public FairGenericStack
     TClonesArray* GetListOfParticles() { return fParticles; }
 
     /** Clone this object (used in MT mode only) */
-    virtual FairGenericStack* CloneStack() const { return new FairStack(); }
+    virtual FairGenericStack* CloneStack() const;
 
   private:
     /** STL stack (FILO) used to handle the TParticles for tracking **/
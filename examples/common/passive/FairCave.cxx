@@ -73,3 +73,16 @@ FairCave::FairCave(const char* name,  const char* Title)
   world[1] = 0;
   world[2] = 0;
 }
+
+FairCave::FairCave(const FairCave& right)
+  : FairModule(right)
+{
+  world[0] = right.world[0];
+  world[1] = right.world[1];
+  world[2] = right.world[2];
+}
+
+FairModule* FairCave::CloneModule() const
+{
+  return new FairCave(*this);
+}
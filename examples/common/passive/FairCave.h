@@ -19,9 +19,11 @@ class FairCave : public FairModule
     FairCave();
     virtual ~FairCave();
     virtual void ConstructGeometry();
+    virtual FairModule* CloneModule() const;
 
 
   private:
+    FairCave(const FairCave& right);
     Double_t world[3];
     ClassDef(FairCave,1) //PNDCaveSD
 };
@@ -0,0 +1,14 @@
+#!/bin/bash
+# Startup time of Tutorial1 without (cold) and with (warm) geometry cache.
+# Has to be called from an environment set up with config.sh, the output
+# files and the cache are written to the current directory.
+# Usage: run_tutorial1_geocache_startup.sh [TGeant3|TGeant4]
+
+macro=$(dirname $0)/run_tutorial1_geocache.C
+mcEngine=${1:-TGeant3}
+
+for warm in kFALSE kTRUE; do
+  time=$(root -l -b -q "$macro(1, \"$mcEngine\", $warm)" 2>&1 | grep "Init time" | awk '{print $3}')
+  if [ "$warm" == "kFALSE" ]; then label=cold; else label=warm; fi
+  printf "%s init %s s\n" $label "${time:-failed}"
+done
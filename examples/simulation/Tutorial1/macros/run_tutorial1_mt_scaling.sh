@@ -0,0 +1,16 @@
+#!/bin/bash
+# Event rate of the multi-threaded Tutorial1 simulation for 1, 2, 4, 8 and
+# 16 worker threads. Has to be called from an environment set up with
+# config.sh, the output files are written to the current directory.
+# Usage: run_tutorial1_mt_scaling.sh [events] [threads...]
+
+macro=$(dirname $0)/run_tutorial1_mt.C
+nEvents=${1:-1000}
+shift
+threads=${@:-1 2 4 8 16}
+
+echo "threads   events/s"
+for nThreads in $threads; do
+  rate=$(root -l -b -q "$macro($nEvents, $nThreads)" 2>&1 | grep "Events per second" | awk '{print $4}')
+  printf "%7d   %s\n" $nThreads "${rate:-failed}"
+done
@@ -58,6 +58,19 @@ FairTutorialDet1::FairTutorialDet1(const char* name, Bool_t active)
 {
 }
 
+FairTutorialDet1::FairTutorialDet1(const FairTutorialDet1& right)
+  : FairDetector(right),
+    fTrackID(-1),
+    fVolumeID(-1),
+    fPos(),
+    fMom(),
+    fTime(-1.),
+    fLength(-1.),
+    fELoss(-1),
+    fFairTutorialDet1PointCollection(new TClonesArray("FairTutorialDet1Point"))
+{
+}
+
 FairTutorialDet1::~FairTutorialDet1()
 {
   if (fFairTutorialDet1PointCollection) {
@@ -185,6 +198,11 @@ void FairTutorialDet1::ConstructGeometry()
   ProcessNodes ( volList );
 }
 
+FairModule* FairTutorialDet1::CloneModule() const
+{
+  return new FairTutorialDet1(*this);
+}
+
 FairTutorialDet1Point* FairTutorialDet1::AddHit(Int_t trackID, Int_t detID,
     TVector3 pos, TVector3 mom,
     Double_t time, Double_t length,
@@ -80,6 +80,9 @@ class FairTutorialDet1: public FairDetector
     virtual void   PreTrack() {;}
     virtual void   BeginEvent() {;}
 
+    /** Clone this detector for a worker thread (used in MT mode only) */
+    virtual FairModule* CloneModule() const;
+
 
   private:
 
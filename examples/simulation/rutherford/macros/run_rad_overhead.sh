@@ -0,0 +1,18 @@
+#!/bin/bash
+# Transport time per event of run_rad.C without and with the radiation map
+# manager, which adds a point for every volume a track passes. Both runs
+# generate the same events, so the difference is the overhead of the
+# radiation mapping in the stepping. Has to be called from an environment
+# set up with config.sh, the output files are written to ./data.
+# Usage: run_rad_overhead.sh [events] [engine]
+
+macro=$(dirname $0)/run_rad.C
+nEvents=${1:-1000}
+engine=${2:-TGeant3}
+
+mkdir -p data
+echo "radmap   ms/event"
+for radMap in kFALSE kTRUE; do
+  time=$(root -l -b -q "$macro($nEvents, \"$engine\", $radMap)" 2>&1 | grep "Transport time per event" | awk '{print $5}')
+  printf "%-6s   %s\n" $radMap "${time:-failed}"
+done
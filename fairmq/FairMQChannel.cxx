@@ -40,6 +40,8 @@ FairMQChannel::FairMQChannel()
     , fSndMoreFlag(0)
     , fSndTimeoutInMs(-1)
     , fRcvTimeoutInMs(-1)
+    , fFastPath(true)
+    , fMetrics()
 {
 }
 
@@ -60,6 +62,8 @@ FairMQChannel::FairMQChannel(const string& type, const string& method, const str
     , fSndMoreFlag(0)
     , fSndTimeoutInMs(-1)
     , fRcvTimeoutInMs(-1)
+    , fFastPath(true)
+    , fMetrics()
 {
 }
 
@@ -394,35 +398,26 @@ void FairMQChannel::ResetChannel()
 
 int FairMQChannel::Send(const unique_ptr<FairMQMessage>& msg) const
 {
-    fPoller->Poll(fSndTimeoutInMs);
-
-    if (fPoller->CheckInput(0))
-    {
-        HandleUnblock();
-        return -2;
-    }
-
-    if (fPoller->CheckOutput(1))
-    {
-        return fSocket->Send(msg.get(), 0);
-    }
-
-    return -2;
+    chrono::steady_clock::time_point start = CallStart();
+    return Sent(SendBlocking(msg.get()), start);
 }
 
 int FairMQChannel::SendAsync(const unique_ptr<FairMQMessage>& msg) const
 {
-    return fSocket->Send(msg.get(), fNoBlockFlag);
+    chrono::steady_clock::time_point start = CallStart();
+    return Sent(fSocket->Send(msg.get(), fNoBlockFlag), start);
 }
 
 int FairMQChannel::SendPart(const unique_ptr<FairMQMessage>& msg) const
 {
-    return fSocket->Send(msg.get(), fSndMoreFlag);
+    chrono::steady_clock::time_point start = CallStart();
+    return Sent(fSocket->Send(msg.get(), fSndMoreFlag), start);
 }
 
 int FairMQChannel::SendPartAsync(const unique_ptr<FairMQMessage>& msg) const
 {
-    return fSocket->Send(msg.get(), fSndMoreFlag|fNoBlockFlag);
+    chrono::steady_clock::time_point start = CallStart();
+    return Sent(fSocket->Send(msg.get(), fSndMoreFlag|fNoBlockFlag), start);
 }
 
 // int FairMQChannel::SendParts(initializer_list<unique_ptr<FairMQMessage>> partsList) const
@@ -462,125 +457,126 @@ int FairMQChannel::SendPartAsync(const unique_ptr<FairMQMessage>& msg) const
 
 int FairMQChannel::Receive(const unique_ptr<FairMQMessage>& msg) const
 {
-    fPoller->Poll(fRcvTimeoutInMs);
-
-    if (fPoller->CheckInput(0))
-    {
-        HandleUnblock();
-        return -2;
-    }
-
-    if (fPoller->CheckInput(1))
-    {
-        return fSocket->Receive(msg.get(), 0);
-    }
-
-    return -2;
+    chrono::steady_clock::time_point start = CallStart();
+    return Received(ReceiveBlocking(msg.get()), start);
 }
 
 int FairMQChannel::ReceiveAsync(const unique_ptr<FairMQMessage>& msg) const
 {
-    return fSocket->Receive(msg.get(), fNoBlockFlag);
+    chrono::steady_clock::time_point start = CallStart();
+    return Received(fSocket->Receive(msg.get(), fNoBlockFlag), start);
 }
 
 int FairMQChannel::Send(FairMQMessage* msg, const string& flag) const
 {
+    chrono::steady_clock::time_point start = CallStart();
     if (flag == "")
     {
-        fPoller->Poll(fSndTimeoutInMs);
-
-        if (fPoller->CheckInput(0))
-        {
-            HandleUnblock();
-            return -2;
-        }
-
-        if (fPoller->CheckOutput(1))
-        {
-            return fSocket->Send(msg, flag);
-        }
-
-        return -2;
+        return Sent(SendBlocking(msg), start);
     }
     else
     {
-        return fSocket->Send(msg, flag);
+        return Sent(fSocket->Send(msg, flag), start);
     }
 }
 
 int FairMQChannel::Send(FairMQMessage* msg, const int flags) const
 {
+    chrono::steady_clock::time_point start = CallStart();
     if (flags == 0)
     {
-        fPoller->Poll(fSndTimeoutInMs);
-
-        if (fPoller->CheckInput(0))
-        {
-            HandleUnblock();
-            return -2;
-        }
-
-        if (fPoller->CheckOutput(1))
-        {
-            return fSocket->Send(msg, flags);
-        }
-
-        return -2;
+        return Sent(SendBlocking(msg), start);
     }
     else
     {
-        return fSocket->Send(msg, flags);
+        return Sent(fSocket->Send(msg, flags), start);
     }
 }
 
 int FairMQChannel::Receive(FairMQMessage* msg, const string& flag) const
 {
+    chrono::steady_clock::time_point start = CallStart();
     if (flag == "")
     {
-        fPoller->Poll(fRcvTimeoutInMs);
+        return Received(ReceiveBlocking(msg), start);
+    }
+    else
+    {
+        return Received(fSocket->Receive(msg, flag), start);
+    }
+}
+
+int FairMQChannel::Receive(FairMQMessage* msg, const int flags) const
+{
+    chrono::steady_clock::time_point start = CallStart();
+    if (flags == 0)
+    {
+        return Received(ReceiveBlocking(msg), start);
+    }
+    else
+    {
+        return Received(fSocket->Receive(msg, flags), start);
+    }
+}
 
-        if (fPoller->CheckInput(0))
+int FairMQChannel::SendBlocking(FairMQMessage* msg) const
+{
+    if (fFastPath)
+    {
+        // queue the message right away if possible, poll only when the call would block
+        int nbytes = fSocket->Send(msg, fNoBlockFlag);
+        if (nbytes != -2)
         {
-            HandleUnblock();
-            return -2;
+            return nbytes;
         }
-
-        if (fPoller->CheckInput(1))
+        if (fMetrics)
         {
-            return fSocket->Receive(msg, flag);
+            fMetrics->RecordHighWaterMark();
         }
+    }
+
+    fPoller->Poll(fSndTimeoutInMs);
 
+    if (fPoller->CheckInput(0))
+    {
+        HandleUnblock();
         return -2;
     }
-    else
+
+    if (fPoller->CheckOutput(1))
     {
-        return fSocket->Receive(msg, flag);
+        return fSocket->Send(msg, 0);
     }
+
+    return -2;
 }
 
-int FairMQChannel::Receive(FairMQMessage* msg, const int flags) const
+int FairMQChannel::ReceiveBlocking(FairMQMessage* msg) const
 {
-    if (flags == 0)
+    if (fFastPath)
     {
-        fPoller->Poll(fRcvTimeoutInMs);
-
-        if (fPoller->CheckInput(0))
+        // take a queued message right away if there is one, poll only when the call would block
+        int nbytes = fSocket->Receive(msg, fNoBlockFlag);
+        if (nbytes != -2)
         {
-            HandleUnblock();
-            return -2;
+            return nbytes;
         }
+    }
 
-        if (fPoller->CheckInput(1))
-        {
-            return fSocket->Receive(msg, flags);
-        }
+    fPoller->Poll(fRcvTimeoutInMs);
 
+    if (fPoller->CheckInput(0))
+    {
+        HandleUnblock();
         return -2;
     }
-    else
+
+    if (fPoller->CheckInput(1))
     {
-        return fSocket->Receive(msg, flags);
+        return fSocket->Receive(msg, 0);
     }
+
+    return -2;
 }
 
 void FairMQChannel::SetSendTimeout(const int timeout)
@@ -641,6 +637,44 @@ int FairMQChannel::GetReceiveTimeout() const
     // }
 }
 
+chrono::steady_clock::time_point FairMQChannel::CallStart() const
+{
+    return fMetrics ? chrono::steady_clock::now() : chrono::steady_clock::time_point();
+}
+
+int FairMQChannel::Sent(const int nbytes, const chrono::steady_clock::time_point& start) const
+{
+    if (fMetrics)
+    {
+        fMetrics->RecordSend(nbytes, start);
+    }
+    return nbytes;
+}
+
+int FairMQChannel::Received(const int nbytes, const chrono::steady_clock::time_point& start) const
+{
+    if (fMetrics)
+    {
+        fMetrics->RecordReceive(nbytes, start);
+    }
+    return nbytes;
+}
+
+shared_ptr<FairMQChannelMetrics> FairMQChannel::GetMetrics() const
+{
+    return fMetrics;
+}
+
+void FairMQChannel::SetFastPath(const bool fastPath)
+{
+    fFastPath = fastPath;
+}
+
+bool FairMQChannel::GetFastPath() const
+{
+    return fFastPath;
+}
+
 bool FairMQChannel::ExpectsAnotherPart() const
 {
     int64_t more = 0;
@@ -675,6 +709,20 @@ inline bool FairMQChannel::HandleUnblock() const
     return true;
 }
 
+void FairMQChannel::DrainCommands() const
+{
+    if (!fCmdSocket)
+    {
+        return;
+    }
+    FairMQMessage* cmd = fTransportFactory->CreateMessage();
+    while (fCmdSocket->Receive(cmd, fNoBlockFlag) >= 0)
+    {
+        LOG(DEBUG) << "discarded a pending command";
+    }
+    delete cmd;
+}
+
 FairMQChannel::~FairMQChannel()
 {
     delete fCmdSocket;
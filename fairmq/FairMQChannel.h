@@ -16,13 +16,15 @@
 #define FAIRMQCHANNEL_H_
 
 #include <string>
-#include <memory> // unique_ptr
+#include <memory> // unique_ptr, shared_ptr
+#include <chrono>
 
 #include <boost/thread/mutex.hpp>
 
 #include "FairMQTransportFactory.h"
 #include "FairMQSocket.h"
 #include "FairMQPoller.h"
+#include "FairMQMetrics.h"
 
 class FairMQPoller;
 class FairMQTransportFactory;
@@ -175,6 +177,24 @@ class FairMQChannel
     /// @return Timeout value in milliseconds. -1 for no timeout.
     int GetReceiveTimeout() const;
 
+    /// Enables or disables the fast path of the blocking Send/Receive methods
+    /// @details With the fast path (default), blocking Send/Receive first try to transfer the message
+    /// without blocking and poll the data socket together with the command socket only if that is not possible.
+    /// The common case then costs a single send/receive call. Interruption with Unblock() is not affected, because
+    /// it matters only when the call would block. Without the fast path every call polls first.
+    /// @param fastPath true to enable the fast path, false to poll before every message
+    void SetFastPath(const bool fastPath);
+
+    /// Checks if the blocking Send/Receive methods use the fast path
+    /// @return true if the fast path is enabled, false otherwise
+    bool GetFastPath() const;
+
+    /// Get the transfer metrics of the channel
+    /// @details The metrics are collected for channels with rate logging enabled, once the device has initialized them.
+    /// They can be read from any thread.
+    /// @return Metrics of the channel, nullptr if they are not collected
+    std::shared_ptr<FairMQChannelMetrics> GetMetrics() const;
+
     /// Checks if the socket is expecting to receive another part of a multipart message.
     /// @return Return true if the socket expects another part of a multipart message and false otherwise.
     bool ExpectsAnotherPart() const;
@@ -201,9 +221,26 @@ class FairMQChannel
     int fSndTimeoutInMs;
     int fRcvTimeoutInMs;
 
+    bool fFastPath;
+
+    std::shared_ptr<FairMQChannelMetrics> fMetrics;
+
     bool InitCommandInterface(FairMQTransportFactory* factory, int numIoThreads);
 
+    int SendBlocking(FairMQMessage* msg) const;
+    int ReceiveBlocking(FairMQMessage* msg) const;
+
+    /// Start time of a send/receive call, if metrics are collected
+    std::chrono::steady_clock::time_point CallStart() const;
+    /// Records a send call in the metrics
+    int Sent(const int nbytes, const std::chrono::steady_clock::time_point& start) const;
+    /// Records a receive call in the metrics
+    int Received(const int nbytes, const std::chrono::steady_clock::time_point& start) const;
+
     bool HandleUnblock() const;
+    /// Discards commands which were sent while no call was waiting, e.g. the Unblock() of the previous run
+    /// when its last calls took the fast path
+    void DrainCommands() const;
 
     // use static mutex to make the class easily copyable
     // implication: same mutex is used for all instances of the class
@@ -44,6 +44,8 @@ FairMQDevice::FairMQDevice()
     , fPortRangeMin(22000)
     , fPortRangeMax(32000)
     , fLogIntervalInMs(1000)
+    , fMetricsFile()
+    , fMetrics()
     , fCmdSocket(nullptr)
     , fTransportFactory(nullptr)
     , fInitialValidationFinished(false)
@@ -120,6 +122,10 @@ void FairMQDevice::InitWrapper()
                 if (InitChannel(*(*itr)))
                 {
                     (*itr)->InitCommandInterface(fTransportFactory, fNumIoThreads);
+                    if ((*itr)->fRateLogging == 1)
+                    {
+                        (*itr)->fMetrics = fMetrics.Register((*itr)->fChannelName);
+                    }
                     uninitializedChannels.erase(itr++);
                 }
                 else
@@ -299,6 +305,15 @@ void FairMQDevice::RunWrapper()
 {
     LOG(INFO) << "DEVICE: Running...";
 
+    // a command left over from the previous run would interrupt the first call that waits
+    for (auto mi = fChannels.begin(); mi != fChannels.end(); ++mi)
+    {
+        for (auto vi = (mi->second).begin(); vi != (mi->second).end(); ++vi)
+        {
+            vi->DrainCommands();
+        }
+    }
+
     boost::thread rateLogger(boost::bind(&FairMQDevice::LogSocketRates, this));
 
     Run();
@@ -354,6 +369,9 @@ void FairMQDevice::SetProperty(const int key, const string& value)
         case Id:
             fId = value;
             break;
+        case MetricsFile:
+            fMetricsFile = value;
+            break;
         default:
             FairMQConfigurable::SetProperty(key, value);
             break;
@@ -393,6 +411,8 @@ string FairMQDevice::GetProperty(const int key, const string& default_ /*= ""*/)
     {
         case Id:
             return fId;
+        case MetricsFile:
+            return fMetricsFile;
         default:
             return FairMQConfigurable::GetProperty(key, default_);
     }
@@ -414,6 +434,8 @@ string FairMQDevice::GetPropertyDescription(const int key)
             return "PortRangeMax: Maximum value for the port range (when binding to dynamic port).";
         case LogIntervalInMs:
             return "LogIntervalInMs: Time between socket rates logging outputs.";
+        case MetricsFile:
+            return "MetricsFile: File for the channel metrics snapshots (Prometheus text format), written every LogIntervalInMs.";
         default:
             return FairMQConfigurable::GetPropertyDescription(key);
     }
@@ -544,6 +566,11 @@ void FairMQDevice::LogSocketRates()
                 ++i;
             }
 
+            if (fMetricsFile != "")
+            {
+                fMetrics.WriteSnapshot(fMetricsFile, fId);
+            }
+
             t0 = t1;
             boost::this_thread::sleep(boost::posix_time::milliseconds(fLogIntervalInMs));
         }
@@ -554,9 +581,20 @@ void FairMQDevice::LogSocketRates()
         }
     }
 
+    // final snapshot at the end of the run
+    if (fMetricsFile != "")
+    {
+        fMetrics.WriteSnapshot(fMetricsFile, fId);
+    }
+
     // LOG(DEBUG) << "FairMQDevice::LogSocketRates() stopping";
 }
 
+const FairMQMetricsRegistry& FairMQDevice::GetMetrics() const
+{
+    return fMetrics;
+}
+
 void FairMQDevice::InteractiveStateLoop()
 {
     bool running = true;
@@ -26,6 +26,7 @@
 #include "FairMQTransportFactory.h"
 #include "FairMQSocket.h"
 #include "FairMQChannel.h"
+#include "FairMQMetrics.h"
 
 class FairMQDevice : public FairMQStateMachine, public FairMQConfigurable
 {
@@ -40,6 +41,7 @@ class FairMQDevice : public FairMQStateMachine, public FairMQConfigurable
         PortRangeMin, ///< Minimum value for the port range (if dynamic)
         PortRangeMax, ///< Maximum value for the port range (if dynamic)
         LogIntervalInMs, ///< Interval for logging the socket transfer rates
+        MetricsFile, ///< File for the channel metrics snapshots
         Last
     };
 
@@ -52,8 +54,15 @@ class FairMQDevice : public FairMQStateMachine, public FairMQConfigurable
     void CatchSignals();
 
     /// Outputs the socket transfer rates
+    /// @details If a metrics file is set, a snapshot of the channel metrics is written to it at the same interval.
     virtual void LogSocketRates();
 
+    /// Get the metrics registry of the device
+    /// @details Channels with rate logging enabled register their metrics when they are initialized.
+    /// The registry can be queried from any thread.
+    /// @return Metrics registry
+    const FairMQMetricsRegistry& GetMetrics() const;
+
     /// Sorts a channel by address, with optional reindexing of the sorted values
     /// @param name    Channel name
     /// @param reindex Should reindexing be done
@@ -121,6 +130,9 @@ class FairMQDevice : public FairMQStateMachine, public FairMQConfigurable
 
     int fLogIntervalInMs; ///< Interval for logging the socket transfer rates
 
+    std::string fMetricsFile; ///< File for the channel metrics snapshots (none if empty)
+    FairMQMetricsRegistry fMetrics; ///< Channel metrics
+
     FairMQSocket* fCmdSocket; ///< Socket used for the internal unblocking mechanism
 
     FairMQTransportFactory* fTransportFactory; ///< Transport factory
@@ -0,0 +1,268 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * FairMQMetrics.cxx
+ *
+ * @since 2016-03-01
+ */
+
+#include <cstdio> // rename
+#include <cmath>
+#include <fstream>
+
+#include "FairMQMetrics.h"
+#include "FairMQLogger.h"
+
+using namespace std;
+
+FairMQHistogram::FairMQHistogram()
+{
+    for (int i = 0; i < kNumBuckets; ++i)
+    {
+        fCounts[i].store(0, memory_order_relaxed);
+    }
+}
+
+void FairMQHistogram::Record(const uint64_t value)
+{
+    fCounts[GetBucket(value)].fetch_add(1, memory_order_relaxed);
+}
+
+uint64_t FairMQHistogram::GetCount() const
+{
+    uint64_t count = 0;
+    for (int i = 0; i < kNumBuckets; ++i)
+    {
+        count += fCounts[i].load(memory_order_relaxed);
+    }
+    return count;
+}
+
+uint64_t FairMQHistogram::GetBucketCount(const int bucket) const
+{
+    return fCounts[bucket].load(memory_order_relaxed);
+}
+
+uint64_t FairMQHistogram::GetPercentile(const double fraction) const
+{
+    // take a copy, the counts may change while searching
+    vector<uint64_t> counts(kNumBuckets);
+    uint64_t total = 0;
+    for (int i = 0; i < kNumBuckets; ++i)
+    {
+        counts[i] = fCounts[i].load(memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(ceil(fraction * total));
+    if (rank < 1)
+    {
+        rank = 1;
+    }
+    uint64_t sum = 0;
+    for (int i = 0; i < kNumBuckets; ++i)
+    {
+        sum += counts[i];
+        if (sum >= rank)
+        {
+            return GetBucketUpperBound(i);
+        }
+    }
+    return GetBucketUpperBound(kNumBuckets - 1);
+}
+
+int FairMQHistogram::GetBucket(const uint64_t value)
+{
+    if (value < kSubBuckets)
+    {
+        return static_cast<int>(value);
+    }
+    // the three bits below the highest set bit select the sub-bucket
+    int shift = 63 - __builtin_clzll(value) - 3;
+    return (shift + 1) * kSubBuckets + static_cast<int>((value >> shift) - kSubBuckets);
+}
+
+uint64_t FairMQHistogram::GetBucketUpperBound(const int bucket)
+{
+    if (bucket < kSubBuckets)
+    {
+        return bucket;
+    }
+    int shift = bucket / kSubBuckets - 1;
+    uint64_t lower = static_cast<uint64_t>(kSubBuckets + bucket % kSubBuckets) << shift;
+    return lower + (static_cast<uint64_t>(1) << shift) - 1;
+}
+
+FairMQChannelMetrics::FairMQChannelMetrics()
+    : fMessagesTx(0)
+    , fBytesTx(0)
+    , fMessagesRx(0)
+    , fBytesRx(0)
+    , fSendAgain(0)
+    , fReceiveAgain(0)
+    , fErrors(0)
+    , fHighWaterMark(0)
+    , fSendLatency()
+    , fReceiveLatency()
+{
+}
+
+void FairMQChannelMetrics::RecordSend(const int nbytes, const chrono::steady_clock::time_point& start)
+{
+    fSendLatency.Record(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+    if (nbytes >= 0)
+    {
+        fMessagesTx.fetch_add(1, memory_order_relaxed);
+        fBytesTx.fetch_add(nbytes, memory_order_relaxed);
+    }
+    else if (nbytes == -2)
+    {
+        fSendAgain.fetch_add(1, memory_order_relaxed);
+    }
+    else
+    {
+        fErrors.fetch_add(1, memory_order_relaxed);
+    }
+}
+
+void FairMQChannelMetrics::RecordReceive(const int nbytes, const chrono::steady_clock::time_point& start)
+{
+    fReceiveLatency.Record(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+    if (nbytes >= 0)
+    {
+        fMessagesRx.fetch_add(1, memory_order_relaxed);
+        fBytesRx.fetch_add(nbytes, memory_order_relaxed);
+    }
+    else if (nbytes == -2)
+    {
+        fReceiveAgain.fetch_add(1, memory_order_relaxed);
+    }
+    else
+    {
+        fErrors.fetch_add(1, memory_order_relaxed);
+    }
+}
+
+void FairMQChannelMetrics::RecordHighWaterMark()
+{
+    fHighWaterMark.fetch_add(1, memory_order_relaxed);
+}
+
+namespace
+{
+
+void WriteHistogram(ostream& os, const string& name, const string& labels, const FairMQHistogram& histogram)
+{
+    // cumulative counts of the non-empty buckets
+    uint64_t sum = 0;
+    for (int i = 0; i < FairMQHistogram::kNumBuckets; ++i)
+    {
+        uint64_t count = histogram.GetBucketCount(i);
+        if (count > 0)
+        {
+            sum += count;
+            os << name << "_bucket{" << labels << ",le=\"" << FairMQHistogram::GetBucketUpperBound(i) << "\"} " << sum << "\n";
+        }
+    }
+    os << name << "_bucket{" << labels << ",le=\"+Inf\"} " << sum << "\n";
+    os << name << "_count{" << labels << "} " << sum << "\n";
+
+    const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+    for (size_t i = 0; i < sizeof(quantiles) / sizeof(double); ++i)
+    {
+        os << name << "_quantile{" << labels << ",quantile=\"" << quantiles[i] << "\"} " << histogram.GetPercentile(quantiles[i]) << "\n";
+    }
+}
+
+}
+
+void FairMQChannelMetrics::Write(ostream& os, const string& labels) const
+{
+    os << "fairmq_channel_messages_tx{" << labels << "} " << fMessagesTx.load(memory_order_relaxed) << "\n";
+    os << "fairmq_channel_bytes_tx{" << labels << "} " << fBytesTx.load(memory_order_relaxed) << "\n";
+    os << "fairmq_channel_messages_rx{" << labels << "} " << fMessagesRx.load(memory_order_relaxed) << "\n";
+    os << "fairmq_channel_bytes_rx{" << labels << "} " << fBytesRx.load(memory_order_relaxed) << "\n";
+    os << "fairmq_channel_send_again{" << labels << "} " << fSendAgain.load(memory_order_relaxed) << "\n";
+    os << "fairmq_channel_receive_again{" << labels << "} " << fReceiveAgain.load(memory_order_relaxed) << "\n";
+    os << "fairmq_channel_errors{" << labels << "} " << fErrors.load(memory_order_relaxed) << "\n";
+    os << "fairmq_channel_high_water_mark{" << labels << "} " << fHighWaterMark.load(memory_order_relaxed) << "\n";
+    WriteHistogram(os, "fairmq_channel_send_latency_ns", labels, fSendLatency);
+    WriteHistogram(os, "fairmq_channel_receive_latency_ns", labels, fReceiveLatency);
+}
+
+FairMQMetricsRegistry::FairMQMetricsRegistry()
+    : fChannels()
+    , fMutex()
+{
+}
+
+shared_ptr<FairMQChannelMetrics> FairMQMetricsRegistry::Register(const string& channelName)
+{
+    boost::unique_lock<boost::mutex> scoped_lock(fMutex);
+    shared_ptr<FairMQChannelMetrics>& metrics = fChannels[channelName];
+    if (!metrics)
+    {
+        metrics = make_shared<FairMQChannelMetrics>();
+    }
+    return metrics;
+}
+
+shared_ptr<FairMQChannelMetrics> FairMQMetricsRegistry::Get(const string& channelName) const
+{
+    boost::unique_lock<boost::mutex> scoped_lock(fMutex);
+    auto it = fChannels.find(channelName);
+    if (it == fChannels.end())
+    {
+        return nullptr;
+    }
+    return it->second;
+}
+
+vector<string> FairMQMetricsRegistry::GetChannelNames() const
+{
+    boost::unique_lock<boost::mutex> scoped_lock(fMutex);
+    vector<string> names;
+    for (auto it = fChannels.begin(); it != fChannels.end(); ++it)
+    {
+        names.push_back(it->first);
+    }
+    return names;
+}
+
+void FairMQMetricsRegistry::WriteSnapshot(ostream& os, const string& deviceId) const
+{
+    boost::unique_lock<boost::mutex> scoped_lock(fMutex);
+    for (auto it = fChannels.begin(); it != fChannels.end(); ++it)
+    {
+        it->second->Write(os, "device=\"" + deviceId + "\",channel=\"" + it->first + "\"");
+    }
+}
+
+bool FairMQMetricsRegistry::WriteSnapshot(const string& fileName, const string& deviceId) const
+{
+    string tmpFileName = fileName + ".tmp";
+    {
+        ofstream file(tmpFileName.c_str());
+        if (!file)
+        {
+            LOG(ERROR) << "Could not open metrics file " << tmpFileName;
+            return false;
+        }
+        WriteSnapshot(file, deviceId);
+    }
+    if (rename(tmpFileName.c_str(), fileName.c_str()) != 0)
+    {
+        LOG(ERROR) << "Could not replace metrics file " << fileName;
+        return false;
+    }
+    return true;
+}
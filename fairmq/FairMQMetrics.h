@@ -0,0 +1,155 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * FairMQMetrics.h
+ *
+ * @since 2016-03-01
+ */
+
+#ifndef FAIRMQMETRICS_H_
+#define FAIRMQMETRICS_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory> // shared_ptr
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+
+/**
+ * Latency histogram with logarithmic buckets, each divided into 8 linear sub-buckets (as in HDR histograms).
+ * Values below 8 have their own bucket, above that the bucket width is at most 1/8 of the value.
+ * Recording is lock-free and can run concurrently with reading from another thread.
+ */
+
+class FairMQHistogram
+{
+  public:
+    static const int kSubBuckets = 8;
+    static const int kNumBuckets = 62 * kSubBuckets;
+
+    FairMQHistogram();
+
+    /// Records a value
+    /// @param value Value (e.g. latency in nanoseconds)
+    void Record(const uint64_t value);
+
+    /// Get the number of recorded values
+    uint64_t GetCount() const;
+    /// Get the number of values in a bucket
+    /// @param bucket Bucket index in the range [0, kNumBuckets)
+    uint64_t GetBucketCount(const int bucket) const;
+    /// Get the value below which the given fraction of the recorded values lies
+    /// @param fraction Fraction of the values (e.g. 0.99 for the 99th percentile)
+    /// @return Upper bound of the bucket containing the percentile, 0 if no value was recorded
+    uint64_t GetPercentile(const double fraction) const;
+
+    /// Get the bucket of a value
+    static int GetBucket(const uint64_t value);
+    /// Get the largest value of a bucket
+    static uint64_t GetBucketUpperBound(const int bucket);
+
+  private:
+    std::atomic<uint64_t> fCounts[kNumBuckets];
+
+    /// Copy Constructor
+    FairMQHistogram(const FairMQHistogram&);
+    FairMQHistogram operator=(const FairMQHistogram&);
+};
+
+/**
+ * Transfer metrics of one channel. The counters are updated by the thread using the channel
+ * and can be read at any time from another thread.
+ */
+
+class FairMQChannelMetrics
+{
+  public:
+    FairMQChannelMetrics();
+
+    /// Records the result of a send call
+    /// @param nbytes Return value of the send call
+    /// @param start Time when the call was started
+    void RecordSend(const int nbytes, const std::chrono::steady_clock::time_point& start);
+    /// Records the result of a receive call
+    /// @param nbytes Return value of the receive call
+    /// @param start Time when the call was started
+    void RecordReceive(const int nbytes, const std::chrono::steady_clock::time_point& start);
+    /// Records a blocking send that could not queue the message right away (queue full or no peer)
+    void RecordHighWaterMark();
+
+    /// Writes the metrics in the Prometheus text format
+    /// @param os Output stream
+    /// @param labels Labels of the metrics, e.g. device="sampler",channel="data-out[0]"
+    void Write(std::ostream& os, const std::string& labels) const;
+
+    std::atomic<uint64_t> fMessagesTx; ///< Sent messages (and message parts)
+    std::atomic<uint64_t> fBytesTx; ///< Sent bytes
+    std::atomic<uint64_t> fMessagesRx; ///< Received messages (and message parts)
+    std::atomic<uint64_t> fBytesRx; ///< Received bytes
+    std::atomic<uint64_t> fSendAgain; ///< Send calls which did not transfer the message (EAGAIN, timeout or interruption)
+    std::atomic<uint64_t> fReceiveAgain; ///< Receive calls which did not get a message (EAGAIN, timeout or interruption)
+    std::atomic<uint64_t> fErrors; ///< Send/receive calls which failed
+    std::atomic<uint64_t> fHighWaterMark; ///< Blocking sends which found the queue full or no peer
+    FairMQHistogram fSendLatency; ///< Duration of the send calls in nanoseconds
+    FairMQHistogram fReceiveLatency; ///< Duration of the receive calls in nanoseconds
+
+  private:
+    /// Copy Constructor
+    FairMQChannelMetrics(const FairMQChannelMetrics&);
+    FairMQChannelMetrics operator=(const FairMQChannelMetrics&);
+};
+
+/**
+ * Registry of the channel metrics of a device. Registration and snapshots take a lock,
+ * the channels update their metrics without it.
+ */
+
+class FairMQMetricsRegistry
+{
+  public:
+    FairMQMetricsRegistry();
+
+    /// Registers a channel, or returns the metrics of an already registered channel with the same name
+    /// @param channelName Channel name (e.g. "data-out[0]")
+    /// @return Metrics of the channel
+    std::shared_ptr<FairMQChannelMetrics> Register(const std::string& channelName);
+
+    /// Get the metrics of a channel
+    /// @param channelName Channel name
+    /// @return Metrics of the channel, nullptr if it is not registered
+    std::shared_ptr<FairMQChannelMetrics> Get(const std::string& channelName) const;
+
+    /// Get the names of the registered channels
+    std::vector<std::string> GetChannelNames() const;
+
+    /// Writes a snapshot of the metrics of all channels in the Prometheus text format
+    /// @param os Output stream
+    /// @param deviceId Device ID, used as a label of the metrics
+    void WriteSnapshot(std::ostream& os, const std::string& deviceId) const;
+
+    /// Writes a snapshot to a file, replacing it at once so that readers never see a partial snapshot
+    /// @param fileName File name
+    /// @param deviceId Device ID, used as a label of the metrics
+    /// @return true if the file has been written
+    bool WriteSnapshot(const std::string& fileName, const std::string& deviceId) const;
+
+  private:
+    std::map<std::string, std::shared_ptr<FairMQChannelMetrics>> fChannels;
+    mutable boost::mutex fMutex;
+
+    /// Copy Constructor
+    FairMQMetricsRegistry(const FairMQMetricsRegistry&);
+    FairMQMetricsRegistry operator=(const FairMQMetricsRegistry&);
+};
+
+#endif /* FAIRMQMETRICS_H_ */
@@ -11,3 +11,95 @@
  * @since 2014-01-23
  * @author A. Rybalchenko
  */
+
+#include <chrono>
+
+#include "FairMQPoller.h"
+
+using namespace std;
+
+FairMQPoller::FairMQPoller()
+    : fHandlers()
+    , fDispatchOffset(0)
+    , fMaxBusyPollInUs(0)
+    , fBusyPollInUs(0)
+{
+}
+
+void FairMQPoller::OnData(const int handle, function<bool(int)> handler)
+{
+    if (handle >= fHandlers.size())
+    {
+        fHandlers.resize(handle + 1);
+    }
+    fHandlers.at(handle) = handler;
+}
+
+void FairMQPoller::SetBusyPollTime(const int busyPollInUs)
+{
+    fMaxBusyPollInUs = busyPollInUs;
+    fBusyPollInUs = busyPollInUs;
+}
+
+bool FairMQPoller::AnyInput()
+{
+    for (int i = 0; i < fHandlers.size(); ++i)
+    {
+        if (fHandlers[i] && CheckInput(i))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FairMQPoller::Dispatch(const int timeout)
+{
+    bool ready = false;
+
+    if (fMaxBusyPollInUs > 0)
+    {
+        // spin with zero timeout first, avoiding the wake-up latency of a blocking poll
+        chrono::steady_clock::time_point end = chrono::steady_clock::now() + chrono::microseconds(fBusyPollInUs);
+        do
+        {
+            Poll(0);
+            ready = AnyInput();
+        }
+        while (!ready && chrono::steady_clock::now() < end);
+
+        if (ready)
+        {
+            fBusyPollInUs = min(fMaxBusyPollInUs, max(2 * fBusyPollInUs, 1));
+        }
+        else
+        {
+            fBusyPollInUs /= 2;
+        }
+    }
+
+    if (!ready)
+    {
+        Poll(timeout);
+    }
+
+    int numHandlers = fHandlers.size();
+    for (int k = 0; k < numHandlers; ++k)
+    {
+        int i = (fDispatchOffset + k) % numHandlers;
+        if (fHandlers[i] && CheckInput(i))
+        {
+            if (!fHandlers[i](i))
+            {
+                return false;
+            }
+        }
+    }
+
+    if (numHandlers > 0)
+    {
+        fDispatchOffset = (fDispatchOffset + 1) % numHandlers;
+    }
+
+    return true;
+}
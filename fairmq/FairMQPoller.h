@@ -16,17 +16,59 @@
 #define FAIRMQPOLLER_H_
 
 #include <string>
+#include <vector>
+#include <functional>
 
 class FairMQPoller
 {
   public:
+    FairMQPoller();
+
     virtual void Poll(const int timeout) = 0;
     virtual bool CheckInput(const int index) = 0;
     virtual bool CheckOutput(const int index) = 0;
     virtual bool CheckInput(const std::string channelKey, const int index) = 0;
     virtual bool CheckOutput(const std::string channelKey, const int index) = 0;
 
+    /// Resolves a channel key and index into an integer handle
+    /// @details The handle can be passed to CheckInput(int)/CheckOutput(int) and OnData(),
+    /// avoiding the string lookup on every poll.
+    /// @param channelKey Channel name as given to the poller constructor
+    /// @param index Sub-channel index
+    /// @return Handle of the poll item
+    virtual int GetHandle(const std::string channelKey, const int index) = 0;
+    /// Get the number of poll items
+    /// @return Number of poll items (handles are in the range [0, GetNumItems()))
+    virtual int GetNumItems() const = 0;
+
+    /// Registers a handler for incoming data
+    /// @details The handler is called from Dispatch() with the handle as argument, when the channel is ready for reading.
+    /// It should return false to stop the dispatching (e.g. when a receive/send was interrupted by a command).
+    /// @param handle Handle returned by GetHandle() (or the channel index for single channel vector pollers)
+    /// @param handler Callable to be invoked for the ready channel
+    void OnData(const int handle, std::function<bool(int)> handler);
+
+    /// Sets the maximum time spent busy polling before Dispatch() blocks
+    /// @details The actually used busy poll time adapts between 0 and this value: it grows when data arrives while
+    /// busy polling and shrinks when it does not. 0 (default) disables busy polling.
+    /// @param busyPollInUs Maximum busy poll time in microseconds
+    void SetBusyPollTime(const int busyPollInUs);
+
+    /// Waits for data on the channels with registered handlers and calls the handlers of all ready channels
+    /// @details The channels are visited starting from a different channel on every call, so that no input is preferred.
+    /// @param timeout Maximum blocking time in milliseconds (-1 for infinite)
+    /// @return false if one of the handlers requested to stop, true otherwise
+    bool Dispatch(const int timeout);
+
     virtual ~FairMQPoller() {};
+
+  private:
+    bool AnyInput();
+
+    std::vector<std::function<bool(int)>> fHandlers;
+    int fDispatchOffset;
+    int fMaxBusyPollInUs;
+    int fBusyPollInUs;
 };
 
 #endif /* FAIRMQPOLLER_H_ */
\ No newline at end of file
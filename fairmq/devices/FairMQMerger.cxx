@@ -19,7 +19,12 @@
 #include "FairMQMerger.h"
 #include "FairMQPoller.h"
 
+using namespace std;
+
 FairMQMerger::FairMQMerger()
+    : fInputBudget(1)
+    , fPollTimeout(100)
+    , fBusyPollTime(0)
 {
 }
 
@@ -29,46 +34,129 @@ FairMQMerger::~FairMQMerger()
 
 void FairMQMerger::Run()
 {
-    std::unique_ptr<FairMQPoller> poller(fTransportFactory->CreatePoller(fChannels.at("data-in")));
+    unique_ptr<FairMQPoller> poller(fTransportFactory->CreatePoller(fChannels.at("data-in")));
 
     // store the channel references to avoid traversing the map on every loop iteration
     const FairMQChannel& dataOutChannel = fChannels.at("data-out").at(0);
-    std::vector<FairMQChannel*> dataInChannels(fChannels.at("data-in").size());
+    vector<FairMQChannel*> dataInChannels(fChannels.at("data-in").size());
     for (int i = 0; i < fChannels.at("data-in").size(); ++i)
     {
         dataInChannels.at(i) = &(fChannels.at("data-in").at(i));
-    }
-
-    int numInputs = fChannels.at("data-in").size();
-
-    while (CheckCurrentState(RUNNING))
-    {
-        std::unique_ptr<FairMQMessage> msg(fTransportFactory->CreateMessage());
 
-        poller->Poll(100);
-
-        // Loop over the data input channels.
-        for (int i = 0; i < numInputs; ++i)
+        // The poller visits the ready inputs starting with a different one each round,
+        // each input forwards up to the budget before the next one is served.
+        poller->OnData(i, [&](int index)
         {
-            // Check if the channel has data ready to be received.
-            if (poller->CheckInput(i))
+            for (int n = 0; n < fInputBudget; ++n)
             {
-                // Try receiving the data.
-                if (dataInChannels[i]->Receive(msg) > 0)
+                unique_ptr<FairMQMessage> msg(fTransportFactory->CreateMessage());
+
+                // the first receive is known not to block
+                int received = (n == 0) ? dataInChannels[index]->Receive(msg) : dataInChannels[index]->ReceiveAsync(msg);
+                if (received == -2 && n > 0)
                 {
-                    // If data was received, send it to output.
-                    if (dataOutChannel.Send(msg) < 0)
-                    {
-                        LOG(DEBUG) << "Blocking send interrupted by a command";
-                        break;
-                    }
+                    // input queue is empty, move on to the next input
+                    return true;
                 }
-                else
+                if (received <= 0)
                 {
                     LOG(DEBUG) << "Blocking receive interrupted by a command";
-                    break;
+                    return false;
+                }
+
+                // If data was received, send it to output.
+                if (dataOutChannel.Send(msg) < 0)
+                {
+                    LOG(DEBUG) << "Blocking send interrupted by a command";
+                    return false;
                 }
             }
-        }
+            return true;
+        });
+    }
+
+    poller->SetBusyPollTime(fBusyPollTime);
+
+    while (CheckCurrentState(RUNNING))
+    {
+        poller->Dispatch(fPollTimeout);
+    }
+}
+
+void FairMQMerger::SetProperty(const int key, const string& value)
+{
+    switch (key)
+    {
+        default:
+            FairMQDevice::SetProperty(key, value);
+            break;
+    }
+}
+
+string FairMQMerger::GetProperty(const int key, const string& default_ /*= ""*/)
+{
+    switch (key)
+    {
+        default:
+            return FairMQDevice::GetProperty(key, default_);
+    }
+}
+
+void FairMQMerger::SetProperty(const int key, const int value)
+{
+    switch (key)
+    {
+        case InputBudget:
+            fInputBudget = value;
+            break;
+        case PollTimeout:
+            fPollTimeout = value;
+            break;
+        case BusyPollTime:
+            fBusyPollTime = value;
+            break;
+        default:
+            FairMQDevice::SetProperty(key, value);
+            break;
+    }
+}
+
+int FairMQMerger::GetProperty(const int key, const int default_ /*= 0*/)
+{
+    switch (key)
+    {
+        case InputBudget:
+            return fInputBudget;
+        case PollTimeout:
+            return fPollTimeout;
+        case BusyPollTime:
+            return fBusyPollTime;
+        default:
+            return FairMQDevice::GetProperty(key, default_);
+    }
+}
+
+string FairMQMerger::GetPropertyDescription(const int key)
+{
+    switch (key)
+    {
+        case InputBudget:
+            return "InputBudget: Maximum number of messages forwarded from one input per poll round.";
+        case PollTimeout:
+            return "PollTimeout: Timeout of the input poller in milliseconds.";
+        case BusyPollTime:
+            return "BusyPollTime: Maximum time in microseconds to busy poll the inputs before blocking (0 to disable).";
+        default:
+            return FairMQDevice::GetPropertyDescription(key);
+    }
+}
+
+void FairMQMerger::ListProperties()
+{
+    LOG(INFO) << "Properties of FairMQMerger:";
+    for (int p = FairMQConfigurable::Last; p < FairMQMerger::Last; ++p)
+    {
+        LOG(INFO) << " " << GetPropertyDescription(p);
     }
+    LOG(INFO) << "---------------------------";
 }
@@ -15,15 +15,44 @@
 #ifndef FAIRMQMERGER_H_
 #define FAIRMQMERGER_H_
 
+#include <string>
+
 #include "FairMQDevice.h"
 
+/**
+ * Forwards messages from all data-in channels to the data-out channel.
+ *
+ * Each poll round visits the inputs starting from a rotating offset and drains at most
+ * InputBudget messages from every ready input, so that a busy input cannot starve the others.
+ */
+
 class FairMQMerger : public FairMQDevice
 {
   public:
+    enum
+    {
+        InputBudget = FairMQDevice::Last,
+        PollTimeout,
+        BusyPollTime,
+        Last
+    };
+
     FairMQMerger();
     virtual ~FairMQMerger();
 
+    virtual void SetProperty(const int key, const std::string& value);
+    virtual std::string GetProperty(const int key, const std::string& default_ = "");
+    virtual void SetProperty(const int key, const int value);
+    virtual int GetProperty(const int key, const int default_ = 0);
+
+    virtual std::string GetPropertyDescription(const int key);
+    virtual void ListProperties();
+
   protected:
+    int fInputBudget;
+    int fPollTimeout;
+    int fBusyPollTime;
+
     virtual void Run();
 };
 
@@ -18,7 +18,11 @@
 #include "FairMQLogger.h"
 #include "FairMQSplitter.h"
 
+using namespace std;
+
 FairMQSplitter::FairMQSplitter()
+    : fRoutingMode("round-robin")
+    , fInitialCredits(1)
 {
 }
 
@@ -28,20 +32,40 @@ FairMQSplitter::~FairMQSplitter()
 
 void FairMQSplitter::Run()
 {
-    int direction = 0;
-    int numOutputs = fChannels.at("data-out").size();
-
     // store the channel references to avoid traversing the map on every loop iteration
     const FairMQChannel& dataInChannel = fChannels.at("data-in").at(0);
-    FairMQChannel* dataOutChannels[fChannels.at("data-out").size()];
-    for (int i = 0; i < numOutputs; ++i)
+    vector<FairMQChannel*> dataOutChannels(fChannels.at("data-out").size());
+    for (int i = 0; i < dataOutChannels.size(); ++i)
     {
-        dataOutChannels[i] = &(fChannels.at("data-out").at(i));
+        dataOutChannels.at(i) = &(fChannels.at("data-out").at(i));
     }
 
+    if (fRoutingMode == "round-robin")
+    {
+        RunRoundRobin(dataInChannel, dataOutChannels);
+    }
+    else if (fRoutingMode == "next-ready")
+    {
+        RunNextReady(dataInChannel, dataOutChannels);
+    }
+    else if (fRoutingMode == "credit")
+    {
+        RunCredit(dataInChannel, dataOutChannels);
+    }
+    else
+    {
+        LOG(ERROR) << "Unknown routing mode: \"" << fRoutingMode << "\", expected round-robin/next-ready/credit";
+    }
+}
+
+void FairMQSplitter::RunRoundRobin(const FairMQChannel& dataInChannel, vector<FairMQChannel*>& dataOutChannels)
+{
+    int direction = 0;
+    int numOutputs = dataOutChannels.size();
+
     while (CheckCurrentState(RUNNING))
     {
-        std::unique_ptr<FairMQMessage> msg(fTransportFactory->CreateMessage());
+        unique_ptr<FairMQMessage> msg(fTransportFactory->CreateMessage());
 
         if (dataInChannel.Receive(msg) > 0)
         {
@@ -54,3 +78,202 @@ void FairMQSplitter::Run()
         }
     }
 }
+
+void FairMQSplitter::RunNextReady(const FairMQChannel& dataInChannel, vector<FairMQChannel*>& dataOutChannels)
+{
+    int direction = 0;
+    int numOutputs = dataOutChannels.size();
+
+    unique_ptr<FairMQPoller> poller(fTransportFactory->CreatePoller(fChannels.at("data-out")));
+
+    while (CheckCurrentState(RUNNING))
+    {
+        unique_ptr<FairMQMessage> msg(fTransportFactory->CreateMessage());
+
+        if (dataInChannel.Receive(msg) <= 0)
+        {
+            continue;
+        }
+
+        // try the outputs in turn without blocking, a full queue only skips that output
+        int attempts = 0;
+        while (CheckCurrentState(RUNNING))
+        {
+            int result = dataOutChannels[direction]->SendAsync(msg);
+
+            ++direction;
+            if (direction >= numOutputs)
+            {
+                direction = 0;
+            }
+
+            if (result >= 0)
+            {
+                break;
+            }
+            if (result == -1)
+            {
+                LOG(ERROR) << "Failed sending on data-out channel, dropping message";
+                break;
+            }
+
+            // all outputs are full, wait until at least one of them can take a message
+            if (++attempts >= numOutputs)
+            {
+                poller->Poll(100);
+                attempts = 0;
+            }
+        }
+    }
+}
+
+void FairMQSplitter::RunCredit(const FairMQChannel& dataInChannel, vector<FairMQChannel*>& dataOutChannels)
+{
+    int numOutputs = dataOutChannels.size();
+
+    if (fChannels.count("credit-in") == 0 || fChannels.at("credit-in").size() != numOutputs)
+    {
+        LOG(ERROR) << "Credit routing requires one credit-in channel per data-out channel";
+        return;
+    }
+
+    vector<FairMQChannel*> creditInChannels(numOutputs);
+    for (int i = 0; i < numOutputs; ++i)
+    {
+        creditInChannels.at(i) = &(fChannels.at("credit-in").at(i));
+    }
+
+    unique_ptr<FairMQPoller> poller(fTransportFactory->CreatePoller(fChannels.at("credit-in")));
+
+    vector<int> credits(numOutputs, fInitialCredits);
+    int offset = 0;
+
+    while (CheckCurrentState(RUNNING))
+    {
+        unique_ptr<FairMQMessage> msg(fTransportFactory->CreateMessage());
+
+        if (dataInChannel.Receive(msg) <= 0)
+        {
+            continue;
+        }
+
+        int target = -1;
+        while (CheckCurrentState(RUNNING))
+        {
+            // collect the credits advertised by the workers since the last message
+            for (int i = 0; i < numOutputs; ++i)
+            {
+                unique_ptr<FairMQMessage> credit(fTransportFactory->CreateMessage());
+                while (creditInChannels[i]->ReceiveAsync(credit) > 0)
+                {
+                    if (credit->GetSize() >= sizeof(int))
+                    {
+                        credits[i] += *(static_cast<int*>(credit->GetData()));
+                    }
+                    credit.reset(fTransportFactory->CreateMessage());
+                }
+            }
+
+            // pick the output with the most free slots, rotating the start to break ties
+            target = -1;
+            for (int k = 0; k < numOutputs; ++k)
+            {
+                int i = (offset + k) % numOutputs;
+                if (credits[i] > 0 && (target < 0 || credits[i] > credits[target]))
+                {
+                    target = i;
+                }
+            }
+
+            if (target >= 0)
+            {
+                break;
+            }
+
+            // no worker has free slots, wait for a credit message
+            poller->Poll(100);
+        }
+
+        if (target < 0)
+        {
+            break;
+        }
+
+        if (dataOutChannels[target]->Send(msg) >= 0)
+        {
+            --credits[target];
+        }
+        offset = (target + 1) % numOutputs;
+    }
+}
+
+void FairMQSplitter::SetProperty(const int key, const string& value)
+{
+    switch (key)
+    {
+        case RoutingMode:
+            fRoutingMode = value;
+            break;
+        default:
+            FairMQDevice::SetProperty(key, value);
+            break;
+    }
+}
+
+string FairMQSplitter::GetProperty(const int key, const string& default_ /*= ""*/)
+{
+    switch (key)
+    {
+        case RoutingMode:
+            return fRoutingMode;
+        default:
+            return FairMQDevice::GetProperty(key, default_);
+    }
+}
+
+void FairMQSplitter::SetProperty(const int key, const int value)
+{
+    switch (key)
+    {
+        case InitialCredits:
+            fInitialCredits = value;
+            break;
+        default:
+            FairMQDevice::SetProperty(key, value);
+            break;
+    }
+}
+
+int FairMQSplitter::GetProperty(const int key, const int default_ /*= 0*/)
+{
+    switch (key)
+    {
+        case InitialCredits:
+            return fInitialCredits;
+        default:
+            return FairMQDevice::GetProperty(key, default_);
+    }
+}
+
+string FairMQSplitter::GetPropertyDescription(const int key)
+{
+    switch (key)
+    {
+        case RoutingMode:
+            return "RoutingMode: Distribution of messages over the outputs (round-robin/next-ready/credit).";
+        case InitialCredits:
+            return "InitialCredits: Number of free slots assumed per output before its worker advertises any (credit mode).";
+        default:
+            return FairMQDevice::GetPropertyDescription(key);
+    }
+}
+
+void FairMQSplitter::ListProperties()
+{
+    LOG(INFO) << "Properties of FairMQSplitter:";
+    for (int p = FairMQConfigurable::Last; p < FairMQSplitter::Last; ++p)
+    {
+        LOG(INFO) << " " << GetPropertyDescription(p);
+    }
+    LOG(INFO) << "---------------------------";
+}
@@ -15,16 +15,53 @@
 #ifndef FAIRMQSPLITTER_H_
 #define FAIRMQSPLITTER_H_
 
+#include <string>
+#include <vector>
+
 #include "FairMQDevice.h"
 
+/**
+ * Distributes messages from the data-in channel over the data-out channels.
+ *
+ * Supported routing modes:
+ *  - "round-robin": blocking send to the next output in turn (default).
+ *  - "next-ready": non-blocking send, skipping outputs whose queue is full.
+ *  - "credit": each output i has a matching "credit-in" channel i, on which the
+ *    downstream worker advertises free slots (an int per message). Messages go to
+ *    the output with the most credits, i.e. the least outstanding messages.
+ */
+
 class FairMQSplitter : public FairMQDevice
 {
   public:
+    enum
+    {
+        RoutingMode = FairMQDevice::Last,
+        InitialCredits,
+        Last
+    };
+
     FairMQSplitter();
     virtual ~FairMQSplitter();
 
+    virtual void SetProperty(const int key, const std::string& value);
+    virtual std::string GetProperty(const int key, const std::string& default_ = "");
+    virtual void SetProperty(const int key, const int value);
+    virtual int GetProperty(const int key, const int default_ = 0);
+
+    virtual std::string GetPropertyDescription(const int key);
+    virtual void ListProperties();
+
   protected:
+    std::string fRoutingMode;
+    int fInitialCredits;
+
     virtual void Run();
+
+  private:
+    void RunRoundRobin(const FairMQChannel& dataInChannel, std::vector<FairMQChannel*>& dataOutChannels);
+    void RunNextReady(const FairMQChannel& dataInChannel, std::vector<FairMQChannel*>& dataOutChannels);
+    void RunCredit(const FairMQChannel& dataInChannel, std::vector<FairMQChannel*>& dataOutChannels);
 };
 
 #endif /* FAIRMQSPLITTER_H_ */
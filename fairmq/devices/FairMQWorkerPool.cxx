@@ -0,0 +1,171 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * FairMQWorkerPool.cxx
+ *
+ * @since 2016-02-22
+ */
+
+#include <boost/bind.hpp>
+
+#include "FairMQWorkerPool.h"
+#include "FairMQLogger.h"
+
+using namespace std;
+
+FairMQWorkerPool::FairMQWorkerPool(const int numWorkers, const bool ordered, const int queueDepth)
+    : fNumWorkers(numWorkers > 0 ? numWorkers : 1)
+    , fOrdered(ordered)
+    , fQueueDepth(queueDepth > 0 ? queueDepth : 2 * fNumWorkers)
+    , fStopping(false)
+    , fInFlight(0)
+    , fNumReceived(0)
+    , fNumSent(0)
+    , fInputMutex()
+    , fInputCondition()
+    , fInputQueue()
+    , fOutputMutex()
+    , fOutputCondition()
+    , fOutputQueue()
+    , fNextToSend(0)
+{
+}
+
+FairMQWorkerPool::~FairMQWorkerPool()
+{
+}
+
+void FairMQWorkerPool::Run(const FairMQChannel& inputChannel,
+                           const FairMQChannel& outputChannel,
+                           FairMQTransportFactory* factory,
+                           function<bool()> running,
+                           ProcessFunction process)
+{
+    fStopping = false;
+
+    boost::thread_group workers;
+    for (int i = 0; i < fNumWorkers; ++i)
+    {
+        workers.create_thread(boost::bind(&FairMQWorkerPool::Work, this, i, process));
+    }
+
+    unsigned long sequence = 0;
+
+    while (running())
+    {
+        // the sent messages free the slots for the input
+        SendOutput(outputChannel);
+
+        // a full pool takes no input, so that a slow worker or output cannot make the queues grow without limit
+        if (fInFlight < fQueueDepth)
+        {
+            unique_ptr<FairMQMessage> msg(factory->CreateMessage());
+
+            // with nothing in flight there is nothing to send, wait for the input
+            int nbytes = (fInFlight == 0) ? inputChannel.Receive(msg) : inputChannel.ReceiveAsync(msg);
+            if (nbytes > 0)
+            {
+                ++fNumReceived;
+                ++fInFlight;
+                {
+                    boost::lock_guard<boost::mutex> lock(fInputMutex);
+                    fInputQueue.push_back(make_pair(sequence++, move(msg)));
+                }
+                fInputCondition.notify_one();
+                continue;
+            }
+            if (fInFlight == 0)
+            {
+                continue;
+            }
+        }
+
+        // wait for the workers, the input is checked again after a millisecond
+        boost::unique_lock<boost::mutex> lock(fOutputMutex);
+        if (!ReadyToSend())
+        {
+            fOutputCondition.timed_wait(lock, boost::posix_time::milliseconds(1));
+        }
+    }
+
+    {
+        boost::lock_guard<boost::mutex> lock(fInputMutex);
+        fStopping = true;
+    }
+    fInputCondition.notify_all();
+
+    workers.join_all();
+
+    // drop what was not processed/sent before the state change
+    fInputQueue.clear();
+    fOutputQueue.clear();
+    fInFlight = 0;
+    fNextToSend = 0;
+}
+
+void FairMQWorkerPool::Work(const int workerId, ProcessFunction process)
+{
+    while (true)
+    {
+        pair<unsigned long, unique_ptr<FairMQMessage>> item;
+        {
+            boost::unique_lock<boost::mutex> lock(fInputMutex);
+            while (fInputQueue.empty() && !fStopping)
+            {
+                fInputCondition.wait(lock);
+            }
+            if (fStopping)
+            {
+                return;
+            }
+            item = move(fInputQueue.front());
+            fInputQueue.pop_front();
+        }
+
+        if (!process(workerId, item.second))
+        {
+            item.second.reset();
+        }
+
+        {
+            boost::lock_guard<boost::mutex> lock(fOutputMutex);
+            fOutputQueue[item.first] = move(item.second);
+        }
+        fOutputCondition.notify_one();
+    }
+}
+
+bool FairMQWorkerPool::ReadyToSend() const
+{
+    // in ordered mode only the next message in sequence, otherwise any processed message
+    return !fOutputQueue.empty() && (!fOrdered || fOutputQueue.begin()->first == fNextToSend);
+}
+
+void FairMQWorkerPool::SendOutput(const FairMQChannel& outputChannel)
+{
+    while (true)
+    {
+        unique_ptr<FairMQMessage> msg;
+        {
+            boost::lock_guard<boost::mutex> lock(fOutputMutex);
+            if (!ReadyToSend())
+            {
+                return;
+            }
+            msg = move(fOutputQueue.begin()->second);
+            fOutputQueue.erase(fOutputQueue.begin());
+            ++fNextToSend;
+        }
+
+        if (msg && outputChannel.Send(msg) >= 0)
+        {
+            ++fNumSent;
+        }
+        --fInFlight;
+    }
+}
@@ -0,0 +1,99 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * FairMQWorkerPool.h
+ *
+ * @since 2016-02-22
+ */
+
+#ifndef FAIRMQWORKERPOOL_H_
+#define FAIRMQWORKERPOOL_H_
+
+#include <map>
+#include <deque>
+#include <vector>
+#include <memory> // unique_ptr
+#include <functional>
+
+#include <boost/thread.hpp>
+
+#include "FairMQChannel.h"
+#include "FairMQMessage.h"
+#include "FairMQTransportFactory.h"
+
+/**
+ * Intra-device worker pool for processor devices.
+ *
+ * The calling thread receives messages from the input channel and queues them to N worker threads,
+ * each of which calls the process function with its own worker index (so that every worker can use its own task clone).
+ * The calling thread also sends the processed messages to the output channel, optionally in the order they were received,
+ * so the sockets are used only by the thread of the device. The worker threads see only the messages.
+ * The number of messages in flight (received but not yet sent) is bounded by the queue depth.
+ */
+
+class FairMQWorkerPool
+{
+  public:
+    /// Process function: called with the worker index and the message to process in place.
+    /// Returns false if the message should be dropped instead of sent.
+    typedef std::function<bool(const int, std::unique_ptr<FairMQMessage>&)> ProcessFunction;
+
+    /// Constructor
+    /// @param numWorkers Number of worker threads
+    /// @param ordered Send the output in the order of the input
+    /// @param queueDepth Maximum number of messages in flight (0 for 2 * numWorkers)
+    FairMQWorkerPool(const int numWorkers, const bool ordered, const int queueDepth = 0);
+    virtual ~FairMQWorkerPool();
+
+    /// Runs the pool until running() returns false
+    /// @param inputChannel Channel to receive from (used only from the calling thread)
+    /// @param outputChannel Channel to send to (used only from the calling thread)
+    /// @param factory Transport factory to create the messages
+    /// @param running Returns false when the pool should stop
+    /// @param process Process function
+    void Run(const FairMQChannel& inputChannel,
+             const FairMQChannel& outputChannel,
+             FairMQTransportFactory* factory,
+             std::function<bool()> running,
+             ProcessFunction process);
+
+    unsigned long GetNumReceived() const { return fNumReceived; }
+    unsigned long GetNumSent() const { return fNumSent; }
+
+  private:
+    void Work(const int workerId, ProcessFunction process);
+    /// Sends the processed messages which are ready, on the calling thread
+    void SendOutput(const FairMQChannel& outputChannel);
+    /// The next message may be sent, to be called with fOutputMutex locked
+    bool ReadyToSend() const;
+
+    int fNumWorkers;
+    bool fOrdered;
+    int fQueueDepth;
+
+    bool fStopping;
+    int fInFlight;
+    unsigned long fNumReceived;
+    unsigned long fNumSent;
+
+    boost::mutex fInputMutex;
+    boost::condition_variable fInputCondition;
+    std::deque<std::pair<unsigned long, std::unique_ptr<FairMQMessage>>> fInputQueue;
+
+    boost::mutex fOutputMutex;
+    boost::condition_variable fOutputCondition;
+    // processed messages by sequence number, a null message marks a dropped one
+    std::map<unsigned long, std::unique_ptr<FairMQMessage>> fOutputQueue;
+    unsigned long fNextToSend;
+
+    /// Copy Constructor
+    FairMQWorkerPool(const FairMQWorkerPool&);
+    FairMQWorkerPool operator=(const FairMQWorkerPool&);
+};
+
+#endif /* FAIRMQWORKERPOOL_H_ */
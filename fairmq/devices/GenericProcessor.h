@@ -15,7 +15,13 @@
 #ifndef GENERICPROCESSOR_H
 #define GENERICPROCESSOR_H
 
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+
 #include "FairMQDevice.h"
+#include "FairMQWorkerPool.h"
 
 /*********************************************************************
  * -------------- NOTES -----------------------
@@ -37,6 +43,14 @@
  * CONTAINER_TYPE proc_task_type::GetOutputData()
  *                proc_task_type::ExecuteTask(CONTAINER_TYPE container)
  *                proc_task_type::InitTask(...)  // if GenericProcessor::InitTask(...) is used
+ *
+ *  -------- WORKER POOL --------
+ * With NumWorkers > 1 every additional worker thread uses its own default constructed
+ * set of the three policies, initialized with the same InitTask/InitInputContainer/InitOutputContainer arguments.
+ * The serialization policy must fill the message given with SetMessage(...).
+ * Policies using ROOT objects require ROOT::EnableThreadSafety() (ROOT 6) to be called by the application
+ * before the device starts (see InitConfig() of the GenericDevices examples).
+ * The channels are used only by the device thread, the worker threads see only the messages.
  *                
  **********************************************************************/
 
@@ -47,16 +61,72 @@ class GenericProcessor : public FairMQDevice, public T, public U, public V
     typedef T                                         deserialization_type;
     typedef U                                           serialization_type;
     typedef V                                               proc_task_type;
+
+    // policy set of an additional worker thread
+    struct worker_type : public T, public U, public V
+    {
+    };
+
   public:
+    enum
+    {
+        NumWorkers = FairMQDevice::Last,
+        OrderedOutput,
+        Last
+    };
+
     GenericProcessor()
         : deserialization_type()
         , serialization_type()
         , proc_task_type()
+        , fNumWorkers(1)
+        , fOrderedOutput(0)
+        , fWorkers()
+        , fWorkerInit()
     {}
 
     virtual ~GenericProcessor()
     {}
 
+    virtual void SetProperty(const int key, const std::string& value)
+    {
+        FairMQDevice::SetProperty(key, value);
+    }
+
+    virtual std::string GetProperty(const int key, const std::string& default_ = "")
+    {
+        return FairMQDevice::GetProperty(key, default_);
+    }
+
+    virtual void SetProperty(const int key, const int value)
+    {
+        switch (key)
+        {
+            case NumWorkers:
+                fNumWorkers = value;
+                break;
+            case OrderedOutput:
+                fOrderedOutput = value;
+                break;
+            default:
+                FairMQDevice::SetProperty(key, value);
+                break;
+        }
+    }
+
+    virtual int GetProperty(const int key, const int default_ = 0)
+    {
+        switch (key)
+        {
+            case NumWorkers:
+                return fNumWorkers;
+            case OrderedOutput:
+                return fOrderedOutput;
+            default:
+                return FairMQDevice::GetProperty(key, default_);
+        }
+    }
+
     // the four following methods ensure 
     // that the correct policy method is called
 
@@ -68,18 +138,21 @@ class GenericProcessor : public FairMQDevice, public T, public U, public V
     template <typename... Args>
     void InitTask(Args... args)
     {
+        fWorkerInit.push_back([=](worker_type& worker) { worker.proc_task_type::InitTask(args...); });
         proc_task_type::InitTask(std::forward<Args>(args)...);
     }
 
     template <typename... Args>
     void InitInputContainer(Args... args)
     {
+        fWorkerInit.push_back([=](worker_type& worker) { worker.deserialization_type::InitContainer(args...); });
         deserialization_type::InitContainer(std::forward<Args>(args)...);
     }
 
     template <typename... Args>
     void InitOutputContainer(Args... args)
     {
+        fWorkerInit.push_back([=](worker_type& worker) { worker.serialization_type::InitContainer(args...); });
         serialization_type::InitContainer(std::forward<Args>(args)...);
     }
 
@@ -111,16 +184,60 @@ class GenericProcessor : public FairMQDevice, public T, public U, public V
     */
 
   protected:
+    int fNumWorkers;
+    int fOrderedOutput;
+
     virtual void InitTask()
     {
         // TODO: implement multipart features
         // fProcessorTask->InitTask();
         // fProcessorTask->SetSendPart(boost::bind(&FairMQProcessor::SendPart, this));
         // fProcessorTask->SetReceivePart(boost::bind(&FairMQProcessor::ReceivePart, this));
+
+        // worker 0 uses the policies of the device itself
+        for (int i = fWorkers.size(); i < fNumWorkers - 1; ++i)
+        {
+            fWorkers.emplace_back(new worker_type());
+            for (auto& init : fWorkerInit)
+            {
+                init(*fWorkers.back());
+            }
+        }
+    }
+
+    template <typename W>
+    static void Process(W& worker, FairMQMessage* msg)
+    {
+        worker.proc_task_type::ExecuteTask(worker.deserialization_type::DeserializeMsg(msg));
+        worker.serialization_type::SetMessage(msg);
+        worker.serialization_type::SerializeMsg(worker.proc_task_type::GetOutputData());
     }
 
     virtual void Run()
     {
+        if (fNumWorkers > 1)
+        {
+            FairMQWorkerPool pool(fNumWorkers, fOrderedOutput != 0);
+
+            pool.Run(fChannels.at("data-in").at(0), fChannels.at("data-out").at(0), fTransportFactory,
+                     [this]() { return CheckCurrentState(RUNNING); },
+                     [this](const int worker, std::unique_ptr<FairMQMessage>& msg)
+                     {
+                         if (worker == 0)
+                         {
+                             Process(*this, msg.get());
+                         }
+                         else
+                         {
+                             Process(*fWorkers.at(worker - 1), msg.get());
+                         }
+                         return true;
+                     });
+
+            MQLOG(INFO) << "Received " << pool.GetNumReceived() << " and sent " << pool.GetNumSent() << " messages with " << fNumWorkers << " workers!";
+            return;
+        }
+
         int receivedMsgs = 0;
         int sentMsgs = 0;
 
@@ -151,6 +268,10 @@ class GenericProcessor : public FairMQDevice, public T, public U, public V
         MQLOG(INFO) << "Received " << receivedMsgs << " and sent " << sentMsgs << " messages!";
     }
 
+  private:
+    std::vector<std::unique_ptr<worker_type>> fWorkers;
+    std::vector<std::function<void(worker_type&)>> fWorkerInit;
+
 };
 
 #endif /* GENERICPROCESSOR_H */
@@ -44,6 +44,12 @@
  *           void BindSendHeader(std::function<void(int)> callback)       // enabled if exists
  *           void BindGetSocketNumber(std::function<int()> callback)    // enabled if exists
  *           void GetHeader(std::function<int()> callback)    // enabled if exists
+ *           void BindCreateMessage(std::function<FairMQMessage*()> callback) // enabled if exists
+ * FairMQMessage* GetReadyMessage(int& socketIdx)                     // enabled if exists
+ *
+ *  A source policy with GetReadyMessage() serializes the events itself: the sampler
+ *  sends the returned messages on the returned socket of the output channel until it
+ *  returns nullptr, the serialization policy is not used for the events then.
  * 
  *  -------- OUTPUT POLICY --------
  *                serialization_type::SerializeMsg(CONTAINER_TYPE)            // must be there to compile
@@ -186,6 +192,20 @@ class base_GenericSampler : public FairMQDevice, public T, public U
         fChannels.at(fOutChanName).at(socketIdx).Send(serialization_type::SerializeMsg(source_type::GetHeader()), "snd-more");
     }
 
+    template<typename S = source_type,FairMQ::tools::enable_if_hasNot_BindCreateMessage<S> = 0>
+    void BindingCreateMessage() {}
+    template<typename S = source_type,FairMQ::tools::enable_if_has_BindCreateMessage<S> = 0>
+    void BindingCreateMessage()
+    {
+        source_type::BindCreateMessage([this]() { return fTransportFactory->CreateMessage(); });
+    }
+
+    // sends the events of the source, returns the number of sent messages
+    template<typename S = source_type,FairMQ::tools::enable_if_hasNot_GetReadyMessage<S> = 0>
+    int SendEvents();
+    template<typename S = source_type,FairMQ::tools::enable_if_has_GetReadyMessage<S> = 0>
+    int SendEvents();
+
     template<typename S = source_type,FairMQ::tools::enable_if_hasNot_BindGetCurrentIndex<S> = 0>
     void BindingGetCurrentIndex() {}
     template<typename S = source_type,FairMQ::tools::enable_if_has_BindGetCurrentIndex<S> = 0>
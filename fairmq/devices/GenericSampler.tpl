@@ -33,6 +33,7 @@ void base_GenericSampler<T,U,K,L>::InitTask()
     BindingSendPart();
     BindingGetSocketNumber();
     BindingGetCurrentIndex();
+    BindingCreateMessage();
 
     source_type::InitSource();
     fNumEvents = source_type::GetNumberOfEvent();
@@ -43,12 +44,27 @@ void base_GenericSampler<T,U,K,L>::Run()
 {
     // boost::thread resetEventCounter(boost::bind(&GenericSampler::ResetEventCounter, this));
 
-    int sentMsgs = 0;
-
     boost::timer::auto_cpu_timer timer;
 
     LOG(INFO) << "Number of events to process: " << fNumEvents;
 
+    int sentMsgs = SendEvents();
+
+    boost::timer::cpu_times const elapsed_time(timer.elapsed());
+    LOG(INFO) << "Sent everything in:\n" << boost::timer::format(elapsed_time, 2);
+    LOG(INFO) << "Sent " << sentMsgs << " messages!";
+    if (elapsed_time.wall > 0)
+    {
+        LOG(INFO) << "Event rate: " << sentMsgs / (elapsed_time.wall * 1e-9) << " events/s";
+    }
+}
+
+template <typename T, typename U, typename K, typename L>
+template <typename S, FairMQ::tools::enable_if_hasNot_GetReadyMessage<S>>
+int base_GenericSampler<T,U,K,L>::SendEvents()
+{
+    int sentMsgs = 0;
+
     do
     {
         for (fCurrentIdx = 0; fCurrentIdx < fNumEvents; fCurrentIdx++)
@@ -82,11 +98,38 @@ void base_GenericSampler<T,U,K,L>::Run()
     }
     while (CheckCurrentState(RUNNING) && fContinuous);
 
-    boost::timer::cpu_times const elapsed_time(timer.elapsed());
-    LOG(INFO) << "Sent everything in:\n" << boost::timer::format(elapsed_time, 2);
-    LOG(INFO) << "Sent " << sentMsgs << " messages!";
+    return sentMsgs;
 }
 
+template <typename T, typename U, typename K, typename L>
+template <typename S, FairMQ::tools::enable_if_has_GetReadyMessage<S>>
+int base_GenericSampler<T,U,K,L>::SendEvents()
+{
+    int sentMsgs = 0;
+    int socketIdx = 0;
+
+    do
+    {
+        // (re)starts the source at the first event
+        source_type::SetIndex(0);
+        fCurrentIdx = 0;
+        while (CheckCurrentState(RUNNING))
+        {
+            std::unique_ptr<FairMQMessage> msg(source_type::GetReadyMessage(socketIdx));
+            if (!msg)
+            {
+                break;
+            }
+            ExecuteTasks();
+            fChannels.at(fOutChanName).at(socketIdx).Send(msg.get());
+            sentMsgs++;
+            fCurrentIdx++;
+        }
+    }
+    while (CheckCurrentState(RUNNING) && fContinuous);
+
+    return sentMsgs;
+}
 
 template <typename T, typename U, typename K, typename L>
 int base_GenericSampler<T,U,K,L>::GetSocketNumber() const
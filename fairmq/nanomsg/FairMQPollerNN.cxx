@@ -226,6 +226,25 @@ bool FairMQPollerNN::CheckOutput(const string channelKey, const int index)
     }
 }
 
+int FairMQPollerNN::GetHandle(const string channelKey, const int index)
+{
+    try
+    {
+        return fOffsetMap.at(channelKey) + index;
+    }
+    catch (const std::out_of_range& oor)
+    {
+        LOG(ERROR) << "Invalid channel key: \"" << channelKey << "\"";
+        LOG(ERROR) << "Out of Range error: " << oor.what() << '\n';
+        exit(EXIT_FAILURE);
+    }
+}
+
+int FairMQPollerNN::GetNumItems() const
+{
+    return fNumItems;
+}
+
 FairMQPollerNN::~FairMQPollerNN()
 {
     if (items != NULL)
@@ -15,6 +15,8 @@
 #ifndef FAIRMQSOCKETNN_H_
 #define FAIRMQSOCKETNN_H_
 
+#include <atomic>
+
 #include <nanomsg/nn.h>
 #include <nanomsg/pipeline.h>
 #include <nanomsg/pubsub.h>
@@ -63,10 +65,10 @@ class FairMQSocketNN : public FairMQSocket
   private:
     int fSocket;
     std::string fId;
-    unsigned long fBytesTx;
-    unsigned long fBytesRx;
-    unsigned long fMessagesTx;
-    unsigned long fMessagesRx;
+    std::atomic<unsigned long> fBytesTx;
+    std::atomic<unsigned long> fBytesRx;
+    std::atomic<unsigned long> fMessagesTx;
+    std::atomic<unsigned long> fMessagesRx;
 
     /// Copy Constructor
     FairMQSocketNN(const FairMQSocketNN&);
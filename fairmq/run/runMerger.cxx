@@ -32,7 +32,8 @@ typedef struct DeviceOptions
     DeviceOptions() :
         id(), ioThreads(0), numInputs(0),
         inputSocketType(), inputBufSize(), inputMethod(), inputAddress(),
-        outputSocketType(), outputBufSize(0), outputMethod(), outputAddress() {}
+        outputSocketType(), outputBufSize(0), outputMethod(), outputAddress(),
+        inputBudget(0), pollTimeout(0), busyPollTime(0) {}
 
     string id;
     int ioThreads;
@@ -45,6 +46,9 @@ typedef struct DeviceOptions
     int outputBufSize;
     string outputMethod;
     string outputAddress;
+    int inputBudget;
+    int pollTimeout;
+    int busyPollTime;
 } DeviceOptions_t;
 
 inline bool parse_cmd_line(int _argc, char* _argv[], DeviceOptions* _options)
@@ -66,6 +70,9 @@ inline bool parse_cmd_line(int _argc, char* _argv[], DeviceOptions* _options)
         ("output-buff-size", bpo::value<int>()->required(), "Output buffer size in number of messages (ZeroMQ)/bytes(nanomsg)")
         ("output-method", bpo::value<string>()->required(), "Output method: bind/connect")
         ("output-address", bpo::value<string>()->required(), "Output address, e.g.: \"tcp://localhost:5555\"")
+        ("input-budget", bpo::value<int>()->default_value(1), "Maximum number of messages forwarded from one input per poll round")
+        ("poll-timeout", bpo::value<int>()->default_value(100), "Input poll timeout in milliseconds")
+        ("busy-poll-time", bpo::value<int>()->default_value(0), "Maximum busy poll time in microseconds before blocking (0 to disable)")
         ("help", "Print help messages");
 
     bpo::variables_map vm;
@@ -112,6 +119,15 @@ inline bool parse_cmd_line(int _argc, char* _argv[], DeviceOptions* _options)
     if (vm.count("output-address"))
         _options->outputAddress = vm["output-address"].as<string>();
 
+    if (vm.count("input-budget"))
+        _options->inputBudget = vm["input-budget"].as<int>();
+
+    if (vm.count("poll-timeout"))
+        _options->pollTimeout = vm["poll-timeout"].as<int>();
+
+    if (vm.count("busy-poll-time"))
+        _options->busyPollTime = vm["busy-poll-time"].as<int>();
+
     return true;
 }
 
@@ -161,6 +177,9 @@ int main(int argc, char** argv)
 
     merger.SetProperty(FairMQMerger::Id, options.id);
     merger.SetProperty(FairMQMerger::NumIoThreads, options.ioThreads);
+    merger.SetProperty(FairMQMerger::InputBudget, options.inputBudget);
+    merger.SetProperty(FairMQMerger::PollTimeout, options.pollTimeout);
+    merger.SetProperty(FairMQMerger::BusyPollTime, options.busyPollTime);
 
     merger.ChangeState("INIT_DEVICE");
     merger.WaitForEndOfState("INIT_DEVICE");
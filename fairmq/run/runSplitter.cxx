@@ -32,7 +32,8 @@ typedef struct DeviceOptions
     DeviceOptions() :
         id(), ioThreads(0), numOutputs(0),
         inputSocketType(), inputBufSize(0), inputMethod(), inputAddress(),
-        outputSocketType(), outputBufSize(), outputMethod(), outputAddress()
+        outputSocketType(), outputBufSize(), outputMethod(), outputAddress(),
+        routingMode(), initialCredits(0), creditMethod(), creditAddress()
         {}
 
     string id;
@@ -46,6 +47,10 @@ typedef struct DeviceOptions
     vector<int> outputBufSize;
     vector<string> outputMethod;
     vector<string> outputAddress;
+    string routingMode;
+    int initialCredits;
+    vector<string> creditMethod;
+    vector<string> creditAddress;
 } DeviceOptions_t;
 
 inline bool parse_cmd_line(int _argc, char* _argv[], DeviceOptions* _options)
@@ -67,6 +72,10 @@ inline bool parse_cmd_line(int _argc, char* _argv[], DeviceOptions* _options)
         ("output-buff-size", bpo::value<vector<int>>(), "Output buffer size in number of messages (ZeroMQ)/bytes(nanomsg)")
         ("output-method", bpo::value<vector<string>>()->required(), "Output method: bind/connect")
         ("output-address", bpo::value<vector<string>>()->required(), "Output address, e.g.: \"tcp://localhost:5555\"")
+        ("routing-mode", bpo::value<string>()->default_value("round-robin"), "Routing mode: round-robin/next-ready/credit")
+        ("initial-credits", bpo::value<int>()->default_value(1), "Free slots assumed per output before the first credit message (credit mode)")
+        ("credit-method", bpo::value<vector<string>>(), "Credit input method, one per output: bind/connect (credit mode)")
+        ("credit-address", bpo::value<vector<string>>(), "Credit input address, one per output (credit mode)")
         ("help", "Print help messages");
 
     bpo::variables_map vm;
@@ -113,6 +122,18 @@ inline bool parse_cmd_line(int _argc, char* _argv[], DeviceOptions* _options)
     if ( vm.count("output-address") )
         _options->outputAddress = vm["output-address"].as<vector<string>>();
 
+    if ( vm.count("routing-mode") )
+        _options->routingMode = vm["routing-mode"].as<string>();
+
+    if ( vm.count("initial-credits") )
+        _options->initialCredits = vm["initial-credits"].as<int>();
+
+    if ( vm.count("credit-method") )
+        _options->creditMethod = vm["credit-method"].as<vector<string>>();
+
+    if ( vm.count("credit-address") )
+        _options->creditAddress = vm["credit-address"].as<vector<string>>();
+
     return true;
 }
 
@@ -160,8 +181,18 @@ int main(int argc, char** argv)
         splitter.fChannels["data-out"].push_back(outputChannel);
     }
 
+    for (int i = 0; i < options.creditAddress.size(); ++i)
+    {
+        FairMQChannel creditChannel("pull", options.creditMethod.at(i), options.creditAddress.at(i));
+        creditChannel.UpdateRateLogging(0);
+
+        splitter.fChannels["credit-in"].push_back(creditChannel);
+    }
+
     splitter.SetProperty(FairMQSplitter::Id, options.id);
     splitter.SetProperty(FairMQSplitter::NumIoThreads, options.ioThreads);
+    splitter.SetProperty(FairMQSplitter::RoutingMode, options.routingMode);
+    splitter.SetProperty(FairMQSplitter::InitialCredits, options.initialCredits);
 
     splitter.ChangeState("INIT_DEVICE");
     splitter.WaitForEndOfState("INIT_DEVICE");
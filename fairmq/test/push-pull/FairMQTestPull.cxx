@@ -13,22 +13,81 @@
  */
 
 #include <memory> // unique_ptr
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
 
 #include "FairMQTestPull.h"
 #include "FairMQLogger.h"
 
+using namespace std;
+
 FairMQTestPull::FairMQTestPull()
+    : fNumMessages(1)
+    , fNumLatencyMessages(0)
 {
 }
 
 void FairMQTestPull::Run()
 {
-    std::unique_ptr<FairMQMessage> msg(fTransportFactory->CreateMessage());
+    const FairMQChannel& dataChannel = fChannels.at("data").at(0);
+
+    vector<double> latencies;
+    latencies.reserve(fNumLatencyMessages);
+    chrono::steady_clock::time_point first;
+    chrono::steady_clock::time_point last;
+
+    int received = 0;
+    while (received < fNumMessages + fNumLatencyMessages && CheckCurrentState(RUNNING))
+    {
+        unique_ptr<FairMQMessage> msg(fTransportFactory->CreateMessage());
+        int nbytes = dataChannel.Receive(msg);
+        if (nbytes == -1)
+        {
+            break;
+        }
+        if (nbytes < 0)
+        {
+            continue;
+        }
+
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();
+        if (received == 0)
+        {
+            first = now;
+        }
+        if (++received <= fNumMessages)
+        {
+            last = now;
+        }
+        else if (msg->GetSize() >= sizeof(int64_t))
+        {
+            int64_t sendTime = 0;
+            memcpy(&sendTime, msg->GetData(), sizeof(sendTime));
+            int64_t receiveTime = chrono::duration_cast<chrono::nanoseconds>(now.time_since_epoch()).count();
+            latencies.push_back((receiveTime - sendTime) / 1000.);
+        }
+    }
 
-    if (fChannels.at("data").at(0).Receive(msg) >= 0)
+    if (received < fNumMessages + fNumLatencyMessages)
+    {
+        LOG(ERROR) << "Received only " << received << " of " << fNumMessages + fNumLatencyMessages << " messages";
+        return;
+    }
+
+    if (fNumMessages > 1)
+    {
+        double seconds = chrono::duration<double>(last - first).count();
+        LOG(INFO) << (dataChannel.GetFastPath() ? "fast path" : "poll") << ": " << fNumMessages << " messages in " << seconds << " s, " << (fNumMessages - 1) / seconds << " msg/s";
+    }
+    if (!latencies.empty())
     {
-        LOG(INFO) << "PUSH-PULL test successfull";
+        sort(latencies.begin(), latencies.end());
+        LOG(INFO) << (dataChannel.GetFastPath() ? "fast path" : "poll") << ": latency p50: " << latencies.at(latencies.size() / 2) << " us, p99: " << latencies.at((latencies.size() * 99) / 100) << " us";
     }
+    LOG(INFO) << "PUSH-PULL test successfull";
 }
 
 FairMQTestPull::~FairMQTestPull()
@@ -17,13 +17,26 @@
 
 #include "FairMQDevice.h"
 
+/**
+ * Receiving side of the push-pull test. With the default settings a single empty message is
+ * transferred. For the small message benchmark a number of messages is first transferred
+ * back-to-back to measure the throughput and then paced, carrying their send time,
+ * to measure the latency.
+ */
+
 class FairMQTestPull : public FairMQDevice
 {
   public:
     FairMQTestPull();
     virtual ~FairMQTestPull();
 
+    void SetNumMessages(int numMessages) { fNumMessages = numMessages; }
+    void SetNumLatencyMessages(int numLatencyMessages) { fNumLatencyMessages = numLatencyMessages; }
+
   protected:
+    int fNumMessages;
+    int fNumLatencyMessages;
+
     virtual void Run();
 };
 
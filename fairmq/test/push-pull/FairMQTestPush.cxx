@@ -13,18 +13,47 @@
  */
 
 #include <memory> // unique_ptr
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <cstdint>
 
 #include "FairMQTestPush.h"
 #include "FairMQLogger.h"
 
+using namespace std;
+
 FairMQTestPush::FairMQTestPush()
+    : fNumMessages(1)
+    , fNumLatencyMessages(0)
+    , fMsgSize(0)
 {
 }
 
 void FairMQTestPush::Run()
 {
-    std::unique_ptr<FairMQMessage> msg(fTransportFactory->CreateMessage());
-    fChannels.at("data").at(0).Send(msg);
+    const FairMQChannel& dataChannel = fChannels.at("data").at(0);
+
+    for (int i = 0; i < fNumMessages + fNumLatencyMessages && CheckCurrentState(RUNNING); ++i)
+    {
+        if (i >= fNumMessages)
+        {
+            // pace the latency messages, so that they do not queue up
+            this_thread::sleep_for(chrono::microseconds(100));
+        }
+
+        unique_ptr<FairMQMessage> msg(fMsgSize > 0 ? fTransportFactory->CreateMessage(fMsgSize) : fTransportFactory->CreateMessage());
+        if (fMsgSize >= static_cast<int>(sizeof(int64_t)))
+        {
+            int64_t sendTime = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+            memcpy(msg->GetData(), &sendTime, sizeof(sendTime));
+        }
+
+        if (dataChannel.Send(msg) < 0)
+        {
+            break;
+        }
+    }
 }
 
 FairMQTestPush::~FairMQTestPush()
@@ -17,13 +17,28 @@
 
 #include "FairMQDevice.h"
 
+/**
+ * Sending side of the push-pull test. With the default settings a single empty message is
+ * transferred. For the small message benchmark a number of messages is first transferred
+ * back-to-back to measure the throughput and then paced, carrying their send time,
+ * to measure the latency.
+ */
+
 class FairMQTestPush : public FairMQDevice
 {
   public:
     FairMQTestPush();
     virtual ~FairMQTestPush();
 
+    void SetNumMessages(int numMessages) { fNumMessages = numMessages; }
+    void SetNumLatencyMessages(int numLatencyMessages) { fNumLatencyMessages = numLatencyMessages; }
+    void SetMsgSize(int msgSize) { fMsgSize = msgSize; }
+
   protected:
+    int fNumMessages;
+    int fNumLatencyMessages;
+    int fMsgSize;
+
     virtual void Run();
 };
 
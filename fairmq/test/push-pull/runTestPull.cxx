@@ -12,6 +12,9 @@
  * @author A. Rybalchenko
  */
 
+#include <string>
+#include <cstdlib>
+
 #include "FairMQLogger.h"
 #include "FairMQTestPull.h"
 
@@ -21,6 +24,8 @@
 #include "FairMQTransportFactoryZMQ.h"
 #endif
 
+// usage: test-fairmq-pull [fast/poll] [messages]
+// without arguments a single message is transferred, with arguments the 64 byte message benchmark is run
 int main(int argc, char** argv)
 {
     FairMQTestPull testPull;
@@ -35,6 +40,12 @@ int main(int argc, char** argv)
     testPull.SetProperty(FairMQTestPull::Id, "testPull");
 
     FairMQChannel pullChannel("pull", "connect", "tcp://127.0.0.1:5557");
+    if (argc > 1)
+    {
+        pullChannel.SetFastPath(std::string(argv[1]) != "poll");
+        testPull.SetNumMessages(argc > 2 ? atoi(argv[2]) : 1000000);
+        testPull.SetNumLatencyMessages(10000);
+    }
     testPull.fChannels["data"].push_back(pullChannel);
 
     testPull.ChangeState("INIT_DEVICE");
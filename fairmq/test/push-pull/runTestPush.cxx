@@ -12,6 +12,9 @@
  * @author A. Rybalchenko
  */
 
+#include <string>
+#include <cstdlib>
+
 #include "FairMQLogger.h"
 #include "FairMQTestPush.h"
 
@@ -21,6 +24,8 @@
 #include "FairMQTransportFactoryZMQ.h"
 #endif
 
+// usage: test-fairmq-push [fast/poll] [messages]
+// without arguments a single message is transferred, with arguments the 64 byte message benchmark is run
 int main(int argc, char** argv)
 {
     FairMQTestPush testPush;
@@ -35,6 +40,13 @@ int main(int argc, char** argv)
     testPush.SetProperty(FairMQTestPush::Id, "testPush");
 
     FairMQChannel pushChannel("push", "bind", "tcp://127.0.0.1:5557");
+    if (argc > 1)
+    {
+        pushChannel.SetFastPath(std::string(argv[1]) != "poll");
+        testPush.SetNumMessages(argc > 2 ? atoi(argv[2]) : 1000000);
+        testPush.SetNumLatencyMessages(10000);
+        testPush.SetMsgSize(64);
+    }
     testPush.fChannels["data"].push_back(pushChannel);
 
     testPush.ChangeState("INIT_DEVICE");
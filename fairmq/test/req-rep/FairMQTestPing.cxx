@@ -0,0 +1,92 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * FairMQTestPing.cxx
+ *
+ * @since 2016-02-15
+ */
+
+#include <memory> // unique_ptr
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+#include "FairMQTestPing.h"
+#include "FairMQPoller.h"
+#include "FairMQLogger.h"
+
+using namespace std;
+
+FairMQTestPing::FairMQTestPing()
+    : fNumRoundTrips(10000)
+    , fMode("poll")
+{
+}
+
+void FairMQTestPing::Run()
+{
+    const FairMQChannel& dataChannel = fChannels.at("data").at(0);
+    unique_ptr<FairMQPoller> poller(fTransportFactory->CreatePoller(fChannels.at("data")));
+
+    bool replied = false;
+    poller->OnData(0, [&](int)
+    {
+        unique_ptr<FairMQMessage> reply(fTransportFactory->CreateMessage());
+        replied = dataChannel.ReceiveAsync(reply) >= 0;
+        return true;
+    });
+    poller->SetBusyPollTime(200);
+
+    vector<double> rtts;
+    rtts.reserve(fNumRoundTrips);
+
+    for (int i = 0; i < fNumRoundTrips && CheckCurrentState(RUNNING); ++i)
+    {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+        unique_ptr<FairMQMessage> request(fTransportFactory->CreateMessage(64));
+        if (dataChannel.Send(request) < 0)
+        {
+            break;
+        }
+
+        replied = false;
+        while (!replied && CheckCurrentState(RUNNING))
+        {
+            if (fMode == "dispatch")
+            {
+                poller->Dispatch(100);
+            }
+            else
+            {
+                poller->Poll(100);
+                if (poller->CheckInput(0))
+                {
+                    unique_ptr<FairMQMessage> reply(fTransportFactory->CreateMessage());
+                    replied = dataChannel.Receive(reply) >= 0;
+                }
+            }
+        }
+
+        rtts.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - start).count());
+    }
+
+    if (rtts.size() < fNumRoundTrips)
+    {
+        LOG(ERROR) << "Completed only " << rtts.size() << " of " << fNumRoundTrips << " round trips";
+        return;
+    }
+
+    sort(rtts.begin(), rtts.end());
+    LOG(INFO) << fMode << ": round trip time p50: " << rtts.at(rtts.size() / 2) << " us, p99: " << rtts.at((rtts.size() * 99) / 100) << " us";
+    LOG(INFO) << "REQ-REP latency test successfull";
+}
+
+FairMQTestPing::~FairMQTestPing()
+{
+}
@@ -0,0 +1,43 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * FairMQTestPing.h
+ *
+ * @since 2016-02-15
+ */
+
+#ifndef FAIRMQTESTPING_H_
+#define FAIRMQTESTPING_H_
+
+#include <string>
+
+#include "FairMQDevice.h"
+
+/**
+ * Request side of the ping-pong latency benchmark. Measures the round trip time of small
+ * requests, waiting for the replies either with fixed-timeout polling ("poll") or with the
+ * handler based FairMQPoller::Dispatch() and adaptive busy polling ("dispatch").
+ */
+
+class FairMQTestPing : public FairMQDevice
+{
+  public:
+    FairMQTestPing();
+    virtual ~FairMQTestPing();
+
+    void SetNumRoundTrips(int numRoundTrips) { fNumRoundTrips = numRoundTrips; }
+    void SetMode(const std::string& mode) { fMode = mode; }
+
+  protected:
+    int fNumRoundTrips;
+    std::string fMode;
+
+    virtual void Run();
+};
+
+#endif /* FAIRMQTESTPING_H_ */
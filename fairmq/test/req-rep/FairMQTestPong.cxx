@@ -0,0 +1,75 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * FairMQTestPong.cxx
+ *
+ * @since 2016-02-15
+ */
+
+#include <memory> // unique_ptr
+
+#include "FairMQTestPong.h"
+#include "FairMQPoller.h"
+#include "FairMQLogger.h"
+
+using namespace std;
+
+FairMQTestPong::FairMQTestPong()
+    : fNumRoundTrips(10000)
+    , fMode("poll")
+{
+}
+
+void FairMQTestPong::Run()
+{
+    const FairMQChannel& dataChannel = fChannels.at("data").at(0);
+    unique_ptr<FairMQPoller> poller(fTransportFactory->CreatePoller(fChannels.at("data")));
+
+    int replies = 0;
+    poller->OnData(0, [&](int)
+    {
+        unique_ptr<FairMQMessage> request(fTransportFactory->CreateMessage());
+        if (dataChannel.ReceiveAsync(request) >= 0)
+        {
+            unique_ptr<FairMQMessage> reply(fTransportFactory->CreateMessage(64));
+            if (dataChannel.Send(reply) < 0)
+            {
+                return false;
+            }
+            ++replies;
+        }
+        return true;
+    });
+    poller->SetBusyPollTime(200);
+
+    while (replies < fNumRoundTrips && CheckCurrentState(RUNNING))
+    {
+        if (fMode == "dispatch")
+        {
+            poller->Dispatch(100);
+        }
+        else
+        {
+            poller->Poll(100);
+            if (poller->CheckInput(0))
+            {
+                unique_ptr<FairMQMessage> request(fTransportFactory->CreateMessage());
+                if (dataChannel.Receive(request) >= 0)
+                {
+                    unique_ptr<FairMQMessage> reply(fTransportFactory->CreateMessage(64));
+                    dataChannel.Send(reply);
+                    ++replies;
+                }
+            }
+        }
+    }
+}
+
+FairMQTestPong::~FairMQTestPong()
+{
+}
@@ -0,0 +1,41 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * FairMQTestPong.h
+ *
+ * @since 2016-02-15
+ */
+
+#ifndef FAIRMQTESTPONG_H_
+#define FAIRMQTESTPONG_H_
+
+#include <string>
+
+#include "FairMQDevice.h"
+
+/**
+ * Reply side of the ping-pong latency benchmark, echoes every request (see FairMQTestPing).
+ */
+
+class FairMQTestPong : public FairMQDevice
+{
+  public:
+    FairMQTestPong();
+    virtual ~FairMQTestPong();
+
+    void SetNumRoundTrips(int numRoundTrips) { fNumRoundTrips = numRoundTrips; }
+    void SetMode(const std::string& mode) { fMode = mode; }
+
+  protected:
+    int fNumRoundTrips;
+    std::string fMode;
+
+    virtual void Run();
+};
+
+#endif /* FAIRMQTESTPONG_H_ */
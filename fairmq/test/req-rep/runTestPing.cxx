@@ -0,0 +1,62 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * runTestPing.cxx
+ *
+ * @since 2016-02-15
+ */
+
+#include <string>
+
+#include "FairMQLogger.h"
+#include "FairMQTestPing.h"
+
+#ifdef NANOMSG
+#include "FairMQTransportFactoryNN.h"
+#else
+#include "FairMQTransportFactoryZMQ.h"
+#endif
+
+// usage: test-fairmq-ping <poll/dispatch>
+int main(int argc, char** argv)
+{
+    FairMQTestPing testPing;
+    testPing.CatchSignals();
+
+#ifdef NANOMSG
+    testPing.SetTransport(new FairMQTransportFactoryNN());
+#else
+    testPing.SetTransport(new FairMQTransportFactoryZMQ());
+#endif
+
+    testPing.SetProperty(FairMQTestPing::Id, "testPing");
+    testPing.SetNumRoundTrips(10000);
+    testPing.SetMode(argc > 1 ? argv[1] : "poll");
+
+    FairMQChannel reqChannel("req", "bind", "tcp://127.0.0.1:5561");
+    testPing.fChannels["data"].push_back(reqChannel);
+
+    testPing.ChangeState("INIT_DEVICE");
+    testPing.WaitForEndOfState("INIT_DEVICE");
+
+    testPing.ChangeState("INIT_TASK");
+    testPing.WaitForEndOfState("INIT_TASK");
+
+    testPing.ChangeState("RUN");
+    testPing.WaitForEndOfState("RUN");
+
+    testPing.ChangeState("RESET_TASK");
+    testPing.WaitForEndOfState("RESET_TASK");
+
+    testPing.ChangeState("RESET_DEVICE");
+    testPing.WaitForEndOfState("RESET_DEVICE");
+
+    testPing.ChangeState("END");
+
+    return 0;
+}
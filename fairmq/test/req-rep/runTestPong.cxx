@@ -0,0 +1,62 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * runTestPong.cxx
+ *
+ * @since 2016-02-15
+ */
+
+#include <string>
+
+#include "FairMQLogger.h"
+#include "FairMQTestPong.h"
+
+#ifdef NANOMSG
+#include "FairMQTransportFactoryNN.h"
+#else
+#include "FairMQTransportFactoryZMQ.h"
+#endif
+
+// usage: test-fairmq-pong <poll/dispatch>
+int main(int argc, char** argv)
+{
+    FairMQTestPong testPong;
+    testPong.CatchSignals();
+
+#ifdef NANOMSG
+    testPong.SetTransport(new FairMQTransportFactoryNN());
+#else
+    testPong.SetTransport(new FairMQTransportFactoryZMQ());
+#endif
+
+    testPong.SetProperty(FairMQTestPong::Id, "testPong");
+    testPong.SetNumRoundTrips(10000);
+    testPong.SetMode(argc > 1 ? argv[1] : "poll");
+
+    FairMQChannel repChannel("rep", "connect", "tcp://127.0.0.1:5561");
+    testPong.fChannels["data"].push_back(repChannel);
+
+    testPong.ChangeState("INIT_DEVICE");
+    testPong.WaitForEndOfState("INIT_DEVICE");
+
+    testPong.ChangeState("INIT_TASK");
+    testPong.WaitForEndOfState("INIT_TASK");
+
+    testPong.ChangeState("RUN");
+    testPong.WaitForEndOfState("RUN");
+
+    testPong.ChangeState("RESET_TASK");
+    testPong.WaitForEndOfState("RESET_TASK");
+
+    testPong.ChangeState("RESET_DEVICE");
+    testPong.WaitForEndOfState("RESET_DEVICE");
+
+    testPong.ChangeState("END");
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * runMetricsTest.cxx
+ *
+ * @since 2016-03-01
+ */
+
+#include <memory> // unique_ptr, shared_ptr
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "FairMQLogger.h"
+#include "FairMQDevice.h"
+#include "FairMQMetrics.h"
+
+#ifdef NANOMSG
+#include "FairMQTransportFactoryNN.h"
+#else
+#include "FairMQTransportFactoryZMQ.h"
+#endif
+
+using namespace std;
+
+// Transfers messages between two channels of one device, while another thread
+// reads the metrics, and checks the counters, the histograms and the snapshot.
+
+class MetricsTester : public FairMQDevice
+{
+  public:
+    MetricsTester() {}
+    virtual ~MetricsTester() {}
+
+  protected:
+    virtual void Run()
+    {
+        const int numMessages = 1000;
+        const FairMQChannel& outChannel = fChannels.at("data-out").at(0);
+        const FairMQChannel& inChannel = fChannels.at("data-in").at(0);
+
+        shared_ptr<FairMQChannelMetrics> out = GetMetrics().Get("data-out[0]");
+        shared_ptr<FairMQChannelMetrics> in = GetMetrics().Get("data-in[0]");
+        if (!out || !in || outChannel.GetMetrics() != out || inChannel.GetMetrics() != in)
+        {
+            LOG(ERROR) << "channel metrics are not registered";
+            return;
+        }
+
+        // nothing to receive yet
+        unique_ptr<FairMQMessage> empty(fTransportFactory->CreateMessage());
+        inChannel.ReceiveAsync(empty);
+
+        // reads the metrics concurrently to the transfer
+        atomic<bool> reading(true);
+        thread reader([&]()
+        {
+            while (reading)
+            {
+                stringstream ss;
+                GetMetrics().WriteSnapshot(ss, fId);
+                out->fSendLatency.GetPercentile(0.99);
+            }
+        });
+
+        int received = 0;
+        for (int i = 0; i < numMessages && CheckCurrentState(RUNNING); ++i)
+        {
+            unique_ptr<FairMQMessage> msg(fTransportFactory->CreateMessage(100));
+            unique_ptr<FairMQMessage> reply(fTransportFactory->CreateMessage());
+            if (outChannel.Send(msg) >= 0 && inChannel.Receive(reply) == 100)
+            {
+                ++received;
+            }
+        }
+
+        reading = false;
+        reader.join();
+
+        stringstream snapshot;
+        GetMetrics().WriteSnapshot(snapshot, fId);
+        string sentLine = "fairmq_channel_messages_tx{device=\"metricsTester\",channel=\"data-out[0]\"} 1000\n";
+
+        if (received == numMessages
+            && out->fMessagesTx == numMessages && out->fBytesTx == 100 * numMessages
+            && in->fMessagesRx == numMessages && in->fBytesRx == 100 * numMessages
+            && in->fReceiveAgain == 1 && out->fErrors == 0 && in->fErrors == 0
+            && out->fSendLatency.GetCount() == numMessages && in->fReceiveLatency.GetCount() == numMessages + 1
+            && out->fSendLatency.GetPercentile(0.5) <= out->fSendLatency.GetPercentile(0.99)
+            && snapshot.str().find(sentLine) != string::npos)
+        {
+            LOG(INFO) << "send latency p50: " << out->fSendLatency.GetPercentile(0.5) << " ns, p99: " << out->fSendLatency.GetPercentile(0.99) << " ns";
+            LOG(INFO) << "Metrics test successfull";
+        }
+        else
+        {
+            LOG(ERROR) << "unexpected metrics:\n" << snapshot.str();
+        }
+    }
+};
+
+int main(int argc, char** argv)
+{
+    MetricsTester metricsTester;
+    metricsTester.CatchSignals();
+
+#ifdef NANOMSG
+    metricsTester.SetTransport(new FairMQTransportFactoryNN());
+#else
+    metricsTester.SetTransport(new FairMQTransportFactoryZMQ());
+#endif
+
+    metricsTester.SetProperty(MetricsTester::Id, "metricsTester");
+
+    FairMQChannel dataOutChannel("push", "bind", "tcp://127.0.0.1:5565");
+    metricsTester.fChannels["data-out"].push_back(dataOutChannel);
+
+    FairMQChannel dataInChannel("pull", "connect", "tcp://127.0.0.1:5565");
+    metricsTester.fChannels["data-in"].push_back(dataInChannel);
+
+    metricsTester.ChangeState(MetricsTester::INIT_DEVICE);
+    metricsTester.WaitForEndOfState(MetricsTester::INIT_DEVICE);
+
+    metricsTester.ChangeState(MetricsTester::INIT_TASK);
+    metricsTester.WaitForEndOfState(MetricsTester::INIT_TASK);
+
+    metricsTester.ChangeState(MetricsTester::RUN);
+    metricsTester.WaitForEndOfState(MetricsTester::RUN);
+
+    metricsTester.ChangeState(MetricsTester::RESET_TASK);
+    metricsTester.WaitForEndOfState(MetricsTester::RESET_TASK);
+
+    metricsTester.ChangeState(MetricsTester::RESET_DEVICE);
+    metricsTester.WaitForEndOfState(MetricsTester::RESET_DEVICE);
+
+    metricsTester.ChangeState(MetricsTester::END);
+
+    return 0;
+}
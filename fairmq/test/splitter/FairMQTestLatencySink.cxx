@@ -0,0 +1,77 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * FairMQTestLatencySink.cxx
+ *
+ * @since 2016-02-08
+ */
+
+#include <memory> // unique_ptr
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+
+#include "FairMQTestLatencySink.h"
+#include "FairMQLogger.h"
+
+using namespace std;
+
+FairMQTestLatencySink::FairMQTestLatencySink()
+    : fNumMessages(1000)
+{
+}
+
+void FairMQTestLatencySink::Run()
+{
+    const FairMQChannel& dataChannel = fChannels.at("data-in").at(0);
+
+    vector<int64_t> latencies;
+    latencies.reserve(fNumMessages);
+
+    chrono::steady_clock::time_point start;
+
+    while (latencies.size() < fNumMessages && CheckCurrentState(RUNNING))
+    {
+        unique_ptr<FairMQMessage> msg(fTransportFactory->CreateMessage());
+
+        if (dataChannel.Receive(msg) < static_cast<int>(sizeof(int64_t)))
+        {
+            continue;
+        }
+
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();
+        if (latencies.empty())
+        {
+            start = now;
+        }
+
+        int64_t sent = 0;
+        memcpy(&sent, msg->GetData(), sizeof(int64_t));
+        latencies.push_back(chrono::duration_cast<chrono::nanoseconds>(now.time_since_epoch()).count() - sent);
+    }
+
+    if (latencies.size() < fNumMessages)
+    {
+        LOG(ERROR) << "Received only " << latencies.size() << " of " << fNumMessages << " messages";
+        return;
+    }
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    sort(latencies.begin(), latencies.end());
+    double p50 = latencies.at(latencies.size() / 2) / 1.e6;
+    double p99 = latencies.at((latencies.size() * 99) / 100) / 1.e6;
+
+    LOG(INFO) << "throughput: " << latencies.size() / seconds << " msg/s, latency p50: " << p50 << " ms, p99: " << p99 << " ms";
+    LOG(INFO) << "SPLITTER test successfull";
+}
+
+FairMQTestLatencySink::~FairMQTestLatencySink()
+{
+}
@@ -0,0 +1,37 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * FairMQTestLatencySink.h
+ *
+ * @since 2016-02-08
+ */
+
+#ifndef FAIRMQTESTLATENCYSINK_H_
+#define FAIRMQTESTLATENCYSINK_H_
+
+#include "FairMQDevice.h"
+
+/**
+ * Receives the messages of FairMQTestTimedPush and reports throughput and latency percentiles.
+ */
+
+class FairMQTestLatencySink : public FairMQDevice
+{
+  public:
+    FairMQTestLatencySink();
+    virtual ~FairMQTestLatencySink();
+
+    void SetNumMessages(int numMessages) { fNumMessages = numMessages; }
+
+  protected:
+    int fNumMessages;
+
+    virtual void Run();
+};
+
+#endif /* FAIRMQTESTLATENCYSINK_H_ */
@@ -0,0 +1,66 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * FairMQTestSlowWorker.cxx
+ *
+ * @since 2016-02-08
+ */
+
+#include <memory> // unique_ptr
+#include <cstring>
+
+#include <boost/thread.hpp>
+
+#include "FairMQTestSlowWorker.h"
+#include "FairMQLogger.h"
+
+using namespace std;
+
+FairMQTestSlowWorker::FairMQTestSlowWorker()
+    : fDelayInMs(0)
+{
+}
+
+void FairMQTestSlowWorker::Run()
+{
+    const FairMQChannel& dataInChannel = fChannels.at("data-in").at(0);
+    const FairMQChannel& dataOutChannel = fChannels.at("data-out").at(0);
+    const FairMQChannel* creditOutChannel = fChannels.count("credit-out") ? &(fChannels.at("credit-out").at(0)) : nullptr;
+
+    while (CheckCurrentState(RUNNING))
+    {
+        unique_ptr<FairMQMessage> msg(fTransportFactory->CreateMessage());
+
+        if (dataInChannel.Receive(msg) <= 0)
+        {
+            continue;
+        }
+
+        if (fDelayInMs > 0)
+        {
+            boost::this_thread::sleep(boost::posix_time::milliseconds(fDelayInMs));
+        }
+
+        if (dataOutChannel.Send(msg) < 0)
+        {
+            break;
+        }
+
+        if (creditOutChannel)
+        {
+            int credits = 1;
+            unique_ptr<FairMQMessage> credit(fTransportFactory->CreateMessage(sizeof(int)));
+            memcpy(credit->GetData(), &credits, sizeof(int));
+            creditOutChannel->Send(credit);
+        }
+    }
+}
+
+FairMQTestSlowWorker::~FairMQTestSlowWorker()
+{
+}
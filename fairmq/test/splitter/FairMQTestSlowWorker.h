@@ -0,0 +1,38 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * FairMQTestSlowWorker.h
+ *
+ * @since 2016-02-08
+ */
+
+#ifndef FAIRMQTESTSLOWWORKER_H_
+#define FAIRMQTESTSLOWWORKER_H_
+
+#include "FairMQDevice.h"
+
+/**
+ * Forwards messages from data-in to data-out after a configurable processing delay.
+ * If a credit-out channel is configured, one credit is returned per processed message.
+ */
+
+class FairMQTestSlowWorker : public FairMQDevice
+{
+  public:
+    FairMQTestSlowWorker();
+    virtual ~FairMQTestSlowWorker();
+
+    void SetDelayInMs(int delayInMs) { fDelayInMs = delayInMs; }
+
+  protected:
+    int fDelayInMs;
+
+    virtual void Run();
+};
+
+#endif /* FAIRMQTESTSLOWWORKER_H_ */
@@ -0,0 +1,53 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * FairMQTestTimedPush.cxx
+ *
+ * @since 2016-02-08
+ */
+
+#include <memory> // unique_ptr
+#include <chrono>
+#include <cstring>
+
+#include <boost/thread.hpp>
+
+#include "FairMQTestTimedPush.h"
+#include "FairMQLogger.h"
+
+using namespace std;
+
+FairMQTestTimedPush::FairMQTestTimedPush()
+    : fNumMessages(1000)
+    , fIntervalInUs(1000)
+{
+}
+
+void FairMQTestTimedPush::Run()
+{
+    const FairMQChannel& dataChannel = fChannels.at("data-out").at(0);
+
+    for (int i = 0; i < fNumMessages && CheckCurrentState(RUNNING); ++i)
+    {
+        int64_t now = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+
+        unique_ptr<FairMQMessage> msg(fTransportFactory->CreateMessage(sizeof(int64_t)));
+        memcpy(msg->GetData(), &now, sizeof(int64_t));
+
+        if (dataChannel.Send(msg) < 0)
+        {
+            break;
+        }
+
+        boost::this_thread::sleep(boost::posix_time::microseconds(fIntervalInUs));
+    }
+}
+
+FairMQTestTimedPush::~FairMQTestTimedPush()
+{
+}
@@ -0,0 +1,40 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * FairMQTestTimedPush.h
+ *
+ * @since 2016-02-08
+ */
+
+#ifndef FAIRMQTESTTIMEDPUSH_H_
+#define FAIRMQTESTTIMEDPUSH_H_
+
+#include "FairMQDevice.h"
+
+/**
+ * Sends a fixed number of messages carrying their send time (steady clock, in ns),
+ * used by the LatencySink to measure the end-to-end latency of a topology.
+ */
+
+class FairMQTestTimedPush : public FairMQDevice
+{
+  public:
+    FairMQTestTimedPush();
+    virtual ~FairMQTestTimedPush();
+
+    void SetNumMessages(int numMessages) { fNumMessages = numMessages; }
+    void SetIntervalInUs(int intervalInUs) { fIntervalInUs = intervalInUs; }
+
+  protected:
+    int fNumMessages;
+    int fIntervalInUs;
+
+    virtual void Run();
+};
+
+#endif /* FAIRMQTESTTIMEDPUSH_H_ */
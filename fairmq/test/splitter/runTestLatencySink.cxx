@@ -0,0 +1,58 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * runTestLatencySink.cxx
+ *
+ * @since 2016-02-08
+ */
+
+#include "FairMQLogger.h"
+#include "FairMQTestLatencySink.h"
+
+#ifdef NANOMSG
+#include "FairMQTransportFactoryNN.h"
+#else
+#include "FairMQTransportFactoryZMQ.h"
+#endif
+
+int main(int argc, char** argv)
+{
+    FairMQTestLatencySink testSink;
+    testSink.CatchSignals();
+
+#ifdef NANOMSG
+    testSink.SetTransport(new FairMQTransportFactoryNN());
+#else
+    testSink.SetTransport(new FairMQTransportFactoryZMQ());
+#endif
+
+    testSink.SetProperty(FairMQTestLatencySink::Id, "testLatencySink");
+    testSink.SetNumMessages(1000);
+
+    FairMQChannel pullChannel("pull", "bind", "tcp://127.0.0.1:5575");
+    testSink.fChannels["data-in"].push_back(pullChannel);
+
+    testSink.ChangeState("INIT_DEVICE");
+    testSink.WaitForEndOfState("INIT_DEVICE");
+
+    testSink.ChangeState("INIT_TASK");
+    testSink.WaitForEndOfState("INIT_TASK");
+
+    testSink.ChangeState("RUN");
+    testSink.WaitForEndOfState("RUN");
+
+    testSink.ChangeState("RESET_TASK");
+    testSink.WaitForEndOfState("RESET_TASK");
+
+    testSink.ChangeState("RESET_DEVICE");
+    testSink.WaitForEndOfState("RESET_DEVICE");
+
+    testSink.ChangeState("END");
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * runTestSlowWorker.cxx
+ *
+ * @since 2016-02-08
+ */
+
+#include <cstdlib>
+#include <string>
+
+#include "FairMQLogger.h"
+#include "FairMQTestSlowWorker.h"
+
+#ifdef NANOMSG
+#include "FairMQTransportFactoryNN.h"
+#else
+#include "FairMQTransportFactoryZMQ.h"
+#endif
+
+using namespace std;
+
+// usage: test-fairmq-slow-worker <index> <delay in ms> <return credits (0/1)>
+int main(int argc, char** argv)
+{
+    if (argc < 4)
+    {
+        LOG(ERROR) << "usage: " << argv[0] << " <index> <delay in ms> <return credits (0/1)>";
+        return 1;
+    }
+
+    int index = atoi(argv[1]);
+    int delayInMs = atoi(argv[2]);
+    bool credits = atoi(argv[3]) != 0;
+
+    FairMQTestSlowWorker testWorker;
+    testWorker.CatchSignals();
+
+#ifdef NANOMSG
+    testWorker.SetTransport(new FairMQTransportFactoryNN());
+#else
+    testWorker.SetTransport(new FairMQTransportFactoryZMQ());
+#endif
+
+    testWorker.SetProperty(FairMQTestSlowWorker::Id, "testSlowWorker" + to_string(index));
+    testWorker.SetDelayInMs(delayInMs);
+
+    FairMQChannel pullChannel("pull", "connect", "tcp://127.0.0.1:" + to_string(5571 + index));
+    testWorker.fChannels["data-in"].push_back(pullChannel);
+
+    FairMQChannel pushChannel("push", "connect", "tcp://127.0.0.1:5575");
+    testWorker.fChannels["data-out"].push_back(pushChannel);
+
+    if (credits)
+    {
+        FairMQChannel creditChannel("push", "connect", "tcp://127.0.0.1:" + to_string(5581 + index));
+        testWorker.fChannels["credit-out"].push_back(creditChannel);
+    }
+
+    testWorker.ChangeState("INIT_DEVICE");
+    testWorker.WaitForEndOfState("INIT_DEVICE");
+
+    testWorker.ChangeState("INIT_TASK");
+    testWorker.WaitForEndOfState("INIT_TASK");
+
+    testWorker.ChangeState("RUN");
+    testWorker.WaitForEndOfState("RUN");
+
+    testWorker.ChangeState("RESET_TASK");
+    testWorker.WaitForEndOfState("RESET_TASK");
+
+    testWorker.ChangeState("RESET_DEVICE");
+    testWorker.WaitForEndOfState("RESET_DEVICE");
+
+    testWorker.ChangeState("END");
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * runTestSplitter.cxx
+ *
+ * @since 2016-02-08
+ */
+
+#include <string>
+
+#include "FairMQLogger.h"
+#include "FairMQSplitter.h"
+
+#ifdef NANOMSG
+#include "FairMQTransportFactoryNN.h"
+#else
+#include "FairMQTransportFactoryZMQ.h"
+#endif
+
+using namespace std;
+
+// usage: test-fairmq-splitter <routing mode> <number of outputs>
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        LOG(ERROR) << "usage: " << argv[0] << " <round-robin/next-ready/credit> <number of outputs>";
+        return 1;
+    }
+
+    string routingMode(argv[1]);
+    int numOutputs = stoi(argv[2]);
+
+    FairMQSplitter testSplitter;
+    testSplitter.CatchSignals();
+
+#ifdef NANOMSG
+    testSplitter.SetTransport(new FairMQTransportFactoryNN());
+#else
+    testSplitter.SetTransport(new FairMQTransportFactoryZMQ());
+#endif
+
+    testSplitter.SetProperty(FairMQSplitter::Id, "testSplitter");
+    testSplitter.SetProperty(FairMQSplitter::RoutingMode, routingMode);
+    testSplitter.SetProperty(FairMQSplitter::InitialCredits, 2);
+
+    FairMQChannel pullChannel("pull", "connect", "tcp://127.0.0.1:5570");
+    testSplitter.fChannels["data-in"].push_back(pullChannel);
+
+    for (int i = 0; i < numOutputs; ++i)
+    {
+        // keep the output queues short, so that a slow worker is not hidden behind buffering
+        FairMQChannel pushChannel("push", "bind", "tcp://127.0.0.1:" + to_string(5571 + i));
+        pushChannel.UpdateSndBufSize(2);
+        pushChannel.UpdateRcvBufSize(2);
+        testSplitter.fChannels["data-out"].push_back(pushChannel);
+
+        if (routingMode == "credit")
+        {
+            FairMQChannel creditChannel("pull", "bind", "tcp://127.0.0.1:" + to_string(5581 + i));
+            testSplitter.fChannels["credit-in"].push_back(creditChannel);
+        }
+    }
+
+    testSplitter.ChangeState("INIT_DEVICE");
+    testSplitter.WaitForEndOfState("INIT_DEVICE");
+
+    testSplitter.ChangeState("INIT_TASK");
+    testSplitter.WaitForEndOfState("INIT_TASK");
+
+    testSplitter.ChangeState("RUN");
+    testSplitter.WaitForEndOfState("RUN");
+
+    testSplitter.ChangeState("RESET_TASK");
+    testSplitter.WaitForEndOfState("RESET_TASK");
+
+    testSplitter.ChangeState("RESET_DEVICE");
+    testSplitter.WaitForEndOfState("RESET_DEVICE");
+
+    testSplitter.ChangeState("END");
+
+    return 0;
+}
@@ -0,0 +1,59 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+/**
+ * runTestTimedPush.cxx
+ *
+ * @since 2016-02-08
+ */
+
+#include "FairMQLogger.h"
+#include "FairMQTestTimedPush.h"
+
+#ifdef NANOMSG
+#include "FairMQTransportFactoryNN.h"
+#else
+#include "FairMQTransportFactoryZMQ.h"
+#endif
+
+int main(int argc, char** argv)
+{
+    FairMQTestTimedPush testPush;
+    testPush.CatchSignals();
+
+#ifdef NANOMSG
+    testPush.SetTransport(new FairMQTransportFactoryNN());
+#else
+    testPush.SetTransport(new FairMQTransportFactoryZMQ());
+#endif
+
+    testPush.SetProperty(FairMQTestTimedPush::Id, "testTimedPush");
+    testPush.SetNumMessages(1000);
+    testPush.SetIntervalInUs(1000);
+
+    FairMQChannel pushChannel("push", "bind", "tcp://127.0.0.1:5570");
+    testPush.fChannels["data-out"].push_back(pushChannel);
+
+    testPush.ChangeState("INIT_DEVICE");
+    testPush.WaitForEndOfState("INIT_DEVICE");
+
+    testPush.ChangeState("INIT_TASK");
+    testPush.WaitForEndOfState("INIT_TASK");
+
+    testPush.ChangeState("RUN");
+    testPush.WaitForEndOfState("RUN");
+
+    testPush.ChangeState("RESET_TASK");
+    testPush.WaitForEndOfState("RESET_TASK");
+
+    testPush.ChangeState("RESET_DEVICE");
+    testPush.WaitForEndOfState("RESET_DEVICE");
+
+    testPush.ChangeState("END");
+
+    return 0;
+}
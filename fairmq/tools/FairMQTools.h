@@ -14,8 +14,11 @@
 #include <map>
 #include <string>
 #include <iostream>
+#include <functional>
 #include <type_traits>
 
+class FairMQMessage;
+
 using namespace std;
 
 namespace FairMQ
@@ -109,6 +112,25 @@ struct has_BindGetCurrentIndex
     >:true_type {};
 
 
+// test, at compile time, whether T has BindCreateMessage member function with returned type R and argument ...Args type
+template<class T, class Sig, class=void>
+struct has_BindCreateMessage : false_type {};
+
+template<class T, class R, class... Args>
+struct has_BindCreateMessage
+    <T, R(Args...), typename enable_if<
+        is_convertible<decltype(declval<T>().BindCreateMessage(declval<Args>()...)), R>::value || is_same<R, void>::value>::type
+    >:true_type {};
+
+// test, at compile time, whether T has GetReadyMessage member function with returned type R and argument ...Args type
+template<class T, class Sig, class=void>
+struct has_GetReadyMessage : false_type {};
+
+template<class T, class R, class... Args>
+struct has_GetReadyMessage
+    <T, R(Args...), typename enable_if<
+        is_convertible<decltype(declval<T>().GetReadyMessage(declval<Args>()...)), R>::value || is_same<R, void>::value>::type
+    >:true_type {};
 
 } // end namespace details
 
@@ -125,6 +147,12 @@ using has_GetHeader = integral_constant<bool, details::has_GetHeader<T, Sig>::va
 template<class T, class Sig>
 using has_BindGetCurrentIndex = integral_constant<bool, details::has_BindGetCurrentIndex<T, Sig>::value>;
 
+template<class T, class Sig>
+using has_BindCreateMessage = integral_constant<bool, details::has_BindCreateMessage<T, Sig>::value>;
+
+template<class T, class Sig>
+using has_GetReadyMessage = integral_constant<bool, details::has_GetReadyMessage<T, Sig>::value>;
+
 // enable_if Alias template
 template<typename T>
 using enable_if_has_BindSendHeader = typename enable_if<has_BindSendHeader<T, void(int)>::value, int>::type;
@@ -146,6 +174,16 @@ using enable_if_has_GetHeader = typename enable_if<has_GetHeader<T, int()>::valu
 template<typename T>
 using enable_if_hasNot_GetHeader = typename enable_if<!has_GetHeader<T, int()>::value, int>::type;
 
+template<typename T>
+using enable_if_has_BindCreateMessage = typename enable_if<has_BindCreateMessage<T, void(std::function<FairMQMessage*()>)>::value, int>::type;
+template<typename T>
+using enable_if_hasNot_BindCreateMessage = typename enable_if<!has_BindCreateMessage<T, void(std::function<FairMQMessage*()>)>::value, int>::type;
+
+template<typename T>
+using enable_if_has_GetReadyMessage = typename enable_if<has_GetReadyMessage<T, FairMQMessage*(int&)>::value, int>::type;
+template<typename T>
+using enable_if_hasNot_GetReadyMessage = typename enable_if<!has_GetReadyMessage<T, FairMQMessage*(int&)>::value, int>::type;
+
 } // namespace tools
 } // namespace FairMQ
 
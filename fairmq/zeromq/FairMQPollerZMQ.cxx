@@ -231,6 +231,25 @@ bool FairMQPollerZMQ::CheckOutput(const string channelKey, const int index)
     }
 }
 
+int FairMQPollerZMQ::GetHandle(const string channelKey, const int index)
+{
+    try
+    {
+        return fOffsetMap.at(channelKey) + index;
+    }
+    catch (const std::out_of_range& oor)
+    {
+        LOG(ERROR) << "Invalid channel key: \"" << channelKey << "\"";
+        LOG(ERROR) << "Out of Range error: " << oor.what() << '\n';
+        exit(EXIT_FAILURE);
+    }
+}
+
+int FairMQPollerZMQ::GetNumItems() const
+{
+    return fNumItems;
+}
+
 FairMQPollerZMQ::~FairMQPollerZMQ()
 {
     if (items != NULL)
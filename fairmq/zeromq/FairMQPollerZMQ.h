@@ -40,6 +40,9 @@ class FairMQPollerZMQ : public FairMQPoller
     virtual bool CheckInput(const std::string channelKey, const int index);
     virtual bool CheckOutput(const std::string channelKey, const int index);
 
+    virtual int GetHandle(const std::string channelKey, const int index);
+    virtual int GetNumItems() const;
+
     virtual ~FairMQPollerZMQ();
 
   private:
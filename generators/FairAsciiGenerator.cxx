@@ -11,6 +11,7 @@
 // -------------------------------------------------------------------------
 #include "FairAsciiGenerator.h"
 
+#include "FairBufferedInput.h"          // for FairBufferedInput
 #include "FairPrimaryGenerator.h"       // for FairPrimaryGenerator
 #include "FairLogger.h"
 
@@ -36,8 +37,8 @@ FairAsciiGenerator::FairAsciiGenerator(const char* fileName)
   //  fFileName  = fileName;
   LOG(INFO) << "FairAsciiGenerator: Opening input file " 
 	    << fileName << FairLogger::endl;
-  fInputFile = new std::ifstream(fFileName);
-  if ( ! fInputFile->is_open() ) {
+  fInputFile = new FairBufferedInput(fFileName, "ascii");
+  if ( ! fInputFile->IsOpen() ) {
     LOG(FATAL) << "Cannot open input file." << FairLogger::endl;
   }
 
@@ -61,7 +62,7 @@ Bool_t FairAsciiGenerator::ReadEvent(FairPrimaryGenerator* primGen)
 {
 
   // Check for input file
-  if ( ! fInputFile->is_open() ) {
+  if ( ! fInputFile || ! fInputFile->IsOpen() ) {
     LOG(ERROR) << "FairAsciiGenerator: Input file not open!" 
 	       << FairLogger::endl;
     return kFALSE;
@@ -77,13 +78,7 @@ Bool_t FairAsciiGenerator::ReadEvent(FairPrimaryGenerator* primGen)
   Double_t px = 0., py = 0., pz = 0.;
 
   // Read event header line from input file
-  *fInputFile >> ntracks >> eventID >>  vx >>  vy >>  vz;
-
-  // If end of input file is reached : close it and abort run
-  if ( fInputFile->eof() ) {
-    LOG(INFO) << "FairAsciiGenerator: End of input file reached " 
-	      << FairLogger::endl;
-    CloseInput();
+  if ( ! ReadHeader(ntracks, eventID, vx, vy, vz) ) {
     return kFALSE;
   }
 
@@ -95,7 +90,10 @@ Bool_t FairAsciiGenerator::ReadEvent(FairPrimaryGenerator* primGen)
   for (Int_t itrack=0; itrack<ntracks; itrack++) {
 
     // Read PID and momentum from file
-    *fInputFile >> pdgID >> px >> py >> pz;
+    fInputFile->ReadInt(pdgID);
+    fInputFile->ReadDouble(px);
+    fInputFile->ReadDouble(py);
+    fInputFile->ReadDouble(pz);
     // convert Geant3 code to PDG code
 
     // Int_t pdg= fPDG->ConvertGeant3ToPdg(pdgID);
@@ -112,14 +110,81 @@ Bool_t FairAsciiGenerator::ReadEvent(FairPrimaryGenerator* primGen)
 
 
 
+// -----   Public method SkipEvents   -------------------------------------
+Bool_t FairAsciiGenerator::SkipEvents(Int_t count)
+{
+  if (count<=0) { return kTRUE; }
+
+  if ( ! fInputFile || ! fInputFile->IsOpen() ) {
+    LOG(ERROR) << "FairAsciiGenerator: Input file not open!"
+	       << FairLogger::endl;
+    return kFALSE;
+  }
+
+  // Go directly to the event if an earlier job has seen it, else
+  // to the last known event and read the remaining headers
+  Int_t target = fInputFile->GetEventNumber() + count;
+  if ( fInputFile->SeekEvent(target) ) {
+    LOG(INFO) << "FairAsciiGenerator: Skipped " << count
+	      << " events using the event index" << FairLogger::endl;
+    return kTRUE;
+  }
+  if ( fInputFile->GetNIndexed() > fInputFile->GetEventNumber() ) {
+    fInputFile->SeekEvent(fInputFile->GetNIndexed() - 1);
+  }
+
+  Int_t ntracks = 0, eventID = 0;
+  Double_t vx = 0., vy = 0., vz = 0.;
+  while ( fInputFile->GetEventNumber() < target ) {
+    if ( ! ReadHeader(ntracks, eventID, vx, vy, vz) ) {
+      return kFALSE;
+    }
+    for (Int_t iword=0; iword<4*ntracks; iword++) { fInputFile->SkipWord(); }
+  }
+  LOG(INFO) << "FairAsciiGenerator: Skipped " << count << " events"
+	    << FairLogger::endl;
+
+  return kTRUE;
+}
+// ------------------------------------------------------------------------
+
+
+
+// -----   Private method ReadHeader   ------------------------------------
+Bool_t FairAsciiGenerator::ReadHeader(Int_t& ntracks, Int_t& eventID,
+				      Double_t& vx, Double_t& vy, Double_t& vz)
+{
+  // The event starts at its first number
+  Bool_t found = fInputFile->SkipSpace();
+  Long64_t offset = fInputFile->Tell();
+
+  found = found
+	  && fInputFile->ReadInt(ntracks) && fInputFile->ReadInt(eventID)
+	  && fInputFile->ReadDouble(vx) && fInputFile->ReadDouble(vy)
+	  && fInputFile->ReadDouble(vz);
+
+  // If end of input file is reached : close it and abort run
+  if ( ! found ) {
+    LOG(INFO) << "FairAsciiGenerator: End of input file reached " 
+	      << FairLogger::endl;
+    CloseInput();
+    return kFALSE;
+  }
+
+  fInputFile->IndexEvent(offset);
+  return kTRUE;
+}
+// ------------------------------------------------------------------------
+
+
+
 // -----   Private method CloseInput   ------------------------------------
 void FairAsciiGenerator::CloseInput()
 {
   if ( fInputFile ) {
-    if ( fInputFile->is_open() ) {
+    if ( fInputFile->IsOpen() ) {
       LOG(INFO) << "FairAsciiGenerator: Closing input file "
 		<< fFileName << FairLogger::endl;
-      fInputFile->close();
     }
     delete fInputFile;
     fInputFile = NULL;
@@ -22,6 +22,8 @@
  followed by NTRACKS lines of the format G3PID, PX, PY, PZ, where
  G3PID is the GEANT3 particle code, and PX, PY, PZ the cartesian
  momentum coordinates in GeV.
+ The file is read through a FairBufferedInput, which keeps an index of the
+ events next to the input file for SkipEvents.
  Derived from FairGenerator.
 **/
 
@@ -31,11 +33,9 @@
 
 #include "FairGenerator.h"              // for FairGenerator
 
-#include "Riosfwd.h"                    // for ifstream
 #include "Rtypes.h"                     // for FairAsciiGenerator::Class, etc
 
-#include <fstream>                      // for ifstream
-
+class FairBufferedInput;
 class FairPrimaryGenerator;
 
 class FairAsciiGenerator : public FairGenerator
@@ -63,13 +63,22 @@ class FairAsciiGenerator : public FairGenerator
      **/
     virtual Bool_t ReadEvent(FairPrimaryGenerator* primGen);
 
+    /** The generator draws no random numbers (see FairGenerator::UsesGlobalRandom) **/
+    virtual Bool_t UsesGlobalRandom() const { return kFALSE; }
+
+    /** Skip defined number of events in file **/
+    Bool_t SkipEvents(Int_t count);
 
 
   private:
 
-    std::ifstream* fInputFile;               //! Input file stream
+    FairBufferedInput* fInputFile;      //! Input file
     const Char_t* fFileName;            //! Input file Name
 
+    /** Private method ReadHeader. Reads the event header line and adds
+     ** the event to the index, closes the input at the end of the file. **/
+    Bool_t ReadHeader(Int_t& ntracks, Int_t& eventID,
+                      Double_t& vx, Double_t& vy, Double_t& vz);
 
     /** Private method CloseInput. Just for convenience. Closes the
      ** input file properly. Called from destructor and from ReadEvent. **/
@@ -82,7 +91,7 @@ class FairAsciiGenerator : public FairGenerator
 
 //  TDatabasePDG *fPDG; //!
 
-    ClassDef(FairAsciiGenerator,1);
+    ClassDef(FairAsciiGenerator,2);
 
 };
 
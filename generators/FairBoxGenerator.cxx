@@ -181,23 +181,23 @@ Bool_t FairBoxGenerator::ReadEvent(FairPrimaryGenerator* primGen)
 
   // Generate particles
   for (Int_t k = 0; k < fMult; k++) {
-    phi = gRandom->Uniform(fPhiMin,fPhiMax) * TMath::DegToRad();
+    phi = GetRandom()->Uniform(fPhiMin,fPhiMax) * TMath::DegToRad();
 
-    if      (fPRangeIsSet ) { pabs = gRandom->Uniform(fPMin,fPMax); }
-    else if (fPtRangeIsSet) { pt   = gRandom->Uniform(fPtMin,fPtMax); }
+    if      (fPRangeIsSet ) { pabs = GetRandom()->Uniform(fPMin,fPMax); }
+    else if (fPtRangeIsSet) { pt   = GetRandom()->Uniform(fPtMin,fPtMax); }
 
     if      (fThetaRangeIsSet) {
       if (fCosThetaIsSet)
-        theta = acos(gRandom->Uniform(cos(fThetaMin* TMath::DegToRad()),
+        theta = acos(GetRandom()->Uniform(cos(fThetaMin* TMath::DegToRad()),
                                       cos(fThetaMax* TMath::DegToRad())));
       else {
-        theta = gRandom->Uniform(fThetaMin,fThetaMax) * TMath::DegToRad();
+        theta = GetRandom()->Uniform(fThetaMin,fThetaMax) * TMath::DegToRad();
       }
     } else if (fEtaRangeIsSet) {
-      eta   = gRandom->Uniform(fEtaMin,fEtaMax);
+      eta   = GetRandom()->Uniform(fEtaMin,fEtaMax);
       theta = 2*TMath::ATan(TMath::Exp(-eta));
     } else if (fYRangeIsSet) {
-      y     = gRandom->Uniform(fYMin,fYMax);
+      y     = GetRandom()->Uniform(fYMin,fYMax);
       mt = TMath::Sqrt(fPDGMass*fPDGMass + pt*pt);
       pz = mt * TMath::SinH(y);
     }
@@ -215,8 +215,8 @@ Bool_t FairBoxGenerator::ReadEvent(FairPrimaryGenerator* primGen)
     py = pt*TMath::Sin(phi);
 
     if (fBoxVtxIsSet) {
-      fX = gRandom->Uniform(fX1,fX2);
-      fY = gRandom->Uniform(fY1,fY2);
+      fX = GetRandom()->Uniform(fX1,fX2);
+      fY = GetRandom()->Uniform(fY1,fY2);
     }
 
     if (fDebug)
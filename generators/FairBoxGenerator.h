@@ -108,6 +108,9 @@ class FairBoxGenerator : public FairGenerator
      **/
     virtual Bool_t ReadEvent(FairPrimaryGenerator* primGen);
 
+    /** The generator draws only from GetRandom() (see FairGenerator::UsesGlobalRandom) **/
+    virtual Bool_t UsesGlobalRandom() const { return kFALSE; }
+
     /** Clone this object (used in MT mode only) */
     virtual FairGenerator* CloneGenerator() const;
 
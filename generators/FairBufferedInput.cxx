@@ -0,0 +1,471 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+// -------------------------------------------------------------------------
+// -----                FairBufferedInput source file                  -----
+// -------------------------------------------------------------------------
+#include "FairBufferedInput.h"
+
+#include "FairLogger.h"                 // for logging
+
+#include "TMath.h"                      // for Min
+#include "TSystem.h"                    // for TSystem, gSystem, FileStat_t
+
+#include <math.h>                       // for nextafterf, HUGE_VALF
+#include <stdlib.h>                     // for strtod, strtof
+#include <string.h>                     // for memchr, memcpy, memmove, etc
+#include <sys/types.h>                  // for off_t
+
+namespace
+{
+// size of the read buffer
+const Int_t kBufSize = 1 << 20;
+
+// numbers are parsed once this many characters are in the buffer
+const Int_t kMaxWord = 128;
+
+// tag at the start of the index files
+const char kIndexMagic[8] = { 'F', 'A', 'I', 'R', 'I', 'D', 'X', '1' };
+const Int_t kFormatSize = 16;
+
+// powers of ten which are exact doubles
+const Double_t kPow10[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+inline Bool_t IsSpace(char c)
+{
+  return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline Bool_t IsDigit(char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+/** Decimal number with at most 19 significant digits whose mantissa is
+ ** exact in a double and which needs one multiplication or division by an
+ ** exact power of ten. The result is then correctly rounded, the same as
+ ** from strtod. Returns false for all other numbers, which are left to
+ ** the C library. */
+Bool_t ParseDecimal(const char* p, const char*& end, Double_t& value)
+{
+  Bool_t negative = kFALSE;
+  if (*p == '+' || *p == '-') {
+    negative = (*p == '-');
+    p++;
+  }
+
+  ULong64_t mantissa = 0;
+  Int_t nDigits = 0;
+  Int_t exponent = 0;
+  Bool_t found = kFALSE;
+  for (; IsDigit(*p); p++) {
+    found = kTRUE;
+    if (mantissa == 0 && *p == '0') { continue; }
+    if (nDigits == 19) { return kFALSE; }
+    mantissa = 10 * mantissa + (*p - '0');
+    nDigits++;
+  }
+  if (*p == '.') {
+    for (p++; IsDigit(*p); p++) {
+      found = kTRUE;
+      exponent--;
+      if (mantissa == 0 && *p == '0') { continue; }
+      if (nDigits == 19) { return kFALSE; }
+      mantissa = 10 * mantissa + (*p - '0');
+      nDigits++;
+    }
+  }
+  if (!found) { return kFALSE; }
+
+  if (*p == 'e' || *p == 'E') {
+    const char* q = p + 1;
+    Bool_t negativeExp = kFALSE;
+    if (*q == '+' || *q == '-') {
+      negativeExp = (*q == '-');
+      q++;
+    }
+    if (!IsDigit(*q)) { return kFALSE; }
+    Int_t e = 0;
+    for (; IsDigit(*q); q++) {
+      if (e < 10000) { e = 10 * e + (*q - '0'); }
+    }
+    exponent += negativeExp ? -e : e;
+    p = q;
+  }
+  // anything which does not end like a plain number goes to strtod
+  if (!IsSpace(*p) && *p != '\0') { return kFALSE; }
+
+  if (mantissa == 0) {
+    value = negative ? -0. : 0.;
+  } else {
+    if (mantissa > (static_cast<ULong64_t>(1) << 53) || exponent < -22 || exponent > 22) {
+      return kFALSE;
+    }
+    value = static_cast<Double_t>(mantissa);
+    value = exponent < 0 ? value / kPow10[-exponent] : value * kPow10[exponent];
+    if (negative) { value = -value; }
+  }
+  end = p;
+  return kTRUE;
+}
+
+/** The correctly rounded double of a number gives the correctly rounded
+ ** float, unless it lies exactly half way between two floats. */
+Bool_t IsFloatTie(Double_t value)
+{
+  Float_t f = static_cast<Float_t>(value);
+  if (static_cast<Double_t>(f) == value) { return kFALSE; }
+  Float_t g = nextafterf(f, value > f ? HUGE_VALF : -HUGE_VALF);
+  return 0.5 * (static_cast<Double_t>(f) + static_cast<Double_t>(g)) == value;
+}
+}
+
+// -----   Constructor   --------------------------------------------------
+FairBufferedInput::FairBufferedInput(const char* fileName, const char* format)
+  : fFile(NULL),
+    fFileName(fileName),
+    fFileSize(0),
+    fFileTime(0),
+    fFormat(format),
+    fBuf(new char[kBufSize+1]),
+    fPos(0),
+    fEnd(0),
+    fBufStart(0),
+    fEof(kFALSE),
+    fFileEnd(kFALSE),
+    fEvent(0),
+    fOffsets(),
+    fIndexChanged(kFALSE)
+{
+  fBuf[0] = '\0';
+  fFile = fopen(fileName, "rb");
+  if ( ! fFile ) { return; }
+  // all reading is done through the own buffer
+  setvbuf(fFile, NULL, _IONBF, 0);
+
+  FileStat_t stat;
+  if (gSystem->GetPathInfo(fileName, stat) == 0) {
+    fFileSize = stat.fSize;
+    fFileTime = stat.fMtime;
+    ReadIndex();
+  }
+}
+// ------------------------------------------------------------------------
+
+
+
+// -----   Destructor   ---------------------------------------------------
+FairBufferedInput::~FairBufferedInput()
+{
+  if ( fFile ) {
+    fclose(fFile);
+    fFile = NULL;
+    WriteIndex();
+  }
+  delete [] fBuf;
+}
+// ------------------------------------------------------------------------
+
+
+
+// -----   Private method Fill   ------------------------------------------
+Int_t FairBufferedInput::Fill(Int_t n)
+{
+  Int_t available = fEnd - fPos;
+  if (available >= n || fFileEnd || !fFile) { return available; }
+
+  // keep the characters not yet used at the start of the buffer
+  if (fPos > 0) {
+    memmove(fBuf, fBuf + fPos, available);
+    fBufStart += fPos;
+    fPos = 0;
+    fEnd = available;
+  }
+  while (fEnd < n) {
+    size_t nRead = fread(fBuf + fEnd, 1, kBufSize - fEnd, fFile);
+    fEnd += static_cast<Int_t>(nRead);
+    if (nRead == 0) {
+      fFileEnd = kTRUE;
+      break;
+    }
+  }
+  fBuf[fEnd] = '\0';
+  return fEnd - fPos;
+}
+// ------------------------------------------------------------------------
+
+
+
+// -----   Public method SkipSpace   --------------------------------------
+Bool_t FairBufferedInput::SkipSpace()
+{
+  for (;;) {
+    while (fPos < fEnd && IsSpace(fBuf[fPos])) { fPos++; }
+    if (fPos < fEnd) { return kTRUE; }
+    if (Fill(1) == 0) {
+      fEof = kTRUE;
+      return kFALSE;
+    }
+  }
+}
+// ------------------------------------------------------------------------
+
+
+
+// -----   Public method ReadInt   ----------------------------------------
+Bool_t FairBufferedInput::ReadInt(Int_t& value)
+{
+  if ( ! SkipSpace() ) { return kFALSE; }
+  Fill(kMaxWord);
+
+  const char* p = fBuf + fPos;
+  Bool_t negative = kFALSE;
+  if (*p == '+' || *p == '-') {
+    negative = (*p == '-');
+    p++;
+  }
+  if ( ! IsDigit(*p) ) { return kFALSE; }
+  Long64_t number = 0;
+  for (; IsDigit(*p); p++) { number = 10 * number + (*p - '0'); }
+  value = static_cast<Int_t>(negative ? -number : number);
+
+  fPos = static_cast<Int_t>(p - fBuf);
+  if (fPos == fEnd && Fill(1) == 0) { fEof = kTRUE; }
+  return kTRUE;
+}
+// ------------------------------------------------------------------------
+
+
+
+// -----   Public method ReadFloat   --------------------------------------
+Bool_t FairBufferedInput::ReadFloat(Float_t& value)
+{
+  if ( ! SkipSpace() ) { return kFALSE; }
+  Fill(kMaxWord);
+
+  const char* start = fBuf + fPos;
+  const char* end = start;
+  Double_t number = 0.;
+  if (ParseDecimal(start, end, number) && !IsFloatTie(number)) {
+    value = static_cast<Float_t>(number);
+  } else {
+    char* stop = NULL;
+    Float_t result = strtof(start, &stop);
+    if (stop == start) { return kFALSE; }
+    value = result;
+    end = stop;
+  }
+
+  fPos = static_cast<Int_t>(end - fBuf);
+  if (fPos == fEnd && Fill(1) == 0) { fEof = kTRUE; }
+  return kTRUE;
+}
+// ------------------------------------------------------------------------
+
+
+
+// -----   Public method ReadDouble   -------------------------------------
+Bool_t FairBufferedInput::ReadDouble(Double_t& value)
+{
+  if ( ! SkipSpace() ) { return kFALSE; }
+  Fill(kMaxWord);
+
+  const char* start = fBuf + fPos;
+  const char* end = start;
+  Double_t number = 0.;
+  if (ParseDecimal(start, end, number)) {
+    value = number;
+  } else {
+    char* stop = NULL;
+    Double_t result = strtod(start, &stop);
+    if (stop == start) { return kFALSE; }
+    value = result;
+    end = stop;
+  }
+
+  fPos = static_cast<Int_t>(end - fBuf);
+  if (fPos == fEnd && Fill(1) == 0) { fEof = kTRUE; }
+  return kTRUE;
+}
+// ------------------------------------------------------------------------
+
+
+
+// -----   Public method SkipWord   ---------------------------------------
+Bool_t FairBufferedInput::SkipWord()
+{
+  if ( ! SkipSpace() ) { return kFALSE; }
+  for (;;) {
+    while (fPos < fEnd && !IsSpace(fBuf[fPos])) { fPos++; }
+    if (fPos < fEnd) { return kTRUE; }
+    if (Fill(1) == 0) {
+      fEof = kTRUE;
+      return kTRUE;
+    }
+  }
+}
+// ------------------------------------------------------------------------
+
+
+
+// -----   Public method Gets   -------------------------------------------
+Bool_t FairBufferedInput::Gets(char* buf, Int_t size)
+{
+  Int_t n = 0;
+  while (n < size - 1) {
+    if (fPos == fEnd && Fill(1) == 0) {
+      fEof = kTRUE;
+      break;
+    }
+    Int_t chunk = TMath::Min(size - 1 - n, fEnd - fPos);
+    const char* start = fBuf + fPos;
+    const char* newline = static_cast<const char*>(memchr(start, '\n', chunk));
+    Int_t length = newline ? static_cast<Int_t>(newline - start) + 1 : chunk;
+    if (buf) { memcpy(buf + n, start, length); }
+    n += length;
+    fPos += length;
+    if (newline) { break; }
+  }
+  if (buf && size > 0) { buf[n] = '\0'; }
+  return n > 0;
+}
+// ------------------------------------------------------------------------
+
+
+
+// -----   Public method IndexEvent   -------------------------------------
+void FairBufferedInput::IndexEvent(Long64_t offset)
+{
+  Int_t nIndexed = GetNIndexed();
+  if (fEvent < nIndexed && fOffsets[fEvent] != offset) {
+    // the stored index does not fit to the file, it is rebuilt from here
+    LOG(WARNING) << "FairBufferedInput: Event index of " << fFileName
+                 << " does not match the file at event " << fEvent << FairLogger::endl;
+    fOffsets.resize(fEvent);
+    nIndexed = fEvent;
+    fIndexChanged = kTRUE;
+  }
+  if (fEvent == nIndexed) {
+    fOffsets.push_back(offset);
+    fIndexChanged = kTRUE;
+  }
+  fEvent++;
+}
+// ------------------------------------------------------------------------
+
+
+
+// -----   Public method SeekEvent   --------------------------------------
+Bool_t FairBufferedInput::SeekEvent(Int_t event)
+{
+  if ( ! fFile || event < 0 || event >= GetNIndexed() ) { return kFALSE; }
+  Seek(fOffsets[event]);
+  fEvent = event;
+  return kTRUE;
+}
+// ------------------------------------------------------------------------
+
+
+
+// -----   Private method Seek   ------------------------------------------
+void FairBufferedInput::Seek(Long64_t offset)
+{
+  fEof = kFALSE;
+  if (offset >= fBufStart && offset <= fBufStart + fEnd) {
+    fPos = static_cast<Int_t>(offset - fBufStart);
+    return;
+  }
+  fseeko(fFile, static_cast<off_t>(offset), SEEK_SET);
+  fBufStart = offset;
+  fPos = 0;
+  fEnd = 0;
+  fFileEnd = kFALSE;
+  fBuf[0] = '\0';
+}
+// ------------------------------------------------------------------------
+
+
+
+// -----   Private method ReadIndex   -------------------------------------
+void FairBufferedInput::ReadIndex()
+{
+  TString indexName = fFileName + ".idx";
+  FILE* index = fopen(indexName.Data(), "rb");
+  if ( ! index ) { return; }
+
+  char magic[sizeof(kIndexMagic)];
+  char format[kFormatSize];
+  Long64_t size = 0, time = 0;
+  Int_t n = 0;
+  Bool_t ok = fread(magic, sizeof(magic), 1, index) == 1
+              && memcmp(magic, kIndexMagic, sizeof(magic)) == 0
+              && fread(format, sizeof(format), 1, index) == 1
+              && strncmp(format, fFormat.Data(), kFormatSize) == 0
+              && fread(&size, sizeof(size), 1, index) == 1
+              && fread(&time, sizeof(time), 1, index) == 1
+              && fread(&n, sizeof(n), 1, index) == 1
+              && size == fFileSize && time == fFileTime && n > 0;
+  if (ok) {
+    fOffsets.resize(n);
+    ok = fread(&fOffsets[0], sizeof(Long64_t), n, index) == static_cast<size_t>(n);
+    for (Int_t i = 0; ok && i < n; i++) {
+      ok = fOffsets[i] >= 0 && fOffsets[i] < fFileSize && (i == 0 || fOffsets[i] > fOffsets[i-1]);
+    }
+    if ( ! ok ) { fOffsets.clear(); }
+  }
+  fclose(index);
+
+  if (ok) {
+    LOG(INFO) << "FairBufferedInput: Event index with " << n << " events read from "
+              << indexName << FairLogger::endl;
+  }
+}
+// ------------------------------------------------------------------------
+
+
+
+// -----   Private method WriteIndex   ------------------------------------
+void FairBufferedInput::WriteIndex()
+{
+  if ( ! fIndexChanged || fOffsets.empty() || fFileSize == 0 ) { return; }
+
+  // written to a temporary file first, jobs reading the same input in
+  // parallel never see a partly written index
+  TString indexName = fFileName + ".idx";
+  TString tmpName = Form("%s.%d.tmp", indexName.Data(), gSystem->GetPid());
+  FILE* index = fopen(tmpName.Data(), "wb");
+  if ( ! index ) {
+    LOG(DEBUG) << "FairBufferedInput: Cannot write event index " << indexName << FairLogger::endl;
+    return;
+  }
+
+  char format[kFormatSize];
+  strncpy(format, fFormat.Data(), kFormatSize);
+  Long64_t time = fFileTime;
+  Int_t n = GetNIndexed();
+  Bool_t ok = fwrite(kIndexMagic, sizeof(kIndexMagic), 1, index) == 1
+              && fwrite(format, sizeof(format), 1, index) == 1
+              && fwrite(&fFileSize, sizeof(fFileSize), 1, index) == 1
+              && fwrite(&time, sizeof(time), 1, index) == 1
+              && fwrite(&n, sizeof(n), 1, index) == 1
+              && fwrite(&fOffsets[0], sizeof(Long64_t), n, index) == static_cast<size_t>(n);
+  ok = (fclose(index) == 0) && ok;
+
+  if (ok) { ok = (gSystem->Rename(tmpName, indexName) == 0); }
+  if (ok) {
+    fIndexChanged = kFALSE;
+    LOG(INFO) << "FairBufferedInput: Event index with " << n << " events written to "
+              << indexName << FairLogger::endl;
+  } else {
+    LOG(DEBUG) << "FairBufferedInput: Cannot write event index " << indexName << FairLogger::endl;
+    gSystem->Unlink(tmpName);
+  }
+}
+// ------------------------------------------------------------------------
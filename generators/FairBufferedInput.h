@@ -0,0 +1,116 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+// -------------------------------------------------------------------------
+// -----                FairBufferedInput header file                  -----
+// -------------------------------------------------------------------------
+
+/** FairBufferedInput.h
+ *
+ Block buffered reading of the text input files of the event generators.
+ The numbers are parsed directly from the buffer with the same results as
+ fscanf and the stream operators, Gets behaves like fgets.
+
+ The positions of the events which have been read are kept in an index,
+ which is stored next to the input file (<fileName>.idx) and reused as long
+ as the size and the modification time of the input file do not change.
+ With the index a job can go to any event already seen by an earlier job
+ without reading the events before it.
+**/
+
+#ifndef FAIRBUFFEREDINPUT_H
+#define FAIRBUFFEREDINPUT_H
+
+#include "Rtypes.h"                     // for Int_t, Long64_t, etc
+#include "TString.h"                    // for TString
+
+#include <stdio.h>                      // for FILE
+#include <vector>                       // for vector
+
+class FairBufferedInput
+{
+  public:
+
+    /** Opens the file and reads an existing event index.
+     ** @param fileName  input file
+     ** @param format    name of the file format, stored in the index
+     **/
+    FairBufferedInput(const char* fileName, const char* format);
+
+    /** Closes the file and writes the index if it has grown. **/
+    ~FairBufferedInput();
+
+    Bool_t IsOpen() const { return fFile != NULL; }
+
+    /** True if a read has run into the end of the file, like feof **/
+    Bool_t IsEof() const { return fEof; }
+
+    /** Skip white space, false if the end of the file is reached **/
+    Bool_t SkipSpace();
+
+    /** Parse the next number after white space. The value is not
+     ** changed if there is no number, like for fscanf. **/
+    Bool_t ReadInt(Int_t& value);
+    Bool_t ReadFloat(Float_t& value);
+    Bool_t ReadDouble(Double_t& value);
+
+    /** Skip the next white space separated word **/
+    Bool_t SkipWord();
+
+    /** Like fgets(buf, size, file), buf can be NULL to only skip the
+     ** characters. Returns false if nothing could be read. **/
+    Bool_t Gets(char* buf, Int_t size);
+
+    /** Position in the file of the next character **/
+    Long64_t Tell() const { return fBufStart + fPos; }
+
+    /** Number of the next event, counted from 0 **/
+    Int_t GetEventNumber() const { return fEvent; }
+
+    /** Number of events in the index **/
+    Int_t GetNIndexed() const { return static_cast<Int_t>(fOffsets.size()); }
+
+    /** Called by the generator when an event was found at the given
+     ** position, adds it to the index if it is not yet there. **/
+    void IndexEvent(Long64_t offset);
+
+    /** Go to the start of an event in the index, false if it is not
+     ** in the index (the position does not change then). **/
+    Bool_t SeekEvent(Int_t event);
+
+  private:
+
+    /** Make at least n characters available in the buffer if the
+     ** file has them, returns the number of available characters **/
+    Int_t Fill(Int_t n);
+
+    /** Move to a position in the file **/
+    void Seek(Long64_t offset);
+
+    void ReadIndex();
+    void WriteIndex();
+
+    FILE* fFile;                  // input file
+    TString fFileName;            // input file name
+    Long64_t fFileSize;           // size of the input file when opened
+    Long_t fFileTime;             // modification time of the input file
+    TString fFormat;              // file format stored in the index
+    char* fBuf;                   // buffer, 0 terminated after fEnd
+    Int_t fPos;                   // next character in the buffer
+    Int_t fEnd;                   // end of the data in the buffer
+    Long64_t fBufStart;           // position of the buffer in the file
+    Bool_t fEof;                  // a read ran into the end of the file
+    Bool_t fFileEnd;              // all of the file was read into the buffer
+    Int_t fEvent;                 // number of the next event
+    std::vector<Long64_t> fOffsets; // positions of the events
+    Bool_t fIndexChanged;         // index differs from the stored one
+
+    FairBufferedInput(const FairBufferedInput&);
+    FairBufferedInput& operator=(const FairBufferedInput&);
+};
+
+#endif
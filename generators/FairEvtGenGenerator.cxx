@@ -137,8 +137,8 @@ Bool_t FairEvtGenGenerator::ReadEvent(FairPrimaryGenerator* primGen)
 
           // Random 2D point in a circle of radius r (simple beamprofile)
           Double_t fX, fY, fZ, radius;
-          radius = gRandom->Gaus(0,fRsigma);
-          gRandom->Circle(fX, fY, radius);
+          radius = GetRandom()->Gaus(0,fRsigma);
+          GetRandom()->Circle(fX, fY, radius);
           fVx = fVx + fX;
           fVy = fVy + fY;
 
@@ -121,6 +121,10 @@ class FairEvtGenGenerator : public FairGenerator
      **/
     virtual Bool_t ReadEvent(FairPrimaryGenerator* primGen);
 
+    /** In gas mode the z of the vertex is sampled by TF1::GetRandom(), which
+     ** draws from gRandom (see FairGenerator::UsesGlobalRandom) **/
+    virtual Bool_t UsesGlobalRandom() const { return fGasmode == 1; }
+
 
 
   private:
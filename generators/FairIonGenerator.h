@@ -80,6 +80,9 @@ class FairIonGenerator : public FairGenerator
      **/
     virtual Bool_t ReadEvent(FairPrimaryGenerator* primGen);
 
+    /** The generator draws no random numbers (see FairGenerator::UsesGlobalRandom) **/
+    virtual Bool_t UsesGlobalRandom() const { return kFALSE; }
+
 
   private:
 
@@ -67,6 +67,9 @@ class FairParticleGenerator : public FairGenerator
      **/
     virtual Bool_t ReadEvent(FairPrimaryGenerator* primGen);
 
+    /** The generator draws no random numbers (see FairGenerator::UsesGlobalRandom) **/
+    virtual Bool_t UsesGlobalRandom() const { return kFALSE; }
+
 
 
   private:
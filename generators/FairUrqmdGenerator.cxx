@@ -11,6 +11,7 @@
 // -------------------------------------------------------------------------
 #include "FairUrqmdGenerator.h"
 
+#include "FairBufferedInput.h"          // for FairBufferedInput
 #include "FairMCEventHeader.h"          // for FairMCEventHeader
 #include "FairPrimaryGenerator.h"       // for FairPrimaryGenerator
 #include "FairLogger.h"                 // for logging
@@ -48,8 +49,8 @@ FairUrqmdGenerator::FairUrqmdGenerator(const char* fileName)
   //  fFileName = fileName;
   LOG(INFO) << "FairUrqmdGenerator: Opening input file " 
 	    << fileName << FairLogger::endl;
-  fInputFile = fopen(fFileName, "r");
-  if ( ! fInputFile ) { 
+  fInputFile = new FairBufferedInput(fFileName, "urqmd");
+  if ( ! fInputFile->IsOpen() ) { 
     LOG(FATAL) << "Cannot open input file."
 	       << FairLogger::endl; 
   }
@@ -65,8 +66,8 @@ fFileName(fileName)
     //  fFileName = fileName;
     LOG(INFO) << "FairUrqmdGenerator: Opening input file "
     << fileName << FairLogger::endl;
-    fInputFile = fopen(fFileName, "r");
-    if ( ! fInputFile ) {
+    fInputFile = new FairBufferedInput(fFileName, "urqmd");
+    if ( ! fInputFile->IsOpen() ) {
         LOG(FATAL) << "Cannot open input file."
 	       << FairLogger::endl;
     }
@@ -82,10 +83,7 @@ FairUrqmdGenerator::~FairUrqmdGenerator()
 {
   //  LOG(DEBUG) << "Enter Destructor of FairUrqmdGenerator"
   //             << FairLogger::endl;
-  if ( fInputFile ) {
-    fclose(fInputFile);
-    fInputFile = NULL;
-  }
+  CloseInput();
   fParticleTable.clear();
   //  LOG(DEBUG) << "Leave Destructor of FairUrqmdGenerator"
   //             << FairLogger::endl;
@@ -99,7 +97,7 @@ Bool_t FairUrqmdGenerator::ReadEvent(FairPrimaryGenerator* primGen)
 {
 
   // ---> Check for input file
-  if ( ! fInputFile ) {
+  if ( ! fInputFile || ! fInputFile->IsOpen() ) {
     LOG(ERROR) << "FairUrqmdGenerator: Input file not open! " 
 	       << FairLogger::endl;
     return kFALSE;
@@ -113,60 +111,14 @@ Bool_t FairUrqmdGenerator::ReadEvent(FairPrimaryGenerator* primGen)
   }
 
   // ---> Define event variables to be read from file
-  int evnr=0, ntracks=0, aProj=0, zProj=0, aTarg=0, zTarg=0;
+  int evnr=0, ntracks=0;
   float b = 0., ekin = 0.;
 
   int ityp=0, i3=0, ichg=0, pid=0;
   float ppx=0., ppy=0., ppz=0., m=0.;
 
-  // ---> Read and check first event header line from input file
-  char read[200];
-  fgets(read, 200, fInputFile);
-  if ( feof(fInputFile) ) {
-    LOG(INFO) << "FairUrqmdGenerator : End of input file reached." 
-	      << FairLogger::endl;
-    fclose(fInputFile);
-    fInputFile = NULL;
-    return kFALSE;
-  }
-  if ( read[0] != 'U' ) {
-    LOG(ERROR) << "FairUrqmdGenerator: Wrong event header" 
-	       << FairLogger::endl;
-    return kFALSE;
-  }
-
-  Int_t retval = 0;
-
-  // ---> Read rest of event header
-  fgets(read, 26, fInputFile);
-  retval = fscanf(fInputFile, "%d", &aProj);
-  CheckReturnValue(retval);
-  retval = fscanf(fInputFile, "%d", &zProj);
-  CheckReturnValue(retval);
-  fgets(read, 25, fInputFile);
-  retval = fscanf(fInputFile, "%d", &aTarg);
-  CheckReturnValue(retval);
-  retval = fscanf(fInputFile, "%d", &zTarg);
-  CheckReturnValue(retval);
-  fgets(read, 200, fInputFile);
-  fgets(read, 200, fInputFile);
-  fgets(read, 36, fInputFile);
-  retval = fscanf(fInputFile, "%f", &b);
-  CheckReturnValue(retval);
-  fgets(read, 200, fInputFile);
-  fgets(read, 39, fInputFile);
-  retval = fscanf(fInputFile, "%e", &ekin);
-  CheckReturnValue(retval);
-  fgets(read, 200, fInputFile);
-  fgets(read, 7, fInputFile);
-  retval = fscanf(fInputFile, "%d", &evnr);
-  CheckReturnValue(retval);
-  fgets(read, 200, fInputFile);
-  for (int iline=0; iline<8; iline++)  { fgets(read, 200,fInputFile); }
-  retval = fscanf(fInputFile, "%d", &ntracks);
-  CheckReturnValue(retval);
-  fgets(read, 200, fInputFile);
-  fgets(read, 200, fInputFile);
+  // ---> Read the event header
+  if ( ! ReadEventHeader(evnr, ntracks, b, ekin) ) { return kFALSE; }
 
   // ---> Calculate beta and gamma for Lorentztransformation
   TDatabasePDG* pdgDB = TDatabasePDG::Instance();
@@ -195,22 +147,15 @@ Bool_t FairUrqmdGenerator::ReadEvent(FairPrimaryGenerator* primGen)
   for(int itrack=0; itrack<ntracks; itrack++) {
 
     // Read momentum and PID from file
-    fgets(read, 81, fInputFile);
-    retval = fscanf(fInputFile, "%e", &ppx);
-    CheckReturnValue(retval);
-    retval = fscanf(fInputFile, "%e", &ppy);
-    CheckReturnValue(retval);
-    retval = fscanf(fInputFile, "%e", &ppz);
-    CheckReturnValue(retval);
-    retval = fscanf(fInputFile, "%e", &m);
-    CheckReturnValue(retval);
-    retval = fscanf(fInputFile, "%d", &ityp);
-    CheckReturnValue(retval);
-    retval = fscanf(fInputFile, "%d", &i3);
-    CheckReturnValue(retval);
-    retval = fscanf(fInputFile, "%d", &ichg);
-    CheckReturnValue(retval);
-    fgets(read, 200, fInputFile);
+    fInputFile->Gets(NULL, 81);
+    CheckReturnValue(fInputFile->ReadFloat(ppx));
+    CheckReturnValue(fInputFile->ReadFloat(ppy));
+    CheckReturnValue(fInputFile->ReadFloat(ppz));
+    CheckReturnValue(fInputFile->ReadFloat(m));
+    CheckReturnValue(fInputFile->ReadInt(ityp));
+    CheckReturnValue(fInputFile->ReadInt(i3));
+    CheckReturnValue(fInputFile->ReadInt(ichg));
+    fInputFile->Gets(NULL, 200);
 
     // Convert UrQMD type and charge to unique pid identifier
     if (ityp >= 0) { pid =  1000 * (ichg+2) + ityp; }
@@ -251,71 +196,37 @@ Bool_t FairUrqmdGenerator::ReadEvent(FairPrimaryGenerator* primGen)
 // ------------------------------------------------------------------------
 
 
-// -----   Public method ReadEvent   --------------------------------------
+// -----   Public method SkipEvents   -------------------------------------
 Bool_t FairUrqmdGenerator::SkipEvents(Int_t count)
 {
   if (count<=0) { return kTRUE; }
 
-  for(Int_t ii=0; ii<count; ii++) {
-    // ---> Check for input file
-    if ( ! fInputFile ) {
-      LOG(ERROR) << "FairUrqmdGenerator: Input file not open! " 
-		 << FairLogger::endl;
-      return kFALSE;
-    }
+  // ---> Check for input file
+  if ( ! fInputFile || ! fInputFile->IsOpen() ) {
+    LOG(ERROR) << "FairUrqmdGenerator: Input file not open! " 
+	       << FairLogger::endl;
+    return kFALSE;
+  }
+
+  // ---> Go directly to the event if it is in the index, else to the
+  //      last event in the index and read the remaining event headers
+  Int_t target = fInputFile->GetEventNumber() + count;
+  if ( fInputFile->SeekEvent(target) ) {
+    LOG(INFO) << "FairUrqmdGenerator: " << count
+	      << " events skipped using the event index" << FairLogger::endl;
+    return kTRUE;
+  }
+  if ( fInputFile->GetNIndexed() > fInputFile->GetEventNumber() ) {
+    fInputFile->SeekEvent(fInputFile->GetNIndexed() - 1);
+  }
+
+  while ( fInputFile->GetEventNumber() < target ) {
 
     // ---> Define event variables to be read from file
-    int evnr=0, ntracks=0, aProj=0, zProj=0, aTarg=0, zTarg=0;
+    int evnr=0, ntracks=0;
     float b = 0., ekin = 0.;
 
-    // ---> Read and check first event header line from input file
-    char read[200];
-    fgets(read, 200, fInputFile);
-    if ( feof(fInputFile) ) {
-      LOG(INFO) << "FairUrqmdGenerator : End of input file reached." 
-		<< FairLogger::endl;
-      fclose(fInputFile);
-      fInputFile = NULL;
-      return kFALSE;
-    }
-    if ( read[0] != 'U' ) {
-      LOG(ERROR) << "FairUrqmdGenerator: Wrong event header" 
-		 << FairLogger::endl;
-      return kFALSE;
-    }
-
-    Int_t retval = 0;
-
-    // ---> Read rest of event header
-    fgets(read, 26, fInputFile);
-    retval = fscanf(fInputFile, "%d", &aProj);
-    CheckReturnValue(retval);
-    retval = fscanf(fInputFile, "%d", &zProj);
-    CheckReturnValue(retval);
-    fgets(read, 25, fInputFile);
-    retval = fscanf(fInputFile, "%d", &aTarg);
-    CheckReturnValue(retval);
-    retval = fscanf(fInputFile, "%d", &zTarg);
-    CheckReturnValue(retval);
-    fgets(read, 200, fInputFile);
-    fgets(read, 200, fInputFile);
-    fgets(read, 36, fInputFile);
-    retval = fscanf(fInputFile, "%f", &b);
-    CheckReturnValue(retval);
-    fgets(read, 200, fInputFile);
-    fgets(read, 39, fInputFile);
-    retval = fscanf(fInputFile, "%e", &ekin);
-    CheckReturnValue(retval);
-    fgets(read, 200, fInputFile);
-    fgets(read, 7, fInputFile);
-    retval = fscanf(fInputFile, "%d", &evnr);
-    CheckReturnValue(retval);
-    fgets(read, 200, fInputFile);
-    for (int iline=0; iline<8; iline++)  { fgets(read, 200,fInputFile); }
-    retval = fscanf(fInputFile, "%d", &ntracks);
-    CheckReturnValue(retval);
-    fgets(read, 200, fInputFile);
-    fgets(read, 200, fInputFile);
+    if ( ! ReadEventHeader(evnr, ntracks, b, ekin) ) { return kFALSE; }
 
     LOG(INFO) << "FairUrqmdGenerator: Event " << evnr << " skipped!" 
 	      << FairLogger::endl;
@@ -324,14 +235,77 @@ Bool_t FairUrqmdGenerator::SkipEvents(Int_t count)
     for(int itrack=0; itrack<ntracks; itrack++) {
 
       // Read momentum and PID from file
-      fgets(read, 81, fInputFile);
-      fgets(read, 200, fInputFile);
+      fInputFile->Gets(NULL, 81);
+      fInputFile->Gets(NULL, 200);
     }
   }
   return kTRUE;
 }
 // ------------------------------------------------------------------------
 
+
+
+// -----   Private method ReadEventHeader   -------------------------------
+Bool_t FairUrqmdGenerator::ReadEventHeader(Int_t& evnr, Int_t& ntracks,
+					   Float_t& b, Float_t& ekin)
+{
+  int aProj=0, zProj=0, aTarg=0, zTarg=0;
+
+  // ---> Read and check first event header line from input file
+  char read[200];
+  Long64_t offset = fInputFile->Tell();
+  fInputFile->Gets(read, 200);
+  if ( fInputFile->IsEof() ) {
+    LOG(INFO) << "FairUrqmdGenerator : End of input file reached." 
+	      << FairLogger::endl;
+    CloseInput();
+    return kFALSE;
+  }
+  if ( read[0] != 'U' ) {
+    LOG(ERROR) << "FairUrqmdGenerator: Wrong event header" 
+	       << FairLogger::endl;
+    return kFALSE;
+  }
+  fInputFile->IndexEvent(offset);
+
+  // ---> Read rest of event header
+  fInputFile->Gets(NULL, 26);
+  CheckReturnValue(fInputFile->ReadInt(aProj));
+  CheckReturnValue(fInputFile->ReadInt(zProj));
+  fInputFile->Gets(NULL, 25);
+  CheckReturnValue(fInputFile->ReadInt(aTarg));
+  CheckReturnValue(fInputFile->ReadInt(zTarg));
+  fInputFile->Gets(NULL, 200);
+  fInputFile->Gets(NULL, 200);
+  fInputFile->Gets(NULL, 36);
+  CheckReturnValue(fInputFile->ReadFloat(b));
+  fInputFile->Gets(NULL, 200);
+  fInputFile->Gets(NULL, 39);
+  CheckReturnValue(fInputFile->ReadFloat(ekin));
+  fInputFile->Gets(NULL, 200);
+  fInputFile->Gets(NULL, 7);
+  CheckReturnValue(fInputFile->ReadInt(evnr));
+  fInputFile->Gets(NULL, 200);
+  for (int iline=0; iline<8; iline++)  { fInputFile->Gets(NULL, 200); }
+  CheckReturnValue(fInputFile->ReadInt(ntracks));
+  fInputFile->Gets(NULL, 200);
+  fInputFile->Gets(NULL, 200);
+
+  return kTRUE;
+}
+// ------------------------------------------------------------------------
+
+
+
+// -----   Private method CloseInput   ------------------------------------
+void FairUrqmdGenerator::CloseInput()
+{
+  // the event index is written when the input is closed
+  delete fInputFile;
+  fInputFile = NULL;
+}
+// ------------------------------------------------------------------------
+
 // -----   Private method ReadConverisonTable   ---------------------------
 void FairUrqmdGenerator::ReadConversionTable(TString conversion_table)
 {
@@ -371,9 +345,9 @@ void FairUrqmdGenerator::ReadConversionTable(TString conversion_table)
 }
 // ------------------------------------------------------------------------
 
-void FairUrqmdGenerator::CheckReturnValue(Int_t retval)
+void FairUrqmdGenerator::CheckReturnValue(Bool_t found)
 {
-  if (1 != retval) { 
+  if ( ! found ) { 
     LOG(ERROR) << "Error when reading variable from input file"
 	       << FairLogger::endl;
   } 
@@ -18,6 +18,8 @@
  The FairUrqmdGenerator reads the output file 14 (ftn14) from UrQMD. The UrQMD
  calculation has to be performed in the CM system of the collision; Lorentz
  transformation into the lab is performed by this class.
+ The file is read through a FairBufferedInput, which keeps an index of the
+ events next to the input file for SkipEvents.
  Derived from FairGenerator.
 **/
 
@@ -30,9 +32,9 @@
 
 #include "Rtypes.h"                     // for Int_t, Bool_t, etc
 
-#include <stdio.h>                      // for FILE
 #include <map>                          // for map
 
+class FairBufferedInput;
 class FairPrimaryGenerator;
 
 class FairUrqmdGenerator : public FairGenerator
@@ -67,12 +69,15 @@ class FairUrqmdGenerator : public FairGenerator
      **/
     Bool_t ReadEvent(FairPrimaryGenerator* primGen);
 
+    /** The generator draws no random numbers (see FairGenerator::UsesGlobalRandom) **/
+    virtual Bool_t UsesGlobalRandom() const { return kFALSE; }
+
     /** Skip defined number of events in file **/
     Bool_t SkipEvents(Int_t count);
 
   private:
 
-    FILE* fInputFile;                     //!  Input file
+    FairBufferedInput* fInputFile;        //!  Input file
 
     std::map<Int_t,Int_t> fParticleTable;      //!  Map from UrQMD PID to PDGPID
 
@@ -83,13 +88,20 @@ class FairUrqmdGenerator : public FairGenerator
         conversion map. Is called from the constructor. **/
     void ReadConversionTable(TString conversion_table="");
 
-    /** Check return value from fscanf call **/
-    void CheckReturnValue(Int_t retval);
+    /** Private method ReadEventHeader. Reads the event header and adds
+        the event to the index, closes the input at the end of the file. **/
+    Bool_t ReadEventHeader(Int_t& evnr, Int_t& ntracks, Float_t& b, Float_t& ekin);
+
+    /** Private method CloseInput. Closes the input and writes the index. **/
+    void CloseInput();
+
+    /** Check that a number was read from the input **/
+    void CheckReturnValue(Bool_t found);
 
     FairUrqmdGenerator(const FairUrqmdGenerator&);
     FairUrqmdGenerator& operator=(const FairUrqmdGenerator&);
 
-    ClassDef(FairUrqmdGenerator,1);
+    ClassDef(FairUrqmdGenerator,2);
 
 };
 
@@ -0,0 +1,133 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+// Events built per second by FairEventBuilderManager with [builders] event
+// builders on a synthetic free streaming data set. Each builder generates
+// the hits of its detector for a slice of 10 us, with events at a rate of
+// 10 MHz and noise hits in between, and finds the events as clusters of
+// hits in time. The slices are processed with 1 up to [threads] threads.
+// Usage: _BenchFairEventBuilderManager [builders] [threads] [slices]
+
+#include "FairEventBuilder.h"
+#include "FairEventBuilderManager.h"
+#include "FairLogger.h"
+#include "FairRecoEventHeader.h"
+
+#include "TRandom3.h"
+#include "TStopwatch.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+const Double_t kSlice = 1.e4;           // time slice per Exec [ns]
+const Double_t kEventRate = 1.e-2;      // events per ns
+const Double_t kNoiseRate = 1.e-1;      // noise hits per ns
+const Double_t kClusterGap = 5.;        // hits closer than this belong to one event [ns]
+
+class ClusterBuilder : public FairEventBuilder
+{
+  public:
+    ClusterBuilder(Int_t seed)
+      : FairEventBuilder(), fRandom(seed), fSliceStart(0.), fHits() {
+      SetParallel(kTRUE);
+      SetMaxAllowedTime(kSlice);
+    }
+
+    virtual std::vector<std::pair<double, FairRecoEventHeader*> > FindEvents() {
+      // hits of the events and the noise in this slice
+      fHits.clear();
+      for (Double_t t = fSliceStart + fRandom.Exp(1. / kEventRate); t < fSliceStart + kSlice; t += fRandom.Exp(1. / kEventRate)) {
+        Int_t nHits = 5 + fRandom.Poisson(20.);
+        for (Int_t i = 0; i < nHits; i++) { fHits.push_back(t + fRandom.Gaus(0., 1.)); }
+      }
+      for (Double_t t = fSliceStart + fRandom.Exp(1. / kNoiseRate); t < fSliceStart + kSlice; t += fRandom.Exp(1. / kNoiseRate)) {
+        fHits.push_back(t);
+      }
+      std::sort(fHits.begin(), fHits.end());
+
+      // clusters of at least 5 hits are events
+      std::vector<std::pair<double, FairRecoEventHeader*> > events;
+      size_t first = 0;
+      for (size_t i = 1; i <= fHits.size(); i++) {
+        if (i < fHits.size() && fHits[i] - fHits[i-1] < kClusterGap) { continue; }
+        if (i - first >= 5) {
+          Double_t sum = 0.;
+          for (size_t j = first; j < i; j++) { sum += fHits[j]; }
+          FairRecoEventHeader* header = NewEventHeader();
+          header->SetEventTime(sum / (i - first), 1.);
+          events.push_back(std::make_pair(header->GetEventTime(), header));
+        }
+        first = i;
+      }
+      fSliceStart += kSlice;
+      return events;
+    }
+
+    virtual void StoreEventData(FairRecoEventHeader*) {}
+    virtual Bool_t Init() { return kTRUE; }
+    virtual void Print() {}
+
+  private:
+    TRandom3 fRandom;
+    Double_t fSliceStart;
+    std::vector<Double_t> fHits;
+};
+
+class CountingManager : public FairEventBuilderManager
+{
+  public:
+    CountingManager() : FairEventBuilderManager("CountingManager", 0), fNEvents(0) {}
+
+    virtual void AnalyzeAndExtractEvents(Double_t) {
+      for (size_t ieb = 0; ieb < fPossibleEvents.size(); ieb++) {
+        fNEvents += fPossibleEvents[ieb].size();
+        RemoveEvents(ieb, fPossibleEvents[ieb].size());
+      }
+    }
+
+    Long64_t fNEvents;
+};
+
+}
+
+int main(int argc, char** argv)
+{
+  Int_t nBuilders = argc > 1 ? atoi(argv[1]) : 8;
+  Int_t maxThreads = argc > 2 ? atoi(argv[2]) : 8;
+  Int_t nSlices = argc > 3 ? atoi(argv[3]) : 1000;
+
+  FairLogger::GetLogger()->SetLogScreenLevel("ERROR");
+  printf("%d builders, %d slices of %g us\n", nBuilders, nSlices, kSlice / 1.e3);
+
+  for (Int_t nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+    CountingManager manager;
+    manager.SetNumberOfThreads(nThreads);
+    std::vector<ClusterBuilder*> builders;
+    for (Int_t i = 0; i < nBuilders; i++) {
+      builders.push_back(new ClusterBuilder(i + 1));
+      manager.AddEventBuilder(builders.back());
+    }
+
+    TStopwatch timer;
+    timer.Start();
+    for (Int_t i = 0; i < nSlices; i++) {
+      manager.Exec("");
+    }
+    timer.Stop();
+    Double_t t = timer.RealTime();
+    printf("%2d threads %10.3f s %12.0f events/s\n", nThreads, t, manager.fNEvents / t);
+
+    for (size_t i = 0; i < builders.size(); i++) { delete builders[i]; }
+  }
+  return 0;
+}
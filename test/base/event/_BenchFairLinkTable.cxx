@@ -0,0 +1,130 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+// File size and read speed of [events] synthetic events with [objects]
+// digis each, once with the links stored with each FairMultiLinkedData and
+// once in the FairLinkTable of the event, as FairRootManager writes them
+// with SetCompactLinks(). A digi has 1-3 links to points and one to an MC
+// track, most of them to neighbouring indices. Reading includes getting the
+// links of every digi back.
+// Usage: _BenchFairLinkTable [events] [objects]
+
+#include "FairLink.h"
+#include "FairLinkTable.h"
+#include "FairMultiLinkedData.h"
+
+#include "TClonesArray.h"
+#include "TFile.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+#include "TTree.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+
+namespace
+{
+
+enum { kMCTrack = 0, kPoint = 1 };
+
+void CreateEvent(TClonesArray& digis, TRandom3& random, Int_t nDigis)
+{
+  digis.Clear();
+  std::set<FairLink> links;
+  for (Int_t i = 0; i < nDigis; i++) {
+    links.clear();
+    Int_t point = 3 * i + random.Integer(10);
+    Int_t n = 1 + random.Integer(3);
+    for (Int_t j = 0; j < n; j++) {
+      links.insert(FairLink(-1, -1, kPoint, point + j, random.Uniform(0.1, 1.)));
+    }
+    links.insert(FairLink(-1, -1, kMCTrack, point / 20, 1.));
+    new (digis[i]) FairMultiLinkedData(links, kFALSE);
+  }
+}
+
+Double_t Write(const char* fileName, Int_t nEvents, Int_t nDigis, Bool_t compact)
+{
+  TFile file(fileName, "recreate");
+  TTree* tree = new TTree("cbmsim", "/cbmout", 99);
+  TClonesArray* digis = new TClonesArray("FairMultiLinkedData");
+  FairLinkTable* table = new FairLinkTable("LinkTable.");
+  tree->Branch("Digis", &digis, 32000, 99);
+  if (compact) { tree->Branch("LinkTable.", &table, 32000, 99); }
+
+  TRandom3 random(7);
+  TStopwatch timer;
+  timer.Start();
+  for (Int_t event = 0; event < nEvents; event++) {
+    CreateEvent(*digis, random, nDigis);
+    if (compact) {
+      table->Clear();
+      for (Int_t i = 0; i < digis->GetEntriesFast(); i++) { table->Compact(digis->At(i)); }
+    }
+    tree->Fill();
+    if (compact) { table->Restore(); }
+  }
+  file.Write();
+  timer.Stop();
+  Long64_t size = file.GetSize();
+  file.Close();
+  delete digis;
+  delete table;
+
+  const char* what = compact ? "write, link table" : "write, links per object";
+  printf("%-30s %10.3f s %12.1f events/s %10.2f MB\n", what, timer.RealTime(), nEvents / timer.RealTime(), size / 1.e6);
+  return size;
+}
+
+void Read(const char* fileName, Bool_t compact)
+{
+  TFile file(fileName);
+  TTree* tree = static_cast<TTree*>(file.Get("cbmsim"));
+  TClonesArray* digis = new TClonesArray("FairMultiLinkedData");
+  FairLinkTable* table = new FairLinkTable();
+  tree->SetBranchAddress("Digis", &digis);
+  if (compact) { tree->SetBranchAddress("LinkTable.", &table); }
+
+  Long64_t nLinks = 0;
+  TStopwatch timer;
+  timer.Start();
+  for (Long64_t event = 0; event < tree->GetEntries(); event++) {
+    tree->GetEntry(event);
+    table->ResetIndex();
+    for (Int_t i = 0; i < digis->GetEntriesFast(); i++) {
+      FairMultiLinkedData* digi = static_cast<FairMultiLinkedData*>(digis->At(i));
+      // what FairMultiLinkedData does with the table of FairRootManager
+      if (compact) { table->Expand(*digi); }
+      nLinks += digi->GetNLinks();
+    }
+  }
+  timer.Stop();
+  tree->ResetBranchAddresses();
+  delete digis;
+  delete table;
+
+  const char* what = compact ? "read, link table" : "read, links per object";
+  printf("%-30s %10.3f s %12.1f events/s %10lld links\n", what, timer.RealTime(), tree->GetEntries() / timer.RealTime(), nLinks);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  Int_t nEvents = argc > 1 ? atoi(argv[1]) : 1000;
+  Int_t nDigis = argc > 2 ? atoi(argv[2]) : 1000;
+
+  printf("Writing %d events with %d digis\n", nEvents, nDigis);
+  Double_t inlineSize = Write("linktable_inline.root", nEvents, nDigis, kFALSE);
+  Double_t compactSize = Write("linktable_compact.root", nEvents, nDigis, kTRUE);
+  printf("%-30s %10.3f\n", "file size ratio", compactSize / inlineSize);
+
+  Read("linktable_inline.root", kFALSE);
+  Read("linktable_compact.root", kTRUE);
+  return 0;
+}
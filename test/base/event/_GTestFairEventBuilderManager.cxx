@@ -0,0 +1,160 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#include "FairEventBuilder.h"
+#include "FairEventBuilderManager.h"
+#include "FairLogger.h"
+#include "FairRecoEventHeader.h"
+
+#include "TRandom3.h"
+
+#include "gtest/gtest.h"
+
+#include <utility>
+#include <vector>
+
+// The parallel builders have to give the same events as the sequential ones,
+// merged in time order, and the event headers have to be reused after Clear().
+
+namespace
+{
+
+/** finds up to 20 events at random times in each slice of 1 us */
+class RandomBuilder : public FairEventBuilder
+{
+  public:
+    RandomBuilder(Int_t seed, Bool_t parallel)
+      : FairEventBuilder(), fRandom(seed), fSliceStart(0.), fNCreated(0) {
+      SetParallel(parallel);
+      SetMaxAllowedTime(1.e3);
+    }
+
+    virtual std::vector<std::pair<double, FairRecoEventHeader*> > FindEvents() {
+      std::vector<std::pair<double, FairRecoEventHeader*> > events;
+      Int_t nEvents = fRandom.Integer(20);
+      for (Int_t i = 0; i < nEvents; i++) {
+        FairRecoEventHeader* header = NewEventHeader();
+        Double_t time = fSliceStart + fRandom.Uniform(1.e3);
+        header->SetEventTime(time, 1.);
+        events.push_back(std::make_pair(time, header));
+      }
+      fSliceStart += 1.e3;
+      return events;
+    }
+
+    virtual void StoreEventData(FairRecoEventHeader*) {}
+    virtual Bool_t Init() { return kTRUE; }
+    virtual void Print() {}
+
+    Int_t GetNCreated() { return fNCreated; }
+
+  protected:
+    virtual FairRecoEventHeader* CreateEventHeader() {
+      fNCreated++;
+      return new FairRecoEventHeader();
+    }
+
+  private:
+    TRandom3 fRandom;
+    Double_t fSliceStart;
+    Int_t fNCreated;
+};
+
+/** takes the events before the last slice, checks the order */
+class Manager : public FairEventBuilderManager
+{
+  public:
+    Manager() : FairEventBuilderManager("Manager", 0), fEvents(), fOrdered(kTRUE), fSliceEnd(0.) {}
+
+    virtual void Exec(Option_t* opt) {
+      fSliceEnd += 1.e3;
+      FairEventBuilderManager::Exec(opt);
+    }
+
+    virtual void AnalyzeAndExtractEvents(Double_t maxEventTimeAllowed) {
+      for (size_t ieb = 0; ieb < fPossibleEvents.size(); ieb++) {
+        std::vector<std::pair<double, FairRecoEventHeader*> >& events = fPossibleEvents[ieb];
+        for (size_t i = 1; i < events.size(); i++) {
+          if (events[i].first < events[i-1].first) { fOrdered = kFALSE; }
+        }
+        size_t nTaken = 0;
+        while (nTaken < events.size() && (maxEventTimeAllowed < 0. || events[nTaken].first < fSliceEnd - maxEventTimeAllowed)) {
+          fEvents.push_back(std::make_pair(Int_t(ieb), events[nTaken].second->GetEventTime()));
+          nTaken++;
+        }
+        RemoveEvents(ieb, nTaken);
+      }
+    }
+
+    void Finish() {
+      AnalyzeAndExtractEvents(-1.);
+    }
+
+    std::vector<std::pair<Int_t, Double_t> > fEvents;
+    Bool_t fOrdered;
+    Double_t fSliceEnd;
+};
+
+std::vector<std::pair<Int_t, Double_t> > BuildEvents(Int_t nThreads, Int_t& nCreated)
+{
+  Manager manager;
+  manager.SetNumberOfThreads(nThreads);
+  std::vector<RandomBuilder*> builders;
+  for (Int_t i = 0; i < 6; i++) {
+    builders.push_back(new RandomBuilder(i + 1, i != 2));
+    manager.AddEventBuilder(builders.back());
+  }
+  for (Int_t i = 0; i < 200; i++) {
+    manager.Exec("");
+  }
+  manager.Finish();
+  EXPECT_TRUE(manager.fOrdered);
+
+  nCreated = 0;
+  for (size_t i = 0; i < builders.size(); i++) {
+    nCreated += builders[i]->GetNCreated();
+    delete builders[i];
+  }
+  return manager.fEvents;
+}
+
+}
+
+TEST(FairEventBuilderManager, ParallelBuilders)
+{
+  FairLogger::GetLogger()->SetLogScreenLevel("ERROR");
+  Int_t nCreated = 0;
+  std::vector<std::pair<Int_t, Double_t> > expected = BuildEvents(1, nCreated);
+  ASSERT_FALSE(expected.empty());
+
+  // at most the events of two slices per builder are in use at a time
+  EXPECT_LT(nCreated, 6 * 2 * 20);
+
+  for (Int_t nThreads = 2; nThreads <= 8; nThreads *= 2) {
+    EXPECT_EQ(expected, BuildEvents(nThreads, nCreated)) << nThreads << " threads";
+  }
+}
+
+TEST(FairEventBuilderManager, RecycledHeaderIsCleared)
+{
+  RandomBuilder builder(1, kFALSE);
+  builder.SetIdentifier(4);
+  FairRecoEventHeader* header = builder.NewEventHeader();
+  header->SetRunId(17);
+  header->SetIdentifier(1);
+  header->SetEventTime(123., 2.);
+  builder.RecycleEventHeader(header);
+
+  FairRecoEventHeader* reused = builder.NewEventHeader();
+  ASSERT_EQ(header, reused);
+  EXPECT_EQ(1, builder.GetNCreated());
+  EXPECT_EQ(0u, reused->GetRunId());
+  EXPECT_EQ(4, reused->GetIdentifier());
+  EXPECT_EQ(-1., reused->GetEventTime());
+  EXPECT_EQ(-1., reused->GetEventTimeError());
+  delete reused;
+}
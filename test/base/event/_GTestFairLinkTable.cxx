@@ -0,0 +1,151 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#include "FairLink.h"
+#include "FairLinkTable.h"
+#include "FairMultiLinkedData.h"
+
+#include "TClonesArray.h"
+#include "TRandom3.h"
+#include "TTree.h"
+
+#include "gtest/gtest.h"
+
+#include <set>
+#include <vector>
+
+// The links of the objects have to come back unchanged from the link table:
+// with file and entry numbers, several types, indices of -1, weights and
+// objects without links, directly, after Restore() and from a tree.
+
+namespace
+{
+
+std::set<FairLink> CreateLinks(TRandom3& random)
+{
+  std::set<FairLink> links;
+  Int_t nLinks = random.Integer(6);
+  for (Int_t i = 0; i < nLinks; i++) {
+    Int_t file = random.Rndm() < 0.2 ? random.Integer(2) : -1;
+    Int_t entry = random.Rndm() < 0.2 ? random.Integer(3) : -1;
+    Float_t weight = random.Integer(3) * 0.5;
+    links.insert(FairLink(file, entry, random.Integer(4), random.Integer(100) - 1, weight));
+  }
+  return links;
+}
+
+void ExpectSameLinks(const std::set<FairLink>& expected, const std::set<FairLink>& actual)
+{
+  ASSERT_EQ(expected.size(), actual.size());
+  std::set<FairLink>::const_iterator j = actual.begin();
+  for (std::set<FairLink>::const_iterator i = expected.begin(); i != expected.end(); i++, j++) {
+    EXPECT_EQ(i->GetFile(), j->GetFile());
+    EXPECT_EQ(i->GetEntry(), j->GetEntry());
+    EXPECT_EQ(i->GetType(), j->GetType());
+    EXPECT_EQ(i->GetIndex(), j->GetIndex());
+    EXPECT_EQ(i->GetWeight(), j->GetWeight());
+  }
+}
+
+void FillArray(TClonesArray& array, TRandom3& random, Int_t n, std::vector<std::set<FairLink> >& links)
+{
+  array.Clear();
+  links.clear();
+  for (Int_t i = 0; i < n; i++) {
+    links.push_back(CreateLinks(random));
+    new (array[i]) FairMultiLinkedData(links.back(), kFALSE);
+  }
+}
+
+}
+
+TEST(FairLinkTable, AddAndGetLinks)
+{
+  TRandom3 random(1);
+  FairLinkTable table("LinkTable.");
+  std::vector<std::set<FairLink> > links;
+  for (Int_t i = 0; i < 200; i++) {
+    links.push_back(CreateLinks(random));
+    EXPECT_EQ(i, table.Add(links.back()));
+  }
+  EXPECT_EQ(200, table.GetNRows());
+  EXPECT_LE(table.GetNBlocks(), table.GetNLinks());
+  // in reverse order, the rows are found without reading the rows before
+  for (Int_t i = 199; i >= 0; i--) {
+    std::set<FairLink> result;
+    table.GetLinks(i, result);
+    ExpectSameLinks(links[i], result);
+  }
+}
+
+TEST(FairLinkTable, CompactAndRestore)
+{
+  TRandom3 random(2);
+  FairLinkTable table("LinkTable.");
+  TClonesArray array("FairMultiLinkedData");
+  std::vector<std::set<FairLink> > links;
+  for (Int_t event = 0; event < 3; event++) {
+    FillArray(array, random, 100, links);
+    table.Clear();
+    Int_t nRows = 0;
+    for (Int_t i = 0; i < array.GetEntriesFast(); i++) {
+      FairMultiLinkedData* data = static_cast<FairMultiLinkedData*>(array.At(i));
+      table.Compact(data);
+      // objects without links stay as they are
+      if (links[i].empty()) {
+        EXPECT_EQ(-1, data->GetLinkTableIndex());
+      } else {
+        EXPECT_EQ(nRows++, data->GetLinkTableIndex());
+      }
+    }
+    EXPECT_EQ(nRows, table.GetNRows());
+    table.Restore();
+    for (Int_t i = 0; i < array.GetEntriesFast(); i++) {
+      FairMultiLinkedData* data = static_cast<FairMultiLinkedData*>(array.At(i));
+      EXPECT_EQ(-1, data->GetLinkTableIndex());
+      ExpectSameLinks(links[i], data->GetLinks());
+    }
+  }
+}
+
+TEST(FairLinkTable, ReadFromTree)
+{
+  TRandom3 random(3);
+  FairLinkTable* table = new FairLinkTable("LinkTable.");
+  TClonesArray* array = new TClonesArray("FairMultiLinkedData");
+  TTree tree("cbmsim", "link table");
+  tree.SetDirectory(0);
+  tree.Branch("LinkTable.", &table, 32000, 99);
+  tree.Branch("Data", &array, 32000, 99);
+
+  std::vector<std::vector<std::set<FairLink> > > events(5);
+  for (size_t event = 0; event < events.size(); event++) {
+    FillArray(*array, random, 50, events[event]);
+    table->Clear();
+    for (Int_t i = 0; i < array->GetEntriesFast(); i++) {
+      table->Compact(array->At(i));
+    }
+    tree.Fill();
+    table->Restore();
+  }
+
+  // the entries are read backwards, the index of the table has to follow
+  for (Int_t event = events.size() - 1; event >= 0; event--) {
+    tree.GetEntry(event);
+    table->ResetIndex();
+    ASSERT_EQ((Int_t)events[event].size(), array->GetEntriesFast());
+    for (Int_t i = 0; i < array->GetEntriesFast(); i++) {
+      FairMultiLinkedData* data = static_cast<FairMultiLinkedData*>(array->At(i));
+      table->Expand(*data);
+      EXPECT_EQ(-1, data->GetLinkTableIndex());
+      ExpectSameLinks(events[event][i], data->GetLinks());
+    }
+  }
+  tree.ResetBranchAddresses();
+  delete table;
+  delete array;
+}
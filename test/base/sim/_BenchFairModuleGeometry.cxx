@@ -0,0 +1,128 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+// Startup time of the geometry import for a synthetic large ROOT geometry.
+// A station with [modules] modules of [sensors] sensitive sensors each is
+// expanded as done by FairModule::ConstructRootGeometry, afterwards the
+// volumes are looked up by name and by geo node.
+// Usage: _BenchFairModuleGeometry [modules] [sensors]
+
+#include "FairDetector.h"
+#include "FairGeoLoader.h"
+#include "FairGeoNode.h"
+#include "FairLogger.h"
+#include "FairVolume.h"
+#include "FairVolumeList.h"
+
+#include "TGeoManager.h"
+#include "TGeoMaterial.h"
+#include "TGeoMatrix.h"
+#include "TGeoMedium.h"
+#include "TGeoNode.h"
+#include "TGeoVolume.h"
+#include "TRefArray.h"
+#include "TStopwatch.h"
+#include "TString.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+class BenchDetector : public FairDetector
+{
+  public:
+    BenchDetector() : FairDetector("BENCH", kTRUE) {}
+    virtual Bool_t ProcessHits(FairVolume*) { return kTRUE; }
+    virtual void Register() {}
+    virtual TClonesArray* GetCollection(Int_t) const { return 0; }
+    virtual void Reset() {}
+    virtual Bool_t CheckIfSensitive(std::string name) { return name.compare(0, 6, "sensor") == 0; }
+};
+
+TGeoNode* BuildStation(Int_t nModules, Int_t nSensors)
+{
+  TGeoMaterial* air = new TGeoMaterial("Air", 14.61, 7.3, 0.0012);
+  TGeoMedium* medium = new TGeoMedium("Air", 1, air);
+
+  TGeoVolume* cave = gGeoManager->MakeBox("cave", medium, 2000., 2000., 2000.);
+  gGeoManager->SetTopVolume(cave);
+  TGeoVolume* station = gGeoManager->MakeBox("station", medium, 1000., 1000., 1000.);
+
+  for (Int_t m = 0; m < nModules; m++) {
+    TGeoVolume* module = gGeoManager->MakeBox(Form("module%d", m), medium, 10., 10., 1.);
+    for (Int_t s = 0; s < nSensors; s++) {
+      TGeoVolume* sensor = gGeoManager->MakeBox(Form("sensor%d_%d", m, s), medium, 0.5, 0.5, 0.1);
+      module->AddNode(sensor, 1, new TGeoTranslation(-9.5 + 0.19 * (s % 100), 0., 0.));
+    }
+    station->AddNode(module, 1, new TGeoTranslation(0., 0., -990. + 1.98 * (m % 1000)));
+  }
+  cave->AddNode(station, 1, new TGeoTranslation(0., 0., 0.));
+
+  return cave->GetNode(0);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  Int_t nModules = argc > 1 ? atoi(argv[1]) : 200;
+  Int_t nSensors = argc > 2 ? atoi(argv[2]) : 100;
+  Int_t nVolumes = nModules * nSensors;
+
+  FairLogger::GetLogger()->SetLogScreenLevel("ERROR");
+
+  new FairGeoLoader("TGeo", "Geo Loader");
+  TGeoNode* station = BuildStation(nModules, nSensors);
+  Int_t nMatrices = gGeoManager->GetListOfMatrices()->GetEntriesFast();
+
+  BenchDetector detector;
+  TStopwatch timer;
+
+  // matrix removal, medium assignment and sensitive volume registration
+  timer.Start();
+  detector.ExpandNode(station);
+  Double_t expand = timer.RealTime();
+
+  // name lookup as done for every sensitive volume
+  timer.Start();
+  Int_t nFound = 0;
+  for (Int_t m = 0; m < nModules; m++) {
+    for (Int_t s = 0; s < nSensors; s++) {
+      if (FairModule::vList->findObject(Form("sensor%d_%d", m, s))) { nFound++; }
+    }
+  }
+  Double_t byName = timer.RealTime();
+
+  // volumes of an ASCII geometry are looked up by their geo node
+  FairVolumeList list;
+  std::vector<FairGeoNode*> nodes(nVolumes);
+  for (Int_t i = 0; i < nVolumes; i++) {
+    nodes[i] = new FairGeoNode();
+    FairVolume* volume = new FairVolume(Form("node%d", i), i);
+    volume->setGeoNode(nodes[i]);
+    list.addVolume(volume);
+  }
+  timer.Start();
+  Int_t nNodes = 0;
+  for (Int_t i = 0; i < nVolumes; i++) {
+    if (list.findVolume(nodes[i])) { nNodes++; }
+  }
+  Double_t byNode = timer.RealTime();
+
+  printf("%d sensitive volumes, %d matrices\n", nVolumes, nMatrices);
+  printf("ExpandNode           %8.3f s   (%d sensitive volumes registered)\n", expand, FairModule::svList->GetEntriesFast());
+  printf("lookup by name       %8.3f s   (%d found)\n", byName, nFound);
+  printf("lookup by geo node   %8.3f s   (%d found)\n", byNode, nNodes);
+
+  for (Int_t i = 0; i < nVolumes; i++) { delete nodes[i]; }
+
+  return (nFound == nVolumes && nNodes == nVolumes) ? 0 : 1;
+}
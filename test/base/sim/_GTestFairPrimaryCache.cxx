@@ -0,0 +1,181 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#include "FairPrimaryCache.h"
+
+#include "FairGenerator.h"
+#include "FairGenericStack.h"
+#include "FairLogger.h"
+#include "FairMCEventHeader.h"
+#include "FairPrimaryGenerator.h"
+
+#include "TRandom.h"
+#include "TString.h"
+#include "TSystem.h"
+
+#include "gtest/gtest.h"
+
+#include <set>
+#include <vector>
+
+// Seeded events have to be the same with and without the producer thread,
+// while the transport draws from gRandom at the same time, and when they are
+// replayed from a cache file.
+
+namespace
+{
+
+class RandomGenerator : public FairGenerator
+{
+  public:
+    RandomGenerator(Int_t nEvents, Bool_t global = kFALSE)
+      : FairGenerator("RandomGenerator"), fNEvents(nEvents), fNCalls(0), fGlobal(global) {}
+
+    virtual Bool_t ReadEvent(FairPrimaryGenerator* primGen) {
+      if (fNCalls == fNEvents) { return kFALSE; }
+      fNCalls++;
+      TRandom* random = fGlobal ? gRandom : GetRandom();
+      Int_t nTracks = 1 + random->Integer(20);
+      for (Int_t i = 0; i < nTracks; i++) {
+        primGen->AddTrack(211, random->Gaus(), random->Gaus(), random->Uniform(1., 10.),
+                          0., 0., 0., -1, kTRUE, random->Uniform(10., 20.));
+      }
+      return kTRUE;
+    }
+
+    virtual Bool_t UsesGlobalRandom() const { return fGlobal; }
+
+    Int_t fNEvents;
+    Int_t fNCalls;
+    Bool_t fGlobal;
+};
+
+class RecordingStack : public FairGenericStack
+{
+  public:
+    std::vector<Double_t> fValues;
+    virtual void PushTrack(Int_t toBeDone, Int_t parentID, Int_t pdgCode,
+                           Double_t px, Double_t py, Double_t pz,
+                           Double_t e, Double_t vx, Double_t vy,
+                           Double_t vz, Double_t time, Double_t polx,
+                           Double_t poly, Double_t polz, TMCProcess proc,
+                           Int_t& ntr, Double_t weight, Int_t is,
+                           Int_t secondParentId) {
+      Double_t values[] = { Double_t(toBeDone), Double_t(parentID), Double_t(pdgCode),
+                            px, py, pz, e, vx, vy, vz, time, polx, poly, polz,
+                            Double_t(proc), weight, Double_t(is), Double_t(secondParentId)
+                          };
+      fValues.insert(fValues.end(), values, values + 18);
+      ntr = 0;
+    }
+};
+
+/** primaries and headers of all events, the transport draws from gRandom
+ ** between the events, also while a producer thread runs */
+std::vector<Double_t> Generate(FairPrimaryGenerator& primGen, Bool_t useRandom)
+{
+  FairMCEventHeader header;
+  primGen.SetEvent(&header);
+  primGen.SmearGausVertexXY(kTRUE);
+  primGen.SetBeam(0., 0., 0.1, 0.1);
+  primGen.SmearVertexZ(kTRUE);
+  primGen.SetTarget(0., 1.);
+
+  primGen.Init();
+  RecordingStack stack;
+  while (primGen.GenerateEvent(&stack)) {
+    Double_t values[] = { Double_t(header.GetEventID()), Double_t(header.GetNPrim()),
+                          header.GetX(), header.GetY(), header.GetZ()
+                        };
+    stack.fValues.insert(stack.fValues.end(), values, values + 5);
+    if (useRandom) {
+      for (Int_t i = 0; i < 1000; i++) { gRandom->Rndm(); }
+    }
+  }
+  primGen.CloseCache();
+  return stack.fValues;
+}
+
+}
+
+TEST(FairPrimaryCache, EventSeed)
+{
+  std::set<UInt_t> seeds;
+  for (Int_t i = 0; i < 10000; i++) {
+    UInt_t seed = FairPrimaryCache::EventSeed(42, i);
+    EXPECT_NE(0u, seed);
+    seeds.insert(seed);
+    EXPECT_EQ(seed, FairPrimaryCache::EventSeed(42, i));
+  }
+  EXPECT_EQ(10000u, seeds.size());
+  EXPECT_NE(FairPrimaryCache::EventSeed(1, 0), FairPrimaryCache::EventSeed(2, 0));
+}
+
+TEST(FairPrimaryCache, ProducerThread)
+{
+  FairLogger::GetLogger()->SetLogScreenLevel("ERROR");
+
+  FairPrimaryGenerator seeded;
+  seeded.AddGenerator(new RandomGenerator(200));
+  seeded.SetEventSeed(4711);
+  std::vector<Double_t> expected = Generate(seeded, kTRUE);
+  ASSERT_FALSE(expected.empty());
+
+  for (Int_t queueSize = 1; queueSize <= 16; queueSize *= 4) {
+    FairPrimaryGenerator producer;
+    producer.AddGenerator(new RandomGenerator(200));
+    producer.SetEventSeed(4711);
+    producer.SetProducerThread(queueSize);
+    EXPECT_EQ(expected, Generate(producer, kTRUE)) << "queue size " << queueSize;
+  }
+
+  // a generator drawing from gRandom runs without producer thread, seeded
+  // by replacing gRandom
+  FairPrimaryGenerator global;
+  global.AddGenerator(new RandomGenerator(200, kTRUE));
+  global.SetEventSeed(4711);
+  global.SetProducerThread(4);
+  EXPECT_EQ(expected, Generate(global, kTRUE));
+
+  // stopped while the producer waits for a free place in the queue
+  FairPrimaryGenerator stopped;
+  stopped.AddGenerator(new RandomGenerator(200));
+  stopped.SetProducerThread(4);
+  FairMCEventHeader header;
+  stopped.SetEvent(&header);
+  RecordingStack stack;
+  EXPECT_TRUE(stopped.GenerateEvent(&stack));
+  stopped.CloseCache();
+}
+
+TEST(FairPrimaryCache, Replay)
+{
+  FairLogger::GetLogger()->SetLogScreenLevel("ERROR");
+  TString fileName = Form("%s/_GTestFairPrimaryCache_%d.bin", gSystem->TempDirectory(), gSystem->GetPid());
+  gSystem->Unlink(fileName);
+
+  std::vector<Double_t> expected;
+  {
+    FairPrimaryGenerator primGen;
+    primGen.AddGenerator(new RandomGenerator(100));
+    primGen.SetEventSeed(17);
+    primGen.SetPrimaryCache(fileName);
+    expected = Generate(primGen, kTRUE);
+  }
+  ASSERT_TRUE(FairPrimaryCache::IsCacheFile(fileName));
+
+  // the generators are not called for a replay
+  FairPrimaryGenerator replay;
+  RandomGenerator* gen = new RandomGenerator(100);
+  replay.AddGenerator(gen);
+  replay.SetEventSeed(18);
+  replay.SetPrimaryCache(fileName);
+  EXPECT_EQ(expected, Generate(replay, kTRUE));
+  EXPECT_EQ(0, gen->fNCalls);
+
+  gSystem->Unlink(fileName);
+}
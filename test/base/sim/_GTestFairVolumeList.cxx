@@ -0,0 +1,69 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#include "FairVolumeList.h"
+
+#include "FairGeoNode.h"
+#include "FairLogger.h"
+#include "FairVolume.h"
+
+#include "gtest/gtest.h"
+
+TEST(FairVolumeList, FindByName)
+{
+  FairVolumeList list;
+  for (Int_t i = 0; i < 1000; i++) {
+    list.addVolume(new FairVolume(Form("vol%d", i), i));
+  }
+
+  EXPECT_EQ(1000, list.getEntries());
+  for (Int_t i = 0; i < 1000; i++) {
+    FairVolume* v = list.findObject(Form("vol%d", i));
+    ASSERT_TRUE(v != NULL);
+    EXPECT_EQ(i, v->getVolumeId());
+    EXPECT_EQ(v, list.At(i));
+  }
+  EXPECT_TRUE(list.findObject("vol1000") == NULL);
+  EXPECT_TRUE(list.findObject("") == NULL);
+}
+
+TEST(FairVolumeList, RejectDuplicateName)
+{
+  FairLogger::GetLogger()->SetLogScreenLevel("FATAL");
+
+  FairVolumeList list;
+  FairVolume* first = new FairVolume("vol", 1);
+  FairVolume* second = new FairVolume("vol", 2);
+  list.addVolume(first);
+  list.addVolume(second);
+
+  EXPECT_EQ(1, list.getEntries());
+  EXPECT_EQ(first, list.findObject("vol"));
+
+  delete second;
+}
+
+TEST(FairVolumeList, FindByGeoNode)
+{
+  FairGeoNode nodes[3];
+  FairVolumeList list;
+
+  // two volumes of the same node, the first one is returned
+  const char* names[4] = { "a", "b", "c", "d" };
+  FairGeoNode* volNodes[4] = { &nodes[0], &nodes[1], &nodes[0], NULL };
+  FairVolume* volumes[4];
+  for (Int_t i = 0; i < 4; i++) {
+    volumes[i] = new FairVolume(names[i], i);
+    volumes[i]->setGeoNode(volNodes[i]);
+    list.addVolume(volumes[i]);
+  }
+
+  EXPECT_EQ(volumes[0], list.findVolume(&nodes[0]));
+  EXPECT_EQ(volumes[1], list.findVolume(&nodes[1]));
+  EXPECT_TRUE(list.findVolume(&nodes[2]) == NULL);
+  EXPECT_TRUE(list.findVolume(NULL) == NULL);
+}
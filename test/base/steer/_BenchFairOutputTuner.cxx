@@ -0,0 +1,128 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+// Writes [events] events of hits and MC points with the default tree settings
+// and with the settings of FairOutputTuner (tuned after [tune] events), then
+// reads each file back with a GetEntry loop over the full tree. The rates are
+// uncompressed MB per second; the files are read right after writing, i.e.
+// mostly from the page cache, so the read rate is the one of decompression
+// and streaming.
+// Usage: _BenchFairOutputTuner [events] [tune]
+
+#include "FairHit.h"
+#include "FairLogger.h"
+#include "FairMCPoint.h"
+#include "FairOutputTuner.h"
+
+#include "TClonesArray.h"
+#include "TFile.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+#include "TString.h"
+#include "TSystem.h"
+#include "TTree.h"
+#include "TVector3.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+
+/** Fills the tree, tuned after nTune events if nTune > 0, returns the time [s] */
+Double_t Write(const char* fileName, Int_t nEvents, Int_t nTune, Long64_t& fileSize)
+{
+  TStopwatch timer;
+  timer.Start();
+  TFile file(fileName, "RECREATE");
+  TTree* tree = new TTree("cbmsim", "output tuner bench");
+  TClonesArray* hits = new TClonesArray("FairHit");
+  TClonesArray* points = new TClonesArray("FairMCPoint");
+  tree->Branch("Hits", &hits);
+  tree->Branch("MCPoint", &points);
+  FairOutputTuner tuner(nTune);
+
+  TRandom3 random(17);
+  for (Int_t iEvent = 0; iEvent < nEvents; iEvent++) {
+    hits->Delete();
+    points->Delete();
+    Int_t nHits = 100 + random.Integer(200);
+    for (Int_t i = 0; i < nHits; i++) {
+      FairHit* hit = new ((*hits)[i]) FairHit();
+      hit->SetXYZ(random.Gaus(), random.Gaus(), random.Uniform(0., 100.));
+      hit->SetTimeStamp(iEvent * 100. + random.Uniform(0., 100.));
+    }
+    for (Int_t i = 0; i < nHits / 2; i++) {
+      new ((*points)[i]) FairMCPoint(random.Integer(1000), i, TVector3(random.Gaus(), random.Gaus(), 0.),
+                                     TVector3(0., 0., random.Exp(1.)), 0., 0., random.Exp(1.e-3));
+    }
+    tree->Fill();
+    if (nTune > 0) { tuner.Observe(tree); }
+  }
+  tree->Write();
+  fileSize = file.GetSize();
+  file.Close();
+  timer.Stop();
+
+  delete hits;
+  delete points;
+  return timer.RealTime();
+}
+
+/** Reads all entries of all branches, returns the time [s] */
+Double_t Read(const char* fileName, Long64_t& bytes)
+{
+  TStopwatch timer;
+  timer.Start();
+  TFile file(fileName);
+  TTree* tree = static_cast<TTree*>(file.Get("cbmsim"));
+  TClonesArray* hits = new TClonesArray("FairHit");
+  TClonesArray* points = new TClonesArray("FairMCPoint");
+  tree->SetBranchAddress("Hits", &hits);
+  tree->SetBranchAddress("MCPoint", &points);
+
+  bytes = 0;
+  Long64_t nEntries = tree->GetEntries();
+  for (Long64_t i = 0; i < nEntries; i++) {
+    bytes += tree->GetEntry(i);
+  }
+  delete tree;
+  file.Close();
+  timer.Stop();
+
+  delete hits;
+  delete points;
+  return timer.RealTime();
+}
+
+void Run(const char* what, const char* fileName, Int_t nEvents, Int_t nTune)
+{
+  Long64_t fileSize = 0;
+  Double_t writeTime = Write(fileName, nEvents, nTune, fileSize);
+  Long64_t bytes = 0;
+  Double_t readTime = Read(fileName, bytes);
+  printf("%-10s write %8.3f s %8.1f MB/s   read %8.3f s %8.1f MB/s   %8.1f MB -> %8.1f MB on disk\n",
+         what, writeTime, bytes / 1.e6 / writeTime, readTime, bytes / 1.e6 / readTime,
+         bytes / 1.e6, fileSize / 1.e6);
+  gSystem->Unlink(fileName);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  Int_t nEvents = argc > 1 ? atoi(argv[1]) : 20000;
+  Int_t nTune = argc > 2 ? atoi(argv[2]) : 100;
+
+  FairLogger::GetLogger()->SetLogScreenLevel("ERROR");
+
+  TString fileName = Form("%s/_BenchFairOutputTuner_%d.root", gSystem->TempDirectory(), gSystem->GetPid());
+  printf("%d events, tuned after %d events\n", nEvents, nTune);
+  Run("default", fileName, nEvents, 0);
+  Run("tuned", fileName, nEvents, nTune);
+  return 0;
+}
@@ -0,0 +1,110 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+// Time window queries of FairTSBufferFunctional on a free streaming data set
+// of [seconds] seconds with a data rate of [rate] Hz, stored in time slices
+// of 100 ms. Windows of 1 ms are requested in time order and, ten times
+// fewer, at random times, both with and without the time index.
+// Usage: _BenchFairTSBufferFunctional [seconds] [rate] [windows]
+
+#include "FairLogger.h"
+#include "FairRootManager.h"
+#include "FairTSBufferFunctional.h"
+#include "FairTimeStamp.h"
+
+#include "TClonesArray.h"
+#include "TFile.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+#include "TString.h"
+#include "TSystem.h"
+#include "TTree.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+
+const Double_t kSlice = 1.e8;           // time slice per entry [ns]
+const Double_t kWindow = 1.e6;          // requested window [ns]
+
+void WriteData(const char* fileName, Double_t seconds, Double_t rate)
+{
+  TFile file(fileName, "RECREATE");
+  TTree tree("cbmsim", "free streaming");
+  TClonesArray* digis = new TClonesArray("FairTimeStamp");
+  tree.Branch("Digi", &digis);
+
+  TRandom3 random(17);
+  Double_t meanGap = 1.e9 / rate;
+  Double_t time = random.Exp(meanGap);
+  Long64_t nSlices = static_cast<Long64_t>(seconds * 1.e9 / kSlice);
+  for (Long64_t slice = 0; slice < nSlices; slice++) {
+    digis->Clear();
+    Int_t n = 0;
+    while (time < (slice + 1) * kSlice) {
+      new ((*digis)[n++]) FairTimeStamp(time);
+      time += random.Exp(meanGap);
+    }
+    tree.Fill();
+  }
+  tree.Write();
+  delete digis;
+}
+
+void Query(const char* what, TTree* tree, Bool_t useIndex, Bool_t ordered, Double_t seconds, Int_t nWindows)
+{
+  StopTime startFunctor, stopFunctor;
+  FairTSBufferFunctional buffer("Digi", tree, &stopFunctor, &startFunctor);
+  buffer.SetTimeIndex(useIndex);
+
+  TRandom3 random(3);
+  Double_t length = seconds * 1.e9;
+  Long64_t nData = 0;
+  TStopwatch timer;
+  timer.Start();
+  for (Int_t i = 0; i < nWindows; i++) {
+    Double_t start = ordered ? i * length / nWindows : random.Uniform(0., length);
+    TClonesArray* data = buffer.GetData(start, start + kWindow);
+    nData += data->GetEntriesFast();
+    data->Delete();
+  }
+  timer.Stop();
+  Double_t t = timer.RealTime();
+  printf("%-30s %10.3f s %12.0f windows/s %10lld data\n", what, t, nWindows / t, nData);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  Double_t seconds = argc > 1 ? atof(argv[1]) : 3600.;
+  Double_t rate = argc > 2 ? atof(argv[2]) : 1.e3;
+  Int_t nWindows = argc > 3 ? atoi(argv[3]) : 10000;
+
+  FairLogger::GetLogger()->SetLogScreenLevel("ERROR");
+
+  TString fileName = Form("%s/_BenchFairTSBufferFunctional_%d.root", gSystem->TempDirectory(), gSystem->GetPid());
+  printf("Writing %g s of data with %g Hz in %g ms slices\n", seconds, rate, kSlice / 1.e6);
+  WriteData(fileName, seconds, rate);
+
+  TFile file(fileName);
+  TTree* tree = (TTree*)file.Get("cbmsim");
+  TClonesArray* digis = new TClonesArray("FairTimeStamp");
+  tree->SetBranchAddress("Digi", &digis);
+  FairRootManager* ioman = new FairRootManager();
+  ioman->Register("Digi", "Bench", digis, kFALSE);
+
+  Query("ordered windows, linear", tree, kFALSE, kTRUE, seconds, nWindows);
+  Query("ordered windows, index", tree, kTRUE, kTRUE, seconds, nWindows);
+  Query("random windows, linear", tree, kFALSE, kFALSE, seconds, nWindows / 10);
+  Query("random windows, index", tree, kTRUE, kFALSE, seconds, nWindows / 10);
+
+  gSystem->Unlink(fileName);
+  return 0;
+}
@@ -0,0 +1,59 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#include "FairAsyncWriter.h"
+#include "FairHit.h"
+#include "FairLogger.h"
+
+#include "TClonesArray.h"
+#include "TTree.h"
+
+#include "gtest/gtest.h"
+
+// The registered array has to be empty after each Snapshot(), also when the
+// storage of an event written before comes back, and the tree has to get the
+// events as they were filled.
+
+TEST(FairAsyncWriter, EmptyAfterFill)
+{
+  FairLogger::GetLogger()->SetLogScreenLevel("ERROR");
+
+  TClonesArray* hits = new TClonesArray("FairHit");
+  TTree* tree = new TTree("T", "T");
+  tree->SetDirectory(0);
+  tree->Branch("Hits", &hits);
+
+  FairAsyncWriter* writer = FairAsyncWriter::Create(tree, 2);
+  ASSERT_TRUE(writer != 0);
+
+  const Int_t nEvents = 50;
+  for (Int_t iEvent = 0; iEvent < nEvents; iEvent++) {
+    for (Int_t i = 0; i < iEvent % 7 + 1; i++) {
+      FairHit* hit = new ((*hits)[hits->GetEntriesFast()]) FairHit();
+      hit->SetTimeStamp(iEvent * 100. + i);
+    }
+    writer->Snapshot();
+    EXPECT_EQ(0, hits->GetEntriesFast()) << "event " << iEvent;
+    // the written events are reused by the next snapshots
+    if (iEvent % 5 == 4) { writer->Flush(); }
+  }
+  writer->Stop();
+
+  ASSERT_EQ(nEvents, tree->GetEntries());
+  for (Int_t iEvent = 0; iEvent < nEvents; iEvent++) {
+    tree->GetEntry(iEvent);
+    ASSERT_EQ(iEvent % 7 + 1, hits->GetEntriesFast()) << "event " << iEvent;
+    for (Int_t i = 0; i < hits->GetEntriesFast(); i++) {
+      EXPECT_EQ(iEvent * 100. + i, static_cast<FairHit*>(hits->At(i))->GetTimeStamp());
+    }
+  }
+
+  delete writer;
+  delete tree;
+  hits->Delete();
+  delete hits;
+}
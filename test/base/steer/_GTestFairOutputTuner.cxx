@@ -0,0 +1,146 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#include "FairHit.h"
+#include "FairLogger.h"
+#include "FairMCPoint.h"
+#include "FairOutputTuner.h"
+#include "FairTimeStamp.h"
+
+#include "TBranch.h"
+#include "TClonesArray.h"
+#include "TMemFile.h"
+#include "TObjArray.h"
+#include "TTree.h"
+
+#include "gtest/gtest.h"
+
+// The tuner has to change the tree once after the observed events: clusters
+// of the given size, baskets following the size of the branches and the
+// compression by branch type.
+
+namespace
+{
+
+class OutputTunerTest : public ::testing::Test
+{
+  protected:
+    OutputTunerTest()
+      : fFile("OutputTunerTest.root", "RECREATE"), fTree(0),
+        fHits(new TClonesArray("FairHit")), fSparse(new TClonesArray("FairTimeStamp")),
+        fPoints(new TClonesArray("FairMCPoint")), fNEvents(0) {}
+
+    virtual ~OutputTunerTest() {
+      delete fTree;
+      delete fHits;
+      delete fSparse;
+      delete fPoints;
+    }
+
+    virtual void SetUp() {
+      FairLogger::GetLogger()->SetLogScreenLevel("ERROR");
+      fFile.cd();
+      fTree = new TTree("T", "T");
+      fTree->Branch("Hits", &fHits);
+      fTree->Branch("Sparse", &fSparse);
+      fTree->Branch("MCPoint", &fPoints);
+    }
+
+    /** 100 hits and 50 points per event, a sparse entry every 10 events */
+    void FillEvent() {
+      fHits->Clear();
+      fSparse->Clear();
+      fPoints->Clear();
+      for (Int_t i = 0; i < 100; i++) {
+        FairHit* hit = new ((*fHits)[i]) FairHit();
+        hit->SetTimeStamp(fNEvents * 100. + i);
+      }
+      if (fNEvents % 10 == 0) {
+        new ((*fSparse)[0]) FairTimeStamp(fNEvents * 100.);
+      }
+      for (Int_t i = 0; i < 50; i++) {
+        new ((*fPoints)[i]) FairMCPoint();
+      }
+      fTree->Fill();
+      fNEvents++;
+    }
+
+    /** largest basket size of a branch and its sub-branches */
+    static Int_t MaxBasketSize(TBranch* branch) {
+      Int_t size = branch->GetBasketSize();
+      TObjArray* sub = branch->GetListOfBranches();
+      for (Int_t i = 0; i < sub->GetEntriesFast(); i++) {
+        Int_t s = MaxBasketSize(static_cast<TBranch*>(sub->UncheckedAt(i)));
+        if (s > size) { size = s; }
+      }
+      return size;
+    }
+
+    TMemFile fFile;
+    TTree* fTree;
+    TClonesArray* fHits;
+    TClonesArray* fSparse;
+    TClonesArray* fPoints;
+    Int_t fNEvents;
+};
+
+}
+
+TEST_F(OutputTunerTest, TunesOnceAfterObservedEvents)
+{
+  FairOutputTuner tuner(50);
+  for (Int_t i = 0; i < 49; i++) {
+    FillEvent();
+    EXPECT_FALSE(tuner.Observe(fTree));
+  }
+  FillEvent();
+  EXPECT_TRUE(tuner.Observe(fTree));
+  EXPECT_TRUE(tuner.IsTuned());
+  FillEvent();
+  EXPECT_FALSE(tuner.Observe(fTree));
+}
+
+TEST_F(OutputTunerTest, ClustersAndBaskets)
+{
+  FairOutputTuner tuner(50);
+  tuner.SetClusterSize(1000000);
+  for (Int_t i = 0; i < 50; i++) {
+    FillEvent();
+    tuner.Observe(fTree);
+  }
+  ASSERT_TRUE(tuner.IsTuned());
+
+  Double_t bytesPerEvent = static_cast<Double_t>(fTree->GetTotBytes()) / fTree->GetEntries();
+  Long64_t cluster = fTree->GetAutoFlush();
+  ASSERT_GT(cluster, 0);
+  EXPECT_NEAR(1000000., cluster * bytesPerEvent, 100000.);
+
+  Int_t hits = MaxBasketSize(fTree->GetBranch("Hits"));
+  Int_t sparse = MaxBasketSize(fTree->GetBranch("Sparse"));
+  EXPECT_GT(hits, 10 * sparse);
+  EXPECT_GE(sparse, 1024);
+
+  // the tree can still be filled
+  for (Int_t i = 0; i < 100; i++) { FillEvent(); }
+  EXPECT_EQ(150, fTree->GetEntries());
+}
+
+TEST_F(OutputTunerTest, CompressionProfiles)
+{
+  FairOutputTuner tuner(10);
+  tuner.SetProfile("Sparse", FairOutputTuner::kArchive);
+  for (Int_t i = 0; i < 10; i++) {
+    FillEvent();
+    tuner.Observe(fTree);
+  }
+  Int_t fast = FairOutputTuner::GetCompressionSettings(FairOutputTuner::kFast);
+  Int_t archive = FairOutputTuner::GetCompressionSettings(FairOutputTuner::kArchive);
+  EXPECT_NE(fast, archive);
+  EXPECT_EQ(fast, fTree->GetBranch("Hits")->GetCompressionSettings());
+  EXPECT_EQ(archive, fTree->GetBranch("MCPoint")->GetCompressionSettings());
+  EXPECT_EQ(archive, fTree->GetBranch("Sparse")->GetCompressionSettings());
+}
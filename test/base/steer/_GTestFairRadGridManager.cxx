@@ -0,0 +1,163 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#include "FairGenericStack.h"
+#include "FairLogger.h"
+#include "FairMesh.h"
+#include "FairMockVirtualMC.h"
+#include "FairRadGridManager.h"
+
+#include "TH2.h"
+#include "TLorentzVector.h"
+#include "TObjArray.h"
+#include "TParticle.h"
+#include "TRandom3.h"
+
+#include "gtest/gtest.h"
+
+// The sums of FairRadGridManager::FillMeshList, added to the histograms by
+// FillMeshHistograms, have to give the histograms TH2::Fill gives for the
+// same steps: bin contents, errors, entries and statistics.
+
+namespace
+{
+
+/** the current step, as set by the test */
+class StepMC : public FairMockVirtualMC
+{
+  public:
+    StepMC() : FairMockVirtualMC("StepMC"), fPos(), fMom(), fEdep(0.), fStep(0.) {}
+
+    virtual void TrackPosition(TLorentzVector& pos) const { pos = fPos; }
+    virtual void TrackMomentum(TLorentzVector& mom) const { mom = fMom; }
+    virtual Double_t Edep() const { return fEdep; }
+    virtual Double_t TrackStep() const { return fStep; }
+
+    TLorentzVector fPos;
+    TLorentzVector fMom;
+    Double_t fEdep;
+    Double_t fStep;
+};
+
+/** a stack with one track, the one of the current step */
+class StepStack : public FairGenericStack
+{
+  public:
+    StepStack() : FairGenericStack(), fParticle() {}
+
+    virtual TParticle* GetCurrentTrack() const { return const_cast<TParticle*>(&fParticle); }
+    virtual Int_t GetCurrentTrackNumber() const { return 0; }
+
+    TParticle fParticle;
+};
+
+FairMesh* NewMesh(const char* name, Double_t x, Double_t y, Double_t z, Double_t size, Int_t nBins)
+{
+  FairMesh* mesh = new FairMesh(name);
+  mesh->SetX(x, x + size, nBins);
+  mesh->SetY(y, y + size, nBins);
+  mesh->SetZ(z, z + size, 1);
+  mesh->calculate();
+  return mesh;
+}
+
+/** FairRadGridManager::FillMeshList before the flat sums */
+void FillReference(TObjArray& meshes, const StepMC& mc, const TParticle& particle)
+{
+  for (Int_t i = 0; i < meshes.GetEntriesFast(); i++) {
+    FairMesh* mesh = static_cast<FairMesh*>(meshes.At(i));
+    const TLorentzVector& pos = mc.fPos;
+    if (pos.X() < mesh->GetXmin() || pos.X() > mesh->GetXmax() || pos.Y() < mesh->GetYmin()
+        || pos.Y() > mesh->GetYmax() || pos.Z() < mesh->GetZmin() || pos.Z() > mesh->GetZmax()) {
+      continue;
+    }
+    mesh->fillTID(pos.X(), pos.Y(), mc.fEdep / mesh->GetBinVolume());
+    if (mc.fStep < 5 * mesh->GetDiag()) {
+      Double_t length = mc.fStep / mesh->GetBinVolume();
+      mesh->fillFluence(pos.X(), pos.Y(), length);
+      if (particle.P() > 0.02) {
+        mesh->fillSEU(pos.X(), pos.Y(), length);
+      }
+    }
+  }
+}
+
+void ExpectEqual(TH2D* expected, TH2D* h)
+{
+  ASSERT_EQ(expected->GetNcells(), h->GetNcells());
+  for (Int_t bin = 0; bin < expected->GetNcells(); bin++) {
+    EXPECT_DOUBLE_EQ(expected->GetBinContent(bin), h->GetBinContent(bin)) << h->GetName() << " bin " << bin;
+    EXPECT_DOUBLE_EQ(expected->GetBinError(bin), h->GetBinError(bin)) << h->GetName() << " bin " << bin;
+  }
+  EXPECT_DOUBLE_EQ(expected->GetEntries(), h->GetEntries()) << h->GetName();
+  Double_t expectedStats[7];
+  Double_t stats[7];
+  expected->GetStats(expectedStats);
+  h->GetStats(stats);
+  for (Int_t i = 0; i < 7; i++) {
+    EXPECT_DOUBLE_EQ(expectedStats[i], stats[i]) << h->GetName() << " stat " << i;
+  }
+}
+
+}
+
+TEST(FairRadGridManager, FlatSumsAsTH2Fill)
+{
+  FairLogger::GetLogger()->SetLogScreenLevel("ERROR");
+  TH1::AddDirectory(kFALSE);
+
+  StepMC mc;
+  StepStack stack;
+  mc.SetStack(&stack);
+
+  // overlapping meshes of different sizes and binnings
+  TObjArray meshes;
+  TObjArray reference;
+  TRandom3 random(11);
+  for (Int_t i = 0; i < 12; i++) {
+    Double_t x = random.Uniform(-50., 30.);
+    Double_t y = random.Uniform(-50., 30.);
+    Double_t z = random.Uniform(-50., 30.);
+    Double_t size = random.Uniform(5., 40.);
+    Int_t nBins = 2 + random.Integer(20);
+    meshes.Add(NewMesh(Form("mesh%d", i), x, y, z, size, nBins));
+    reference.Add(NewMesh(Form("reference%d", i), x, y, z, size, nBins));
+  }
+
+  FairRadGridManager manager;
+  manager.AddMeshList(&meshes);
+
+  // steps inside and outside of the meshes, the histograms are filled twice
+  const Int_t nSteps = 20000;
+  for (Int_t i = 0; i < nSteps; i++) {
+    mc.fPos.SetXYZT(random.Uniform(-60., 80.), random.Uniform(-60., 80.), random.Uniform(-60., 80.), 0.);
+    mc.fEdep = random.Exp(1.e-3);
+    mc.fStep = random.Exp(5.);
+    Double_t p = random.Exp(0.05);
+    stack.fParticle.SetMomentum(0., 0., p, p);
+    mc.fMom.SetXYZT(0., 0., p, p);
+
+    manager.FillMeshList();
+    FillReference(reference, mc, stack.fParticle);
+    if (i == nSteps / 2) { manager.FillMeshHistograms(); }
+  }
+  manager.FillMeshHistograms();
+
+  Double_t nScored = 0.;
+  for (Int_t i = 0; i < meshes.GetEntriesFast(); i++) {
+    FairMesh* mesh = static_cast<FairMesh*>(meshes.At(i));
+    FairMesh* expected = static_cast<FairMesh*>(reference.At(i));
+    nScored += expected->GetMeshTid()->GetEntries();
+    ExpectEqual(expected->GetMeshTid(), mesh->GetMeshTid());
+    ExpectEqual(expected->GetMeshFlu(), mesh->GetMeshFlu());
+    ExpectEqual(expected->GetMeshSEU(), mesh->GetMeshSEU());
+  }
+  EXPECT_GT(nScored, 0.);
+
+  meshes.Delete();
+  reference.Delete();
+}
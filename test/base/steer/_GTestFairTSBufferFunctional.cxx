@@ -0,0 +1,126 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#include "FairLogger.h"
+#include "FairRootManager.h"
+#include "FairTSBufferFunctional.h"
+#include "FairTimeStamp.h"
+
+#include "TClonesArray.h"
+#include "TRandom3.h"
+#include "TTree.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+// With the time index the buffer has to return for each window (start, stop]
+// all data later than start and not later than stop, and the same data as
+// without the index for a sequence of stop times.
+
+namespace
+{
+
+class TSBufferTest : public ::testing::Test
+{
+  protected:
+    TSBufferTest()
+      : fManager(), fDigis(new TClonesArray("FairTimeStamp")), fTree("T", "T"), fTimes() {}
+
+    virtual ~TSBufferTest() {
+      delete fDigis;
+    }
+
+    virtual void SetUp() {
+      FairLogger::GetLogger()->SetLogScreenLevel("ERROR");
+      fTree.SetDirectory(0);
+      fTree.Branch("Digi", &fDigis);
+      fManager.Register("Digi", "TSBufferTest", fDigis, kFALSE);
+
+      // entries of 100 ns with a mean of 3 data each, some entries are empty
+      TRandom3 random(31);
+      Double_t time = 0.;
+      for (Int_t entry = 0; entry < 500; entry++) {
+        fDigis->Clear();
+        Int_t n = 0;
+        if (entry % 7 != 3) {
+          while (time < (entry + 1) * 100.) {
+            new ((*fDigis)[n++]) FairTimeStamp(time);
+            fTimes.push_back(time);
+            time += random.Exp(33.);
+          }
+        } else {
+          time = (entry + 1) * 100.;
+        }
+        fTree.Fill();
+      }
+      fDigis->Clear();
+    }
+
+    std::vector<Double_t> Times(TClonesArray* data) {
+      std::vector<Double_t> times;
+      for (Int_t i = 0; i < data->GetEntriesFast(); i++) {
+        times.push_back(((FairTimeStamp*)data->At(i))->GetTimeStamp());
+      }
+      data->Delete();
+      return times;
+    }
+
+    std::vector<Double_t> Expected(Double_t start, Double_t stop) {
+      std::vector<Double_t> times;
+      for (size_t i = 0; i < fTimes.size(); i++) {
+        if (fTimes[i] > start && fTimes[i] <= stop) { times.push_back(fTimes[i]); }
+      }
+      return times;
+    }
+
+    FairRootManager fManager;
+    TClonesArray* fDigis;
+    TTree fTree;
+    std::vector<Double_t> fTimes;
+};
+
+}
+
+TEST_F(TSBufferTest, Windows)
+{
+  StopTime startFunctor, stopFunctor;
+  FairTSBufferFunctional buffer("Digi", &fTree, &stopFunctor, &startFunctor);
+
+  // forward, backward and beyond the data
+  TRandom3 random(5);
+  for (Int_t i = 0; i < 300; i++) {
+    Double_t start = random.Uniform(-1000., 51000.);
+    Double_t stop = start + random.Uniform(0., 500.);
+    EXPECT_EQ(Expected(start, stop), Times(buffer.GetData(start, stop))) << "window " << start << " " << stop;
+  }
+  EXPECT_EQ(Expected(-1., 200.), Times(buffer.GetData(-1., 200.)));
+  EXPECT_EQ(Expected(fTimes.back(), 1.e6), Times(buffer.GetData(fTimes.back(), 1.e6)));
+}
+
+TEST_F(TSBufferTest, StopTimes)
+{
+  std::vector<Double_t> linear, indexed;
+  for (Int_t useIndex = 0; useIndex < 2; useIndex++) {
+    StopTime startFunctor, stopFunctor;
+    FairTSBufferFunctional buffer("Digi", &fTree, &stopFunctor, &startFunctor);
+    buffer.SetTimeIndex(useIndex);
+    // the index is built with the first window, for which the linear search
+    // returns all data from the first entry on
+    std::vector<Double_t>& result = useIndex ? indexed : linear;
+    Times(buffer.GetData(-100., -50.));
+    std::vector<Double_t> first = Times(buffer.GetData(1000., 1500.));
+    result.insert(result.end(), first.begin(), first.end());
+    for (Double_t stop = 1600.; stop < 52000.; stop += 250.) {
+      std::vector<Double_t> times = Times(buffer.GetData(stop));
+      result.insert(result.end(), times.begin(), times.end());
+      result.push_back(-1.);
+    }
+    EXPECT_TRUE(buffer.AllDataProcessed());
+  }
+  EXPECT_EQ(linear, indexed);
+}
@@ -0,0 +1,133 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+// MC matching rate of FairMCMatch for [events] synthetic events with the
+// stages of Tutorial3 and [tracks] MC tracks each: every track leaves 1-3
+// points, every digi comes from 1-2 points and every hit from 1-3 digis.
+// The hits are matched back to the MC tracks and the MC tracks forward to
+// the hits, once with the recursive traversal and once with the link graph.
+// Usage: _BenchFairMCMatch [events] [tracks]
+
+#include "FairLink.h"
+#include "FairLinkManager.h"
+#include "FairLogger.h"
+#include "FairMCEntry.h"
+#include "FairMCMatch.h"
+#include "FairMCResult.h"
+#include "FairRootManager.h"
+#include "FairRunAna.h"
+
+#include "TClonesArray.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+#include <vector>
+
+namespace
+{
+
+enum { kMCTrack = 0, kPoint, kDigi, kHit };
+
+void CreateEvent(TClonesArray& entries, TRandom3& random, Int_t nTracks)
+{
+  entries.Clear();
+  std::set<FairLink> links;
+  Int_t nPoints = 0;
+  for (Int_t track = 0; track < nTracks; track++) {
+    new (entries[entries.GetEntriesFast()]) FairMCEntry(std::set<FairLink>(), kMCTrack, track);
+    Int_t n = 1 + random.Integer(3);
+    for (Int_t i = 0; i < n; i++) {
+      links.clear();
+      links.insert(FairLink(kMCTrack, track));
+      new (entries[entries.GetEntriesFast()]) FairMCEntry(links, kPoint, nPoints++);
+    }
+  }
+  Int_t nDigis = 2 * nPoints;
+  for (Int_t digi = 0; digi < nDigis; digi++) {
+    links.clear();
+    Int_t n = 1 + random.Integer(2);
+    for (Int_t i = 0; i < n; i++) {
+      links.insert(FairLink(kPoint, random.Integer(nPoints), random.Uniform(0.2, 1.)));
+    }
+    new (entries[entries.GetEntriesFast()]) FairMCEntry(links, kDigi, digi);
+  }
+  for (Int_t hit = 0; hit < nDigis / 2; hit++) {
+    links.clear();
+    Int_t n = 1 + random.Integer(3);
+    for (Int_t i = 0; i < n; i++) {
+      links.insert(FairLink(kDigi, random.Integer(nDigis), random.Uniform(0.5, 2.)));
+    }
+    new (entries[entries.GetEntriesFast()]) FairMCEntry(links, kHit, hit);
+  }
+}
+
+void Match(const char* what, const std::vector<TClonesArray*>& events, Int_t start, Int_t stop, Bool_t useGraph)
+{
+  FairMCMatch match("MCMatch", "MCMatch");
+  match.InitStage(kMCTrack, "", "MCTrack");
+  match.InitStage(kPoint, "", "FairTestDetectorPoint");
+  match.InitStage(kDigi, "", "FairTestDetectorDigi");
+  match.InitStage(kHit, "", "FairTestDetectorHit");
+  match.SetUseLinkGraph(useGraph);
+
+  Long64_t nLinks = 0;
+  TStopwatch timer;
+  timer.Start();
+  for (size_t i = 0; i < events.size(); i++) {
+    for (Int_t type = kMCTrack; type <= kHit; type++) {
+      match.GetMCStageType(type)->ClearEntries();
+    }
+    match.LoadInMCLists(events[i]);
+    FairMCResult result = match.GetMCInfo(start, stop);
+    for (Int_t j = 0; j < result.GetNEntries(); j++) {
+      nLinks += result.GetNLinks(j);
+    }
+  }
+  timer.Stop();
+  Double_t t = timer.RealTime();
+  printf("%-30s %10.3f s %12.1f events/s %10lld links\n", what, t, events.size() / t, nLinks);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  Int_t nEvents = argc > 1 ? atoi(argv[1]) : 100;
+  Int_t nTracks = argc > 2 ? atoi(argv[2]) : 200;
+
+  FairLogger::GetLogger()->SetLogScreenLevel("ERROR");
+
+  // the empty data arrays give the links added to the results no history
+  new FairRunAna();
+  FairRootManager* ioman = FairRootManager::Instance();
+  const char* names[] = { "MCTrack", "FairTestDetectorPoint", "FairTestDetectorDigi", "FairTestDetectorHit" };
+  for (Int_t type = kMCTrack; type <= kHit; type++) {
+    ioman->Register(names[type], "Tutorial3", new TClonesArray("FairMultiLinkedData"), kFALSE);
+    FairLinkManager::Instance()->AddIncludeType(type);
+  }
+
+  printf("Creating %d events with %d MC tracks\n", nEvents, nTracks);
+  TRandom3 random(11);
+  std::vector<TClonesArray*> events;
+  for (Int_t i = 0; i < nEvents; i++) {
+    events.push_back(new TClonesArray("FairMCEntry"));
+    CreateEvent(*events.back(), random, nTracks);
+  }
+
+  Match("hits to MC tracks, recursive", events, kHit, kMCTrack, kFALSE);
+  Match("hits to MC tracks, graph", events, kHit, kMCTrack, kTRUE);
+  Match("MC tracks to hits, recursive", events, kMCTrack, kHit, kFALSE);
+  Match("MC tracks to hits, graph", events, kMCTrack, kHit, kTRUE);
+
+  for (size_t i = 0; i < events.size(); i++) {
+    delete events[i];
+  }
+  return 0;
+}
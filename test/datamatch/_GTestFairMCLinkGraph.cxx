@@ -0,0 +1,221 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#include "FairLink.h"
+#include "FairLinkManager.h"
+#include "FairMCEntry.h"
+#include "FairMCLinkGraph.h"
+#include "FairMCMatch.h"
+#include "FairMCResult.h"
+#include "FairMCStage.h"
+#include "FairRootManager.h"
+#include "FairRunAna.h"
+
+#include "TClonesArray.h"
+#include "TMath.h"
+#include "TRandom3.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+
+// The link graph has to give the same matches as the recursive traversal of
+// FairMCMatch: for the link and stage weights, for data shared by several
+// entries, for entries without links and for links to unknown data.
+// The stages are those of Tutorial3, MCTrack <- Point <- Digi <- Hit.
+
+namespace
+{
+
+enum { kMCTrack = 0, kPoint, kDigi, kHit };
+
+void InitBranches()
+{
+  static FairRunAna* run = 0;
+  if (run == 0) {
+    // the link manager is needed by FairMultiLinkedData, the empty data
+    // arrays give the links added to the results no history
+    run = new FairRunAna();
+    FairRootManager* ioman = FairRootManager::Instance();
+    const char* names[] = { "MCTrack", "FairTestDetectorPoint", "FairTestDetectorDigi", "FairTestDetectorHit" };
+    for (Int_t type = kMCTrack; type <= kHit; type++) {
+      ioman->Register(names[type], "Tutorial3", new TClonesArray("FairMultiLinkedData"), kFALSE);
+      FairLinkManager::Instance()->AddIncludeType(type);
+    }
+  }
+}
+
+void AddEntry(TClonesArray& entries, Int_t type, Int_t pos, const std::set<FairLink>& links)
+{
+  new (entries[entries.GetEntriesFast()]) FairMCEntry(links, type, pos);
+}
+
+FairMCMatch* CreateEvent(Int_t seed, Int_t nTracks)
+{
+  InitBranches();
+  FairMCMatch* match = new FairMCMatch("MCMatch", "MCMatch");
+  match->InitStage(kMCTrack, "", "MCTrack");
+  match->InitStage(kPoint, "", "FairTestDetectorPoint");
+  match->InitStage(kDigi, "", "FairTestDetectorDigi");
+  match->InitStage(kHit, "", "FairTestDetectorHit");
+
+  TRandom3 random(seed);
+  TClonesArray entries("FairMCEntry");
+  std::set<FairLink> links;
+  Int_t nPoints = 0;
+  for (Int_t track = 0; track < nTracks; track++) {
+    AddEntry(entries, kMCTrack, track, std::set<FairLink>());
+    Int_t n = 1 + random.Integer(3);
+    for (Int_t i = 0; i < n; i++) {
+      links.clear();
+      links.insert(FairLink(kMCTrack, track));
+      AddEntry(entries, kPoint, nPoints++, links);
+    }
+  }
+  Int_t nDigis = 2 * nPoints;
+  for (Int_t digi = 0; digi < nDigis; digi++) {
+    links.clear();
+    // the first digi has no links
+    Int_t n = digi == 0 ? 0 : 1 + random.Integer(2);
+    for (Int_t i = 0; i < n; i++) {
+      links.insert(FairLink(kPoint, random.Integer(nPoints), random.Uniform(0.2, 1.)));
+    }
+    AddEntry(entries, kDigi, digi, links);
+  }
+  Int_t nHits = nDigis / 2;
+  for (Int_t hit = 0; hit < nHits; hit++) {
+    links.clear();
+    Int_t n = 1 + random.Integer(3);
+    for (Int_t i = 0; i < n; i++) {
+      // some links without weight
+      Float_t weight = random.Rndm() < 0.2 ? 0. : random.Uniform(0.5, 2.);
+      links.insert(FairLink(kDigi, random.Integer(nDigis), weight));
+    }
+    if (hit == 0) {
+      links.insert(FairLink(kDigi, nDigis + 1));
+    }
+    AddEntry(entries, kHit, hit, links);
+  }
+  match->LoadInMCLists(&entries);
+  return match;
+}
+
+void ExpectSameLinks(const FairMultiLinkedData& expected, const FairMultiLinkedData& actual)
+{
+  std::set<FairLink> a = expected.GetLinks();
+  std::set<FairLink> b = actual.GetLinks();
+  ASSERT_EQ(a.size(), b.size());
+  std::set<FairLink>::const_iterator j = b.begin();
+  for (std::set<FairLink>::const_iterator i = a.begin(); i != a.end(); i++, j++) {
+    EXPECT_EQ(i->GetType(), j->GetType());
+    EXPECT_EQ(i->GetIndex(), j->GetIndex());
+    EXPECT_NEAR(i->GetWeight(), j->GetWeight(), 1.e-4 * (1. + TMath::Abs(i->GetWeight())));
+  }
+}
+
+void ExpectSameResult(FairMCMatch* match, Int_t start, Int_t stop)
+{
+  match->SetUseLinkGraph(kFALSE);
+  FairMCResult expected = match->GetMCInfo(start, stop);
+  match->SetUseLinkGraph(kTRUE);
+  FairMCResult actual = match->GetMCInfo(start, stop);
+  // twice, the second time with the kept results
+  FairMCResult again = match->GetMCInfo(start, stop);
+
+  ASSERT_EQ(expected.GetNEntries(), actual.GetNEntries());
+  ASSERT_EQ(expected.GetNEntries(), again.GetNEntries());
+  for (Int_t i = 0; i < expected.GetNEntries(); i++) {
+    ExpectSameLinks(expected.GetEntry(i), actual.GetEntry(i));
+    ExpectSameLinks(expected.GetEntry(i), again.GetEntry(i));
+  }
+}
+
+}
+
+TEST(FairMCLinkGraph, BackwardToMCTrack)
+{
+  for (Int_t seed = 1; seed <= 3; seed++) {
+    FairMCMatch* match = CreateEvent(seed, 50);
+    ExpectSameResult(match, kHit, kMCTrack);
+    ExpectSameResult(match, kDigi, kMCTrack);
+    ExpectSameResult(match, kHit, kPoint);
+    delete match;
+  }
+}
+
+TEST(FairMCLinkGraph, BackwardStageWeights)
+{
+  FairMCMatch* match = CreateEvent(4, 50);
+  match->GetMCStageType(kDigi)->SetWeight(0.);
+  ExpectSameResult(match, kHit, kMCTrack);
+  match->GetMCStageType(kDigi)->SetWeight(0.5);
+  match->GetMCStageType(kPoint)->SetWeight(2.);
+  ExpectSameResult(match, kHit, kMCTrack);
+  delete match;
+}
+
+TEST(FairMCLinkGraph, ForwardToHit)
+{
+  FairMCMatch* match = CreateEvent(5, 5);
+  ExpectSameResult(match, kMCTrack, kHit);
+  ExpectSameResult(match, kPoint, kDigi);
+  delete match;
+}
+
+TEST(FairMCLinkGraph, RebuildAfterChange)
+{
+  FairMCMatch* match = CreateEvent(6, 20);
+  ExpectSameResult(match, kHit, kMCTrack);
+  match->AddElement(kHit, 0, FairLink(kDigi, 1, 3.));
+  ExpectSameResult(match, kHit, kMCTrack);
+  match->RemoveStage(kPoint);
+  ExpectSameResult(match, kHit, kMCTrack);
+  delete match;
+}
+
+TEST(FairMCLinkGraph, PrintBackward)
+{
+  InitBranches();
+  // two digis of the same point
+  FairMCStage tracks(kMCTrack, "", "MCTrack");
+  FairMCStage points(kPoint, "", "FairTestDetectorPoint");
+  FairMCStage digis(kDigi, "", "FairTestDetectorDigi");
+  std::set<FairLink> links;
+  tracks.SetEntry(FairMCEntry(links, kMCTrack, 0));
+  links.insert(FairLink(kMCTrack, 0));
+  points.SetEntry(FairMCEntry(links, kPoint, 0));
+  links.clear();
+  links.insert(FairLink(kPoint, 0));
+  digis.SetEntry(FairMCEntry(links, kDigi, 0));
+  digis.SetEntry(FairMCEntry(links, kDigi, 1));
+  std::map<Int_t, FairMCStage*> stages;
+  stages[kMCTrack] = &tracks;
+  stages[kPoint] = &points;
+  stages[kDigi] = &digis;
+
+  FairMCLinkGraph graph;
+  graph.Build(stages);
+  links.clear();
+  links.insert(FairLink(kDigi, 0));
+  links.insert(FairLink(kDigi, 1));
+  FairMultiLinkedData start(links, kFALSE);
+  FairMultiLinkedData result;
+  graph.GetLinksBackward(start, kMCTrack, result);
+
+  std::ostringstream out;
+  graph.PrintLinksBackward(start, kMCTrack, out);
+  std::string trace = out.str();
+  // the point is printed with its track once, below the second digi it is referred to
+  EXPECT_NE(std::string::npos, trace.find(" stop stage"));
+  EXPECT_EQ(trace.find(" stop stage"), trace.rfind(" stop stage"));
+  EXPECT_NE(std::string::npos, trace.find(" --> 1 links, see above"));
+  EXPECT_EQ(5, std::count(trace.begin(), trace.end(), '\n'));
+}
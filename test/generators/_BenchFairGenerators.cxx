@@ -0,0 +1,273 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+// Parse rate of FairUrqmdGenerator and FairAsciiGenerator for synthetic
+// input files of [events] events with [tracks] tracks each. For comparison
+// the files are also parsed with fgets/fscanf and ifstream as done by the
+// generators before. Afterwards SkipEvents to the last event is timed once
+// without and once with the event index.
+// Usage: _BenchFairGenerators [events] [tracks]
+
+#include "FairAsciiGenerator.h"
+#include "FairLogger.h"
+#include "FairPrimaryGenerator.h"
+#include "FairUrqmdGenerator.h"
+
+#include "TMath.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+#include "TString.h"
+#include "TSystem.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+namespace
+{
+
+class TrackCounter : public FairPrimaryGenerator
+{
+  public:
+    TrackCounter() : FairPrimaryGenerator(), fNTracks(0) {}
+    virtual void AddTrack(Int_t, Double_t, Double_t, Double_t,
+                          Double_t, Double_t, Double_t,
+                          Int_t, Bool_t, Double_t, Double_t, Double_t) {
+      fNTracks++;
+    }
+    Long64_t fNTracks;
+};
+
+void WriteUrqmd(const char* fileName, const char* tableName, Int_t nEvents, Int_t nTracks)
+{
+  FILE* table = fopen(tableName, "w");
+  fprintf(table, "3001 2212\n2001 2112\n3101 211\n1101 -211\n");
+  fclose(table);
+
+  const Int_t ityp[] = { 1, 1, 101, 101 };
+  const Int_t ichg[] = { 1, 0, 1, -1 };
+  TRandom3 random(7);
+  FILE* f = fopen(fileName, "w");
+  for (Int_t iev = 0; iev < nEvents; iev++) {
+    fprintf(f, "UQMD   version:       10035   1000  10002  output_file  14\n");
+    fprintf(f, "projectile:  (mass, char)  197  79   target:  (mass, char)  197  79 \n");
+    fprintf(f, "transformation betas (NN,lab,pro)     0.0000000  0.9631836 -0.9631836\n");
+    fprintf(f, "impact_parameter_real/min/max(fm):    %4.2f  0.00  0.00  total_cross_section(mbarn):       0.00\n",
+            random.Uniform(0., 5.));
+    fprintf(f, "equation_of_state:    0  E_lab(GeV/u): 0.2408E+02  sqrt(s)(GeV): 0.6978E+01  p_lab(GeV/u): 0.2500E+02\n");
+    fprintf(f, "event#%10d random seed:  1199995095 (auto)   total_time(fm/c):   100 Delta(t)_O(fm/c):  100.000\n",
+            iev + 1);
+    for (Int_t i = 0; i < 3; i++) {
+      fprintf(f, "op  0    0    0    0    0    0    0    0    0    0    0    0    0    0    0  \n");
+    }
+    for (Int_t i = 0; i < 4; i++) {
+      fprintf(f, "pa 0.1000E+01   0.5200E+00   0.2000E+01   0.3000E+00   0.0000E+00   0.3700E+00  \n");
+    }
+    fprintf(f, "pvec: r0              rx              ry              rz              p0              px              py              pz\n");
+    fprintf(f, " %d 100\n", nTracks);
+    fprintf(f, "    4603    1073    3529       1    1622    3591       0       0\n");
+    for (Int_t i = 0; i < nTracks; i++) {
+      Int_t type = i % 4;
+      Double_t px = random.Gaus(0., 0.3), py = random.Gaus(0., 0.3), pz = random.Gaus(0., 1.);
+      fprintf(f, "%16.8E%16.8E%16.8E%16.8E%16.8E%16.8E%16.8E%16.8E%16.8E%5d%3d%3d%6d%5d%4d\n",
+              100., random.Gaus(0., 30.), random.Gaus(0., 30.), random.Gaus(0., 30.),
+              TMath::Sqrt(px*px + py*py + pz*pz + 0.88), px, py, pz, 0.938,
+              ityp[type], -1, ichg[type], i + 1, 31, 20);
+    }
+  }
+  fclose(f);
+}
+
+void WriteAscii(const char* fileName, Int_t nEvents, Int_t nTracks)
+{
+  TRandom3 random(11);
+  FILE* f = fopen(fileName, "w");
+  for (Int_t iev = 0; iev < nEvents; iev++) {
+    fprintf(f, "%d %d %g %g %g\n", nTracks, iev + 1, random.Gaus(0., 0.1), random.Gaus(0., 0.1), random.Gaus());
+    for (Int_t i = 0; i < nTracks; i++) {
+      fprintf(f, "211 %.6e %.6e %.6e\n", random.Gaus(0., 0.3), random.Gaus(0., 0.3), random.Uniform(0.5, 5.));
+    }
+  }
+  fclose(f);
+}
+
+/** the fgets/fscanf sequence of the former FairUrqmdGenerator */
+Long64_t ParseUrqmdStdio(const char* fileName)
+{
+  FILE* f = fopen(fileName, "r");
+  char read[200];
+  Long64_t nTracks = 0;
+  for (;;) {
+    int i1 = 0, ntracks = 0;
+    float x = 0.;
+    fgets(read, 200, f);
+    if (feof(f)) { break; }
+    fgets(read, 26, f);
+    fscanf(f, "%d", &i1);
+    fscanf(f, "%d", &i1);
+    fgets(read, 25, f);
+    fscanf(f, "%d", &i1);
+    fscanf(f, "%d", &i1);
+    fgets(read, 200, f);
+    fgets(read, 200, f);
+    fgets(read, 36, f);
+    fscanf(f, "%f", &x);
+    fgets(read, 200, f);
+    fgets(read, 39, f);
+    fscanf(f, "%e", &x);
+    fgets(read, 200, f);
+    fgets(read, 7, f);
+    fscanf(f, "%d", &i1);
+    fgets(read, 200, f);
+    for (int iline = 0; iline < 8; iline++) { fgets(read, 200, f); }
+    fscanf(f, "%d", &ntracks);
+    fgets(read, 200, f);
+    fgets(read, 200, f);
+    for (int itrack = 0; itrack < ntracks; itrack++) {
+      float ppx, ppy, ppz, m;
+      int ityp, i3, ichg;
+      fgets(read, 81, f);
+      fscanf(f, "%e", &ppx);
+      fscanf(f, "%e", &ppy);
+      fscanf(f, "%e", &ppz);
+      fscanf(f, "%e", &m);
+      fscanf(f, "%d", &ityp);
+      fscanf(f, "%d", &i3);
+      fscanf(f, "%d", &ichg);
+      fgets(read, 200, f);
+      nTracks++;
+    }
+  }
+  fclose(f);
+  return nTracks;
+}
+
+/** the stream parsing of the former FairAsciiGenerator */
+Long64_t ParseAsciiStream(const char* fileName)
+{
+  std::ifstream in(fileName);
+  Long64_t nTracks = 0;
+  for (;;) {
+    Int_t ntracks = 0, eventID = 0, pdgID = 0;
+    Double_t vx, vy, vz, px, py, pz;
+    in >> ntracks >> eventID >> vx >> vy >> vz;
+    if (in.eof()) { break; }
+    for (Int_t i = 0; i < ntracks; i++) {
+      in >> pdgID >> px >> py >> pz;
+      nTracks++;
+    }
+  }
+  return nTracks;
+}
+
+void Print(const char* what, Long64_t nTracks, Double_t mBytes, TStopwatch& timer)
+{
+  Double_t t = timer.RealTime();
+  printf("%-28s %10.3f s %12.0f tracks/s %8.1f MB/s\n", what, t, nTracks / t, mBytes / t);
+}
+
+template<class Generator>
+Long64_t ReadAll(Generator& gen)
+{
+  TrackCounter counter;
+  while (gen.ReadEvent(&counter)) {}
+  return counter.fNTracks;
+}
+
+TString gTableFile;
+
+FairUrqmdGenerator* OpenUrqmd(const char* fileName)
+{
+  return new FairUrqmdGenerator(fileName, gTableFile);
+}
+
+FairAsciiGenerator* OpenAscii(const char* fileName)
+{
+  return new FairAsciiGenerator(fileName);
+}
+
+template<class Generator>
+void TimeSkip(const char* name, const TString& fileName, Generator* (*open)(const char*), Int_t nEvents)
+{
+  for (Int_t withIndex = 0; withIndex < 2; withIndex++) {
+    if (!withIndex) { gSystem->Unlink(fileName + ".idx"); }
+    TStopwatch timer;
+    timer.Start();
+    Generator* gen = open(fileName);
+    gen->SkipEvents(nEvents - 1);
+    TrackCounter counter;
+    Bool_t ok = gen->ReadEvent(&counter);
+    delete gen;
+    timer.Stop();
+    printf("%-28s %10.3f s %s\n", Form("%s skip to last, %s", name, withIndex ? "index" : "no index"),
+           timer.RealTime(), ok ? "" : "(failed)");
+  }
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  Int_t nEvents = argc > 1 ? atoi(argv[1]) : 2000;
+  Int_t nTracks = argc > 2 ? atoi(argv[2]) : 1000;
+
+  FairLogger::GetLogger()->SetLogScreenLevel("ERROR");
+
+  TString dir = gSystem->TempDirectory();
+  TString urqmdFile = Form("%s/_BenchFairGenerators_%d.ftn14", dir.Data(), gSystem->GetPid());
+  gTableFile = Form("%s/_BenchFairGenerators_%d_pdg.dat", dir.Data(), gSystem->GetPid());
+  TString asciiFile = Form("%s/_BenchFairGenerators_%d.dat", dir.Data(), gSystem->GetPid());
+
+  printf("Writing %d events with %d tracks each\n", nEvents, nTracks);
+  WriteUrqmd(urqmdFile, gTableFile, nEvents, nTracks);
+  WriteAscii(asciiFile, nEvents, nTracks);
+
+  FileStat_t stat;
+  gSystem->GetPathInfo(urqmdFile, stat);
+  Double_t urqmdMB = stat.fSize / 1.e6;
+  gSystem->GetPathInfo(asciiFile, stat);
+  Double_t asciiMB = stat.fSize / 1.e6;
+
+  TStopwatch timer;
+  Long64_t n;
+
+  timer.Start();
+  n = ParseUrqmdStdio(urqmdFile);
+  timer.Stop();
+  Print("UrQMD fgets/fscanf", n, urqmdMB, timer);
+
+  timer.Start();
+  {
+    FairUrqmdGenerator gen(urqmdFile, gTableFile);
+    n = ReadAll(gen);
+  }
+  timer.Stop();
+  Print("FairUrqmdGenerator", n, urqmdMB, timer);
+
+  timer.Start();
+  n = ParseAsciiStream(asciiFile);
+  timer.Stop();
+  Print("Ascii ifstream", n, asciiMB, timer);
+
+  timer.Start();
+  {
+    FairAsciiGenerator gen(asciiFile);
+    n = ReadAll(gen);
+  }
+  timer.Stop();
+  Print("FairAsciiGenerator", n, asciiMB, timer);
+
+  TimeSkip("UrQMD", urqmdFile, OpenUrqmd, nEvents);
+  TimeSkip("Ascii", asciiFile, OpenAscii, nEvents);
+
+  gSystem->Unlink(urqmdFile);
+  gSystem->Unlink(urqmdFile + ".idx");
+  gSystem->Unlink(gTableFile);
+  gSystem->Unlink(asciiFile);
+  gSystem->Unlink(asciiFile + ".idx");
+  return 0;
+}
@@ -0,0 +1,227 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#include "FairAsciiGenerator.h"
+#include "FairBufferedInput.h"
+#include "FairLogger.h"
+#include "FairPrimaryGenerator.h"
+
+#include "TMath.h"
+#include "TRandom3.h"
+#include "TString.h"
+#include "TSystem.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// The buffered input has to give the same numbers as the C library and
+// the same lines as fgets. The event index has to bring a new reader to
+// the same events as reading the file from the start.
+
+namespace
+{
+
+TString TempFile(const char* name)
+{
+  return Form("%s/_GTestFairBufferedInput_%d_%s", gSystem->TempDirectory(), gSystem->GetPid(), name);
+}
+
+void RemoveFile(const TString& name)
+{
+  gSystem->Unlink(name);
+  gSystem->Unlink(name + ".idx");
+}
+
+// numbers in the formats of the generator input files
+std::vector<std::string> WriteNumbers(const char* fileName, Int_t n)
+{
+  TRandom3 random(4357);
+  std::vector<std::string> words;
+  FILE* f = fopen(fileName, "w");
+  for (Int_t i = 0; i < n; i++) {
+    Double_t value = random.Uniform(-1., 1.) * TMath::Power(10., random.Integer(40) - 20.);
+    char word[64];
+    switch (i % 5) {
+      case 0: snprintf(word, sizeof(word), "%16.8E", value); break;
+      case 1: snprintf(word, sizeof(word), "%.17g", value); break;
+      case 2: snprintf(word, sizeof(word), "%.6f", value); break;
+      case 3: snprintf(word, sizeof(word), "%.25e", value); break;
+      default: snprintf(word, sizeof(word), "%d", static_cast<Int_t>(random.Integer(200000)) - 100000);
+    }
+    words.push_back(word);
+    fprintf(f, "%s%s", word, (i % 7 == 6) ? "\n" : " ");
+  }
+  fclose(f);
+  return words;
+}
+
+// tracks of all events written to an Ascii input file
+class TrackRecorder : public FairPrimaryGenerator
+{
+  public:
+    std::vector<Double_t> fValues;
+    virtual void AddTrack(Int_t pdgid, Double_t px, Double_t py, Double_t pz,
+                          Double_t vx, Double_t vy, Double_t vz,
+                          Int_t, Bool_t, Double_t, Double_t, Double_t) {
+      fValues.push_back(pdgid);
+      fValues.push_back(px);
+      fValues.push_back(py);
+      fValues.push_back(pz);
+      fValues.push_back(vx);
+      fValues.push_back(vy);
+      fValues.push_back(vz);
+    }
+};
+
+void WriteAsciiEvents(const char* fileName, Int_t nEvents)
+{
+  TRandom3 random(19);
+  FILE* f = fopen(fileName, "w");
+  for (Int_t iev = 0; iev < nEvents; iev++) {
+    Int_t nTracks = 1 + random.Integer(20);
+    fprintf(f, "%d %d %g %g %g\n", nTracks, iev + 1, random.Gaus(), random.Gaus(), random.Gaus());
+    for (Int_t i = 0; i < nTracks; i++) {
+      fprintf(f, "%d %.6e %.6e %.6e\n", 211, random.Gaus(), random.Gaus(), random.Uniform(1., 10.));
+    }
+  }
+  fclose(f);
+}
+
+}
+
+TEST(FairBufferedInput, Numbers)
+{
+  TString fileName = TempFile("numbers");
+  std::vector<std::string> words = WriteNumbers(fileName, 100000);
+
+  FairBufferedInput input(fileName, "test");
+  ASSERT_TRUE(input.IsOpen());
+  for (size_t i = 0; i < words.size(); i++) {
+    const char* word = words[i].c_str();
+    if (i % 5 == 4) {
+      Int_t value = 0;
+      ASSERT_TRUE(input.ReadInt(value));
+      EXPECT_EQ(atoi(word), value) << word;
+    } else if (i % 2 == 0) {
+      Float_t value = 0.;
+      ASSERT_TRUE(input.ReadFloat(value));
+      EXPECT_EQ(strtof(word, NULL), value) << word;
+    } else {
+      Double_t value = 0.;
+      ASSERT_TRUE(input.ReadDouble(value));
+      EXPECT_EQ(strtod(word, NULL), value) << word;
+    }
+  }
+  Double_t value = 0.;
+  EXPECT_FALSE(input.ReadDouble(value));
+  EXPECT_TRUE(input.IsEof());
+
+  RemoveFile(fileName);
+}
+
+TEST(FairBufferedInput, Gets)
+{
+  TString fileName = TempFile("lines");
+  WriteNumbers(fileName, 100000);
+
+  FILE* f = fopen(fileName, "r");
+  FairBufferedInput input(fileName, "test");
+  const Int_t sizes[] = { 7, 26, 81, 200, 3 };
+  char expected[200], line[200];
+  for (Int_t i = 0; ; i++) {
+    Int_t size = sizes[i % 5];
+    Bool_t found = fgets(expected, size, f) != NULL;
+    ASSERT_EQ(found, input.Gets(line, size));
+    if (!found) { break; }
+    EXPECT_STREQ(expected, line);
+    EXPECT_EQ(feof(f) != 0, input.IsEof());
+  }
+  fclose(f);
+
+  RemoveFile(fileName);
+}
+
+TEST(FairBufferedInput, EventIndex)
+{
+  TString fileName = TempFile("index");
+  WriteNumbers(fileName, 1000);
+
+  // every 10th number starts an event
+  std::vector<Long64_t> offsets;
+  {
+    FairBufferedInput input(fileName, "test");
+    for (Int_t i = 0; i < 1000; i++) {
+      ASSERT_TRUE(input.SkipSpace());
+      if (i % 10 == 0) {
+        offsets.push_back(input.Tell());
+        input.IndexEvent(input.Tell());
+      }
+      input.SkipWord();
+    }
+  }
+
+  FairBufferedInput input(fileName, "test");
+  ASSERT_EQ(100, input.GetNIndexed());
+  EXPECT_TRUE(input.SeekEvent(99));
+  EXPECT_EQ(offsets[99], input.Tell());
+  EXPECT_TRUE(input.SeekEvent(3));
+  EXPECT_EQ(offsets[3], input.Tell());
+  EXPECT_EQ(3, input.GetEventNumber());
+  EXPECT_FALSE(input.SeekEvent(100));
+
+  // an index written for another format is not used
+  FairBufferedInput other(fileName, "other");
+  EXPECT_EQ(0, other.GetNIndexed());
+
+  RemoveFile(fileName);
+}
+
+TEST(FairAsciiGenerator, SkipEvents)
+{
+  FairLogger::GetLogger()->SetLogScreenLevel("ERROR");
+  TString fileName = TempFile("events.dat");
+  WriteAsciiEvents(fileName, 200);
+
+  // all events read in sequence, the index is written at the end
+  std::vector<Int_t> eventStart;
+  TrackRecorder all;
+  {
+    FairAsciiGenerator gen(fileName);
+    for (;;) {
+      eventStart.push_back(all.fValues.size());
+      if (!gen.ReadEvent(&all)) { break; }
+    }
+  }
+  ASSERT_EQ(201u, eventStart.size());
+  ASSERT_FALSE(gSystem->AccessPathName(fileName + ".idx"));
+
+  // with the index and without it
+  for (Int_t withIndex = 1; withIndex >= 0; withIndex--) {
+    if (!withIndex) { gSystem->Unlink(fileName + ".idx"); }
+    FairAsciiGenerator gen(fileName);
+    const Int_t skips[] = { 150, 0, 7, 30 };
+    Int_t event = 0;
+    for (Int_t i = 0; i < 4; i++) {
+      ASSERT_TRUE(gen.SkipEvents(skips[i]));
+      event += skips[i];
+      TrackRecorder one;
+      ASSERT_TRUE(gen.ReadEvent(&one));
+      std::vector<Double_t> expected(all.fValues.begin() + eventStart[event],
+                                     all.fValues.begin() + eventStart[event+1]);
+      EXPECT_EQ(expected, one.fValues) << "event " << event << " index " << withIndex;
+      event++;
+    }
+    EXPECT_FALSE(gen.SkipEvents(100));
+  }
+
+  RemoveFile(fileName);
+}
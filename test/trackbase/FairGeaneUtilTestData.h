@@ -0,0 +1,106 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#ifndef FAIRGEANEUTILTESTDATA_H
+#define FAIRGEANEUTILTESTDATA_H
+
+// Reproducible track parameters and covariance matrices for the tests and the
+// benchmark of the batched FairGeaneUtil transformations. All arrays are in the
+// structure of arrays layout of the batched routines (element e of track t at e*N+t).
+
+#include <cmath>
+#include <vector>
+
+class FairGeaneUtilTestData
+{
+  public:
+    explicit FairGeaneUtilTestData(int n)
+      : N(n), PC(3*n), RC(15*n), PD(3*n), RD(36*n), A(25*n),
+        H(3*n), DJ(3*n), DK(3*n), SP(n), CH(n), fSeed(12345)
+    {
+      for (int t = 0; t < N; t++) {
+        // q/p, lambda, phi (or v', w') of a track which is not parallel to the plane
+        PC[0*N+t] = (Uniform() < 0.5 ? -1. : 1.) * (0.2 + 2. * Uniform());
+        PC[1*N+t] = 1.2 * (Uniform() - 0.5);
+        PC[2*N+t] = 1.2 * (Uniform() - 0.5);
+
+        PD[0*N+t] = 2. * (Uniform() - 0.5);
+        PD[1*N+t] = 2. * (Uniform() - 0.5);
+        PD[2*N+t] = 0.5 + 2. * Uniform();
+
+        H[0*N+t] = 0.;
+        H[1*N+t] = 0.;
+        H[2*N+t] = 10. + 10. * Uniform();
+
+        CH[t] = (t % 3 == 0) ? 1 : -1;
+        SP[t] = (t % 2 == 0) ? 1. : -1.;
+
+        // detector plane tilted around the x axis
+        double angle = 0.5 * (Uniform() - 0.5);
+        DJ[0*N+t] = 1.;
+        DJ[1*N+t] = 0.;
+        DJ[2*N+t] = 0.;
+        DK[0*N+t] = 0.;
+        DK[1*N+t] = cos(angle);
+        DK[2*N+t] = sin(angle);
+
+        // positive definite covariance matrices L*LT
+        double L5[5][5], L6[6][6];
+        Lower(&L5[0][0], 5);
+        Lower(&L6[0][0], 6);
+        int k = 0;
+        for (int i = 0; i < 5; i++) {
+          for (int j = i; j < 5; j++) {
+            double sum = 0.;
+            for (int m = 0; m < 5; m++) { sum += L5[i][m] * L5[j][m]; }
+            RC[k*N+t] = sum;
+            k++;
+          }
+        }
+        for (int i = 0; i < 6; i++) {
+          for (int j = 0; j < 6; j++) {
+            double sum = 0.;
+            for (int m = 0; m < 6; m++) { sum += L6[i][m] * L6[j][m]; }
+            RD[(6*i+j)*N+t] = sum;
+          }
+        }
+
+        // general 5x5 transformation matrix
+        for (int e = 0; e < 25; e++) { A[e*N+t] = 2. * (Uniform() - 0.5); }
+      }
+    }
+
+    /// copy element e of track t of an SoA array into a single track array
+    static void Get(const std::vector<double>& soa, int N, int t, int ne, double* out)
+    {
+      for (int e = 0; e < ne; e++) { out[e] = soa[e*N+t]; }
+    }
+
+    int N;
+    std::vector<double> PC, RC, PD, RD, A, H, DJ, DK, SP;
+    std::vector<int> CH;
+
+  private:
+    void Lower(double* L, int n)
+    {
+      for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+          L[i*n+j] = (j < i) ? 0.01 * (Uniform() - 0.5) : (j == i ? 0.01 + 0.1 * Uniform() : 0.);
+        }
+      }
+    }
+
+    double Uniform()
+    {
+      fSeed = fSeed * 6364136223846793005ULL + 1442695040888963407ULL;
+      return (fSeed >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    unsigned long long fSeed;
+};
+
+#endif
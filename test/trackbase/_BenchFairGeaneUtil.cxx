@@ -0,0 +1,141 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+// Time per conversion of the single track and the batched FairGeaneUtil
+// transformations. Usage: _BenchFairGeaneUtil [tracks] [repetitions]
+
+#include "FairGeaneUtil.h"
+
+#include "FairGeaneUtilTestData.h"
+
+#include "TStopwatch.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+
+void Print(const char* name, double scalar, double batch, int nConversions)
+{
+  printf("%-18s scalar %8.1f ns   batch %8.1f ns   speedup %5.2f\n", name,
+         1.e9 * scalar / nConversions, 1.e9 * batch / nConversions, scalar / batch);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  int N = argc > 1 ? atoi(argv[1]) : 10000;
+  int nRepetitions = argc > 2 ? atoi(argv[2]) : 20;
+  int nConversions = N * nRepetitions;
+
+  FairGeaneUtilTestData d(N);
+  FairGeaneUtil util;
+  TStopwatch timer;
+
+  std::vector<double> P3(3*N), R15(15*N), R36(36*N), SP(N);
+  std::vector<int> IERR(N);
+  double PC[3], RC[15], H[3], DJ[3], DK[3], PD[3], RD[15], A[25], spu;
+  FairGeaneUtil::sixMat RD6;
+  int ierr;
+
+  // SymmProd
+  timer.Start();
+  for (int r = 0; r < nRepetitions; r++) {
+    for (int t = 0; t < N; t++) {
+      FairGeaneUtilTestData::Get(d.A, N, t, 25, A);
+      FairGeaneUtilTestData::Get(d.RC, N, t, 15, RC);
+      util.SymmProd(A, RC, RD);
+    }
+  }
+  double scalar = timer.RealTime();
+  timer.Start();
+  for (int r = 0; r < nRepetitions; r++) {
+    util.SymmProd(N, &d.A[0], &d.RC[0], &R15[0]);
+  }
+  Print("SymmProd", scalar, timer.RealTime(), nConversions);
+
+  // FromPtToSC
+  timer.Start();
+  for (int r = 0; r < nRepetitions; r++) {
+    for (int t = 0; t < N; t++) {
+      FairGeaneUtilTestData::Get(d.PC, N, t, 3, PC);
+      FairGeaneUtilTestData::Get(d.RC, N, t, 15, RC);
+      util.FromPtToSC(PC, RC, PD, RD, ierr);
+    }
+  }
+  scalar = timer.RealTime();
+  timer.Start();
+  for (int r = 0; r < nRepetitions; r++) {
+    util.FromPtToSC(N, &d.PC[0], &d.RC[0], &P3[0], &R15[0], &IERR[0]);
+  }
+  Print("FromPtToSC", scalar, timer.RealTime(), nConversions);
+
+  // FromSCToSD
+  timer.Start();
+  for (int r = 0; r < nRepetitions; r++) {
+    for (int t = 0; t < N; t++) {
+      FairGeaneUtilTestData::Get(d.PC, N, t, 3, PC);
+      FairGeaneUtilTestData::Get(d.RC, N, t, 15, RC);
+      FairGeaneUtilTestData::Get(d.H, N, t, 3, H);
+      FairGeaneUtilTestData::Get(d.DJ, N, t, 3, DJ);
+      FairGeaneUtilTestData::Get(d.DK, N, t, 3, DK);
+      util.FromSCToSD(PC, RC, H, d.CH[t], DJ, DK, ierr, spu, PD, RD);
+    }
+  }
+  scalar = timer.RealTime();
+  timer.Start();
+  for (int r = 0; r < nRepetitions; r++) {
+    util.FromSCToSD(N, &d.PC[0], &d.RC[0], &d.H[0], &d.CH[0], &d.DJ[0], &d.DK[0],
+                    &IERR[0], &SP[0], &P3[0], &R15[0]);
+  }
+  Print("FromSCToSD", scalar, timer.RealTime(), nConversions);
+
+  // FromSDToMars
+  timer.Start();
+  for (int r = 0; r < nRepetitions; r++) {
+    for (int t = 0; t < N; t++) {
+      FairGeaneUtilTestData::Get(d.PC, N, t, 3, PC);
+      FairGeaneUtilTestData::Get(d.RC, N, t, 15, RC);
+      FairGeaneUtilTestData::Get(d.H, N, t, 3, H);
+      FairGeaneUtilTestData::Get(d.DJ, N, t, 3, DJ);
+      FairGeaneUtilTestData::Get(d.DK, N, t, 3, DK);
+      util.FromSDToMars(PC, RC, H, d.CH[t], d.SP[t], DJ, DK, PD, RD6);
+    }
+  }
+  scalar = timer.RealTime();
+  timer.Start();
+  for (int r = 0; r < nRepetitions; r++) {
+    util.FromSDToMars(N, &d.PC[0], &d.RC[0], &d.H[0], &d.CH[0], &d.SP[0], &d.DJ[0], &d.DK[0],
+                      &P3[0], &R36[0]);
+  }
+  Print("FromSDToMars", scalar, timer.RealTime(), nConversions);
+
+  // FromMarsToSD
+  timer.Start();
+  for (int r = 0; r < nRepetitions; r++) {
+    for (int t = 0; t < N; t++) {
+      FairGeaneUtilTestData::Get(d.PD, N, t, 3, PD);
+      FairGeaneUtilTestData::Get(d.RD, N, t, 36, &RD6[0][0]);
+      FairGeaneUtilTestData::Get(d.H, N, t, 3, H);
+      FairGeaneUtilTestData::Get(d.DJ, N, t, 3, DJ);
+      FairGeaneUtilTestData::Get(d.DK, N, t, 3, DK);
+      util.FromMarsToSD(PD, RD6, H, d.CH[t], DJ, DK, ierr, spu, PC, RC);
+    }
+  }
+  scalar = timer.RealTime();
+  timer.Start();
+  for (int r = 0; r < nRepetitions; r++) {
+    util.FromMarsToSD(N, &d.PD[0], &d.RD[0], &d.H[0], &d.CH[0], &d.DJ[0], &d.DK[0],
+                      &IERR[0], &SP[0], &P3[0], &R15[0]);
+  }
+  Print("FromMarsToSD", scalar, timer.RealTime(), nConversions);
+
+  return 0;
+}
@@ -0,0 +1,188 @@
+/********************************************************************************
+ *    Copyright (C) 2014 GSI Helmholtzzentrum fuer Schwerionenforschung GmbH    *
+ *                                                                              *
+ *              This software is distributed under the terms of the             *
+ *         GNU Lesser General Public Licence version 3 (LGPL) version 3,        *
+ *                  copied verbatim in the file "LICENSE"                       *
+ ********************************************************************************/
+#include "FairGeaneUtil.h"
+
+#include "FairGeaneUtilTestData.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// The batched transformations have to give the same results as the single
+// track routines. The arithmetic is done in the same order, only the 3x3
+// rotations of the momentum are summed differently than in TMatrixT, so a
+// relative tolerance close to the double precision is used.
+
+namespace
+{
+
+const double kTolerance = 1.e-12;
+
+// size which leaves a partial block of tracks
+const int kNumTracks = 103;
+
+void ExpectNear(const double* expected, const std::vector<double>& soa, int N, int t, int ne, const char* what)
+{
+  for (int e = 0; e < ne; e++) {
+    double value = soa[e*N+t];
+    double scale = std::max(1., std::fabs(expected[e]));
+    EXPECT_NEAR(expected[e], value, kTolerance * scale) << what << " track " << t << " element " << e;
+  }
+}
+
+}
+
+TEST(FairGeaneUtilBatch, SymmProd)
+{
+  FairGeaneUtilTestData d(kNumTracks);
+  FairGeaneUtil util;
+
+  std::vector<double> R(15*d.N);
+  util.SymmProd(d.N, &d.A[0], &d.RC[0], &R[0]);
+
+  for (int t = 0; t < d.N; t++) {
+    double A[25], S[15], Rs[15];
+    FairGeaneUtilTestData::Get(d.A, d.N, t, 25, A);
+    FairGeaneUtilTestData::Get(d.RC, d.N, t, 15, S);
+    util.SymmProd(A, S, Rs);
+    ExpectNear(Rs, R, d.N, t, 15, "R");
+  }
+
+  // in place, as done by the single track routines
+  std::vector<double> S(d.RC);
+  util.SymmProd(d.N, &d.A[0], &S[0], &S[0]);
+  for (int e = 0; e < 15*d.N; e++) {
+    EXPECT_EQ(R[e], S[e]);
+  }
+}
+
+TEST(FairGeaneUtilBatch, FromVec15ToMat25)
+{
+  FairGeaneUtilTestData d(kNumTracks);
+  FairGeaneUtil util;
+
+  std::vector<double> A(25*d.N);
+  util.FromVec15ToMat25(d.N, &d.RC[0], &A[0]);
+
+  for (int t = 0; t < d.N; t++) {
+    double V[15];
+    FairGeaneUtil::fiveMat As;
+    FairGeaneUtilTestData::Get(d.RC, d.N, t, 15, V);
+    util.FromVec15ToMat25(V, As);
+    ExpectNear(&As[0][0], A, d.N, t, 25, "A");
+  }
+}
+
+TEST(FairGeaneUtilBatch, FromPtToSC)
+{
+  FairGeaneUtilTestData d(kNumTracks);
+  FairGeaneUtil util;
+
+  std::vector<double> PD(3*d.N), RD(15*d.N);
+  std::vector<int> IERR(d.N);
+  util.FromPtToSC(d.N, &d.PC[0], &d.RC[0], &PD[0], &RD[0], &IERR[0]);
+
+  for (int t = 0; t < d.N; t++) {
+    double PC[3], RC[15], PDs[3], RDs[15];
+    int ierr;
+    FairGeaneUtilTestData::Get(d.PC, d.N, t, 3, PC);
+    FairGeaneUtilTestData::Get(d.RC, d.N, t, 15, RC);
+    util.FromPtToSC(PC, RC, PDs, RDs, ierr);
+    ASSERT_EQ(ierr, IERR[t]);
+    ExpectNear(PDs, PD, d.N, t, 3, "PD");
+    ExpectNear(RDs, RD, d.N, t, 15, "RD");
+  }
+}
+
+TEST(FairGeaneUtilBatch, FromSCToSD)
+{
+  FairGeaneUtilTestData d(kNumTracks);
+  FairGeaneUtil util;
+
+  std::vector<double> PD(3*d.N), RD(15*d.N), SPU(d.N);
+  std::vector<int> IERR(d.N);
+  util.FromSCToSD(d.N, &d.PC[0], &d.RC[0], &d.H[0], &d.CH[0], &d.DJ[0], &d.DK[0],
+                  &IERR[0], &SPU[0], &PD[0], &RD[0]);
+
+  int nOk = 0;
+  for (int t = 0; t < d.N; t++) {
+    double PC[3], RC[15], H[3], DJ[3], DK[3], PDs[3], RDs[15], spu;
+    int ierr;
+    FairGeaneUtilTestData::Get(d.PC, d.N, t, 3, PC);
+    FairGeaneUtilTestData::Get(d.RC, d.N, t, 15, RC);
+    FairGeaneUtilTestData::Get(d.H, d.N, t, 3, H);
+    FairGeaneUtilTestData::Get(d.DJ, d.N, t, 3, DJ);
+    FairGeaneUtilTestData::Get(d.DK, d.N, t, 3, DK);
+    util.FromSCToSD(PC, RC, H, d.CH[t], DJ, DK, ierr, spu, PDs, RDs);
+    ASSERT_EQ(ierr, IERR[t]);
+    EXPECT_EQ(spu, SPU[t]);
+    if (ierr == 0) {
+      ExpectNear(PDs, PD, d.N, t, 3, "PD");
+      ExpectNear(RDs, RD, d.N, t, 15, "RD");
+      nOk++;
+    }
+  }
+  EXPECT_GT(nOk, 0);
+}
+
+TEST(FairGeaneUtilBatch, FromSDToMars)
+{
+  FairGeaneUtilTestData d(kNumTracks);
+  FairGeaneUtil util;
+
+  std::vector<double> PD(3*d.N), RD(36*d.N);
+  util.FromSDToMars(d.N, &d.PC[0], &d.RC[0], &d.H[0], &d.CH[0], &d.SP[0], &d.DJ[0], &d.DK[0],
+                    &PD[0], &RD[0]);
+
+  for (int t = 0; t < d.N; t++) {
+    double PC[3], RC[15], H[3], DJ[3], DK[3], PDs[3];
+    FairGeaneUtil::sixMat RDs;
+    FairGeaneUtilTestData::Get(d.PC, d.N, t, 3, PC);
+    FairGeaneUtilTestData::Get(d.RC, d.N, t, 15, RC);
+    FairGeaneUtilTestData::Get(d.H, d.N, t, 3, H);
+    FairGeaneUtilTestData::Get(d.DJ, d.N, t, 3, DJ);
+    FairGeaneUtilTestData::Get(d.DK, d.N, t, 3, DK);
+    util.FromSDToMars(PC, RC, H, d.CH[t], d.SP[t], DJ, DK, PDs, RDs);
+    ExpectNear(PDs, PD, d.N, t, 3, "PD");
+    ExpectNear(&RDs[0][0], RD, d.N, t, 36, "RD");
+  }
+}
+
+TEST(FairGeaneUtilBatch, FromMarsToSD)
+{
+  FairGeaneUtilTestData d(kNumTracks);
+  FairGeaneUtil util;
+
+  std::vector<double> PC(3*d.N), RC(15*d.N), SP1(d.N);
+  std::vector<int> IERR(d.N);
+  util.FromMarsToSD(d.N, &d.PD[0], &d.RD[0], &d.H[0], &d.CH[0], &d.DJ[0], &d.DK[0],
+                    &IERR[0], &SP1[0], &PC[0], &RC[0]);
+
+  int nOk = 0;
+  for (int t = 0; t < d.N; t++) {
+    double PD[3], H[3], DJ[3], DK[3], PCs[3], RCs[15], sp1;
+    FairGeaneUtil::sixMat RD;
+    int ierr;
+    FairGeaneUtilTestData::Get(d.PD, d.N, t, 3, PD);
+    FairGeaneUtilTestData::Get(d.RD, d.N, t, 36, &RD[0][0]);
+    FairGeaneUtilTestData::Get(d.H, d.N, t, 3, H);
+    FairGeaneUtilTestData::Get(d.DJ, d.N, t, 3, DJ);
+    FairGeaneUtilTestData::Get(d.DK, d.N, t, 3, DK);
+    util.FromMarsToSD(PD, RD, H, d.CH[t], DJ, DK, ierr, sp1, PCs, RCs);
+    ASSERT_EQ(ierr, IERR[t]);
+    if (ierr == 0) {
+      EXPECT_EQ(sp1, SP1[t]);
+      ExpectNear(PCs, PC, d.N, t, 3, "PC");
+      ExpectNear(RCs, RC, d.N, t, 15, "RC");
+      nOk++;
+    }
+  }
+  EXPECT_GT(nOk, 0);
+}
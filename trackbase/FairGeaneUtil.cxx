@@ -22,6 +22,189 @@
 
 using namespace std;
 
+namespace
+{
+
+// Kernels of the batched transformations. A block of kLanes tracks is copied
+// into fixed size arrays [element][lane]; all loops have compile time bounds
+// and the lane loop is the innermost one, so that the compiler unrolls the
+// element loops and vectorizes over the tracks. The arithmetic is done in the
+// same order as in the single track routines.
+
+const Int_t kLanes = 4;
+
+/// index of A[i][k] in the 25-dim vector of FromMatToVec (column convention)
+inline Int_t M5(Int_t i, Int_t k) { return i + 5 * k; }
+
+/// index of A[i][k] in the 15-dim upper triangular vector
+inline Int_t T15(Int_t i, Int_t k)
+{
+  static const Int_t index[5][5] = { { 0,  1,  2,  3,  4},
+                                     { 1,  5,  6,  7,  8},
+                                     { 2,  6,  9, 10, 11},
+                                     { 3,  7, 10, 12, 13},
+                                     { 4,  8, 11, 13, 14} };
+  return index[i][k];
+}
+
+/// copy NE elements of the tracks [t0, t0+n) into a block, unused lanes repeat the last track
+template<Int_t NE>
+inline void LoadBlock(const Double_t* src, Int_t N, Int_t t0, Int_t n, Double_t dst[NE][kLanes])
+{
+  for(Int_t e=0; e<NE; e++) {
+    for(Int_t l=0; l<kLanes; l++) {
+      dst[e][l] = src[e*N + t0 + (l < n ? l : n-1)];
+    }
+  }
+}
+
+template<Int_t NE>
+inline void LoadBlock(const Int_t* src, Int_t N, Int_t t0, Int_t n, Int_t dst[NE][kLanes])
+{
+  for(Int_t e=0; e<NE; e++) {
+    for(Int_t l=0; l<kLanes; l++) {
+      dst[e][l] = src[e*N + t0 + (l < n ? l : n-1)];
+    }
+  }
+}
+
+/// copy the n used lanes of a block back, tracks flagged in ierr get zeros
+template<Int_t NE>
+inline void StoreBlock(Double_t src[NE][kLanes], Int_t N, Int_t t0, Int_t n, const Int_t ierr[kLanes], Double_t* dst)
+{
+  for(Int_t e=0; e<NE; e++) {
+    for(Int_t l=0; l<n; l++) {
+      dst[e*N + t0 + l] = ierr[l] ? 0. : src[e][l];
+    }
+  }
+}
+
+template<Int_t NE>
+inline void ZeroBlock(Double_t a[NE][kLanes])
+{
+  for(Int_t e=0; e<NE; e++) {
+    for(Int_t l=0; l<kLanes; l++) {
+      a[e][l] = 0.;
+    }
+  }
+}
+
+/// A*S*AT -> R for a block, A in the 25-dim column convention, S and R triangular.
+/// The row sums of S*AT do not depend on I and are computed once per column J.
+inline void SymmProdBlock(Double_t A[25][kLanes], Double_t Q[15][kLanes], Double_t R[15][kLanes])
+{
+  Int_t K = 0;
+  for(Int_t J=0; J<5; J++) {
+    Double_t W[5][kLanes];
+    for(Int_t l=0; l<kLanes; l++) {
+      Double_t T1=A[J   ][l];
+      Double_t T2=A[J+ 5][l];
+      Double_t T3=A[J+10][l];
+      Double_t T4=A[J+15][l];
+      Double_t T5=A[J+20][l];
+      W[0][l]=Q[0][l]*T1+Q[1][l]*T2+Q[ 2][l]*T3+Q[ 3][l]*T4+Q[ 4][l]*T5;
+      W[1][l]=Q[1][l]*T1+Q[5][l]*T2+Q[ 6][l]*T3+Q[ 7][l]*T4+Q[ 8][l]*T5;
+      W[2][l]=Q[2][l]*T1+Q[6][l]*T2+Q[ 9][l]*T3+Q[10][l]*T4+Q[11][l]*T5;
+      W[3][l]=Q[3][l]*T1+Q[7][l]*T2+Q[10][l]*T3+Q[12][l]*T4+Q[13][l]*T5;
+      W[4][l]=Q[4][l]*T1+Q[8][l]*T2+Q[11][l]*T3+Q[13][l]*T4+Q[14][l]*T5;
+    }
+    for(Int_t I=J; I<5; I++) {
+      for(Int_t l=0; l<kLanes; l++) {
+        R[K][l]=A[I   ][l]*W[0][l]
+               +A[I+ 5][l]*W[1][l]
+               +A[I+10][l]*W[2][l]
+               +A[I+15][l]*W[3][l]
+               +A[I+20][l]*W[4][l];
+      }
+      K++;
+    }
+  }
+}
+
+/// C += A*B for blocks of fixed size matrices
+template<Int_t NI, Int_t NL, Int_t NK>
+inline void MultAddBlock(Double_t A[NI][NL][kLanes], Double_t B[NL][NK][kLanes], Double_t C[NI][NK][kLanes])
+{
+  for(Int_t i=0; i<NI; i++) {
+    for(Int_t k=0; k<NK; k++) {
+      for(Int_t m=0; m<NL; m++) {
+        for(Int_t l=0; l<kLanes; l++) {
+          C[i][k][l] += A[i][m][l]*B[m][k][l];
+        }
+      }
+    }
+  }
+}
+
+/// C += A*BT for blocks of fixed size matrices
+template<Int_t NI, Int_t NL, Int_t NK>
+inline void MultAddTransposedBlock(Double_t A[NI][NL][kLanes], Double_t B[NK][NL][kLanes], Double_t C[NI][NK][kLanes])
+{
+  for(Int_t i=0; i<NI; i++) {
+    for(Int_t k=0; k<NK; k++) {
+      for(Int_t m=0; m<NL; m++) {
+        for(Int_t l=0; l<kLanes; l++) {
+          C[i][k][l] += A[i][m][l]*B[k][m][l];
+        }
+      }
+    }
+  }
+}
+
+/// C += A*RmatT for Rmat = diag(Rot, Rot), only the non-zero 3x3 blocks are summed
+/// (the terms left out are exact zeros, the result is the same as with the full product)
+inline void MultAddRotTransposedBlock(Double_t A[6][6][kLanes], Double_t Rmat[6][6][kLanes], Double_t C[6][6][kLanes])
+{
+  for(Int_t i=0; i<6; i++) {
+    for(Int_t k=0; k<6; k++) {
+      for(Int_t m=(k/3)*3; m<(k/3)*3+3; m++) {
+        for(Int_t l=0; l<kLanes; l++) {
+          C[i][k][l] += A[i][m][l]*Rmat[k][m][l];
+        }
+      }
+    }
+  }
+}
+
+/// C += Rmat*A for Rmat = diag(Rot, Rot)
+inline void MultAddRotBlock(Double_t Rmat[6][6][kLanes], Double_t A[6][6][kLanes], Double_t C[6][6][kLanes])
+{
+  for(Int_t i=0; i<6; i++) {
+    for(Int_t k=0; k<6; k++) {
+      for(Int_t m=(i/3)*3; m<(i/3)*3+3; m++) {
+        for(Int_t l=0; l<kLanes; l++) {
+          C[i][k][l] += Rmat[i][m][l]*A[m][k][l];
+        }
+      }
+    }
+  }
+}
+
+template<Int_t NI, Int_t NK>
+inline void ZeroBlock(Double_t a[NI][NK][kLanes])
+{
+  for(Int_t i=0; i<NI; i++) {
+    ZeroBlock<NK>(a[i]);
+  }
+}
+
+/// rotation from MARS to the local cartesian frame of a detector plane as built
+/// with TVector3 in FromMarsToSD: rows DJ1, DK1 and DJ1 x DK1
+inline void PlaneRotation(const Double_t DJ1[3], const Double_t DK1[3], Double_t Rot[3][3])
+{
+  Rot[0][0] = DJ1[0];
+  Rot[0][1] = DJ1[1];
+  Rot[0][2] = DJ1[2];
+  Rot[1][0] = DK1[0];
+  Rot[1][1] = DK1[1];
+  Rot[1][2] = DK1[2];
+  Rot[2][0] = DJ1[1]*DK1[2] - DK1[1]*DJ1[2];
+  Rot[2][1] = DJ1[2]*DK1[0] - DK1[2]*DJ1[0];
+  Rot[2][2] = DJ1[0]*DK1[1] - DK1[0]*DJ1[1];
+}
+
+}
+
 FairGeaneUtil::FairGeaneUtil() : TObject() { }
 
 FairGeaneUtil::~FairGeaneUtil() { }
@@ -1844,5 +2027,420 @@ TVector3  FairGeaneUtil::FromSDToMARSCoord(TVector3 uvw, TVector3 o, TVector3 di
 }
 
 
+// ------------------------- batched transformations --------------------------
+
+void FairGeaneUtil::FromPtToSC(Int_t N, const Double_t* PC, const Double_t* RC,
+                               //     output
+                               Double_t* PD, Double_t* RD, Int_t* IERR)
+{
+  // batched version of FromPtToSC, see the comments in the header
+
+  for(Int_t t0=0; t0<N; t0+=kLanes) {
+    Int_t n = TMath::Min(kLanes, N-t0);
+
+    Double_t P[3][kLanes], S[15][kLanes], Q[3][kLanes];
+    Double_t A[25][kLanes], R[15][kLanes];
+    Int_t err[kLanes];
+
+    LoadBlock<3>(PC, N, t0, n, P);
+    LoadBlock<15>(RC, N, t0, n, S);
+    ZeroBlock<25>(A);
+
+    for(Int_t l=0; l<kLanes; l++) {
+      Double_t COSL = cos(P[1][l]);
+      Double_t SINL = sin(P[1][l]);
+      err[l] = TMath::Abs(COSL) < 1.e-7;
+
+      Q[0][l] = P[0][l]*COSL;
+      Q[1][l] = P[1][l];
+      Q[2][l] = P[2][l];
+
+      A[M5(0,0)][l] = COSL;
+      A[M5(1,1)][l] = 1.0;
+      A[M5(2,2)][l] = 1.0;
+      A[M5(3,3)][l] = 1.0;
+      A[M5(4,4)][l] = 1.0;
+      A[M5(0,1)][l] = -P[0][l]*SINL;
+    }
+
+    SymmProdBlock(A, S, R);
+
+    StoreBlock<3>(Q, N, t0, n, err, PD);
+    StoreBlock<15>(R, N, t0, n, err, RD);
+    for(Int_t l=0; l<n; l++) { IERR[t0+l] = err[l]; }
+  }
+}
+
+void FairGeaneUtil::FromSCToSD(Int_t N, const Double_t* PC, const Double_t* RC, const Double_t* H, const Int_t* CH,
+                               const Double_t* DJ, const Double_t* DK,
+                               //    output
+                               Int_t* IERR, Double_t* SPU,
+                               Double_t* PD, Double_t* RD)
+{
+  // batched version of FromSCToSD, see the comments in the header
+
+  Double_t CFACT8= 2.997925e-04;
+
+  for(Int_t t0=0; t0<N; t0+=kLanes) {
+    Int_t n = TMath::Min(kLanes, N-t0);
+
+    Double_t P[3][kLanes], S[15][kLanes], HB[3][kLanes], DJB[3][kLanes], DKB[3][kLanes];
+    Double_t Q[3][kLanes], A[25][kLanes], R[15][kLanes], SP[1][kLanes];
+    Int_t C[1][kLanes], err[kLanes];
+
+    LoadBlock<3>(PC, N, t0, n, P);
+    LoadBlock<15>(RC, N, t0, n, S);
+    LoadBlock<3>(H, N, t0, n, HB);
+    LoadBlock<1>(CH, N, t0, n, C);
+    LoadBlock<3>(DJ, N, t0, n, DJB);
+    LoadBlock<3>(DK, N, t0, n, DKB);
+    ZeroBlock<25>(A);
+
+    for(Int_t l=0; l<kLanes; l++) {
+      Double_t TN[3], UN[3], VN[3], DI[3], TVW[3];
+
+      Double_t COSL=TMath::Cos(P[1][l]);
+      Double_t SINP=TMath::Sin(P[2][l]);
+      Double_t COSP=TMath::Cos(P[2][l]);
+
+      TN[0]=COSL*COSP;
+      TN[1]=COSL*SINP;
+      TN[2]=TMath::Sin(P[1][l]);
+
+      // DI = DJ x DK
+      DI[0]=DJB[1][l]*DKB[2][l]-DJB[2][l]*DKB[1][l];
+      DI[1]=DJB[2][l]*DKB[0][l]-DJB[0][l]*DKB[2][l];
+      DI[2]=DJB[0][l]*DKB[1][l]-DJB[1][l]*DKB[0][l];
+
+      TVW[0]=TN[0]*DI[0]+TN[1]*DI[1]+TN[2]*DI[2];
+      SP[0][l] = (TVW[0] < 0.) ? -1. : 1.;
+      TVW[1]=TN[0]*DJB[0][l]+TN[1]*DJB[1][l]+TN[2]*DJB[2][l];
+      TVW[2]=TN[0]*DKB[0][l]+TN[1]*DKB[1][l]+TN[2]*DKB[2][l];
+
+      // track lies in the detector plane: flag it, the output is zeroed when storing
+      err[l] = TMath::Abs(TVW[0]) < 1.e-7;
+
+      Double_t T1R=1./TVW[0];
+      Q[0][l] = P[0][l];
+      Q[1][l] = TVW[1]*T1R;
+      Q[2][l] = TVW[2]*T1R;
+
+      UN[0] = -SINP;
+      UN[1] =  COSP;
+      UN[2] =  0.;
+
+      VN[0] =-TN[2]*UN[1];
+      VN[1] = TN[2]*UN[0];
+      VN[2] = COSL;
+
+      Double_t UJ=UN[0]*DJB[0][l]+UN[1]*DJB[1][l]+UN[2]*DJB[2][l];
+      Double_t UK=UN[0]*DKB[0][l]+UN[1]*DKB[1][l]+UN[2]*DKB[2][l];
+      Double_t VJ=VN[0]*DJB[0][l]+VN[1]*DJB[1][l]+VN[2]*DJB[2][l];
+      Double_t VK=VN[0]*DKB[0][l]+VN[1]*DKB[1][l]+VN[2]*DKB[2][l];
+
+      if(C[0][l] != 0.) {
+        //charged particles
+        Double_t HA=TMath::Sqrt(HB[0][l]*HB[0][l]+HB[1][l]*HB[1][l]+HB[2][l]*HB[2][l]);
+        Double_t HAM=HA*P[0][l];
+        if(HAM != 0.) {
+          // ... in a magnetic field
+          Double_t HM=C[0][l]/HA;
+          Double_t QQ=-HAM*CFACT8;
+          Double_t SINZ=-(HB[0][l]*UN[0]+HB[1][l]*UN[1]+HB[2][l]*UN[2])*HM;
+          Double_t COSZ= (HB[0][l]*VN[0]+HB[1][l]*VN[1]+HB[2][l]*VN[2])*HM;
+          Double_t T3R=QQ*pow(T1R,3);
+          Double_t UI=UN[0]*DI[0]+UN[1]*DI[1]+UN[2]*DI[2];
+          Double_t VI=VN[0]*DI[0]+VN[1]*DI[1]+VN[2]*DI[2];
+          A[M5(1,3)][l] = -UI*(VK*COSZ-UK*SINZ)*T3R;
+          A[M5(1,4)][l] = -VI*(VK*COSZ-UK*SINZ)*T3R;
+          A[M5(2,3)][l] =  UI*(VJ*COSZ-UJ*SINZ)*T3R;
+          A[M5(2,4)][l] =  VI*(VJ*COSZ-UJ*SINZ)*T3R;
+        }
+      }
+
+      Double_t T2R=T1R*T1R;
+
+      // Transformation matrix from SC to SD
+      A[M5(0,0)][l] = 1.;
+      A[M5(1,1)][l] = -UK*T2R;
+      A[M5(1,2)][l] =  VK*COSL*T2R;
+      A[M5(2,1)][l] =  UJ*T2R;
+      A[M5(2,2)][l] = -VJ*COSL*T2R;
+      A[M5(3,3)][l] =  VK*T1R;
+      A[M5(3,4)][l] = -UK*T1R;
+      A[M5(4,3)][l] = -VJ*T1R;
+      A[M5(4,4)][l] =  UJ*T1R;
+    }
+
+    SymmProdBlock(A, S, R);
+
+    StoreBlock<3>(Q, N, t0, n, err, PD);
+    StoreBlock<15>(R, N, t0, n, err, RD);
+    for(Int_t l=0; l<n; l++) {
+      IERR[t0+l] = err[l];
+      SPU[t0+l] = SP[0][l];
+    }
+  }
+}
+
+void FairGeaneUtil::FromSDToMars(Int_t N, const Double_t* PC, const Double_t* RC,
+                                 const Double_t* H, const Int_t* CH,
+                                 const Double_t* SP1, const Double_t* DJ1, const Double_t* DK1,
+                                 //  output
+                                 Double_t* PD, Double_t* RD)
+{
+  // batched version of FromSDToMars, see the comments in the header
+
+  for(Int_t t0=0; t0<N; t0+=kLanes) {
+    Int_t n = TMath::Min(kLanes, N-t0);
+
+    Double_t P[3][kLanes], S[15][kLanes], SP[1][kLanes], DJB[3][kLanes], DKB[3][kLanes];
+    Int_t C[1][kLanes];
+    Int_t ok[kLanes] = { 0 };
+
+    LoadBlock<3>(PC, N, t0, n, P);
+    LoadBlock<15>(RC, N, t0, n, S);
+    LoadBlock<1>(CH, N, t0, n, C);
+    LoadBlock<1>(SP1, N, t0, n, SP);
+    LoadBlock<3>(DJ1, N, t0, n, DJB);
+    LoadBlock<3>(DK1, N, t0, n, DKB);
+
+    Double_t M65[6][5][kLanes], RCM[5][5][kLanes], AJ[5][6][kLanes], RD1[6][6][kLanes];
+    Double_t Rmat[6][6][kLanes], AJJ[6][6][kLanes], RDB[6][6][kLanes];
+    Double_t PDD[3][kLanes], PDB[3][kLanes];
+
+    ZeroBlock<6,5>(M65);
+    ZeroBlock<5,6>(AJ);
+    ZeroBlock<6,6>(RD1);
+    ZeroBlock<6,6>(Rmat);
+    ZeroBlock<6,6>(AJJ);
+    ZeroBlock<6,6>(RDB);
+
+    for(Int_t l=0; l<kLanes; l++) {
+      // jacobian from SD to local cartesian
+      Double_t SPU = SP[0][l];
+      Double_t PM = 1.e+30;
+      if(P[0][l] != 0.) { PM =C[0][l]/P[0][l]; }
+      Double_t PM2  = PM*PM;
+      Double_t PVW  = TMath::Sqrt(1.+P[1][l]*P[1][l]+P[2][l]*P[2][l]);
+      Double_t PVW3 = TMath::Power(PVW,3);
+
+      PDD[0][l] = SPU*PM*P[1][l]/PVW;
+      PDD[1][l] = SPU*PM*P[2][l]/PVW;
+      PDD[2][l] = SPU*PM/PVW ;
+
+      // Jacobian SD -->  Mars
+      //  eq (80) of CMS note 2006/001 (Strandlie and Wittek)
+      M65[0][0][l] = - SPU*PM2*P[1][l]/(C[0][l]*PVW);
+      M65[1][0][l] = - SPU*PM2*P[2][l]/(C[0][l]*PVW);
+      M65[2][0][l] = - SPU*PM2/(C[0][l]*PVW);
+
+      M65[0][1][l] =   SPU*PM*(1.+P[2][l]*P[2][l])/PVW3;
+      M65[1][1][l] = - SPU*PM*P[1][l]*P[2][l]/PVW3;
+      M65[2][1][l] = - SPU*PM*P[1][l]/PVW3;
+
+      M65[0][2][l] = - SPU*PM*P[1][l]*P[2][l]/PVW3;
+      M65[1][2][l] =   SPU*PM*(1.+P[1][l]*P[1][l])/PVW3;
+      M65[2][2][l] = - SPU*PM*P[2][l]/PVW3;
+
+      M65[3][3][l] = 1.;
+      M65[4][4][l] = 1.;
+
+      // from the local cartesian frame to MARS: transposed plane rotation
+      Double_t dj[3] = { DJB[0][l], DJB[1][l], DJB[2][l] };
+      Double_t dk[3] = { DKB[0][l], DKB[1][l], DKB[2][l] };
+      Double_t Rot[3][3];
+      PlaneRotation(dj, dk, Rot);
+
+      for(Int_t i=0; i<3; i++) {
+        for(Int_t k=0; k<3; k++) {
+          Rmat[i][k][l]     = Rot[k][i];
+          Rmat[i+3][k+3][l] = Rot[k][i];
+        }
+      }
+    }
+
+    for(Int_t i=0; i<5; i++) {
+      for(Int_t k=0; k<5; k++) {
+        for(Int_t l=0; l<kLanes; l++) {
+          RCM[i][k][l] = S[T15(i,k)][l];
+        }
+      }
+    }
+
+    // product (J)(RCM)(J+)
+    MultAddTransposedBlock<5,5,6>(RCM, M65, AJ);
+    MultAddBlock<6,5,6>(M65, AJ, RD1);
+
+    for(Int_t i=0; i<3; i++) {
+      for(Int_t l=0; l<kLanes; l++) {
+        PDB[i][l] = 0.;
+      }
+      for(Int_t k=0; k<3; k++) {
+        for(Int_t l=0; l<kLanes; l++) {
+          PDB[i][l] += Rmat[i][k][l]*PDD[k][l];
+        }
+      }
+    }
+
+    // (Rmat)(RD1)(Rmat+)
+    MultAddRotTransposedBlock(RD1, Rmat, AJJ);
+    MultAddRotBlock(Rmat, AJJ, RDB);
+
+    StoreBlock<3>(PDB, N, t0, n, ok, PD);
+    for(Int_t i=0; i<6; i++) {
+      StoreBlock<6>(RDB[i], N, t0, n, ok, RD + 6*i*N);
+    }
+  }
+}
+
+void FairGeaneUtil::FromMarsToSD(Int_t N, const Double_t* PD, const Double_t* RD,
+                                 const Double_t* H, const Int_t* CH,
+                                 const Double_t* DJ1, const Double_t* DK1,
+                                 //  output
+                                 Int_t* IERR, Double_t* SP1,
+                                 Double_t* PC, Double_t* RC)
+{
+  // batched version of FromMarsToSD, see the comments in the header
+
+  for(Int_t t0=0; t0<N; t0+=kLanes) {
+    Int_t n = TMath::Min(kLanes, N-t0);
+
+    Double_t P[3][kLanes], DJB[3][kLanes], DKB[3][kLanes];
+    Double_t RDB[6][6][kLanes];
+    Int_t C[1][kLanes], err[kLanes];
+
+    LoadBlock<3>(PD, N, t0, n, P);
+    LoadBlock<1>(CH, N, t0, n, C);
+    LoadBlock<3>(DJ1, N, t0, n, DJB);
+    LoadBlock<3>(DK1, N, t0, n, DKB);
+    for(Int_t i=0; i<6; i++) {
+      LoadBlock<6>(RD + 6*i*N, N, t0, n, RDB[i]);
+    }
+
+    Double_t Rmat[6][6][kLanes], R6[6][6][kLanes], RLC[6][6][kLanes];
+    Double_t M56[5][6][kLanes], AJT[6][5][kLanes], AJ[5][5][kLanes];
+    Double_t PDD[3][kLanes], Q[3][kLanes], R[15][kLanes], SP[kLanes];
+
+    ZeroBlock<6,6>(Rmat);
+    ZeroBlock<6,6>(R6);
+    ZeroBlock<6,6>(RLC);
+    ZeroBlock<5,6>(M56);
+    ZeroBlock<6,5>(AJT);
+    ZeroBlock<5,5>(AJ);
+
+    for(Int_t l=0; l<kLanes; l++) {
+      Double_t dj[3] = { DJB[0][l], DJB[1][l], DJB[2][l] };
+      Double_t dk[3] = { DKB[0][l], DKB[1][l], DKB[2][l] };
+      Double_t Rot[3][3];
+      PlaneRotation(dj, dk, Rot);
+
+      for(Int_t i=0; i<3; i++) {
+        for(Int_t k=0; k<3; k++) {
+          Rmat[i][k][l]     = Rot[i][k];
+          Rmat[i+3][k+3][l] = Rot[i][k];
+        }
+      }
+
+      SP[l] = (P[0][l]*(dj[1]*dk[2]-dj[2]*dk[1])+
+               P[1][l]*(dj[2]*dk[0]-dj[0]*dk[2])+
+               P[2][l]*(dj[0]*dk[1]-dj[1]*dk[0])) >= 0. ? 1. : -1.;
+    }
+
+    // momentum components in the local cartesian frame
+    for(Int_t i=0; i<3; i++) {
+      for(Int_t l=0; l<kLanes; l++) {
+        PDD[i][l] = 0.;
+      }
+      for(Int_t k=0; k<3; k++) {
+        for(Int_t l=0; l<kLanes; l++) {
+          PDD[i][l] += Rmat[i][k][l]*P[k][l];
+        }
+      }
+    }
+
+    // product (J)(RD)(J+)
+    MultAddRotTransposedBlock(RDB, Rmat, R6);
+    MultAddRotBlock(Rmat, R6, RLC);
+
+    for(Int_t l=0; l<kLanes; l++) {
+      Double_t PM  = TMath::Sqrt(PDD[0][l]*PDD[0][l]+PDD[1][l]*PDD[1][l]+PDD[2][l]*PDD[2][l]);
+      Double_t PM3 = TMath::Power(PM,3);
+
+      // track in the x-y plane of the local cartesian frame: flag it, the output is zeroed when storing
+      err[l] = TMath::Abs(PDD[2][l]) < 1.e-08;
+
+      Q[0][l] = C[0][l]/PM;
+      Q[1][l] = PDD[0][l]/PDD[2][l];
+      Q[2][l] = PDD[1][l]/PDD[2][l];
+
+      //  eq (79) of CMS note 2006/001 (Strandle and Wittek)
+      M56[0][0][l] = - C[0][l]*PDD[0][l]/PM3;
+      M56[0][1][l] = - C[0][l]*PDD[1][l]/PM3;
+      M56[0][2][l] = - C[0][l]*PDD[2][l]/PM3;
+
+      M56[1][0][l] =   1./PDD[2][l];
+      M56[1][2][l] = - PDD[0][l]/(PDD[2][l]*PDD[2][l]);
+
+      M56[2][1][l] =   1./PDD[2][l];
+      M56[2][2][l] = - PDD[1][l]/(PDD[2][l]*PDD[2][l]);
+
+      M56[3][3][l] =   1.;
+      M56[4][4][l] =   1.;
+    }
+
+    MultAddTransposedBlock<6,6,5>(RLC, M56, AJT);
+    MultAddBlock<5,6,5>(M56, AJT, AJ);
+
+    for(Int_t i=0; i<5; i++) {
+      for(Int_t k=i; k<5; k++) {
+        for(Int_t l=0; l<kLanes; l++) {
+          R[T15(i,k)][l] = AJ[i][k][l];
+        }
+      }
+    }
+
+    StoreBlock<3>(Q, N, t0, n, err, PC);
+    StoreBlock<15>(R, N, t0, n, err, RC);
+    for(Int_t l=0; l<n; l++) {
+      IERR[t0+l] = err[l];
+      SP1[t0+l] = err[l] ? 0. : SP[l];
+    }
+  }
+}
+
+void FairGeaneUtil::FromVec15ToMat25(Int_t N, const Double_t* V, Double_t* A)
+{
+  // batched version of FromVec15ToMat25, A is stored row major
+
+  for(Int_t i=0; i<5; i++) {
+    for(Int_t k=0; k<5; k++) {
+      const Double_t* src = V + T15(i,k)*N;
+      Double_t* dst = A + (5*i+k)*N;
+      for(Int_t t=0; t<N; t++) { dst[t] = src[t]; }
+    }
+  }
+}
+
+void FairGeaneUtil::SymmProd(Int_t N, const Double_t* A, const Double_t* S, Double_t* R)
+{
+  // batched version of SymmProd, A in the 25-dim convention of FromMatToVec.
+  // S and R may be the same arrays.
+
+  Int_t ok[kLanes] = { 0 };
+
+  for(Int_t t0=0; t0<N; t0+=kLanes) {
+    Int_t n = TMath::Min(kLanes, N-t0);
+
+    Double_t AB[25][kLanes], Q[15][kLanes], RB[15][kLanes];
+    LoadBlock<25>(A, N, t0, n, AB);
+    LoadBlock<15>(S, N, t0, n, Q);
+
+    SymmProdBlock(AB, Q, RB);
+
+    StoreBlock<15>(RB, N, t0, n, ok, R);
+  }
+}
+
 ClassImp(FairGeaneUtil)
 
@@ -83,6 +83,34 @@ class FairGeaneUtil : public TObject
     TVector3 FromMARSToSDCoord(TVector3 xyz, TVector3 o, TVector3 di, TVector3 dj, TVector3 dk);
     TVector3 FromSDToMARSCoord(TVector3 uvw, TVector3 o, TVector3 di, TVector3 dj, TVector3 dk);
 
+    //---------------------------------------
+    // batched versions: N tracks in structure of arrays layout,
+    // element e of track t is stored at X[e*N+t], e.g. RC[15*N], PC[3*N],
+    // RD[36*N] for 6x6 and A[25*N] for 5x5 matrices (row major).
+    // Tracks with IERR = 1 get zero output parameters and matrices.
+
+    void FromPtToSC(Int_t N, const Double_t* PC, const Double_t* RC,
+                    Double_t* PD, Double_t* RD, Int_t* IERR);
+
+    void FromSCToSD(Int_t N, const Double_t* PC, const Double_t* RC, const Double_t* H, const Int_t* CH,
+                    const Double_t* DJ, const Double_t* DK,
+                    Int_t* IERR, Double_t* SPU,
+                    Double_t* PD, Double_t* RD);
+
+    void FromSDToMars(Int_t N, const Double_t* PC, const Double_t* RC,
+                      const Double_t* H, const Int_t* CH,
+                      const Double_t* SP1, const Double_t* DJ1, const Double_t* DK1,
+                      Double_t* PD, Double_t* RD);
+
+    void FromMarsToSD(Int_t N, const Double_t* PD, const Double_t* RD,
+                      const Double_t* H, const Int_t* CH,
+                      const Double_t* DJ1, const Double_t* DK1,
+                      Int_t* IERR, Double_t* SP1,
+                      Double_t* PC, Double_t* RC);
+
+    void FromVec15ToMat25(Int_t N, const Double_t* V, Double_t* A);
+    void SymmProd(Int_t N, const Double_t* A, const Double_t* S, Double_t* R);
+
     ClassDef(FairGeaneUtil,1);
 };
 